@@ -0,0 +1,137 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "ascii_art_parser.hpp"
+
+bool ParseAsciiArt(const char *art, float scale, std::vector<float> &positions,
+                   std::vector<uint16_t> &indices) {
+  positions.clear();
+  indices.clear();
+
+  // figure out width and height
+  int rows = 1;
+  int curCols = 0, cols = 0;
+  int r, c;
+  const char *p;
+  for (p = art; *p; ++p) {
+    if (*p == '\n') {
+      rows++;
+      curCols = 0;
+    } else {
+      curCols++;
+      cols = curCols > cols ? curCols : cols;
+    }
+  }
+
+  // copy the input into a rows x cols working array
+  std::vector<unsigned int> grid(rows * cols, 0);
+  r = c = 0;
+  for (p = art; *p; ++p) {
+    if (*p == '\n') {
+      r++, c = 0;
+    } else {
+      grid[r * cols + c++] = static_cast<unsigned int>(*p);
+    }
+  }
+#define CELL(row, col) grid[(row) * cols + (col)]
+
+  // remove redundant line markers
+  for (r = 0; r < rows; r++) {
+    for (c = 0; c < cols; c++) {
+      if (c + 1 < cols && CELL(r, c) == '-' && CELL(r, c + 1) == '-') {
+        CELL(r, c) = ' ';
+      }
+      if (r + 1 < rows && CELL(r, c) == '|' && CELL(r + 1, c) == '|') {
+        CELL(r, c) = ' ';
+      }
+      if (r + 1 < rows && c + 1 < cols && CELL(r, c) == '`' && CELL(r + 1, c + 1) == '`') {
+        CELL(r, c) = ' ';
+      }
+      if (r + 1 < rows && c > 0 && CELL(r, c) == '/' && CELL(r + 1, c - 1) == '/') {
+        CELL(r, c) = ' ';
+      }
+    }
+  }
+
+  float left = (-cols / 2) * scale;
+  if (cols % 2 == 0) left += scale * 0.5f;
+  float top = (rows / 2) * scale;
+  if (rows % 2 == 0) top += scale * 0.5f;
+
+  const unsigned int VERTEX_BIT = 0x1000;
+  const unsigned int VERTEX_INDEX_MASK = 0x0fff;
+
+  // process vertices
+  for (r = 0; r < rows; r++) {
+    for (c = 0; c < cols; c++) {
+      if (CELL(r, c) == '+') {
+        // mark which vertex this is
+        CELL(r, c) = VERTEX_BIT | static_cast<unsigned int>(positions.size() / 2);
+        positions.push_back(left + c * scale);
+        positions.push_back(top - r * scale);
+      }
+    }
+  }
+
+  // process lines, each one goes from the vertex found walking back along its
+  // direction to the vertex found walking forward
+  int col_dir, row_dir;
+  for (r = 0; r < rows; r++) {
+    for (c = 0; c < cols; c++) {
+      unsigned int t = CELL(r, c);
+      if (t == '-') {
+        // horizontal line
+        col_dir = -1, row_dir = 0;
+      } else if (t == '|') {
+        // vertical line
+        col_dir = 0, row_dir = -1;
+      } else if (t == '`') {
+        // horizontal line, slanting down
+        col_dir = -1, row_dir = -1;
+      } else if (t == '/') {
+        // horizontal line, slanting up
+        col_dir = -1, row_dir = 1;
+      } else {
+        continue;
+      }
+
+      int start_c = c, start_r = r;
+      while (!(CELL(start_r, start_c) & VERTEX_BIT)) {
+        start_c += col_dir;
+        start_r += row_dir;
+        if (start_c < 0 || start_r < 0 || start_c >= cols || start_r >= rows) {
+          return false;
+        }
+      }
+
+      int end_c = c, end_r = r;
+      while (!(CELL(end_r, end_c) & VERTEX_BIT)) {
+        end_c -= col_dir;
+        end_r -= row_dir;
+        if (end_c < 0 || end_r < 0 || end_c >= cols || end_r >= rows) {
+          return false;
+        }
+      }
+
+      indices.push_back(static_cast<uint16_t>(CELL(start_r, start_c) & VERTEX_INDEX_MASK));
+      indices.push_back(static_cast<uint16_t>(CELL(end_r, end_c) & VERTEX_INDEX_MASK));
+    }
+  }
+#undef CELL
+
+  return true;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef agdktunnel_ascii_art_parser_hpp
+#define agdktunnel_ascii_art_parser_hpp
+
+#include <cstdint>
+#include <vector>
+
+// Parses ASCII art (see ascii_to_geom.hpp) into XY vertex positions, two floats per
+// vertex with z always 0, and pairs of line indices. scale is the size of each
+// character and the center of the art is at 0,0. Returns false if a line of the art
+// has no vertex at one of its ends.
+//
+// This has no dependency on the engine, so that tools/ascii_art_bake can run it on
+// the host to bake the art of the game offline.
+bool ParseAsciiArt(const char *art, float scale, std::vector<float> &positions,
+                   std::vector<uint16_t> &indices);
+
+// Location of the geometry of one piece of art in the tables of ascii_art_baked.inl
+struct BakedAsciiArt {
+  uint32_t firstVertex;
+  uint32_t vertexCount;
+  uint32_t firstIndex;
+  uint32_t indexCount;
+};
+
+// The pieces of ascii_art.inl baked into ascii_art_baked.inl, along with the alphabet
+enum BakedArt {
+  BAKED_ART_LIFE = 0,
+  BAKED_ART_COUNT
+};
+
+#endif // agdktunnel_ascii_art_parser_hpp
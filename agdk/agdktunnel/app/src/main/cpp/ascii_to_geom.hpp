@@ -17,7 +17,10 @@
 #ifndef agdktunnel_ascii_to_geom_hpp
 #define agdktunnel_ascii_to_geom_hpp
 
+#include "ascii_art_parser.hpp"
 #include "simplegeom.hpp"
+#include <cstdint>
+#include <vector>
 
 /* Converts ASCII art into a Vbo/Ibo pair. Useful for retro-looking drawings/text!
  * scale is the size of each character. The center of the rendering will be 0,0.
@@ -39,4 +42,13 @@
  */
 SimpleGeom *AsciiArtToGeom(const char *art, float scale);
 
+/* Like AsciiArtToGeom, for art baked offline into data/ascii_art_baked.inl by
+ * tools/ascii_art_bake, so nothing is parsed at runtime. */
+SimpleGeom *BakedArtToGeom(BakedArt art, float scale);
+
+/* Returns the vertices (P3C4) and line indices of the baked glyph of a character of
+ * alphabet.inl, or false if the character has no glyph. */
+bool BakedGlyphToVertices(int charCode, float scale, std::vector<float> &vertices,
+                          std::vector<uint16_t> &indices);
+
 #endif
@@ -0,0 +1,896 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Generated by tools/ascii_art_bake from alphabet.inl and ascii_art.inl, do not
+// edit. Rebuild the bake_ascii_art target of the tool after changing the art.
+
+#ifndef agdktunnel_ascii_art_baked_inl
+#define agdktunnel_ascii_art_baked_inl
+
+#include "ascii_art_parser.hpp"
+
+// XY positions at a scale of 1, two floats per vertex
+static const float BAKED_ART_POSITIONS[] = {
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    0.0f, 1.5f,
+    -1.0f, 0.5f,
+    1.0f, 0.5f,
+    -1.0f, -1.5f,
+    1.0f, -1.5f,
+    -2.0f, 5.5f,
+    0.0f, 5.5f,
+    -2.0f, 3.5f,
+    0.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    0.0f, -0.5f,
+    2.0f, -0.5f,
+    0.0f, -2.5f,
+    2.0f, -2.5f,
+    0.0f, 5.5f,
+    0.0f, 3.5f,
+    0.0f, 4.5f,
+    -2.0f, 2.5f,
+    0.0f, 2.5f,
+    2.0f, 2.5f,
+    0.0f, 0.5f,
+    1.0f, 0.5f,
+    -1.0f, -1.5f,
+    -2.0f, 2.5f,
+    2.0f, 2.5f,
+    -1.0f, 0.5f,
+    1.0f, 0.5f,
+    -1.0f, -1.5f,
+    1.0f, -1.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    1.0f, 5.5f,
+    1.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 2.5f,
+    2.0f, 2.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 2.5f,
+    2.0f, 2.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 2.5f,
+    2.0f, 2.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 2.5f,
+    2.0f, 2.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 2.5f,
+    2.0f, 2.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 2.5f,
+    2.0f, 2.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 2.5f,
+    2.0f, 2.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -1.0f, 5.5f,
+    1.0f, 5.5f,
+    -1.0f, 3.5f,
+    1.0f, 3.5f,
+    -1.0f, 1.5f,
+    1.0f, 1.5f,
+    -1.0f, -0.5f,
+    1.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    0.0f, 3.5f,
+    2.0f, 3.5f,
+    0.0f, 1.5f,
+    -1.0f, 0.5f,
+    1.0f, 0.5f,
+    -1.0f, -1.5f,
+    1.0f, -1.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 2.5f,
+    2.0f, 2.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 2.5f,
+    2.0f, 2.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    0.0f, 5.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 2.5f,
+    1.0f, 2.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 2.5f,
+    1.0f, 2.5f,
+    -2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    0.0f, 2.5f,
+    2.0f, 2.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 2.5f,
+    2.0f, 2.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    0.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, -0.5f,
+    0.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    0.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 1.5f,
+    -2.0f, -0.5f,
+    0.0f, -0.5f,
+    -2.0f, 5.5f,
+    1.0f, 5.5f,
+    -2.0f, 2.5f,
+    -2.0f, -0.5f,
+    1.0f, -0.5f,
+    -2.0f, 5.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    0.0f, 5.5f,
+    2.0f, 5.5f,
+    0.0f, 1.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    0.0f, 5.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    0.0f, 5.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, 1.5f,
+    2.0f, 1.5f,
+    0.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 2.5f,
+    2.0f, 2.5f,
+    -2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    0.0f, 1.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 2.5f,
+    2.0f, 2.5f,
+    -2.0f, -0.5f,
+    1.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 2.5f,
+    2.0f, 2.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    0.0f, 5.5f,
+    2.0f, 5.5f,
+    0.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 1.5f,
+    2.0f, 1.5f,
+    0.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    0.0f, 2.5f,
+    -2.0f, -0.5f,
+    0.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    0.0f, 3.5f,
+    0.0f, 1.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 2.5f,
+    0.0f, 2.5f,
+    2.0f, 2.5f,
+    0.0f, -0.5f,
+    -2.0f, 5.5f,
+    2.0f, 5.5f,
+    -2.0f, 1.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    0.0f, 5.5f,
+    -2.0f, -0.5f,
+    0.0f, -0.5f,
+    -2.0f, 4.5f,
+    2.0f, 0.5f,
+    0.0f, 5.5f,
+    2.0f, 5.5f,
+    0.0f, -0.5f,
+    2.0f, -0.5f,
+    0.0f, 5.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, 1.5f,
+    2.0f, 1.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    2.0f, 5.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, 1.5f,
+    2.0f, 1.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    1.0f, 5.5f,
+    -2.0f, 2.5f,
+    0.0f, 2.5f,
+    -2.0f, -0.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, -2.5f,
+    2.0f, -2.5f,
+    -2.0f, 5.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    0.0f, 3.5f,
+    0.0f, -0.5f,
+    0.0f, 3.5f,
+    -2.0f, -0.5f,
+    -2.0f, -2.5f,
+    0.0f, -2.5f,
+    -1.0f, 5.5f,
+    1.0f, 3.5f,
+    -1.0f, 1.5f,
+    -1.0f, -0.5f,
+    1.0f, -0.5f,
+    0.0f, 5.5f,
+    0.0f, -0.5f,
+    -2.0f, 3.5f,
+    0.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    0.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, -2.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    2.0f, -2.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, 1.5f,
+    2.0f, 1.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 5.5f,
+    -2.0f, 3.5f,
+    1.0f, 3.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, 1.5f,
+    2.0f, 1.5f,
+    0.0f, -0.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    0.0f, 2.5f,
+    -2.0f, 1.5f,
+    2.0f, 1.5f,
+    -2.0f, -0.5f,
+    0.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -2.0f, -2.5f,
+    2.0f, -2.5f,
+    -2.0f, 3.5f,
+    2.0f, 3.5f,
+    -2.0f, -0.5f,
+    2.0f, -0.5f,
+    -3.5f, 5.5f,
+    -1.5f, 5.5f,
+    2.5f, 5.5f,
+    4.5f, 5.5f,
+    -5.5f, 3.5f,
+    0.5f, 3.5f,
+    6.5f, 3.5f,
+    0.5f, -2.5f,
+};
+
+// Pairs of line indices, relative to the first vertex of each art
+static const uint16_t BAKED_ART_INDICES[] = {
+    0, 1,
+    0, 2,
+    1, 3,
+    2, 4,
+    4, 3,
+    5, 6,
+    5, 7,
+    6, 8,
+    7, 8,
+    0, 1,
+    0, 2,
+    1, 3,
+    2, 3,
+    5, 4,
+    6, 7,
+    6, 8,
+    7, 9,
+    8, 9,
+    0, 1,
+    0, 2,
+    1, 2,
+    2, 3,
+    2, 4,
+    1, 0,
+    0, 1,
+    0, 1,
+    0, 2,
+    1, 3,
+    2, 3,
+    1, 0,
+    0, 1,
+    0, 2,
+    1, 3,
+    2, 3,
+    0, 1,
+    0, 1,
+    1, 3,
+    2, 3,
+    2, 4,
+    4, 5,
+    0, 1,
+    1, 3,
+    2, 3,
+    3, 5,
+    4, 5,
+    0, 2,
+    1, 3,
+    2, 3,
+    3, 4,
+    0, 1,
+    0, 2,
+    2, 3,
+    3, 5,
+    4, 5,
+    0, 1,
+    0, 2,
+    2, 3,
+    2, 4,
+    3, 5,
+    4, 5,
+    0, 1,
+    1, 2,
+    0, 1,
+    0, 2,
+    1, 3,
+    2, 3,
+    2, 4,
+    3, 5,
+    4, 5,
+    0, 1,
+    0, 2,
+    1, 3,
+    2, 3,
+    3, 5,
+    4, 5,
+    0, 1,
+    0, 2,
+    1, 3,
+    2, 3,
+    4, 5,
+    4, 6,
+    5, 7,
+    6, 7,
+    0, 1,
+    1, 3,
+    2, 3,
+    2, 4,
+    5, 6,
+    5, 7,
+    6, 8,
+    7, 8,
+    0, 1,
+    0, 2,
+    1, 3,
+    2, 3,
+    2, 4,
+    3, 5,
+    0, 1,
+    0, 2,
+    1, 3,
+    2, 3,
+    2, 4,
+    3, 5,
+    4, 5,
+    0, 1,
+    0, 2,
+    2, 3,
+    0, 1,
+    1, 2,
+    0, 3,
+    2, 4,
+    3, 4,
+    0, 1,
+    0, 2,
+    2, 3,
+    2, 4,
+    4, 5,
+    0, 1,
+    0, 2,
+    2, 3,
+    2, 4,
+    0, 1,
+    2, 3,
+    0, 4,
+    3, 5,
+    4, 5,
+    0, 2,
+    1, 3,
+    2, 3,
+    2, 4,
+    3, 5,
+    0, 1,
+    1, 2,
+    1, 4,
+    3, 4,
+    4, 5,
+    0, 1,
+    1, 2,
+    3, 4,
+    1, 5,
+    4, 5,
+    0, 2,
+    2, 1,
+    2, 3,
+    2, 4,
+    0, 1,
+    1, 2,
+    0, 1,
+    1, 2,
+    1, 3,
+    0, 4,
+    2, 5,
+    0, 1,
+    1, 2,
+    0, 3,
+    2, 4,
+    1, 0,
+    0, 2,
+    1, 3,
+    2, 4,
+    3, 5,
+    5, 4,
+    0, 1,
+    0, 2,
+    1, 3,
+    2, 3,
+    2, 4,
+    0, 1,
+    0, 3,
+    2, 4,
+    1, 4,
+    3, 4,
+    0, 1,
+    0, 2,
+    1, 3,
+    2, 3,
+    2, 4,
+    2, 5,
+    0, 1,
+    0, 2,
+    2, 3,
+    3, 5,
+    4, 5,
+    0, 1,
+    1, 2,
+    1, 3,
+    0, 2,
+    1, 3,
+    2, 3,
+    0, 2,
+    1, 3,
+    2, 4,
+    4, 3,
+    0, 3,
+    2, 4,
+    1, 5,
+    3, 4,
+    4, 5,
+    0, 2,
+    2, 1,
+    2, 3,
+    4, 3,
+    3, 5,
+    0, 2,
+    1, 4,
+    2, 3,
+    3, 4,
+    3, 5,
+    0, 1,
+    2, 1,
+    2, 3,
+    3, 4,
+    0, 1,
+    0, 2,
+    2, 3,
+    0, 1,
+    0, 1,
+    1, 3,
+    2, 3,
+    1, 0,
+    0, 2,
+    0, 1,
+    0, 1,
+    1, 3,
+    2, 3,
+    2, 4,
+    3, 5,
+    4, 5,
+    0, 1,
+    1, 2,
+    1, 3,
+    2, 4,
+    3, 4,
+    0, 1,
+    0, 2,
+    2, 3,
+    0, 2,
+    1, 2,
+    1, 3,
+    2, 4,
+    3, 4,
+    0, 1,
+    0, 2,
+    1, 3,
+    2, 3,
+    2, 4,
+    4, 5,
+    0, 1,
+    0, 2,
+    2, 3,
+    2, 4,
+    0, 1,
+    0, 2,
+    1, 3,
+    2, 3,
+    3, 5,
+    4, 5,
+    0, 1,
+    1, 2,
+    1, 3,
+    2, 4,
+    0, 1,
+    1, 2,
+    0, 3,
+    2, 3,
+    0, 2,
+    2, 1,
+    2, 3,
+    2, 4,
+    0, 1,
+    0, 1,
+    1, 2,
+    0, 3,
+    1, 4,
+    2, 5,
+    0, 1,
+    0, 2,
+    1, 3,
+    0, 1,
+    0, 2,
+    1, 3,
+    2, 3,
+    0, 1,
+    0, 2,
+    1, 3,
+    2, 3,
+    2, 4,
+    0, 1,
+    0, 2,
+    1, 3,
+    2, 3,
+    3, 4,
+    0, 1,
+    0, 2,
+    0, 1,
+    0, 2,
+    2, 3,
+    3, 5,
+    4, 5,
+    0, 1,
+    1, 2,
+    1, 3,
+    3, 4,
+    0, 2,
+    1, 3,
+    2, 3,
+    0, 2,
+    1, 3,
+    2, 4,
+    4, 3,
+    0, 3,
+    1, 4,
+    3, 5,
+    2, 6,
+    4, 7,
+    5, 6,
+    6, 7,
+    0, 3,
+    2, 1,
+    2, 1,
+    0, 3,
+    0, 2,
+    1, 3,
+    2, 3,
+    3, 5,
+    4, 5,
+    0, 1,
+    2, 1,
+    2, 3,
+    0, 1,
+    2, 3,
+    4, 0,
+    1, 5,
+    5, 2,
+    3, 6,
+    4, 7,
+    7, 6,
+};
+
+// Alphabet glyphs indexed by character code, a vertex count of 0 means no glyph
+static const BakedAsciiArt BAKED_ALPHABET[128] = {
+    {0, 0, 0, 0}, // chr 0
+    {0, 0, 0, 0}, // chr 1
+    {0, 0, 0, 0}, // chr 2
+    {0, 0, 0, 0}, // chr 3
+    {0, 0, 0, 0}, // chr 4
+    {0, 0, 0, 0}, // chr 5
+    {0, 0, 0, 0}, // chr 6
+    {0, 0, 0, 0}, // chr 7
+    {0, 0, 0, 0}, // chr 8
+    {0, 0, 0, 0}, // chr 9
+    {0, 0, 0, 0}, // chr 10
+    {0, 0, 0, 0}, // chr 11
+    {0, 0, 0, 0}, // chr 12
+    {0, 0, 0, 0}, // chr 13
+    {0, 0, 0, 0}, // chr 14
+    {0, 0, 0, 0}, // chr 15
+    {0, 0, 0, 0}, // chr 16
+    {0, 0, 0, 0}, // chr 17
+    {0, 0, 0, 0}, // chr 18
+    {0, 0, 0, 0}, // chr 19
+    {0, 0, 0, 0}, // chr 20
+    {0, 0, 0, 0}, // chr 21
+    {0, 0, 0, 0}, // chr 22
+    {0, 0, 0, 0}, // chr 23
+    {0, 0, 0, 0}, // chr 24
+    {0, 0, 0, 0}, // chr 25
+    {0, 0, 0, 0}, // chr 26
+    {0, 0, 0, 0}, // chr 27
+    {0, 0, 0, 0}, // chr 28
+    {0, 0, 0, 0}, // chr 29
+    {0, 0, 0, 0}, // chr 30
+    {0, 0, 0, 0}, // chr 31
+    {0, 0, 0, 0}, // chr 32
+    {0, 9, 0, 18}, // chr 33
+    {0, 0, 0, 0}, // chr 34
+    {0, 0, 0, 0}, // chr 35
+    {0, 0, 0, 0}, // chr 36
+    {9, 10, 18, 18}, // chr 37
+    {0, 0, 0, 0}, // chr 38
+    {19, 2, 36, 2}, // chr 39
+    {0, 0, 0, 0}, // chr 40
+    {0, 0, 0, 0}, // chr 41
+    {0, 0, 0, 0}, // chr 42
+    {21, 5, 38, 8}, // chr 43
+    {26, 2, 46, 2}, // chr 44
+    {28, 2, 48, 2}, // chr 45
+    {30, 4, 50, 8}, // chr 46
+    {34, 2, 58, 2}, // chr 47
+    {36, 4, 60, 8}, // chr 48
+    {40, 2, 68, 2}, // chr 49
+    {42, 6, 70, 10}, // chr 50
+    {48, 6, 80, 10}, // chr 51
+    {54, 5, 90, 8}, // chr 52
+    {59, 6, 98, 10}, // chr 53
+    {65, 6, 108, 12}, // chr 54
+    {71, 3, 120, 4}, // chr 55
+    {74, 6, 124, 14}, // chr 56
+    {80, 6, 138, 12}, // chr 57
+    {86, 8, 150, 16}, // chr 58
+    {0, 0, 0, 0}, // chr 59
+    {0, 0, 0, 0}, // chr 60
+    {0, 0, 0, 0}, // chr 61
+    {0, 0, 0, 0}, // chr 62
+    {94, 9, 166, 16}, // chr 63
+    {0, 0, 0, 0}, // chr 64
+    {103, 6, 182, 12}, // chr 65
+    {109, 6, 194, 14}, // chr 66
+    {115, 4, 208, 6}, // chr 67
+    {119, 5, 214, 10}, // chr 68
+    {124, 6, 224, 10}, // chr 69
+    {130, 5, 234, 8}, // chr 70
+    {135, 6, 242, 10}, // chr 71
+    {141, 6, 252, 10}, // chr 72
+    {147, 6, 262, 10}, // chr 73
+    {153, 6, 272, 10}, // chr 74
+    {159, 5, 282, 8}, // chr 75
+    {164, 3, 290, 4}, // chr 76
+    {167, 6, 294, 10}, // chr 77
+    {173, 5, 304, 8}, // chr 78
+    {178, 6, 312, 12}, // chr 79
+    {184, 5, 324, 10}, // chr 80
+    {189, 5, 334, 10}, // chr 81
+    {194, 6, 344, 12}, // chr 82
+    {200, 6, 356, 10}, // chr 83
+    {206, 4, 366, 6}, // chr 84
+    {210, 4, 372, 6}, // chr 85
+    {214, 5, 378, 8}, // chr 86
+    {219, 6, 386, 10}, // chr 87
+    {225, 6, 396, 10}, // chr 88
+    {231, 6, 406, 10}, // chr 89
+    {237, 5, 416, 8}, // chr 90
+    {242, 4, 424, 6}, // chr 91
+    {246, 2, 430, 2}, // chr 92
+    {248, 4, 432, 6}, // chr 93
+    {252, 3, 438, 4}, // chr 94
+    {255, 2, 442, 2}, // chr 95
+    {0, 0, 0, 0}, // chr 96
+    {257, 6, 444, 12}, // chr 97
+    {263, 5, 456, 10}, // chr 98
+    {268, 4, 466, 6}, // chr 99
+    {272, 5, 472, 10}, // chr 100
+    {277, 6, 482, 12}, // chr 101
+    {283, 5, 494, 8}, // chr 102
+    {288, 6, 502, 12}, // chr 103
+    {294, 5, 514, 8}, // chr 104
+    {299, 2, 522, 2}, // chr 105
+    {301, 4, 524, 6}, // chr 106
+    {305, 5, 530, 8}, // chr 107
+    {310, 2, 538, 2}, // chr 108
+    {312, 6, 540, 10}, // chr 109
+    {318, 4, 550, 6}, // chr 110
+    {322, 4, 556, 8}, // chr 111
+    {326, 5, 564, 10}, // chr 112
+    {331, 5, 574, 10}, // chr 113
+    {336, 3, 584, 4}, // chr 114
+    {339, 6, 588, 10}, // chr 115
+    {345, 5, 598, 8}, // chr 116
+    {350, 4, 606, 6}, // chr 117
+    {354, 5, 612, 8}, // chr 118
+    {359, 8, 620, 14}, // chr 119
+    {367, 4, 634, 8}, // chr 120
+    {371, 6, 642, 10}, // chr 121
+    {377, 4, 652, 6}, // chr 122
+    {0, 0, 0, 0}, // chr 123
+    {0, 0, 0, 0}, // chr 124
+    {0, 0, 0, 0}, // chr 125
+    {0, 0, 0, 0}, // chr 126
+    {0, 0, 0, 0}, // chr 127
+};
+
+// Indexed by BakedArt
+static const BakedAsciiArt BAKED_ARTS[BAKED_ART_COUNT] = {
+    {381, 8, 658, 16}, // BAKED_ART_LIFE
+};
+
+#endif
@@ -17,50 +17,77 @@
 #ifndef agdktunnel_our_shader_inl
 #define agdktunnel_our_shader_inl
 
+// FEATURE_POINT_LIGHT and FEATURE_FOG are defined to 0 or 1 by the shader
+// variant the source is compiled for
+
 #define OUR_VERTEX_SHADER_SOURCE \
-           "uniform mat4 u_MVP;            \n" \
-           "uniform vec4 u_PointLightPos;  \n" \
-           "uniform mediump vec4 u_PointLightColor; \n" \
-           "attribute vec4 a_Position;     \n" \
-           "attribute vec4 a_Color;        \n" \
-           "attribute vec2 a_TexCoord;     \n" \
-           "varying vec4 v_Color;          \n" \
-           "varying vec4 v_Pos;            \n" \
-           "varying float v_FogFactor;     \n" \
-           "varying vec2 v_TexCoord;      \n" \
+           "#version 300 es                \n" \
+           "layout(std140) uniform OurUniforms { \n" \
+           "   mat4 u_MVP;                 \n" \
+           "   vec4 u_PointLightPos;       \n" \
+           "   mediump vec4 u_PointLightColor; \n" \
+           "   mediump vec4 u_Tint;        \n" \
+           "};                             \n" \
+           "in vec4 a_Position;            \n" \
+           "in vec4 a_Color;               \n" \
+           "in vec2 a_TexCoord;            \n" \
+           "out vec4 v_Color;              \n" \
+           "out vec4 v_Pos;                \n" \
+           "out float v_FogFactor;         \n" \
+           "out vec2 v_TexCoord;           \n" \
            "float FOG_START = 100.0;        \n" \
            "float FOG_END = 200.0;         \n" \
-           "varying vec4 v_PointLightPos;  \n" \
+           "out vec4 v_PointLightPos;      \n" \
            "void main()                    \n" \
            "{                              \n" \
            "   v_Color = a_Color;          \n" \
            "   gl_Position = u_MVP         \n" \
            "               * a_Position;   \n" \
            "   v_Pos = u_MVP * a_Position; \n" \
+           "#if FEATURE_POINT_LIGHT        \n" \
            "   v_PointLightPos = u_MVP * u_PointLightPos; \n" \
+           "#else                          \n" \
+           "   v_PointLightPos = v_Pos;    \n" \
+           "#endif                         \n" \
            "   v_TexCoord = a_TexCoord;    \n" \
+           "#if FEATURE_FOG                \n" \
            "   v_FogFactor = clamp((v_Pos.z - FOG_START) / \n" \
            "                       (FOG_END - FOG_START), 0.0, 1.0); \n" \
+           "#else                          \n" \
+           "   v_FogFactor = 0.0;          \n" \
+           "#endif                         \n" \
            "}                              \n";
 
 #define OUR_FRAG_SHADER_SOURCE \
+           "#version 300 es                \n" \
            "precision mediump float;       \n" \
-           "varying vec4 v_Color;          \n" \
-           "varying vec4 v_Pos;          \n" \
-           "varying vec2 v_TexCoord;      \n" \
-           "varying float v_FogFactor;     \n" \
-           "uniform vec4 u_Tint;           \n" \
+           "layout(std140) uniform OurUniforms { \n" \
+           "   highp mat4 u_MVP;           \n" \
+           "   highp vec4 u_PointLightPos; \n" \
+           "   vec4 u_PointLightColor;     \n" \
+           "   vec4 u_Tint;                \n" \
+           "};                             \n" \
+           "in vec4 v_Color;               \n" \
+           "in vec4 v_Pos;                 \n" \
+           "in vec2 v_TexCoord;            \n" \
+           "in float v_FogFactor;          \n" \
            "uniform sampler2D u_Sampler;   \n" \
-           "uniform vec4 u_PointLightColor; \n" \
-           "varying vec4 v_PointLightPos;   \n" \
+           "in vec4 v_PointLightPos;       \n" \
+           "out vec4 o_FragColor;          \n" \
            "float ATT_FACT_2 = 0.005;          \n" \
            "float ATT_FACT_1 = 0.00;          \n" \
            "void main()                    \n" \
            "{                              \n" \
+           "   vec4 color = v_Color * u_Tint * texture(u_Sampler, v_TexCoord);\n" \
+           "#if FEATURE_POINT_LIGHT        \n" \
            "   float d = distance(v_PointLightPos, v_Pos);\n" \
            "   float att = 1.0/(ATT_FACT_1 * d + ATT_FACT_2 * d * d);\n" \
-           "   gl_FragColor = mix(v_Color * u_Tint * texture2D(u_Sampler, v_TexCoord) + \n" \
-           "                      u_PointLightColor * att, vec4(0), v_FogFactor);\n" \
+           "   color += u_PointLightColor * att;\n" \
+           "#endif                         \n" \
+           "#if FEATURE_FOG                \n" \
+           "   color = mix(color, vec4(0), v_FogFactor);\n" \
+           "#endif                         \n" \
+           "   o_FragColor = color;        \n" \
            "}";
 
 #endif
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef agdktunnel_tunnel_shader_inl
+#define agdktunnel_tunnel_shader_inl
+
+// Instanced tunnel section shader, see shaders/tunnel.vert
+
+#define TUNNEL_VERTEX_SHADER_SOURCE \
+           "#version 300 es                \n" \
+           "layout(std140) uniform TunnelUniforms { \n" \
+           "   mat4 u_MVP;                 \n" \
+           "   vec4 u_SectionOffset;       \n" \
+           "   vec4 u_SectionLights[2];    \n" \
+           "};                             \n" \
+           "in vec4 a_Position;            \n" \
+           "in vec4 a_Color;               \n" \
+           "in vec2 a_TexCoord;            \n" \
+           "out vec4 v_Color;              \n" \
+           "out vec4 v_Pos;                \n" \
+           "out float v_FogFactor;         \n" \
+           "out vec2 v_TexCoord;           \n" \
+           "float FOG_START = 100.0;       \n" \
+           "float FOG_END = 200.0;         \n" \
+           "out vec4 v_PointLightPos;      \n" \
+           "flat out vec4 v_PointLightColor; \n" \
+           "void main()                    \n" \
+           "{                              \n" \
+           "   int section = gl_InstanceID; \n" \
+           "   vec4 offset = vec4(u_SectionOffset.xyz * float(section), 0.0); \n" \
+           "   float packedLight = u_SectionLights[section / 4][section % 4]; \n" \
+           "   vec3 lightColor = mod(floor(packedLight / vec3(1.0, 256.0, 65536.0)), \n" \
+           "                         256.0) / 255.0; \n" \
+           "   v_Color = a_Color;          \n" \
+           "   gl_Position = u_MVP * (a_Position + offset); \n" \
+           "   v_Pos = gl_Position;        \n" \
+           "   v_PointLightPos = u_MVP * (vec4(0.0, 0.0, 0.0, 1.0) + offset); \n" \
+           "   v_PointLightColor = vec4(lightColor, packedLight > 0.0 ? 1.0 : 0.0); \n" \
+           "   v_TexCoord = a_TexCoord;    \n" \
+           "   v_FogFactor = clamp((v_Pos.z - FOG_START) / \n" \
+           "                       (FOG_END - FOG_START), 0.0, 1.0); \n" \
+           "}                              \n";
+
+#define TUNNEL_FRAG_SHADER_SOURCE \
+           "#version 300 es                \n" \
+           "precision mediump float;       \n" \
+           "in vec4 v_Color;               \n" \
+           "in vec4 v_Pos;                 \n" \
+           "in vec2 v_TexCoord;            \n" \
+           "in float v_FogFactor;          \n" \
+           "uniform sampler2D u_Sampler;   \n" \
+           "in vec4 v_PointLightPos;       \n" \
+           "flat in vec4 v_PointLightColor; \n" \
+           "out vec4 o_FragColor;          \n" \
+           "float ATT_FACT_2 = 0.005;      \n" \
+           "float ATT_FACT_1 = 0.00;       \n" \
+           "void main()                    \n" \
+           "{                              \n" \
+           "   float d = distance(v_PointLightPos, v_Pos);\n" \
+           "   float att = 1.0/(ATT_FACT_1 * d + ATT_FACT_2 * d * d);\n" \
+           "   o_FragColor = mix(v_Color * texture(u_Sampler, v_TexCoord) + \n" \
+           "                     v_PointLightColor * att, vec4(0), v_FogFactor);\n" \
+           "}";
+
+#endif
@@ -23,11 +23,14 @@ DataLoaderStateMachine::DataLoaderStateMachine(bool isCloudSaveEnabled, char *sa
     strcpy(mSaveFileName, savePath);
     strcat(mSaveFileName, "/");
     strcat(mSaveFileName, SAVE_FILE_NAME);
+    mSaveService = new SaveService(mSaveFileName);
     mLevelLoaded = 0;
     mCurrentState = LOAD_NOT_STARTED;
 }
 
 DataLoaderStateMachine::~DataLoaderStateMachine() {
+    // finishes writing the last requested save
+    delete mSaveService;
     delete mSaveFileName;
 }
 
@@ -89,6 +92,8 @@ void DataLoaderStateMachine::savedStateLoadingFailed() {
 }
 
 void DataLoaderStateMachine::LoadLocalProgress() {
+    // a save still being written is more recent than the file
+    mSaveService->WaitForIdle();
     ALOGI("Attempting to load locally: %s", mSaveFileName);
     mLevelLoaded = 0;
     FILE *f = fopen(mSaveFileName, "r");
@@ -109,13 +114,12 @@ void DataLoaderStateMachine::LoadLocalProgress() {
 
 void DataLoaderStateMachine::SaveLocalProgress(int level) {
     mLevelLoaded = level;
-    ALOGI("Saving progress (level %d) to file: %s", level, mSaveFileName);
-    FILE *f = fopen(mSaveFileName, "w");
-    if (!f) {
-        ALOGE("Error writing to save game file.");
-        return;
-    }
-    fprintf(f, "v1 %d", level);
-    fclose(f);
-    ALOGI("Save file written.");
-}
\ No newline at end of file
+    ALOGI("Queueing save of progress (level %d) to file: %s", level, mSaveFileName);
+    SaveSnapshot snapshot;
+    snapshot.level = level;
+    mSaveService->RequestSave(snapshot);
+}
+
+bool DataLoaderStateMachine::PollSaveCompletion(SaveCompletion *completion) {
+    return mSaveService->PollCompletion(completion);
+}
@@ -17,6 +17,7 @@
 #define agdktunnel_data_loader_machine_hpp
 
 #include "common.hpp"
+#include "save_service.hpp"
 
 // save file name
 #define SAVE_FILE_NAME "tunnel.dat"
@@ -49,6 +50,9 @@ private:
     // name of the save file
     char *mSaveFileName;
 
+    // writes the save file off the game thread
+    SaveService *mSaveService;
+
     // flag to know if cloud save is enabled
     bool mIsCloudSaveEnabled;
 
@@ -99,9 +103,13 @@ public:
     // load progress saved in internal storage and moves state to DATA_LOADED
     void LoadLocalProgress();
 
-    // save progress to internal storage
+    // queues a save of progress to internal storage, the level is reported
+    // through PollSaveCompletion once it has been written
     void SaveLocalProgress(int level);
 
+    // returns false when no local save finished since the last call
+    bool PollSaveCompletion(SaveCompletion *completion);
+
 };
 
 #endif //agdktunnel_data_loader_machine_hpp
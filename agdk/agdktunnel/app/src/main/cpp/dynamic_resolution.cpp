@@ -0,0 +1,110 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "dynamic_resolution.hpp"
+#include "common.hpp"
+#include "game_consts.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+DynamicResolution::DynamicResolution() {
+  mThermalManager = NULL;
+  mLastThermalQuery = std::chrono::steady_clock::time_point();
+  mThermalHeadroom = 0.0f;
+  mGpuFrameTime = 0;
+  mScale = DYNRES_MAX_SCALE;
+  mMaxScale = DYNRES_MAX_SCALE;
+  mOverBudgetFrames = 0;
+  mUnderBudgetFrames = 0;
+  if (__builtin_available(android 31, *)) {
+    mThermalManager = AThermal_acquireManager();
+  }
+}
+
+DynamicResolution::~DynamicResolution() {
+  if (mThermalManager != NULL) {
+    if (__builtin_available(android 31, *)) {
+      AThermal_releaseManager(mThermalManager);
+    }
+    mThermalManager = NULL;
+  }
+}
+
+void DynamicResolution::UpdateThermalHeadroom() {
+  if (mThermalManager == NULL) {
+    return;
+  }
+  // The headroom query is rate limited by the system and returns NaN when
+  // called too often, so only poll it periodically
+  const auto now = std::chrono::steady_clock::now();
+  const std::chrono::duration<float> sinceQuery = now - mLastThermalQuery;
+  if (sinceQuery.count() < DYNRES_THERMAL_POLL_SECONDS) {
+    return;
+  }
+  mLastThermalQuery = now;
+
+  float headroom = NAN;
+  if (__builtin_available(android 31, *)) {
+    headroom = AThermal_getThermalHeadroom(mThermalManager, DYNRES_THERMAL_FORECAST_SECONDS);
+  }
+  if (std::isnan(headroom)) {
+    return;
+  }
+  mThermalHeadroom = headroom;
+
+  // Scale down the maximum linearly from the start headroom to severe throttling
+  const float throttle = std::min(1.0f, std::max(0.0f,
+      (headroom - DYNRES_THERMAL_HEADROOM_START) / (1.0f - DYNRES_THERMAL_HEADROOM_START)));
+  mMaxScale = DYNRES_MAX_SCALE - (DYNRES_MAX_SCALE - DYNRES_MIN_SCALE) * throttle;
+}
+
+float DynamicResolution::Update(const uint64_t gpuFrameTime, const uint64_t cpuFrameTime,
+                                const uint64_t targetFrameTime) {
+  UpdateThermalHeadroom();
+
+  if (gpuFrameTime > 0) {
+    mGpuFrameTime = gpuFrameTime;
+  }
+  const uint64_t frameTime = std::max(mGpuFrameTime, cpuFrameTime);
+  if (frameTime > 0 && targetFrameTime > 0) {
+    const float load = static_cast<float>(frameTime) / static_cast<float>(targetFrameTime);
+    if (load > DYNRES_HIGH_LOAD) {
+      ++mOverBudgetFrames;
+      mUnderBudgetFrames = 0;
+    } else if (load < DYNRES_LOW_LOAD) {
+      ++mUnderBudgetFrames;
+      mOverBudgetFrames = 0;
+    } else {
+      mOverBudgetFrames = 0;
+      mUnderBudgetFrames = 0;
+    }
+
+    // Drop quickly to recover from missed frames, rise slowly so a brief lull
+    // doesn't bounce straight back over budget
+    if (mOverBudgetFrames >= DYNRES_DOWNSCALE_FRAMES) {
+      mScale -= DYNRES_SCALE_STEP;
+      mOverBudgetFrames = 0;
+    } else if (mUnderBudgetFrames >= DYNRES_UPSCALE_FRAMES) {
+      mScale += DYNRES_SCALE_STEP;
+      mUnderBudgetFrames = 0;
+    }
+  }
+
+  mScale = std::min(mMaxScale, std::max(DYNRES_MIN_SCALE, mScale));
+  return mScale;
+}
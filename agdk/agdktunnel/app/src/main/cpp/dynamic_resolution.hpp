@@ -0,0 +1,60 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef agdktunnel_dynamic_resolution_hpp
+#define agdktunnel_dynamic_resolution_hpp
+
+#include <android/thermal.h>
+#include <chrono>
+#include <cstdint>
+
+// Picks the resolution scale of the 3D scene each frame. The scale drops when
+// the frame takes longer than the frame budget (the swap interval) and rises when
+// there is room to spare, with hysteresis so it doesn't oscillate. The thermal
+// headroom lowers the maximum scale as the device approaches throttling.
+class DynamicResolution {
+ public:
+  DynamicResolution();
+  ~DynamicResolution();
+
+  // Feed the GPU and CPU time of the last frame and the target frame time, all in
+  // nanoseconds, and pick the scale to render the next frame at. GPU times resolve
+  // with some latency, a GPU time of 0 reuses the last one measured. Returns the
+  // new scale.
+  float Update(const uint64_t gpuFrameTime, const uint64_t cpuFrameTime,
+               const uint64_t targetFrameTime);
+
+  // Current scale, in the range [DYNRES_MIN_SCALE, DYNRES_MAX_SCALE]
+  float GetScale() const { return mScale; }
+
+  // Maximum scale allowed by the last queried thermal headroom
+  float GetMaxScale() const { return mMaxScale; }
+
+ private:
+  void UpdateThermalHeadroom();
+
+  AThermalManager *mThermalManager;
+  std::chrono::steady_clock::time_point mLastThermalQuery;
+  float mThermalHeadroom;
+  uint64_t mGpuFrameTime;
+  float mScale;
+  float mMaxScale;
+  int mOverBudgetFrames;
+  int mUnderBudgetFrames;
+};
+
+#endif // agdktunnel_dynamic_resolution_hpp
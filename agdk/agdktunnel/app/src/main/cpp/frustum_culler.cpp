@@ -0,0 +1,164 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "frustum_culler.hpp"
+
+#include <cmath>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#define FRUSTUM_CULLER_NEON
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#define FRUSTUM_CULLER_SSE
+#endif
+
+FrustumCuller::FrustumCuller() {
+  SetFrustum(glm::mat4(1.0f));
+}
+
+void FrustumCuller::SetFrustum(const glm::mat4 &worldToClip) {
+  // A point is inside when -w <= x, y, z <= w in clip space, each plane is the
+  // w row of the matrix plus or minus the x, y or z row (glm is column major)
+  const glm::vec4 rowX(worldToClip[0][0], worldToClip[1][0], worldToClip[2][0], worldToClip[3][0]);
+  const glm::vec4 rowY(worldToClip[0][1], worldToClip[1][1], worldToClip[2][1], worldToClip[3][1]);
+  const glm::vec4 rowZ(worldToClip[0][2], worldToClip[1][2], worldToClip[2][2], worldToClip[3][2]);
+  const glm::vec4 rowW(worldToClip[0][3], worldToClip[1][3], worldToClip[2][3], worldToClip[3][3]);
+  const glm::vec4 planes[kPlaneCount] = {
+      rowW + rowX, rowW - rowX,
+      rowW + rowY, rowW - rowY,
+      rowW + rowZ, rowW - rowZ
+  };
+  for (int i = 0; i < kPlaneCount; ++i) {
+    mPlaneX[i] = planes[i].x;
+    mPlaneY[i] = planes[i].y;
+    mPlaneZ[i] = planes[i].z;
+    mPlaneW[i] = planes[i].w;
+    mAbsPlaneX[i] = fabsf(planes[i].x);
+    mAbsPlaneY[i] = fabsf(planes[i].y);
+    mAbsPlaneZ[i] = fabsf(planes[i].z);
+  }
+}
+
+void FrustumCuller::Clear() {
+  mCenterX.clear();
+  mCenterY.clear();
+  mCenterZ.clear();
+  mExtentX.clear();
+  mExtentY.clear();
+  mExtentZ.clear();
+}
+
+uint32_t FrustumCuller::AddBox(const glm::vec3 &center, const glm::vec3 &halfExtents) {
+  mCenterX.push_back(center.x);
+  mCenterY.push_back(center.y);
+  mCenterZ.push_back(center.z);
+  mExtentX.push_back(halfExtents.x);
+  mExtentY.push_back(halfExtents.y);
+  mExtentZ.push_back(halfExtents.z);
+  return GetBoxCount() - 1;
+}
+
+// A box is outside when the corner furthest along a plane normal, the center
+// plus the extents projected on the normal, is behind the plane
+bool FrustumCuller::IsBoxVisible(const uint32_t index) const {
+  for (int i = 0; i < kPlaneCount; ++i) {
+    const float distance = mPlaneW[i] + mCenterX[index] * mPlaneX[i] +
+                           mCenterY[index] * mPlaneY[i] + mCenterZ[index] * mPlaneZ[i] +
+                           mExtentX[index] * mAbsPlaneX[i] + mExtentY[index] * mAbsPlaneY[i] +
+                           mExtentZ[index] * mAbsPlaneZ[i];
+    if (distance < 0.0f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void FrustumCuller::Cull(std::vector<uint32_t> &visible) const {
+  visible.clear();
+  const uint32_t boxCount = GetBoxCount();
+  uint32_t index = 0;
+
+#if defined(FRUSTUM_CULLER_NEON) || defined(FRUSTUM_CULLER_SSE)
+  uint32_t inside[4];
+  for (; index + 4 <= boxCount; index += 4) {
+#if defined(FRUSTUM_CULLER_NEON)
+    const float32x4_t centerX = vld1q_f32(&mCenterX[index]);
+    const float32x4_t centerY = vld1q_f32(&mCenterY[index]);
+    const float32x4_t centerZ = vld1q_f32(&mCenterZ[index]);
+    const float32x4_t extentX = vld1q_f32(&mExtentX[index]);
+    const float32x4_t extentY = vld1q_f32(&mExtentY[index]);
+    const float32x4_t extentZ = vld1q_f32(&mExtentZ[index]);
+    uint32x4_t mask = vdupq_n_u32(0xFFFFFFFF);
+    for (int i = 0; i < kPlaneCount; ++i) {
+      float32x4_t distance = vdupq_n_f32(mPlaneW[i]);
+      distance = vmlaq_n_f32(distance, centerX, mPlaneX[i]);
+      distance = vmlaq_n_f32(distance, centerY, mPlaneY[i]);
+      distance = vmlaq_n_f32(distance, centerZ, mPlaneZ[i]);
+      distance = vmlaq_n_f32(distance, extentX, mAbsPlaneX[i]);
+      distance = vmlaq_n_f32(distance, extentY, mAbsPlaneY[i]);
+      distance = vmlaq_n_f32(distance, extentZ, mAbsPlaneZ[i]);
+      mask = vandq_u32(mask, vcgeq_f32(distance, vdupq_n_f32(0.0f)));
+    }
+    vst1q_u32(inside, mask);
+#else
+    const __m128 centerX = _mm_loadu_ps(&mCenterX[index]);
+    const __m128 centerY = _mm_loadu_ps(&mCenterY[index]);
+    const __m128 centerZ = _mm_loadu_ps(&mCenterZ[index]);
+    const __m128 extentX = _mm_loadu_ps(&mExtentX[index]);
+    const __m128 extentY = _mm_loadu_ps(&mExtentY[index]);
+    const __m128 extentZ = _mm_loadu_ps(&mExtentZ[index]);
+    __m128 mask = _mm_cmpeq_ps(centerX, centerX);
+    for (int i = 0; i < kPlaneCount; ++i) {
+      __m128 distance = _mm_set1_ps(mPlaneW[i]);
+      distance = _mm_add_ps(distance, _mm_mul_ps(centerX, _mm_set1_ps(mPlaneX[i])));
+      distance = _mm_add_ps(distance, _mm_mul_ps(centerY, _mm_set1_ps(mPlaneY[i])));
+      distance = _mm_add_ps(distance, _mm_mul_ps(centerZ, _mm_set1_ps(mPlaneZ[i])));
+      distance = _mm_add_ps(distance, _mm_mul_ps(extentX, _mm_set1_ps(mAbsPlaneX[i])));
+      distance = _mm_add_ps(distance, _mm_mul_ps(extentY, _mm_set1_ps(mAbsPlaneY[i])));
+      distance = _mm_add_ps(distance, _mm_mul_ps(extentZ, _mm_set1_ps(mAbsPlaneZ[i])));
+      mask = _mm_and_ps(mask, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+    }
+    const int maskBits = _mm_movemask_ps(mask);
+    for (int lane = 0; lane < 4; ++lane) {
+      inside[lane] = (maskBits >> lane) & 1;
+    }
+#endif
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+      if (inside[lane] != 0) {
+        visible.push_back(index + lane);
+      }
+    }
+  }
+#endif
+
+  for (; index < boxCount; ++index) {
+    if (IsBoxVisible(index)) {
+      visible.push_back(index);
+    }
+  }
+}
+
+void FrustumCuller::CullScalar(std::vector<uint32_t> &visible) const {
+  visible.clear();
+  const uint32_t boxCount = GetBoxCount();
+  for (uint32_t index = 0; index < boxCount; ++index) {
+    if (IsBoxVisible(index)) {
+      visible.push_back(index);
+    }
+  }
+}
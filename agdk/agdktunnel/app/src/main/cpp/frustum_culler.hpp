@@ -0,0 +1,75 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef agdktunnel_frustum_culler_hpp
+#define agdktunnel_frustum_culler_hpp
+
+#include "glm/glm.hpp"
+#include <cstdint>
+#include <vector>
+
+// Tests axis aligned bounding boxes against the view frustum of a world to clip
+// space matrix. Boxes are stored as a structure of arrays so the plane tests
+// run on four boxes at a time with NEON or SSE, with a scalar path for the
+// remainder and for other architectures.
+class FrustumCuller {
+ public:
+  FrustumCuller();
+
+  // Derive the six frustum planes from a world to clip space matrix
+  void SetFrustum(const glm::mat4 &worldToClip);
+
+  // Remove all boxes
+  void Clear();
+
+  // Add a box to test, returns its index
+  uint32_t AddBox(const glm::vec3 &center, const glm::vec3 &halfExtents);
+
+  uint32_t GetBoxCount() const { return static_cast<uint32_t>(mCenterX.size()); }
+
+  // Replace the contents of visible with the indices of the boxes that intersect
+  // the frustum, in ascending order
+  void Cull(std::vector<uint32_t> &visible) const;
+
+  // Scalar reference implementation of Cull, testing one box at a time with the
+  // same operations in the same order
+  void CullScalar(std::vector<uint32_t> &visible) const;
+
+ private:
+  static constexpr int kPlaneCount = 6;
+
+  bool IsBoxVisible(const uint32_t index) const;
+
+  // Plane normals and distances, with the absolute values of the normals used to
+  // project the box extents onto them
+  float mPlaneX[kPlaneCount];
+  float mPlaneY[kPlaneCount];
+  float mPlaneZ[kPlaneCount];
+  float mPlaneW[kPlaneCount];
+  float mAbsPlaneX[kPlaneCount];
+  float mAbsPlaneY[kPlaneCount];
+  float mAbsPlaneZ[kPlaneCount];
+
+  std::vector<float> mCenterX;
+  std::vector<float> mCenterY;
+  std::vector<float> mCenterZ;
+  std::vector<float> mExtentX;
+  std::vector<float> mExtentY;
+  std::vector<float> mExtentZ;
+};
+
+#endif // agdktunnel_frustum_culler_hpp
@@ -22,12 +22,73 @@
 // #define GOD_MODE
 // #define TOUCH_INDICATOR_MODE
 // #define SWAPPY_OFF_MODE
+// Render through the null renderer backend (nothing is drawn on screen) and
+// periodically log the CPU cost and draw counts of frame submission
+// #define NULL_RENDERER_BENCHMARK_MODE
+// Show the renderer statistics of recent frames on the play scene HUD
+// #define RENDERER_STATS_OVERLAY_MODE
+// Render the 3D scene directly at display resolution instead of scaling it
+// with the frame time and thermal headroom
+// #define DYNAMIC_RESOLUTION_OFF_MODE
+// Record and render every frame on the game thread, instead of executing the
+// play scene frames on a separate render thread
+// #define RENDER_THREAD_OFF_MODE
+// Draw every tunnel section and obstacle box instead of only those inside the
+// view frustum
+// #define CULLING_OFF_MODE
+// Record every play scene session to REPLAY_FILE_NAME in internal storage
+// #define REPLAY_RECORD_MODE
+// Play back the recorded session in a loop, through the null renderer and without
+// waiting for the display, and log the CPU time and state checksum of every frame
+// to REPLAY_REPORT_FILE_NAME in internal storage
+// #define REPLAY_BENCHMARK_MODE
+// Request a save of the loaded checkpoint on every play scene frame and
+// periodically log the longest frame CPU time seen while the saves are written
+// #define SAVE_STRESS_MODE
+
+#if defined(NULL_RENDERER_BENCHMARK_MODE) || defined(REPLAY_BENCHMARK_MODE)
+#define NULL_RENDERER_MODE
+#endif
 
 // Render settings
 #define RENDER_FOV 45.0f
 #define RENDER_NEAR_CLIP 0.1f
 #define RENDER_FAR_CLIP 200.0f
 
+// Replay settings
+#define REPLAY_FILE_NAME "replay.bin"
+#define REPLAY_REPORT_FILE_NAME "replay_benchmark.csv"
+// frames replayed back to back for every frame presented to the display
+#define REPLAY_FRAMES_PER_PRESENT 32
+
+// Save settings
+// frames to track between save stress log lines
+#define SAVE_STRESS_FRAME_COUNT 300
+
+// Dynamic resolution settings, scales apply to each axis of the display resolution
+#define DYNRES_MIN_SCALE 0.5f
+#define DYNRES_MAX_SCALE 1.0f
+#define DYNRES_SCALE_STEP 0.05f
+// fraction of the frame budget above which the scale drops, and below which it rises
+#define DYNRES_HIGH_LOAD 0.9f
+#define DYNRES_LOW_LOAD 0.7f
+// consecutive frames over (or under) budget before the scale drops (or rises)
+#define DYNRES_DOWNSCALE_FRAMES 4
+#define DYNRES_UPSCALE_FRAMES 60
+// thermal headroom at which the maximum scale starts dropping, it reaches the
+// minimum scale at a headroom of 1.0 (severe throttling)
+#define DYNRES_THERMAL_HEADROOM_START 0.7f
+// how far ahead the thermal headroom is forecast, and how often it is queried
+#define DYNRES_THERMAL_FORECAST_SECONDS 2
+#define DYNRES_THERMAL_POLL_SECONDS 1.0f
+
+// Render thread settings
+// number of recorded frames that can wait to be rendered while the game thread
+// records the next one, bounds the input to display latency
+#define RENDER_THREAD_QUEUED_FRAMES 1
+// number of presented frames the latency statistics are calculated over
+#define RENDER_THREAD_LATENCY_FRAMES 60
+
 // Size of the tunnel
 #define TUNNEL_HALF_W 10.0f
 #define TUNNEL_HALF_H 10.0f
@@ -56,9 +117,12 @@
 // once a tunnel section is this far behind the player, delete it
 #define SHIFT_THRESH 20.0f
 
-// maximum delta T between two frames
+// maximum delta T between two frames, this also bounds the simulation steps per frame
 #define MAX_DELTA_T 0.05f
 
+// rate of the fixed simulation steps of the play scene, in steps per second
+#define SIM_TICK_RATE 60.0f
+
 // player's speed
 #define PLAYER_SPEED 80.0f
 
@@ -94,6 +158,13 @@
 #define MEMORY_POS_Y 0.80f
 #define MEMORY_FONT_SCALE 0.4f
 
+// settings for rendering renderer stats to the screen (x is a fraction of the aspect)
+#define RENDERER_STATS_POS_X 0.5f
+#define RENDERER_STATS_POS_Y 0.72f
+#define RENDERER_STATS_FONT_SCALE 0.3f
+// number of frames the renderer stats are averaged over
+#define RENDERER_STATS_FRAMES 60
+
 // scale of the signs that appear onscreen
 #define SIGN_FONT_SCALE 0.9f
 
@@ -127,6 +198,11 @@
 // roll speeds for each level (how fast the chamber turns)
 #define ROLL_SPEEDS { 0.0f, 0.1f, 0.0f, -0.1f, 0.0f, 0.2f, 0.0f, -0.2f }
 
+// tones mixed at the same time, and capacity of the queue of sound commands sent to
+// the audio thread (a power of two)
+#define SFX_MAX_VOICES 8
+#define SFX_COMMAND_RING_SIZE 64
+
 // recipes for synthesizing our very advanced sound effects:
 #define TONE_LEVEL_UP "d100 f500. f600. f700. f600. f700. f800."
 #define TONE_CRASHED "a100 d15 f0. a40 d75 f0. a30 f0. a20 f0. a70 d100 f400. a0. a70. a0. a70."
@@ -154,10 +230,6 @@
 // UI transition animation duration
 #define TRANSITION_DURATION 0.25f
 
-// for the purposes of testing for close calls with obstacles, by how much do we move
-// the player to test for collisions?
-#define CLOSE_CALL_CALC_DELTA (OBS_CELL_SIZE*0.2f)
-
 // menu item pulse animation settings
 #define MENUITEM_PULSE_AMOUNT 1.1f
 #define MENUITEM_PULSE_PERIOD 0.5f
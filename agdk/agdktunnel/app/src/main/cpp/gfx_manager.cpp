@@ -16,8 +16,13 @@
 
 #include "gfx_manager.hpp"
 #include "common.hpp"
+#include "game_consts.hpp"
+#include "render_thread.hpp"
 #include "tunnel_engine.hpp"
 #include "data/our_shader.inl"
+#include "data/tunnel_shader.inl"
+
+#include <algorithm>
 
 #define ARRAY_COUNTOF(array) (sizeof(array) / sizeof(array[0]))
 
@@ -30,6 +35,14 @@ static const char* kOur_SPIRV_Vertex = "shaders/our.vert.spv";
 static const char* kOur_SPIRV_Fragment = "shaders/our.frag.spv";
 static const char* kTrivial_SPIRV_Vertex = "shaders/trivial.vert.spv";
 static const char* kTrivial_SPIRV_Fragment = "shaders/trivial.frag.spv";
+static const char* kTunnel_SPIRV_Vertex = "shaders/tunnel.vert.spv";
+static const char* kTunnel_SPIRV_Fragment = "shaders/tunnel.frag.spv";
+
+// Feature keywords of the 'our' shader, in OurShaderFeatures bit order
+static const char* kOurFeatureKeywords[] = {
+    "FEATURE_POINT_LIGHT",
+    "FEATURE_FOG"
+};
 
 // Static utility functions
 static const char* GetOurVertShaderSourceGLES() {
@@ -40,12 +53,23 @@ static const char* GetOurFragShaderSourceGLES() {
   return OUR_FRAG_SHADER_SOURCE;
 }
 
+static const char* GetTunnelVertShaderSourceGLES() {
+  return TUNNEL_VERTEX_SHADER_SOURCE;
+}
+
+static const char* GetTunnelFragShaderSourceGLES() {
+  return TUNNEL_FRAG_SHADER_SOURCE;
+}
+
 static const char *GetTrivialVertShaderSourceGLES() {
-  return "uniform mat4 u_MVP;            \n"
-         "uniform vec4 u_Tint;           \n"
-         "attribute vec4 a_Position;     \n"
-         "attribute vec4 a_Color;        \n"
-         "varying vec4 v_Color;          \n"
+  return "#version 300 es                \n"
+         "layout(std140) uniform BasicUniforms { \n"
+         "   mat4 u_MVP;                 \n"
+         "   vec4 u_Tint;                \n"
+         "};                             \n"
+         "in vec4 a_Position;            \n"
+         "in vec4 a_Color;               \n"
+         "out vec4 v_Color;              \n"
          "void main()                    \n"
          "{                              \n"
          "   v_Color = a_Color * u_Tint; \n"
@@ -55,11 +79,13 @@ static const char *GetTrivialVertShaderSourceGLES() {
 }
 
 static const char *GetTrivialFragShaderSourceGLES() {
-  return "precision mediump float;       \n"
-         "varying vec4 v_Color;          \n"
+  return "#version 300 es                \n"
+         "precision mediump float;       \n"
+         "in vec4 v_Color;               \n"
+         "out vec4 o_FragColor;          \n"
          "void main()                    \n"
          "{                              \n"
-         "   gl_FragColor = v_Color;     \n"
+         "   o_FragColor = v_Color;      \n"
          "}";
 }
 
@@ -83,6 +109,7 @@ static constexpr UniformBuffer::UniformBufferElement basic_uniform_elements[] =
 };
 static constexpr size_t kBasicUniformSize = 64 + 16;
 static constexpr uint32_t kBasicUniformOffset = 0;
+static const char* kBasicUniformBlockName = "BasicUniforms";
 
 static constexpr UniformBuffer::UniformBufferElement our_uniform_elements[] = {
     { UniformBuffer::kBufferElement_Matrix44, UniformBuffer::kElementStageVertexFlag,
@@ -101,8 +128,34 @@ static constexpr uint32_t kOurUniformVertexOffset = 0;
 static constexpr uint32_t kOurUniformVertexSize = 64 + 16;
 static constexpr uint32_t kOurUniformFragmentOffset = 64 + 16;
 static constexpr uint32_t kOurUniformFragmentSize = 16 + 16;
+static const char* kOurUniformBlockName = "OurUniforms";
+
+// Only the vertex shader reads the tunnel uniforms, it passes the light color of
+// each section to the fragment shader
+static constexpr UniformBuffer::UniformBufferElement tunnel_uniform_elements[] = {
+    { UniformBuffer::kBufferElement_Matrix44, UniformBuffer::kElementStageVertexFlag,
+      0, 0, "u_MVP" },
+    { UniformBuffer::kBufferElement_Float4, UniformBuffer::kElementStageVertexFlag,
+      0, 1, "u_SectionOffset" },
+    { UniformBuffer::kBufferElement_Float4, UniformBuffer::kElementStageVertexFlag,
+      0, 2, "u_SectionLights" },
+    { UniformBuffer::kBufferElement_Float4, UniformBuffer::kElementStageVertexFlag,
+      0, 3, "u_SectionLights" }
+};
+static constexpr size_t kTunnelUniformSize = 64 + 16 + 16 + 16;
+static constexpr uint32_t kTunnelUniformVertexOffset = 0;
+static const char* kTunnelUniformBlockName = "TunnelUniforms";
+
+static const float kUpscaleTint[4] = {1.0f, 1.0f, 1.0f, 1.0f};
 
 GfxManager::GfxManager(bool useVulkan, const int32_t width, const int32_t height) {
+  mUpscaleGeom = NULL;
+  mOurShaderVariants = NULL;
+  mDisplayWidth = width;
+  mDisplayHeight = height;
+  mSceneAreaWidth = 0;
+  mSceneAreaHeight = 0;
+  mScenePassActive = false;
   CreateRenderResources(useVulkan, width, height);
 }
 
@@ -114,7 +167,11 @@ void GfxManager::CreateRenderResources(bool useVulkan, const int32_t width, cons
   CreateRenderPasses();
   CreateShaderPrograms(useVulkan);
   CreateUniformBuffers();
-  CreateRenderStates(width, height);
+  CreateRenderStates(mMainRenderPass, mRenderStates, width, height);
+#ifndef DYNAMIC_RESOLUTION_OFF_MODE
+  CreateSceneResources(width, height);
+  CreateUpscaleGeom();
+#endif
 }
 
 void GfxManager::CreateShaderPrograms(bool useVulkan) {
@@ -122,7 +179,8 @@ void GfxManager::CreateShaderPrograms(bool useVulkan) {
   if (useVulkan) {
     ShaderProgram::ShaderProgramCreationParams trivialShaderParams = {
         0, 0,
-        0, 0};
+        0, 0,
+        nullptr, 0, 0};
     LoadSPIRVAsset(kTrivial_SPIRV_Vertex,
                    &trivialShaderParams.vertex_shader_data,
                    &trivialShaderParams.vertex_data_byte_count);
@@ -135,29 +193,55 @@ void GfxManager::CreateShaderPrograms(bool useVulkan) {
 
     ShaderProgram::ShaderProgramCreationParams ourShaderParams = {
         0, 0,
-        0, 0};
+        0, 0,
+        nullptr, 0, 0};
     LoadSPIRVAsset(kOur_SPIRV_Vertex,
                    &ourShaderParams.vertex_shader_data,
                    &ourShaderParams.vertex_data_byte_count);
     LoadSPIRVAsset(kOur_SPIRV_Fragment,
                    &ourShaderParams.fragment_shader_data,
                    &ourShaderParams.fragment_data_byte_count);
-    mOurShaderProgram = renderer.CreateShaderProgram(ourShaderParams);
+    mOurShaderVariants = new ShaderVariantCache(ourShaderParams, kOurFeatureKeywords,
+                                                ARRAY_COUNTOF(kOurFeatureKeywords));
     free(ourShaderParams.vertex_shader_data);
     free(ourShaderParams.fragment_shader_data);
+
+    ShaderProgram::ShaderProgramCreationParams tunnelShaderParams = {
+        0, 0,
+        0, 0,
+        nullptr, 0, 0};
+    LoadSPIRVAsset(kTunnel_SPIRV_Vertex,
+                   &tunnelShaderParams.vertex_shader_data,
+                   &tunnelShaderParams.vertex_data_byte_count);
+    LoadSPIRVAsset(kTunnel_SPIRV_Fragment,
+                   &tunnelShaderParams.fragment_shader_data,
+                   &tunnelShaderParams.fragment_data_byte_count);
+    mTunnelShaderProgram = renderer.CreateShaderProgram(tunnelShaderParams);
+    free(tunnelShaderParams.vertex_shader_data);
+    free(tunnelShaderParams.fragment_shader_data);
   } else {
     ShaderProgram::ShaderProgramCreationParams trivialShaderParams = {
         (void*) GetTrivialFragShaderSourceGLES(),
         (void*) GetTrivialVertShaderSourceGLES(),
         strlen(GetTrivialFragShaderSourceGLES()),
-        strlen(GetTrivialVertShaderSourceGLES())};
+        strlen(GetTrivialVertShaderSourceGLES()),
+        nullptr, 0, 0};
     mTrivialShaderProgram = renderer.CreateShaderProgram(trivialShaderParams);
     ShaderProgram::ShaderProgramCreationParams ourShaderParams = {
         (void*)GetOurFragShaderSourceGLES(),
         (void*)GetOurVertShaderSourceGLES(),
         strlen(GetOurFragShaderSourceGLES()),
-        strlen(GetOurVertShaderSourceGLES())};
-    mOurShaderProgram = renderer.CreateShaderProgram(ourShaderParams);
+        strlen(GetOurVertShaderSourceGLES()),
+        nullptr, 0, 0};
+    mOurShaderVariants = new ShaderVariantCache(ourShaderParams, kOurFeatureKeywords,
+                                                ARRAY_COUNTOF(kOurFeatureKeywords));
+    ShaderProgram::ShaderProgramCreationParams tunnelShaderParams = {
+        (void*)GetTunnelFragShaderSourceGLES(),
+        (void*)GetTunnelVertShaderSourceGLES(),
+        strlen(GetTunnelFragShaderSourceGLES()),
+        strlen(GetTunnelVertShaderSourceGLES()),
+        nullptr, 0, 0};
+    mTunnelShaderProgram = renderer.CreateShaderProgram(tunnelShaderParams);
   }
 }
 
@@ -179,7 +263,9 @@ void GfxManager::CreateRenderPasses() {
   mMainRenderPass = renderer.CreateRenderPass(mainRenderPassParams);
 }
 
-void GfxManager::CreateRenderStates(const int32_t width, const int32_t height) {
+void GfxManager::CreateRenderStates(const std::shared_ptr<RenderPass> &renderPass,
+                                    std::shared_ptr<RenderState> *renderStates,
+                                    const int32_t width, const int32_t height) {
   Renderer& renderer = Renderer::GetInstance();
 
   const base_game_framework::GraphicsAPIFeatures& api_features =
@@ -192,7 +278,7 @@ void GfxManager::CreateRenderStates(const int32_t width, const int32_t height) {
   RenderState::RenderStateCreationParams basicStateParams {
       {0, 0, width, height},
       {0, 0, width, height, 0.0f, 1.0f},
-      mMainRenderPass,
+      renderPass,
       mTrivialShaderProgram,
       mUniformBuffers[kGfxType_BasicLines],
       VertexBuffer::kVertexFormat_P3C4,
@@ -203,31 +289,31 @@ void GfxManager::CreateRenderStates(const int32_t width, const int32_t height) {
       RenderState::kLineList,
       NORMAL_LINE_WIDTH, false, false, true, true, false
   };
-  mRenderStates[kGfxType_BasicLines] = renderer.CreateRenderState(basicStateParams);
+  renderStates[kGfxType_BasicLines] = renderer.CreateRenderState(basicStateParams);
 
   basicStateParams.depth_test = false;
   basicStateParams.state_uniform = mUniformBuffers[kGfxType_BasicLinesNoDepthTest];
-  mRenderStates[kGfxType_BasicLinesNoDepthTest] = renderer.CreateRenderState(basicStateParams);
+  renderStates[kGfxType_BasicLinesNoDepthTest] = renderer.CreateRenderState(basicStateParams);
 
   basicStateParams.line_width = text_line_width;
   basicStateParams.state_uniform = mUniformBuffers[kGfxType_BasicThickLinesNoDepthTest];
-  mRenderStates[kGfxType_BasicThickLinesNoDepthTest] = renderer.CreateRenderState(basicStateParams);
+  renderStates[kGfxType_BasicThickLinesNoDepthTest] = renderer.CreateRenderState(basicStateParams);
 
   basicStateParams.line_width = NORMAL_LINE_WIDTH;
   basicStateParams.primitive_type = RenderState::kTriangleList;
   basicStateParams.depth_test = true;
   basicStateParams.state_uniform = mUniformBuffers[kGfxType_BasicTris];
-  mRenderStates[kGfxType_BasicTris] = renderer.CreateRenderState(basicStateParams);
+  renderStates[kGfxType_BasicTris] = renderer.CreateRenderState(basicStateParams);
 
   basicStateParams.depth_test = false;
   basicStateParams.state_uniform = mUniformBuffers[kGfxType_BasicTrisNoDepthTest];
-  mRenderStates[kGfxType_BasicTrisNoDepthTest] = renderer.CreateRenderState(basicStateParams);
+  renderStates[kGfxType_BasicTrisNoDepthTest] = renderer.CreateRenderState(basicStateParams);
 
   RenderState::RenderStateCreationParams our_state_params {
       {0, 0, width, height},
       {0, 0, width, height, 0.0f, 1.0f},
-      mMainRenderPass,
-      mOurShaderProgram,
+      renderPass,
+      mOurShaderVariants->GetVariant(kOurFeature_PointLight | kOurFeature_Fog),
       mUniformBuffers[kGfxType_OurTris],
       VertexBuffer::kVertexFormat_P3T2C4,
       RenderState::kBlendOne, RenderState::kBlendZero,
@@ -237,11 +323,18 @@ void GfxManager::CreateRenderStates(const int32_t width, const int32_t height) {
       RenderState::kTriangleList,
       NORMAL_LINE_WIDTH, false, false, true, true, false
   };
-  mRenderStates[kGfxType_OurTris] = renderer.CreateRenderState(our_state_params);
+  renderStates[kGfxType_OurTris] = renderer.CreateRenderState(our_state_params);
 
+  // The no depth test state only draws the scene upscale, which is unlit and unfogged
   our_state_params.depth_test = false;
+  our_state_params.state_program = mOurShaderVariants->GetVariant(0);
   our_state_params.state_uniform = mUniformBuffers[kGfxType_OurTrisNoDepthTest];
-  mRenderStates[kGfxType_OurTrisNoDepthTest] = renderer.CreateRenderState(our_state_params);
+  renderStates[kGfxType_OurTrisNoDepthTest] = renderer.CreateRenderState(our_state_params);
+
+  our_state_params.depth_test = true;
+  our_state_params.state_program = mTunnelShaderProgram;
+  our_state_params.state_uniform = mUniformBuffers[kGfxType_TunnelTris];
+  renderStates[kGfxType_TunnelTris] = renderer.CreateRenderState(our_state_params);
 }
 
 void GfxManager::CreateUniformBuffers() {
@@ -250,10 +343,11 @@ void GfxManager::CreateUniformBuffers() {
   UniformBuffer::UniformBufferCreationParams basicUniformParams = {
       basic_uniform_elements, ARRAY_COUNTOF(basic_uniform_elements),
       (UniformBuffer::kBufferFlag_UpdateDynamicPerDraw |
-          UniformBuffer::kBufferFlag_UsePushConstants),
+          UniformBuffer::kBufferFlag_UseUniformRing),
       {kBasicUniformOffset, kBasicUniformSize,
        UniformBuffer::kUnusedStageRange, UniformBuffer::kUnusedStageRange},
-      kBasicUniformSize
+      kBasicUniformSize,
+      kBasicUniformBlockName
   };
   // Separate buffer object for each render type, but they share the same layout
   mUniformBuffers[kGfxType_BasicLines] = renderer.CreateUniformBuffer(basicUniformParams);
@@ -267,16 +361,126 @@ void GfxManager::CreateUniformBuffers() {
   UniformBuffer::UniformBufferCreationParams ourUniformParams = {
       our_uniform_elements, ARRAY_COUNTOF(our_uniform_elements),
       (UniformBuffer::kBufferFlag_UpdateDynamicPerDraw |
-                  UniformBuffer::kBufferFlag_UsePushConstants),
+                  UniformBuffer::kBufferFlag_UseUniformRing),
       {kOurUniformVertexOffset, kOurUniformVertexSize,
        kOurUniformFragmentOffset, kOurUniformFragmentSize},
-      kOurUniformSize
+      kOurUniformSize,
+      kOurUniformBlockName
   };
   mUniformBuffers[kGfxType_OurTris] = renderer.CreateUniformBuffer(ourUniformParams);
   mUniformBuffers[kGfxType_OurTrisNoDepthTest] = renderer.CreateUniformBuffer(ourUniformParams);
+
+  UniformBuffer::UniformBufferCreationParams tunnelUniformParams = {
+      tunnel_uniform_elements, ARRAY_COUNTOF(tunnel_uniform_elements),
+      (UniformBuffer::kBufferFlag_UpdateDynamicPerDraw |
+                  UniformBuffer::kBufferFlag_UseUniformRing),
+      {kTunnelUniformVertexOffset, kTunnelUniformSize,
+       UniformBuffer::kUnusedStageRange, UniformBuffer::kUnusedStageRange},
+      kTunnelUniformSize,
+      kTunnelUniformBlockName
+  };
+  mUniformBuffers[kGfxType_TunnelTris] = renderer.CreateUniformBuffer(tunnelUniformParams);
+}
+
+void GfxManager::CreateSceneResources(const int32_t width, const int32_t height) {
+  Renderer& renderer = Renderer::GetInstance();
+  Texture::RenderTargetCreationParams colorTargetParams = {
+      Texture::kTextureFormat_RGBA_8888,
+      Texture::kMinFilter_Linear,
+      Texture::kMagFilter_Linear,
+      static_cast<uint32_t>(width),
+      static_cast<uint32_t>(height),
+      1,
+      Texture::kRenderTarget_Sampled
+  };
+  mSceneColorTarget = renderer.CreateRenderTarget(colorTargetParams);
+  mSceneColorTarget->SetTextureDebugName("scene color");
+
+  // Depth is only needed while the pass is rendering, it can stay in tile memory
+  Texture::RenderTargetCreationParams depthTargetParams = colorTargetParams;
+  depthTargetParams.format = Texture::kTextureFormat_Depth24_Stencil8;
+  depthTargetParams.min_filter = Texture::kMinFilter_Nearest;
+  depthTargetParams.mag_filter = Texture::kMagFilter_Nearest;
+  depthTargetParams.flags = Texture::kRenderTarget_Transient;
+  mSceneDepthTarget = renderer.CreateRenderTarget(depthTargetParams);
+  mSceneDepthTarget->SetTextureDebugName("scene depth");
+
+  RenderPass::RenderPassCreationParams sceneRenderPassParams = {
+      RenderPass::kRenderPassColorLoad_Clear,
+      RenderPass::kRenderPassColorStore_Write,
+      RenderPass::kRenderPassDepthLoad_Clear,
+      RenderPass::kRenderPassDepthStore_DontCare,
+      RenderPass::kRenderPassStencilLoad_DontCare,
+      RenderPass::kRenderPassStencilStore_DontCare,
+      (RenderPass::kRenderPassAttachment_Color | RenderPass::kRenderPassAttachment_Depth),
+      { 0.0f, 0.0f, 0.0f, 1.0f },
+      1.0f,
+      0,
+      mSceneColorTarget,
+      mSceneDepthTarget,
+      nullptr
+  };
+  mSceneRenderPass = renderer.CreateRenderPass(sceneRenderPassParams);
+  mSceneRenderPass->SetRenderPassDebugName("scene");
+
+  CreateRenderStates(mSceneRenderPass, mSceneRenderStates, width, height);
+
+  // Force the render area to be applied to the new pass and render states by
+  // the next BeginScenePass
+  mSceneAreaWidth = 0;
+  mSceneAreaHeight = 0;
+}
+
+void GfxManager::CreateUpscaleGeom() {
+  // Unit quad covering the scene target, the upscale transform stretches the
+  // rendered area of the target over the display
+  GLfloat vertices[] = {
+      // x, y, z, r, g, b, a, u, v
+      0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f,
+      1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f,
+      1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+      0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f
+  };
+  GLushort indices[] = {0, 1, 2, 0, 2, 3};
+
+  IndexBuffer::IndexBufferCreationParams indexParams = {
+      indices, sizeof(indices)
+  };
+  VertexBuffer::VertexBufferCreationParams vertexParams = {
+      vertices, VertexBuffer::kVertexFormat_P3T2C4, sizeof(vertices)
+  };
+  Renderer& renderer = Renderer::GetInstance();
+  mUpscaleGeom = new SimpleGeom(renderer.CreateIndexBuffer(indexParams),
+                                renderer.CreateVertexBuffer(vertexParams));
+}
+
+void GfxManager::DestroySceneResources() {
+  Renderer& renderer = Renderer::GetInstance();
+  for (int32_t i = kGfxType_BasicLines; i < kGfxType_Count; ++i) {
+    if (mSceneRenderStates[i].get() != nullptr) {
+      renderer.DestroyRenderState(mSceneRenderStates[i]);
+      mSceneRenderStates[i] = nullptr;
+    }
+  }
+  if (mSceneRenderPass.get() != nullptr) {
+    renderer.DestroyRenderPass(mSceneRenderPass);
+    mSceneRenderPass = nullptr;
+  }
+  if (mSceneColorTarget.get() != nullptr) {
+    renderer.DestroyTexture(mSceneColorTarget);
+    mSceneColorTarget = nullptr;
+  }
+  if (mSceneDepthTarget.get() != nullptr) {
+    renderer.DestroyTexture(mSceneDepthTarget);
+    mSceneDepthTarget = nullptr;
+  }
 }
 
 void GfxManager::DestroyRenderResources() {
+  DestroySceneResources();
+  delete mUpscaleGeom;
+  mUpscaleGeom = NULL;
+
   Renderer& renderer = Renderer::GetInstance();
   for (int32_t i = kGfxType_BasicLines; i < kGfxType_Count; ++i) {
     renderer.DestroyRenderState(mRenderStates[i]);
@@ -286,21 +490,106 @@ void GfxManager::DestroyRenderResources() {
   }
   renderer.DestroyShaderProgram(mTrivialShaderProgram);
   mTrivialShaderProgram = nullptr;
-  renderer.DestroyShaderProgram(mOurShaderProgram);
-  mOurShaderProgram = nullptr;
+  renderer.DestroyShaderProgram(mTunnelShaderProgram);
+  mTunnelShaderProgram = nullptr;
+  mOurShaderVariants->DestroyVariants();
+  delete mOurShaderVariants;
+  mOurShaderVariants = NULL;
   renderer.DestroyRenderPass(mMainRenderPass);
   mMainRenderPass = nullptr;
 }
 
 void GfxManager::SetMainRenderPass() {
-  Renderer& renderer = Renderer::GetInstance();
-  renderer.SetRenderPass(mMainRenderPass);
+  CommandList& commands = RenderThread::GetInstance()->GetCommandList();
+  commands.SetRenderPass(mMainRenderPass);
+}
+
+void GfxManager::BeginScenePass() {
+#ifdef DYNAMIC_RESOLUTION_OFF_MODE
+  SetMainRenderPass();
+  RenderThread::GetInstance()->GetCommandList().AddStat(RendererStats::kStat_SceneScale, 1000);
+#else
+  // Pick the scale from the timings of the last frame against the frame budget
+  RenderThread *renderThread = RenderThread::GetInstance();
+  TunnelEngine *engine = TunnelEngine::GetInstance();
+  uint64_t gpuFrameTime;
+  {
+    std::lock_guard<std::mutex> statsLock(renderThread->GetStatsMutex());
+    gpuFrameTime = Renderer::GetInstance().GetStats().GetLastFrameStats().values[
+        RendererStats::kStat_GPUFrameTime];
+  }
+  const float scale = mDynamicResolution.Update(gpuFrameTime, engine->GetLastFrameCpuTime(),
+                                                engine->GetSwapInterval());
+  SetSceneRenderArea(scale);
+
+  CommandList& commands = renderThread->GetCommandList();
+  commands.AddStat(RendererStats::kStat_SceneScale, static_cast<uint32_t>(scale * 1000.0f + 0.5f));
+  commands.SetRenderPass(mSceneRenderPass);
+  mScenePassActive = true;
+#endif
+}
+
+void GfxManager::EndScenePass() {
+  if (!mScenePassActive) {
+    return;
+  }
+  mScenePassActive = false;
+  SetMainRenderPass();
+
+  // Map the rendered area of the scene target, [0, area / size] in texture
+  // coordinates, over the whole display
+  const float areaU = static_cast<float>(mSceneAreaWidth) / static_cast<float>(mDisplayWidth);
+  const float areaV = static_cast<float>(mSceneAreaHeight) / static_cast<float>(mDisplayHeight);
+  const glm::mat4 upscaleMat = glm::ortho(0.0f, areaU, 0.0f, areaV);
+
+  std::shared_ptr<UniformBuffer> ourBuffer = mUniformBuffers[kGfxType_OurTrisNoDepthTest];
+  CommandList& commands = RenderThread::GetInstance()->GetCommandList();
+  commands.SetBufferElementData(ourBuffer, kOurUniform_MVP, glm::value_ptr(upscaleMat),
+                                UniformBuffer::kElementSize_Matrix44);
+  commands.SetBufferElementData(ourBuffer, kOurUniform_Tint, kUpscaleTint,
+                                UniformBuffer::kElementSize_Float4);
+
+  SetRenderState(kGfxType_OurTrisNoDepthTest);
+  commands.BindIndexBuffer(mUpscaleGeom->index_buffer_);
+  commands.BindVertexBuffer(mUpscaleGeom->vertex_buffer_);
+  commands.BindTexture(mSceneColorTarget);
+  commands.DrawIndexed(mUpscaleGeom->index_buffer_->GetBufferElementCount(), 0);
+}
+
+float GfxManager::PackTunnelLightColor(const float red, const float green, const float blue) {
+  // Exact in a float, which holds integers up to 2^24
+  const float r = roundf(std::min(std::max(red, 0.0f), 1.0f) * 255.0f);
+  const float g = roundf(std::min(std::max(green, 0.0f), 1.0f) * 255.0f);
+  const float b = roundf(std::min(std::max(blue, 0.0f), 1.0f) * 255.0f);
+  return r + g * 256.0f + b * 65536.0f;
+}
+
+void GfxManager::SetSceneRenderArea(const float scale) {
+  const int32_t areaWidth = std::max(1, static_cast<int32_t>(mDisplayWidth * scale + 0.5f));
+  const int32_t areaHeight = std::max(1, static_cast<int32_t>(mDisplayHeight * scale + 0.5f));
+  if (areaWidth == mSceneAreaWidth && areaHeight == mSceneAreaHeight) {
+    return;
+  }
+  mSceneAreaWidth = areaWidth;
+  mSceneAreaHeight = areaHeight;
+
+  // Vulkan takes the viewport from the render pass, GLES from the render states.
+  // Recorded, as the render thread may still be rendering with the previous area
+  CommandList& commands = RenderThread::GetInstance()->GetCommandList();
+  commands.SetRenderArea(mSceneRenderPass, areaWidth, areaHeight);
+  RenderState::ScissorRect scissor_rect = {0, 0, areaWidth, areaHeight};
+  RenderState::Viewport viewport = {0, 0, areaWidth, areaHeight, 0.0f, 1.0f};
+  for (int32_t i = 0; i < kGfxType_Count; ++i) {
+    commands.SetScissorRect(mSceneRenderStates[i], scissor_rect);
+    commands.SetViewport(mSceneRenderStates[i], viewport);
+  }
 }
 
 void GfxManager::SetRenderState(GfxType gfxType) {
   if (gfxType < kGfxType_Count) {
-    Renderer &renderer = Renderer::GetInstance();
-    renderer.SetRenderState(mRenderStates[gfxType]);
+    CommandList& commands = RenderThread::GetInstance()->GetCommandList();
+    commands.SetRenderState(mScenePassActive ? mSceneRenderStates[gfxType] :
+                            mRenderStates[gfxType]);
   } else {
     MY_ASSERT(false);
   }
@@ -316,20 +605,20 @@ std::shared_ptr<simple_renderer::UniformBuffer> GfxManager::GetUniformBuffer(Gfx
 
 void GfxManager::RenderSimpleGeom(const GfxType gfxType, const float *mvpMat, SimpleGeom *sg) {
   MY_ASSERT(gfxType < kGfxType_Count);
-  simple_renderer::Renderer& renderer = simple_renderer::Renderer::GetInstance();
+  CommandList& commands = RenderThread::GetInstance()->GetCommandList();
   SetRenderState(gfxType);
 
-  mUniformBuffers[gfxType]->SetBufferElementData(kBasicUniform_MVP,
-                                       mvpMat, sizeof(float) * 16);
+  commands.SetBufferElementData(mUniformBuffers[gfxType], kBasicUniform_MVP,
+                                mvpMat, sizeof(float) * 16);
   const float tintData[4] = {1.0f, 1.0f, 1.0f, 1.0f};
-  mUniformBuffers[gfxType]->SetBufferElementData(kBasicUniform_Tint,
-                                       tintData, UniformBuffer::kElementSize_Float4);
-  renderer.BindVertexBuffer(sg->vertex_buffer_);
+  commands.SetBufferElementData(mUniformBuffers[gfxType], kBasicUniform_Tint,
+                                tintData, UniformBuffer::kElementSize_Float4);
+  commands.BindVertexBuffer(sg->vertex_buffer_);
   if (sg->index_buffer_.get() != NULL) {
-    renderer.BindIndexBuffer(sg->index_buffer_);
-    renderer.DrawIndexed(sg->index_buffer_->GetBufferElementCount(), 0);
+    commands.BindIndexBuffer(sg->index_buffer_);
+    commands.DrawIndexed(sg->index_buffer_->GetBufferElementCount(), 0);
   } else {
-    renderer.Draw(sg->vertex_buffer_->GetBufferElementCount(), 0);
+    commands.Draw(sg->vertex_buffer_->GetBufferElementCount(), 0);
   }
 }
 
@@ -341,4 +630,14 @@ void GfxManager::UpdateDisplaySize(const int32_t width, const int32_t height) {
     mRenderStates[i]->SetScissorRect(scissor_rect);
     mRenderStates[i]->SetViewport(viewport);
   }
+
+  // The scene targets match the display size, recreate them when it changes
+  if (width != mDisplayWidth || height != mDisplayHeight) {
+    mDisplayWidth = width;
+    mDisplayHeight = height;
+#ifndef DYNAMIC_RESOLUTION_OFF_MODE
+    DestroySceneResources();
+    CreateSceneResources(width, height);
+#endif
+  }
 }
\ No newline at end of file
@@ -17,8 +17,10 @@
 #ifndef agdktunnel_gfx_manager_hpp
 #define agdktunnel_gfx_manager_hpp
 
+#include "dynamic_resolution.hpp"
 #include "simplegeom.hpp"
 #include "simple_renderer/renderer_interface.h"
+#include "simple_renderer/renderer_shader_variant_cache.h"
 
 class GfxManager {
  public:
@@ -29,7 +31,8 @@ class GfxManager {
     kGfxType_BasicTris,             // Basic geometry, tris with colors (depth testing)
     kGfxType_BasicTrisNoDepthTest,  // kGfxType_BasicTris, but with depth testing disabled
     kGfxType_OurTris,               // Triangle rendering with 'our' shader (color/texture/lighting)
-    kGfxType_OurTrisNoDepthTest,    // OurTris, but no depth test
+    kGfxType_OurTrisNoDepthTest,    // OurTris, but no depth test, lighting or fog
+    kGfxType_TunnelTris,            // Tunnel sections, one instance per section
     kGfxType_Count
   };
 
@@ -45,11 +48,43 @@ class GfxManager {
     kOurUniform_Tint
   };
 
+  enum TunnelUniformElements : int32_t {
+    kTunnelUniform_MVP = 0,
+    kTunnelUniform_SectionOffset,
+    kTunnelUniform_SectionLights0,
+    kTunnelUniform_SectionLights1
+  };
+
+  // Maximum number of instances of a tunnel draw, limited by the packed light
+  // colors of the tunnel uniforms
+  static constexpr int kMaxTunnelSections = 8;
+
+  // Pack a point light color into a float of the tunnel section lights, with
+  // 8 bits per channel
+  static float PackTunnelLightColor(const float red, const float green, const float blue);
+
+  // Feature keywords of the 'our' shader, render states pick the shader variant
+  // with the features they use
+  enum OurShaderFeatures : uint32_t {
+    kOurFeature_PointLight = (1U << 0),
+    kOurFeature_Fog = (1U << 1)
+  };
+
   GfxManager(bool useVulkan, const int32_t width, const int32_t height);
   ~GfxManager();
 
   void SetMainRenderPass();
 
+  // Render the 3D scene into an offscreen target at the resolution scale picked by
+  // the dynamic resolution controller. Until EndScenePass, SetRenderState selects
+  // render states compatible with the scene pass. The scale is reported to the
+  // renderer statistics as kStat_SceneScale.
+  void BeginScenePass();
+
+  // Switch to the main render pass and upscale the scene into it, the UI and HUD
+  // are then rendered over it at display resolution
+  void EndScenePass();
+
   void SetRenderState(GfxType gfxType);
 
   std::shared_ptr<simple_renderer::UniformBuffer> GetUniformBuffer(GfxType gfxType);
@@ -62,14 +97,35 @@ class GfxManager {
   void CreateRenderResources(bool useVulkan, const int32_t width, const int32_t height);
   void CreateShaderPrograms(bool useVulkan);
   void CreateRenderPasses();
-  void CreateRenderStates(const int32_t width, const int32_t height);
+  void CreateRenderStates(const std::shared_ptr<simple_renderer::RenderPass> &renderPass,
+                          std::shared_ptr<simple_renderer::RenderState> *renderStates,
+                          const int32_t width, const int32_t height);
   void CreateUniformBuffers();
+  void CreateSceneResources(const int32_t width, const int32_t height);
+  void CreateUpscaleGeom();
+  void DestroySceneResources();
   void DestroyRenderResources();
+  void SetSceneRenderArea(const float scale);
 
   std::shared_ptr<simple_renderer::RenderPass> mMainRenderPass;
   std::shared_ptr<simple_renderer::RenderState> mRenderStates[kGfxType_Count];
+
+  // Offscreen targets the 3D scene renders to, sized to the display and
+  // rendered to a scaled area at their origin
+  std::shared_ptr<simple_renderer::Texture> mSceneColorTarget;
+  std::shared_ptr<simple_renderer::Texture> mSceneDepthTarget;
+  std::shared_ptr<simple_renderer::RenderPass> mSceneRenderPass;
+  std::shared_ptr<simple_renderer::RenderState> mSceneRenderStates[kGfxType_Count];
+  SimpleGeom *mUpscaleGeom;
+  DynamicResolution mDynamicResolution;
+  int32_t mDisplayWidth;
+  int32_t mDisplayHeight;
+  int32_t mSceneAreaWidth;
+  int32_t mSceneAreaHeight;
+  bool mScenePassActive;
   std::shared_ptr<simple_renderer::ShaderProgram> mTrivialShaderProgram;
-  std::shared_ptr<simple_renderer::ShaderProgram> mOurShaderProgram;
+  simple_renderer::ShaderVariantCache *mOurShaderVariants;
+  std::shared_ptr<simple_renderer::ShaderProgram> mTunnelShaderProgram;
   std::shared_ptr<simple_renderer::UniformBuffer> mUniformBuffers[kGfxType_Count];
 };
 #endif // agdktunnel_gfx_manager_hpp
@@ -0,0 +1,390 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "input_replay.hpp"
+#include "common.hpp"
+#include "game_consts.hpp"
+#include "scene_manager.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+// "ATRL" in the first four bytes of the file
+static constexpr uint32_t LOG_MAGIC = 0x4c525441;
+static constexpr uint32_t LOG_VERSION = 1;
+
+static InputReplay _inputReplay;
+
+InputReplay *InputReplay::GetInstance() {
+  return &_inputReplay;
+}
+
+InputReplay::InputReplay() :
+    mMode(MODE_OFF),
+    mReadOffset(0),
+    mSessionActive(false),
+    mDispatching(false),
+    mPlaybackFrame(false),
+    mPlaybackDone(false),
+    mSavedLevel(0),
+    mFrameCount(0),
+    mDivergedFrameCount(0) {
+}
+
+void InputReplay::Init(Mode mode, const std::string &directory) {
+  mMode = mode;
+  mLogPath = directory + "/" + REPLAY_FILE_NAME;
+  mReportPath = directory + "/" + REPLAY_REPORT_FILE_NAME;
+  mLog.clear();
+  if (mMode != MODE_PLAYBACK) {
+    return;
+  }
+
+  FILE *f = fopen(mLogPath.c_str(), "rb");
+  if (f) {
+    fseek(f, 0, SEEK_END);
+    const long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size > 0) {
+      mLog.resize(static_cast<size_t>(size));
+      if (fread(mLog.data(), 1, mLog.size(), f) != mLog.size()) {
+        mLog.clear();
+      }
+    }
+    fclose(f);
+  }
+
+  LogHeader header;
+  mReadOffset = 0;
+  if (!Read(&header, sizeof(header)) || header.magic != LOG_MAGIC ||
+      header.version != LOG_VERSION) {
+    ALOGE("InputReplay: no valid replay log at %s, playback disabled.", mLogPath.c_str());
+    mLog.clear();
+    mMode = MODE_OFF;
+    return;
+  }
+  mSavedLevel = header.savedLevel;
+  ALOGI("InputReplay: loaded replay log %s (%zu bytes).", mLogPath.c_str(), mLog.size());
+}
+
+void InputReplay::BeginSession(int savedLevel) {
+  if (mMode == MODE_OFF) {
+    return;
+  }
+  MY_ASSERT(!mSessionActive);
+
+  LogHeader header;
+  if (mMode == MODE_RECORD) {
+    header.magic = LOG_MAGIC;
+    header.version = LOG_VERSION;
+    header.randomState = GetRandomState();
+    header.savedLevel = savedLevel;
+    header.startTime = WallClock();
+    mLog.clear();
+    Append(&header, sizeof(header));
+  } else {
+    mReadOffset = 0;
+    Read(&header, sizeof(header));
+    SetRandomState(header.randomState);
+    mFrameStats.clear();
+  }
+  FreezeClock(header.startTime);
+
+  mSessionActive = true;
+  mPlaybackFrame = false;
+  mPlaybackDone = false;
+  mFrameCount = 0;
+  mDivergedFrameCount = 0;
+}
+
+void InputReplay::EndSession() {
+  if (!mSessionActive) {
+    return;
+  }
+  if (mMode == MODE_RECORD) {
+    SaveLog();
+  } else {
+    ReportBenchmark();
+  }
+  UnfreezeClock();
+  mSessionActive = false;
+}
+
+bool InputReplay::IsPlaybackDone() const {
+  return mMode == MODE_PLAYBACK && mSessionActive && mPlaybackDone;
+}
+
+void InputReplay::BeginFrame() {
+  if (!mSessionActive) {
+    return;
+  }
+
+  if (mMode == MODE_RECORD) {
+    const float time = WallClock();
+    FreezeClock(time);
+    Write(EVENT_FRAME);
+    Append(&time, sizeof(time));
+    ++mFrameCount;
+    return;
+  }
+
+  // dispatch the events received after the previous frame, up to this frame
+  mPlaybackFrame = false;
+  uint8_t type;
+  while (!mPlaybackDone && Read(&type, sizeof(type))) {
+    if (type == EVENT_FRAME) {
+      float time;
+      Read(&time, sizeof(time));
+      FreezeClock(time);
+      mPlaybackFrame = true;
+      ++mFrameCount;
+      return;
+    } else if (type == EVENT_CHECKSUM) {
+      // a frame of the recording that did not end, its checksum has nothing to compare to
+      uint32_t checksum;
+      Read(&checksum, sizeof(checksum));
+    } else {
+      DispatchEvent(static_cast<EventType>(type));
+    }
+  }
+  mPlaybackDone = true;
+}
+
+void InputReplay::EndFrame(uint32_t checksum) {
+  if (!mSessionActive) {
+    return;
+  }
+
+  if (mMode == MODE_RECORD) {
+    Write(EVENT_CHECKSUM);
+    Append(&checksum, sizeof(checksum));
+    return;
+  }
+
+  if (!mPlaybackFrame) {
+    return;
+  }
+  FrameStats stats = {0, checksum, 0};
+  uint8_t type;
+  const size_t offset = mReadOffset;
+  if (Read(&type, sizeof(type)) && type == EVENT_CHECKSUM) {
+    Read(&stats.recordedChecksum, sizeof(stats.recordedChecksum));
+    if (stats.recordedChecksum != checksum) {
+      if (mDivergedFrameCount == 0) {
+        ALOGE("InputReplay: frame %zu diverged from the recording (checksum %08x, "
+              "recorded %08x).", mFrameStats.size(), checksum, stats.recordedChecksum);
+      }
+      ++mDivergedFrameCount;
+    }
+  } else {
+    mReadOffset = offset;
+  }
+  mFrameStats.push_back(stats);
+}
+
+void InputReplay::ReportFrameTime(uint64_t frameTime) {
+  if (mMode == MODE_PLAYBACK && mSessionActive && mPlaybackFrame && !mFrameStats.empty()) {
+    mFrameStats.back().frameTime = frameTime;
+  }
+}
+
+bool InputReplay::FilterPointerEvent(EventType type, int pointerId,
+                                     const struct PointerCoords *coords) {
+  if (mMode == MODE_PLAYBACK) {
+    return mDispatching;
+  }
+  if (mMode == MODE_RECORD && mSessionActive) {
+    const uint8_t id = static_cast<uint8_t>(pointerId);
+    const uint8_t isScreen = coords->isScreen ? 1 : 0;
+    const float values[6] = {coords->x, coords->y, coords->minX, coords->minY,
+                             coords->maxX, coords->maxY};
+    Write(type);
+    Append(&id, sizeof(id));
+    Append(&isScreen, sizeof(isScreen));
+    Append(values, sizeof(values));
+  }
+  return true;
+}
+
+bool InputReplay::FilterKeyEvent(EventType type, int ourKeyCode) {
+  if (mMode == MODE_PLAYBACK) {
+    return mDispatching;
+  }
+  if (mMode == MODE_RECORD && mSessionActive) {
+    const uint8_t key = static_cast<uint8_t>(ourKeyCode);
+    Write(type);
+    Append(&key, sizeof(key));
+  }
+  return true;
+}
+
+bool InputReplay::FilterJoyEvent(float joyX, float joyY) {
+  if (mMode == MODE_PLAYBACK) {
+    return mDispatching;
+  }
+  if (mMode == MODE_RECORD && mSessionActive) {
+    Write(EVENT_JOY);
+    Append(&joyX, sizeof(joyX));
+    Append(&joyY, sizeof(joyY));
+  }
+  return true;
+}
+
+bool InputReplay::FilterEvent(EventType type) {
+  if (mMode == MODE_PLAYBACK) {
+    return mDispatching;
+  }
+  if (mMode == MODE_RECORD && mSessionActive) {
+    Write(type);
+    if (type == EVENT_PAUSE) {
+      // the app may be killed while paused, keep what was recorded so far
+      SaveLog();
+    }
+  }
+  return true;
+}
+
+void InputReplay::Write(EventType type) {
+  const uint8_t value = type;
+  Append(&value, sizeof(value));
+}
+
+void InputReplay::Append(const void *data, size_t size) {
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  mLog.insert(mLog.end(), bytes, bytes + size);
+}
+
+bool InputReplay::Read(void *data, size_t size) {
+  if (mReadOffset + size > mLog.size()) {
+    mReadOffset = mLog.size();
+    return false;
+  }
+  memcpy(data, mLog.data() + mReadOffset, size);
+  mReadOffset += size;
+  return true;
+}
+
+void InputReplay::DispatchEvent(EventType type) {
+  SceneManager *mgr = SceneManager::GetInstance();
+  mDispatching = true;
+  switch (type) {
+    case EVENT_POINTER_DOWN:
+    case EVENT_POINTER_UP:
+    case EVENT_POINTER_MOVE: {
+      uint8_t id, isScreen;
+      float values[6];
+      Read(&id, sizeof(id));
+      Read(&isScreen, sizeof(isScreen));
+      Read(values, sizeof(values));
+      PointerCoords coords;
+      coords.x = values[0];
+      coords.y = values[1];
+      coords.minX = values[2];
+      coords.minY = values[3];
+      coords.maxX = values[4];
+      coords.maxY = values[5];
+      coords.isScreen = isScreen != 0;
+      if (type == EVENT_POINTER_DOWN) {
+        mgr->OnPointerDown(id, &coords);
+      } else if (type == EVENT_POINTER_UP) {
+        mgr->OnPointerUp(id, &coords);
+      } else {
+        mgr->OnPointerMove(id, &coords);
+      }
+      break;
+    }
+    case EVENT_KEY_DOWN:
+    case EVENT_KEY_UP: {
+      uint8_t key;
+      Read(&key, sizeof(key));
+      if (type == EVENT_KEY_DOWN) {
+        mgr->OnKeyDown(key);
+      } else {
+        mgr->OnKeyUp(key);
+      }
+      break;
+    }
+    case EVENT_BACK_KEY:
+      mgr->OnBackKeyPressed();
+      break;
+    case EVENT_JOY: {
+      float joyX, joyY;
+      Read(&joyX, sizeof(joyX));
+      Read(&joyY, sizeof(joyY));
+      mgr->UpdateJoy(joyX, joyY);
+      break;
+    }
+    case EVENT_PAUSE:
+      mgr->OnPause();
+      break;
+    case EVENT_RESUME:
+      mgr->OnResume();
+      break;
+    default:
+      // the payload size is unknown, nothing after this event can be trusted
+      ALOGE("InputReplay: unknown event type %d in the replay log.", type);
+      mReadOffset = mLog.size();
+      break;
+  }
+  mDispatching = false;
+}
+
+void InputReplay::SaveLog() {
+  FILE *f = fopen(mLogPath.c_str(), "wb");
+  if (!f) {
+    ALOGE("InputReplay: error writing replay log %s.", mLogPath.c_str());
+    return;
+  }
+  fwrite(mLog.data(), 1, mLog.size(), f);
+  fclose(f);
+  ALOGI("InputReplay: saved %u frames (%zu bytes) to %s.", mFrameCount, mLog.size(),
+        mLogPath.c_str());
+}
+
+void InputReplay::ReportBenchmark() {
+  if (mFrameStats.empty()) {
+    return;
+  }
+
+  uint64_t totalTime = 0;
+  uint64_t maxTime = 0;
+  for (const FrameStats &stats : mFrameStats) {
+    totalTime += stats.frameTime;
+    maxTime = std::max(maxTime, stats.frameTime);
+  }
+  const size_t frameCount = mFrameStats.size();
+  ALOGI("InputReplay: played back %zu frames, cpu avg %.3f ms max %.3f ms, "
+        "final checksum %08x, %u frames diverged.", frameCount,
+        static_cast<double>(totalTime) / frameCount / 1000000.0,
+        static_cast<double>(maxTime) / 1000000.0, mFrameStats.back().checksum,
+        mDivergedFrameCount);
+
+  FILE *f = fopen(mReportPath.c_str(), "w");
+  if (!f) {
+    ALOGE("InputReplay: error writing benchmark report %s.", mReportPath.c_str());
+    return;
+  }
+  fprintf(f, "frame,cpu_ms,checksum,recorded_checksum\n");
+  for (size_t i = 0; i < frameCount; ++i) {
+    const FrameStats &stats = mFrameStats[i];
+    fprintf(f, "%zu,%.3f,%08x,%08x\n", i, static_cast<double>(stats.frameTime) / 1000000.0,
+            stats.checksum, stats.recordedChecksum);
+  }
+  fclose(f);
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef agdktunnel_input_replay_hpp
+#define agdktunnel_input_replay_hpp
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct PointerCoords;
+
+// Records play scene sessions into a compact binary log, and plays them back.
+//
+// A session starts when the play scene is installed. The log holds the state of the
+// random number generator at that point, then for each frame the time seen by the
+// game, a checksum of the simulation state at the end of the frame and the input
+// events delivered to the SceneManager before the next frame. While a session is
+// active the clock is frozen at the time of the current frame, so every reader of
+// Clock() sees the same values when the session is played back.
+//
+// During playback live input is ignored and the recorded events are dispatched to the
+// SceneManager at the start of each frame. The checksum of every frame is compared
+// against the recording, and the CPU time of each frame is kept to report a benchmark
+// (see REPLAY_BENCHMARK_MODE) when the session ends.
+class InputReplay {
+ public:
+  enum Mode {
+    MODE_OFF,
+    MODE_RECORD,
+    MODE_PLAYBACK
+  };
+
+  enum EventType : uint8_t {
+    EVENT_FRAME = 0,
+    EVENT_CHECKSUM,
+    EVENT_POINTER_DOWN,
+    EVENT_POINTER_UP,
+    EVENT_POINTER_MOVE,
+    EVENT_KEY_DOWN,
+    EVENT_KEY_UP,
+    EVENT_BACK_KEY,
+    EVENT_JOY,
+    EVENT_PAUSE,
+    EVENT_RESUME,
+    EVENT_TYPE_COUNT
+  };
+
+  // returns the (singleton) instance
+  static InputReplay *GetInstance();
+
+  InputReplay();
+
+  // Record sessions to, or play them back from, the log file in the given directory.
+  // Playback loads the whole log up front and falls back to MODE_OFF if it is missing.
+  void Init(Mode mode, const std::string &directory);
+
+  Mode GetMode() const { return mMode; }
+
+  // Start and end a session, called when the play scene is installed and uninstalled
+  void BeginSession(int savedLevel);
+  void EndSession();
+
+  bool IsSessionActive() const { return mSessionActive; }
+
+  // Checkpoint level the recorded session started from, when playing back
+  int GetSavedLevel() const { return mSavedLevel; }
+
+  // Returns true once every frame of the log has been played back
+  bool IsPlaybackDone() const;
+
+  // Called by the SceneManager around the frame of the current scene
+  void BeginFrame();
+  void EndFrame(uint32_t checksum);
+
+  // CPU time of recording and submitting the last frame, in nanoseconds
+  void ReportFrameTime(uint64_t frameTime);
+
+  // Input filters called by the SceneManager before delivering an event. They record
+  // the event, and return false if it must be dropped (live input during playback).
+  bool FilterPointerEvent(EventType type, int pointerId, const struct PointerCoords *coords);
+  bool FilterKeyEvent(EventType type, int ourKeyCode);
+  bool FilterJoyEvent(float joyX, float joyY);
+  bool FilterEvent(EventType type);
+
+ private:
+  struct LogHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t randomState;
+    int32_t savedLevel;
+    float startTime;
+  };
+
+  struct FrameStats {
+    uint64_t frameTime;
+    uint32_t checksum;
+    uint32_t recordedChecksum;
+  };
+
+  void Write(EventType type);
+  void Append(const void *data, size_t size);
+  bool Read(void *data, size_t size);
+  void DispatchEvent(EventType type);
+
+  void SaveLog();
+  void ReportBenchmark();
+
+  Mode mMode;
+  std::string mLogPath;
+  std::string mReportPath;
+
+  // the recorded log, or the log being played back
+  std::vector<uint8_t> mLog;
+  size_t mReadOffset;
+
+  bool mSessionActive;
+  // true while dispatching recorded events to the SceneManager
+  bool mDispatching;
+  // true if the current frame was read from the log, false once it is exhausted
+  bool mPlaybackFrame;
+  bool mPlaybackDone;
+  int mSavedLevel;
+  uint32_t mFrameCount;
+  uint32_t mDivergedFrameCount;
+
+  // per frame results of the session being played back
+  std::vector<FrameStats> mFrameStats;
+};
+
+#endif // agdktunnel_input_replay_hpp
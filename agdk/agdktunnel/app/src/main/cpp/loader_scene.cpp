@@ -197,19 +197,23 @@ void LoaderScene::DoFrame() {
         mTextureLoader->LoadTexturesFromAssetPack(GameAssetManifest::EXPANSION_ASSETPACK_NAME);
     }
 
+    SceneManager *mgr = SceneManager::GetInstance();
     if (mTextureLoader->NumberRemainingToLoad() == 0 &&
             mDataStateMachine->isLoadingDataCompleted()) {
-        mTextureLoader->CreateTextures();
-
-        timespec currentTimeSpec;
-        clock_gettime(CLOCK_MONOTONIC, &currentTimeSpec);
-        uint64_t currentTime = currentTimeSpec.tv_sec * 1000 + (currentTimeSpec.tv_nsec / 1000000);
-        uint64_t deltaTime = currentTime - mStartTime;
-        float loadTime = deltaTime;
-        loadTime /= 1000.0f;
-        ALOGI("Load complete in %.1f seconds", loadTime);
-        SceneManager *mgr = SceneManager::GetInstance();
-        mgr->RequestNewScene(new WelcomeScene());
+        // done once, this scene keeps running while the welcome scene is preloaded
+        if (!mgr->IsSceneRequested()) {
+            mTextureLoader->CreateTextures();
+
+            timespec currentTimeSpec;
+            clock_gettime(CLOCK_MONOTONIC, &currentTimeSpec);
+            uint64_t currentTime = currentTimeSpec.tv_sec * 1000 +
+                    (currentTimeSpec.tv_nsec / 1000000);
+            uint64_t deltaTime = currentTime - mStartTime;
+            float loadTime = deltaTime;
+            loadTime /= 1000.0f;
+            ALOGI("Load complete in %.1f seconds", loadTime);
+            mgr->RequestNewScene(new WelcomeScene());
+        }
     } else {
         float totalLoad = mTextureLoader->TotalNumberToLoad() + DATA_LOAD_DELTA *
                 mDataStateMachine->getTotalSteps();
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "mvp_batch.hpp"
+
+#include <cmath>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MVP_BATCH_NEON
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#define MVP_BATCH_SSE
+#endif
+
+namespace {
+
+// Scale factors of the viewProj columns making up each column of
+// translate * scale * rotateZ:
+//   column 0 = vp0 * (sx * c) + vp1 * (sy * s)
+//   column 1 = vp0 * (-sx * s) + vp1 * (sy * c)
+//   column 2 = vp2 * sz
+//   column 3 = vp0 * tx + vp1 * ty + vp2 * tz + vp3
+struct ModelFactors {
+  float m00, m01, m10, m11, m22;
+};
+
+inline ModelFactors GetModelFactors(const ModelTransform &transform) {
+  float c = 1.0f;
+  float s = 0.0f;
+  if (transform.rotationZ != 0.0f) {
+    c = cosf(transform.rotationZ);
+    s = sinf(transform.rotationZ);
+  }
+  const ModelFactors factors = {
+      transform.scale.x * c, transform.scale.y * s,
+      -transform.scale.x * s, transform.scale.y * c,
+      transform.scale.z
+  };
+  return factors;
+}
+
+} // namespace
+
+void BuildMVPsScalar(const glm::mat4 &viewProj, const ModelTransform *transforms,
+                     const uint32_t count, const glm::mat4 *local, glm::mat4 *outMvps) {
+  const float *vp = &viewProj[0][0];
+  for (uint32_t i = 0; i < count; ++i) {
+    const ModelTransform &transform = transforms[i];
+    const ModelFactors f = GetModelFactors(transform);
+    float mvp[16];
+    for (int row = 0; row < 4; ++row) {
+      mvp[row] = vp[row] * f.m00 + vp[4 + row] * f.m01;
+      mvp[4 + row] = vp[row] * f.m10 + vp[4 + row] * f.m11;
+      mvp[8 + row] = vp[8 + row] * f.m22;
+      mvp[12 + row] = ((vp[row] * transform.translation.x +
+                        vp[4 + row] * transform.translation.y) +
+                       vp[8 + row] * transform.translation.z) + vp[12 + row];
+    }
+
+    float *out = &outMvps[i][0][0];
+    if (local == nullptr) {
+      for (int j = 0; j < 16; ++j) {
+        out[j] = mvp[j];
+      }
+    } else {
+      const float *l = &(*local)[0][0];
+      for (int col = 0; col < 4; ++col) {
+        for (int row = 0; row < 4; ++row) {
+          out[col * 4 + row] = ((mvp[row] * l[col * 4] + mvp[4 + row] * l[col * 4 + 1]) +
+                                mvp[8 + row] * l[col * 4 + 2]) + mvp[12 + row] * l[col * 4 + 3];
+        }
+      }
+    }
+  }
+}
+
+#if defined(MVP_BATCH_NEON)
+
+void BuildMVPs(const glm::mat4 &viewProj, const ModelTransform *transforms,
+               const uint32_t count, const glm::mat4 *local, glm::mat4 *outMvps) {
+  const float32x4_t vp0 = vld1q_f32(&viewProj[0][0]);
+  const float32x4_t vp1 = vld1q_f32(&viewProj[1][0]);
+  const float32x4_t vp2 = vld1q_f32(&viewProj[2][0]);
+  const float32x4_t vp3 = vld1q_f32(&viewProj[3][0]);
+  for (uint32_t i = 0; i < count; ++i) {
+    const ModelTransform &transform = transforms[i];
+    const ModelFactors f = GetModelFactors(transform);
+    float32x4_t col[4];
+    col[0] = vaddq_f32(vmulq_n_f32(vp0, f.m00), vmulq_n_f32(vp1, f.m01));
+    col[1] = vaddq_f32(vmulq_n_f32(vp0, f.m10), vmulq_n_f32(vp1, f.m11));
+    col[2] = vmulq_n_f32(vp2, f.m22);
+    col[3] = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(vp0, transform.translation.x),
+                                           vmulq_n_f32(vp1, transform.translation.y)),
+                                 vmulq_n_f32(vp2, transform.translation.z)), vp3);
+
+    float *out = &outMvps[i][0][0];
+    if (local == nullptr) {
+      for (int j = 0; j < 4; ++j) {
+        vst1q_f32(out + j * 4, col[j]);
+      }
+    } else {
+      for (int j = 0; j < 4; ++j) {
+        const float *l = &(*local)[j][0];
+        vst1q_f32(out + j * 4,
+                  vaddq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(col[0], l[0]),
+                                                vmulq_n_f32(col[1], l[1])),
+                                      vmulq_n_f32(col[2], l[2])),
+                            vmulq_n_f32(col[3], l[3])));
+      }
+    }
+  }
+}
+
+#elif defined(MVP_BATCH_SSE)
+
+void BuildMVPs(const glm::mat4 &viewProj, const ModelTransform *transforms,
+               const uint32_t count, const glm::mat4 *local, glm::mat4 *outMvps) {
+  const __m128 vp0 = _mm_loadu_ps(&viewProj[0][0]);
+  const __m128 vp1 = _mm_loadu_ps(&viewProj[1][0]);
+  const __m128 vp2 = _mm_loadu_ps(&viewProj[2][0]);
+  const __m128 vp3 = _mm_loadu_ps(&viewProj[3][0]);
+  for (uint32_t i = 0; i < count; ++i) {
+    const ModelTransform &transform = transforms[i];
+    const ModelFactors f = GetModelFactors(transform);
+    __m128 col[4];
+    col[0] = _mm_add_ps(_mm_mul_ps(vp0, _mm_set1_ps(f.m00)),
+                        _mm_mul_ps(vp1, _mm_set1_ps(f.m01)));
+    col[1] = _mm_add_ps(_mm_mul_ps(vp0, _mm_set1_ps(f.m10)),
+                        _mm_mul_ps(vp1, _mm_set1_ps(f.m11)));
+    col[2] = _mm_mul_ps(vp2, _mm_set1_ps(f.m22));
+    col[3] = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                            _mm_mul_ps(vp0, _mm_set1_ps(transform.translation.x)),
+                            _mm_mul_ps(vp1, _mm_set1_ps(transform.translation.y))),
+                        _mm_mul_ps(vp2, _mm_set1_ps(transform.translation.z))), vp3);
+
+    float *out = &outMvps[i][0][0];
+    if (local == nullptr) {
+      for (int j = 0; j < 4; ++j) {
+        _mm_storeu_ps(out + j * 4, col[j]);
+      }
+    } else {
+      for (int j = 0; j < 4; ++j) {
+        const float *l = &(*local)[j][0];
+        _mm_storeu_ps(out + j * 4,
+                      _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(col[0], _mm_set1_ps(l[0])),
+                                                       _mm_mul_ps(col[1], _mm_set1_ps(l[1]))),
+                                            _mm_mul_ps(col[2], _mm_set1_ps(l[2]))),
+                                 _mm_mul_ps(col[3], _mm_set1_ps(l[3]))));
+      }
+    }
+  }
+}
+
+#else
+
+void BuildMVPs(const glm::mat4 &viewProj, const ModelTransform *transforms,
+               const uint32_t count, const glm::mat4 *local, glm::mat4 *outMvps) {
+  BuildMVPsScalar(viewProj, transforms, count, local, outMvps);
+}
+
+#endif
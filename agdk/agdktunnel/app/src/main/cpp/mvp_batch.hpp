@@ -0,0 +1,45 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef agdktunnel_mvp_batch_hpp
+#define agdktunnel_mvp_batch_hpp
+
+#include "glm/glm.hpp"
+#include <cstdint>
+
+// Model transform of a single object, applied as translate * scale * rotate
+// about the Z axis. This covers every object model matrix built by the scenes.
+struct ModelTransform {
+  glm::vec3 translation;
+  glm::vec3 scale;
+  float rotationZ; // radians
+};
+
+// Writes viewProj * translate * scale * rotateZ * local for count transforms
+// into the contiguous outMvps array. local is shared by all the objects and
+// may be nullptr for identity. Each column of a model matrix only has one to
+// three non-zero terms, so the product is built column by column from scaled
+// columns of viewProj, four rows at a time with NEON or SSE.
+void BuildMVPs(const glm::mat4 &viewProj, const ModelTransform *transforms,
+               const uint32_t count, const glm::mat4 *local, glm::mat4 *outMvps);
+
+// Scalar reference implementation of BuildMVPs, performing the same operations
+// in the same order
+void BuildMVPsScalar(const glm::mat4 &viewProj, const ModelTransform *transforms,
+                     const uint32_t count, const glm::mat4 *local, glm::mat4 *outMvps);
+
+#endif // agdktunnel_mvp_batch_hpp
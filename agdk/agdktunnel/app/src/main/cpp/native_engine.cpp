@@ -15,14 +15,21 @@
  */
 
 #include "common.hpp"
+#include "game_consts.hpp"
+#include "input_replay.hpp"
 #include "input_util.hpp"
 #include "scene_manager.hpp"
 #include "loader_scene.hpp"
 #include "native_engine.hpp"
+#include "render_thread.hpp"
 #include "welcome_scene.hpp"
 
 #include "android/platform_util_android.h"
 #include "simple_renderer/renderer_interface.h"
+#ifdef NULL_RENDERER_BENCHMARK_MODE
+#include "simple_renderer/renderer_null.h"
+#endif
+#include <chrono>
 
 using namespace base_game_framework;
 
@@ -36,7 +43,62 @@ using namespace base_game_framework;
 #endif
 
 // Set to true to force GLES always
+#ifdef NULL_RENDERER_MODE
+// The display still needs a swapchain to present, GLES presents without having rendered
+static bool s_disable_vulkan = true;
+#else
 static bool s_disable_vulkan = false;
+#endif
+
+#ifdef NULL_RENDERER_BENCHMARK_MODE
+// Number of frames to average over between benchmark log lines
+static constexpr uint32_t kBenchmarkFrameCount = 300;
+
+struct NullRendererBenchmark {
+    uint32_t frame_count = 0;
+    double frame_cpu_ms = 0.0;
+    double max_frame_cpu_ms = 0.0;
+    uint64_t draw_calls = 0;
+    uint64_t render_state_binds = 0;
+    uint64_t uniform_bytes = 0;
+    uint64_t triangles = 0;
+};
+
+static NullRendererBenchmark s_benchmark;
+
+static void UpdateNullRendererBenchmark(const double frame_cpu_ms) {
+    const simple_renderer::RendererNull::Counters& counters =
+        simple_renderer::RendererNull::GetInstanceNull().GetFrameCounters();
+    s_benchmark.frame_count++;
+    s_benchmark.frame_cpu_ms += frame_cpu_ms;
+    s_benchmark.max_frame_cpu_ms = std::max(s_benchmark.max_frame_cpu_ms, frame_cpu_ms);
+    s_benchmark.draw_calls += counters.draw_calls;
+    s_benchmark.render_state_binds += counters.render_state_binds;
+    s_benchmark.uniform_bytes += counters.uniform_bytes;
+    s_benchmark.triangles += counters.triangles;
+    if (s_benchmark.frame_count == kBenchmarkFrameCount) {
+        const double frames = static_cast<double>(s_benchmark.frame_count);
+        ALOGI("NullRendererBenchmark: cpu avg %.3f ms max %.3f ms, per frame: draws %.1f "
+              "state binds %.1f uniform bytes %.0f triangles %.0f",
+              s_benchmark.frame_cpu_ms / frames, s_benchmark.max_frame_cpu_ms,
+              s_benchmark.draw_calls / frames, s_benchmark.render_state_binds / frames,
+              s_benchmark.uniform_bytes / frames, s_benchmark.triangles / frames);
+        s_benchmark = NullRendererBenchmark();
+    }
+}
+#endif // NULL_RENDERER_BENCHMARK_MODE
+
+#ifdef REPLAY_BENCHMARK_MODE
+static void UpdateReplayBenchmark(const uint64_t frame_cpu_time) {
+    InputReplay *replay = InputReplay::GetInstance();
+    replay->ReportFrameTime(frame_cpu_time);
+    SceneManager *mgr = SceneManager::GetInstance();
+    if (replay->IsPlaybackDone() && !mgr->IsSceneRequested()) {
+        // the welcome scene starts the next pass, which ends this one
+        mgr->RequestNewScene(new WelcomeScene());
+    }
+}
+#endif // REPLAY_BENCHMARK_MODE
 
 // workaround for internal bug b/149866792
 static NativeEngineSavedState appState = {false};
@@ -54,6 +116,11 @@ NativeEngine::NativeEngine(struct android_app *app) {
     memset(&mState, 0, sizeof(mState));
     mSwapchainFrameHandle = DisplayManager::kInvalid_swapchain_handle;
     mSwapchainHandle = DisplayManager::kInvalid_swapchain_handle;
+    mSwapInterval = DisplayManager::kDisplay_Swap_Interval_60FPS;
+    mLastFrameCpuTime = 0;
+    mHasPendingDisplayChange = false;
+    mPendingSurfWidth = mPendingSurfHeight = 0;
+    mPendingScreenDensity = 0;
     mIsVulkan = false;
     mIsFirstFrame = true;
 
@@ -189,6 +256,7 @@ bool NativeEngine::CreateSwapchain() {
 
         if (swapchain_result == DisplayManager::kInit_Swapchain_Success) {
             mSwapchainImageCount = swapchain_configurations->min_swapchain_frame_count;
+            mSwapInterval = swapchain_configurations->display_swap_intervals[0];
             mSurfWidth = swapchain_configurations->display_resolutions[0].display_width;
             mSurfHeight = swapchain_configurations->display_resolutions[0].display_height;
             mScreenDensity = swapchain_configurations->display_resolutions[0].display_dpi;
@@ -289,8 +357,26 @@ void NativeEngine::DoFrame() {
         return;
     }
 
-    simple_renderer::Renderer& renderer = simple_renderer::Renderer::GetInstance();
-    renderer.BeginFrame(mSwapchainHandle);
+    ApplyPendingDisplayChange();
+
+#ifdef REPLAY_BENCHMARK_MODE
+    // Replayed frames run on the recorded times, not the wall clock, so they are
+    // simulated back to back as fast as possible and only one in
+    // REPLAY_FRAMES_PER_PRESENT is presented
+    for (int i = 1; i < REPLAY_FRAMES_PER_PRESENT; ++i) {
+        RecordAndSubmitFrame(false);
+    }
+#endif
+    RecordAndSubmitFrame(true);
+}
+
+void NativeEngine::RecordAndSubmitFrame(bool present) {
+    RenderThread *renderThread = RenderThread::GetInstance();
+    renderThread->BeginFrame();
+    // BeginFrame waits for a free frame slot, which is not work of this frame: start
+    // timing after it, or the CPU time reads as the full frame interval when the
+    // display paces the game
+    const auto frame_start = std::chrono::steady_clock::now();
 
     SceneManager *mgr = SceneManager::GetInstance();
 
@@ -300,14 +386,55 @@ void NativeEngine::DoFrame() {
         DoFirstFrameSetup();
     }
 
-    // render!
+    // record the frame
     mgr->DoFrame();
 
-    renderer.EndFrame();
+    const std::chrono::nanoseconds record_time = std::chrono::steady_clock::now() - frame_start;
+    const uint64_t record_ns = static_cast<uint64_t>(record_time.count());
 
-    // swap buffers
-    DisplayManager& display_manager = DisplayManager::GetInstance();
-    mSwapchainFrameHandle = display_manager.PresentCurrentSwapchainFrame(mSwapchainHandle);
+    // render and swap buffers, on the render thread if the scene uses it
+    renderThread->SetEnabled(mgr->WantsRenderThread());
+    renderThread->SubmitFrame(mSwapchainHandle, present);
+
+    // With a render thread, recording and execution overlap and the slowest of the
+    // two sets the frame time, otherwise they add up
+    if (renderThread->IsEnabled()) {
+        mLastFrameCpuTime = std::max(record_ns, renderThread->GetLastExecuteTime());
+    } else {
+        mLastFrameCpuTime = record_ns + renderThread->GetLastExecuteTime();
+    }
+#ifdef NULL_RENDERER_BENCHMARK_MODE
+    UpdateNullRendererBenchmark(static_cast<double>(mLastFrameCpuTime) / 1000000.0);
+#endif
+#ifdef REPLAY_BENCHMARK_MODE
+    UpdateReplayBenchmark(mLastFrameCpuTime);
+#endif
+}
+
+void NativeEngine::ApplyPendingDisplayChange() {
+    int width, height, density;
+    {
+        std::lock_guard<std::mutex> lock(mDisplayChangeMutex);
+        if (!mHasPendingDisplayChange) {
+            return;
+        }
+        mHasPendingDisplayChange = false;
+        width = mPendingSurfWidth;
+        height = mPendingSurfHeight;
+        density = mPendingScreenDensity;
+    }
+    if (width != mSurfWidth || height != mSurfHeight) {
+        // notify scene manager that the surface has changed size
+        ALOGI("NativeEngine: surface changed size %dx%d --> %dx%d", mSurfWidth, mSurfHeight,
+              width, height);
+        // size dependent resources are recreated, wait for the render thread
+        RenderThread::GetInstance()->Sync();
+        mSurfWidth = width;
+        mSurfHeight = height;
+        mScreenDensity = density;
+        SceneManager::GetInstance()->SetScreenSize(mSurfWidth, mSurfHeight);
+        ScreenSizeChanged();
+    }
 }
 
 android_app *NativeEngine::GetAndroidApp() {
@@ -360,9 +487,17 @@ void NativeEngine::SwapchainChanged(const DisplayManager::SwapchainChangeMessage
                                     void* user_data) {
     if (reason == DisplayManager::kSwapchain_Gained_Window) {
         mHasSwapchain = true;
+    } else if (reason == DisplayManager::kSwapchain_Losing_Window) {
+        // stop rendering to the window before its surface is destroyed
+        RenderThread::GetInstance()->Sync();
     } else if (reason == DisplayManager::kSwapchain_Lost_Window) {
         mHasSwapchain = false;
     } else if (reason == DisplayManager::kSwapchain_Needs_Recreation) {
+        // sent while presenting, which may happen on the render thread
+        RenderThread *renderThread = RenderThread::GetInstance();
+        if (!renderThread->IsRenderThread()) {
+            renderThread->Sync();
+        }
         simple_renderer::Renderer::GetInstance().SwapchainRecreated();
     }
 }
@@ -370,18 +505,13 @@ void NativeEngine::SwapchainChanged(const DisplayManager::SwapchainChangeMessage
 void NativeEngine::DisplayResolutionChanged(const DisplayManager::DisplayChangeInfo
                               &display_change_info, void *user_data) {
     if (display_change_info.change_message == DisplayManager::kDisplay_Change_Window_Resized) {
-        const int32_t width = display_change_info.display_resolution.display_width;
-        const int32_t height = display_change_info.display_resolution.display_height;
-        if (width != mSurfWidth || height != mSurfHeight) {
-            // notify scene manager that the surface has changed size
-            ALOGI("NativeEngine: surface changed size %dx%d --> %dx%d", mSurfWidth, mSurfHeight,
-                  width, height);
-            mSurfWidth = width;
-            mSurfHeight = height;
-            mScreenDensity = display_change_info.display_resolution.display_dpi;
-            SceneManager::GetInstance()->SetScreenSize(mSurfWidth, mSurfHeight);
-            ScreenSizeChanged();
-        }
+        // sent while presenting, which may happen on the render thread, so the
+        // change is applied by the game thread at the start of the next frame
+        std::lock_guard<std::mutex> lock(mDisplayChangeMutex);
+        mPendingSurfWidth = display_change_info.display_resolution.display_width;
+        mPendingSurfHeight = display_change_info.display_resolution.display_height;
+        mPendingScreenDensity = display_change_info.display_resolution.display_dpi;
+        mHasPendingDisplayChange = true;
     }
 }
 
@@ -22,6 +22,8 @@
 #include "system_event_manager.h"
 #include "user_input_manager.h"
 
+#include <mutex>
+
 using namespace base_game_framework;
 
 struct NativeEngineSavedState {
@@ -56,6 +58,14 @@ public:
     // This is the env for the app thread. It's different to the main thread.
     JNIEnv *GetAppJniEnv();
 
+    // returns the swap interval the swapchain presents at, in nanoseconds
+    uint64_t GetSwapInterval() const { return mSwapInterval; }
+
+    // returns the CPU time of recording and rendering the last frame, not counting
+    // the waits for a free frame, the GPU fence and the swapchain image nor the
+    // present, in nanoseconds
+    uint64_t GetLastFrameCpuTime() const { return mLastFrameCpuTime; }
+
 protected:
     bool ProcessCookedEvent(struct CookedEvent *event);
 
@@ -95,6 +105,19 @@ protected:
 
     int mSwapchainImageCount;
 
+    // swap interval of the swapchain, in nanoseconds
+    uint64_t mSwapInterval;
+
+    // CPU time of the last rendered frame, in nanoseconds
+    uint64_t mLastFrameCpuTime;
+
+    // Display resolution change waiting to be applied at the start of the next
+    // frame, protected by mDisplayChangeMutex
+    std::mutex mDisplayChangeMutex;
+    bool mHasPendingDisplayChange;
+    int mPendingSurfWidth, mPendingSurfHeight;
+    int mPendingScreenDensity;
+
     // Are we using Vulkan?
     bool mIsVulkan;
 
@@ -133,8 +156,13 @@ protected:
 
     bool PrepareToRender();
 
+    void ApplyPendingDisplayChange();
+
     void DoFrame();
 
+    // Records a frame of the current scene and submits it to the render thread
+    void RecordAndSubmitFrame(bool present);
+
     bool IsAnimating();
 };
 
@@ -17,22 +17,65 @@
 #ifndef agdktunnel_obstacle_hpp
 #define agdktunnel_obstacle_hpp
 
-#include "engine.hpp"
 #include "game_consts.hpp"
 #include "util.hpp"
+#include "glm/glm.hpp"
+
+#include <cstdint>
 
 // An obstacle consists of a grid of OBS_GRID_SIZE x OBS_GRID_SIZE cells; each of them may
 // or may not contain a box. One of the cells may be the bonus cell, which gives the player
 // a bonus when hit.
 //
+// The filled cells are a bitmask with one bit per cell, in row major order, so a test
+// against any set of cells is a single AND and the filled cells are visited by counting
+// trailing zeros.
+//
 // The obstacle grid lies on the XZ plane.
 class Obstacle {
 public:
-    bool grid[OBS_GRID_SIZE][OBS_GRID_SIZE]; // indexed as [col][row]
+    typedef uint32_t CellMask;
+    static_assert(OBS_GRID_SIZE * OBS_GRID_SIZE <= 32, "obstacle grid does not fit in a CellMask");
+    static constexpr CellMask ALL_CELLS = (OBS_GRID_SIZE * OBS_GRID_SIZE == 32) ? ~CellMask(0) :
+            (CellMask(1) << (OBS_GRID_SIZE * OBS_GRID_SIZE)) - 1;
+
+    CellMask mask; // filled cells
     int style;  // obstacle style (currently, this specifies its color).
     int bonusRow, bonusCol;
     const static int STYLE_NULL = 0;  // a null obstacle (not displayed)
 
+    static CellMask GetCellMask(int gridCol, int gridRow) {
+        return CellMask(1) << (gridRow * OBS_GRID_SIZE + gridCol);
+    }
+
+    static CellMask GetRowMask(int gridRow) {
+        return ((CellMask(1) << OBS_GRID_SIZE) - 1) << (gridRow * OBS_GRID_SIZE);
+    }
+
+    static CellMask GetColMask(int gridCol) {
+        CellMask cells = 0;
+        for (int r = 0; r < OBS_GRID_SIZE; r++) {
+            cells |= GetCellMask(gridCol, r);
+        }
+        return cells;
+    }
+
+    // Index of the lowest cell of a non empty mask, and the column and row of a cell index
+    static int GetFirstCell(CellMask cells) { return __builtin_ctz(cells); }
+
+    static int GetCellCol(int cell) { return cell % OBS_GRID_SIZE; }
+
+    static int GetCellRow(int cell) { return cell / OBS_GRID_SIZE; }
+
+    // Grow the cells by one in every direction, including the diagonals
+    static CellMask Dilate(CellMask cells) {
+        const CellMask horizontal = cells |
+                ((cells << 1) & ~GetColMask(0) & ALL_CELLS) |
+                ((cells >> 1) & ~GetColMask(OBS_GRID_SIZE - 1));
+        return (horizontal | (horizontal << OBS_GRID_SIZE) | (horizontal >> OBS_GRID_SIZE)) &
+               ALL_CELLS;
+    }
+
     glm::vec3 GetBoxCenter(int gridCol, int gridRow, float posY) {
         return glm::vec3(-TUNNEL_HALF_W + (gridCol + 0.5f) * OBS_CELL_SIZE, posY,
                          -TUNNEL_HALF_H + (gridRow + 0.5f) * OBS_CELL_SIZE);
@@ -54,10 +97,18 @@ public:
 
     float GetMaxY(float posY) { return posY + OBS_BOX_SIZE * 0.5f; }
 
+    bool IsFilled(int gridCol, int gridRow) const {
+        return (mask & GetCellMask(gridCol, gridRow)) != 0;
+    }
+
+    void FillCell(int gridCol, int gridRow) { mask |= GetCellMask(gridCol, gridRow); }
+
+    void ClearCell(int gridCol, int gridRow) { mask &= ~GetCellMask(gridCol, gridRow); }
+
     void Reset() {
         style = STYLE_NULL;
         bonusRow = bonusCol = -1;
-        memset(grid, 0, sizeof(grid));
+        mask = 0;
     }
 
     void SetBonus(int col, int row) {
@@ -71,10 +122,15 @@ public:
         bonusCol = bonusRow = -1;
     }
 
-    bool HasBonus() {
+    bool HasBonus() const {
         return bonusRow >= 0 && bonusRow < OBS_GRID_SIZE &&
                bonusCol >= 0 && bonusCol < OBS_GRID_SIZE &&
-               !grid[bonusCol][bonusRow];
+               !IsFilled(bonusCol, bonusRow);
+    }
+
+    // The bonus cell, or no cells if there is no bonus
+    CellMask GetBonusMask() const {
+        return HasBonus() ? GetCellMask(bonusCol, bonusRow) : 0;
     }
 };
 
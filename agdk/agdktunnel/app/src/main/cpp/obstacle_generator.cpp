@@ -55,15 +55,17 @@ void ObstacleGenerator::Generate(Obstacle *result) {
 }
 
 void ObstacleGenerator::FillRow(Obstacle *result, int row) {
-    for (int i = 0; i < OBS_GRID_SIZE; ++i) {
-        result->grid[i][row] = true;
-    }
+    result->mask |= Obstacle::GetRowMask(row);
 }
 
 void ObstacleGenerator::FillCol(Obstacle *result, int col) {
-    for (int i = 0; i < OBS_GRID_SIZE; ++i) {
-        result->grid[col][i] = true;
-    }
+    result->mask |= Obstacle::GetColMask(col);
+}
+
+void ObstacleGenerator::ClearRandomCell(Obstacle *result) {
+    int col = Random(0, OBS_GRID_SIZE);
+    int row = Random(0, OBS_GRID_SIZE);
+    result->ClearCell(col, row);
 }
 
 void ObstacleGenerator::GenEasy(Obstacle *result) {
@@ -88,7 +90,8 @@ void ObstacleGenerator::GenEasy(Obstacle *result) {
         default:
             i = Random(0, OBS_GRID_SIZE - 2); // i is the row of the bonus
             j = Random(0, OBS_GRID_SIZE - 2); // i is the row of the bonus
-            o->grid[i][j] = o->grid[i + 1][j] = o->grid[i][j + 1] = o->grid[i + 1][j + 1] = true;
+            o->mask |= Obstacle::GetCellMask(i, j) | Obstacle::GetCellMask(i + 1, j) |
+                       Obstacle::GetCellMask(i, j + 1) | Obstacle::GetCellMask(i + 1, j + 1);
             break;
     }
 }
@@ -152,7 +155,7 @@ void ObstacleGenerator::GenHard(Obstacle *result) {
             FillRow(result, i + 1);
             FillRow(result, i + 2);
             FillRow(result, i + 3);
-            result->grid[Random(0, OBS_GRID_SIZE)][Random(0, OBS_GRID_SIZE)] = false;
+            ClearRandomCell(result);
             break;
         case 1:
             i = Random(0, OBS_GRID_SIZE - 3);
@@ -160,7 +163,7 @@ void ObstacleGenerator::GenHard(Obstacle *result) {
             FillCol(result, i + 1);
             FillCol(result, i + 2);
             FillCol(result, i + 3);
-            result->grid[Random(0, OBS_GRID_SIZE)][Random(0, OBS_GRID_SIZE)] = false;
+            ClearRandomCell(result);
             break;
         case 2:
             i = Random(0, OBS_GRID_SIZE);
@@ -169,7 +172,7 @@ void ObstacleGenerator::GenHard(Obstacle *result) {
                     FillCol(result, i);
                 }
             }
-            result->grid[Random(0, OBS_GRID_SIZE)][Random(0, OBS_GRID_SIZE)] = false;
+            ClearRandomCell(result);
             break;
         default:
             i = Random(0, OBS_GRID_SIZE);
@@ -178,7 +181,7 @@ void ObstacleGenerator::GenHard(Obstacle *result) {
                     FillRow(result, i);
                 }
             }
-            result->grid[Random(0, OBS_GRID_SIZE)][Random(0, OBS_GRID_SIZE)] = false;
+            ClearRandomCell(result);
             break;
     }
 }
@@ -17,7 +17,6 @@
 #ifndef agdktunnel_obstacle_generator_hpp
 #define agdktunnel_obstacle_generator_hpp
 
-#include "engine.hpp"
 #include "obstacle.hpp"
 
 // Generates obstacles given a difficulty level.
@@ -48,6 +47,8 @@ private:
     void FillRow(Obstacle *result, int row);
 
     void FillCol(Obstacle *result, int col);
+
+    void ClearRandomCell(Obstacle *result);
 };
 
 #endif
@@ -19,14 +19,15 @@
 #include "ascii_to_geom.hpp"
 #include "game_consts.hpp"
 #include "gfx_manager.hpp"
+#include "input_replay.hpp"
 #include "play_scene.hpp"
+#include "render_thread.hpp"
 #include "texture_manager.hpp"
 #include "tunnel_engine.hpp"
 #include "util.hpp"
 #include "welcome_scene.hpp"
 #include "welcome_scene.hpp"
 
-#include "data/ascii_art.inl"
 #include "data/cube_geom.inl"
 #include "data/strings.inl"
 #include "data/tunnel_geom.inl"
@@ -41,7 +42,6 @@ static const float MENUITEM_COLOR[] = {1.0f, 1.0f, 1.0f};
 
 static const float DEFAULT_TINT[4] = {1.0f, 1.0f, 1.0f, 1.0f};
 static const float LIGHT_OFF[4] = {0.0f, 0.0f, 0.0f, 0.0f};
-static const float LIGHT_POS[4] = {0.0f, 0.0f, 0.0f, 1.0f};
 
 // obstacle colors
 static const float OBS_COLORS[] = {
@@ -54,6 +54,78 @@ static const float OBS_COLORS[] = {
         1.0f, 1.0f, 0.0f
 };
 
+#ifdef SAVE_STRESS_MODE
+struct SaveStress {
+    uint32_t frame_count = 0;
+    uint64_t frame_cpu_ns = 0;
+    uint64_t max_frame_cpu_ns = 0;
+};
+
+static SaveStress s_save_stress;
+
+// Saves the current checkpoint again on every frame, the frame CPU time must not
+// depend on how long the writes take
+static void UpdateSaveStress() {
+    TunnelEngine *engine = TunnelEngine::GetInstance();
+    engine->SaveProgress(engine->GetDataStateMachine()->getLevelLoaded(),
+            /* forceSave = */ true);
+
+    const uint64_t frame_cpu_ns = engine->GetLastFrameCpuTime();
+    s_save_stress.frame_count++;
+    s_save_stress.frame_cpu_ns += frame_cpu_ns;
+    s_save_stress.max_frame_cpu_ns = std::max(s_save_stress.max_frame_cpu_ns, frame_cpu_ns);
+    if (s_save_stress.frame_count == SAVE_STRESS_FRAME_COUNT) {
+        ALOGI("SaveStress: %u saves requested, frame cpu avg %.3f ms max %.3f ms",
+              s_save_stress.frame_count,
+              static_cast<double>(s_save_stress.frame_cpu_ns) / s_save_stress.frame_count / 1e6,
+              static_cast<double>(s_save_stress.max_frame_cpu_ns) / 1e6);
+        s_save_stress = SaveStress();
+    }
+}
+#endif // SAVE_STRESS_MODE
+
+#ifdef RENDERER_STATS_OVERLAY_MODE
+static void FormatRendererStats(char *str, size_t size) {
+    RenderThread *renderThread = RenderThread::GetInstance();
+    std::lock_guard<std::mutex> statsLock(renderThread->GetStatsMutex());
+    const RendererStats &stats = Renderer::GetInstance().GetStats();
+    const RendererStats::StatSummary draws =
+            stats.GetSummary(RendererStats::kStat_DrawCalls, RENDERER_STATS_FRAMES);
+    const RendererStats::StatSummary triangles =
+            stats.GetSummary(RendererStats::kStat_Triangles, RENDERER_STATS_FRAMES);
+    const RendererStats::StatSummary binds =
+            stats.GetSummary(RendererStats::kStat_PipelineBinds, RENDERER_STATS_FRAMES);
+    const RendererStats::StatSummary uniforms =
+            stats.GetSummary(RendererStats::kStat_UniformBytes, RENDERER_STATS_FRAMES);
+    const RendererStats::StatSummary begin_frame =
+            stats.GetSummary(RendererStats::kStat_BeginFrameTime, RENDERER_STATS_FRAMES);
+    const RendererStats::StatSummary end_frame =
+            stats.GetSummary(RendererStats::kStat_EndFrameTime, RENDERER_STATS_FRAMES);
+    const RendererStats::StatSummary gpu_frame =
+            stats.GetSummary(RendererStats::kStat_GPUFrameTime, RENDERER_STATS_FRAMES);
+    const RendererStats::StatSummary culled =
+            stats.GetSummary(RendererStats::kStat_ObjectsCulled, RENDERER_STATS_FRAMES);
+    const RendererStats::StatSummary visible =
+            stats.GetSummary(RendererStats::kStat_ObjectsVisible, RENDERER_STATS_FRAMES);
+    // In thousandths
+    const RendererStats::StatSummary scene_scale =
+            stats.GetSummary(RendererStats::kStat_SceneScale, RENDERER_STATS_FRAMES);
+    // Latency is already in milliseconds
+    const RenderThread::LatencyStats latency = renderThread->GetLatencyStats();
+    // Times are in nanoseconds
+    snprintf(str, size, "DRAWS %.0f/%.0f\nTRIS %.0f/%.0f\nBINDS %.0f/%.0f\n"
+             "UNIFORM KB %.1f/%.1f\nBEGIN+END MS %.2f/%.2f\nGPU MS %.2f/%.2f\nSCALE %% %.0f/%.0f\n"
+             "LATENCY MS %.2f/%.2f\nVISIBLE %.0f/%.0f\nCULLED %.0f/%.0f",
+             draws.avg, draws.max, triangles.avg, triangles.max, binds.avg, binds.max,
+             uniforms.avg / 1024.0, uniforms.max / 1024.0,
+             (begin_frame.avg + end_frame.avg) / 1000000.0,
+             (begin_frame.max + end_frame.max) / 1000000.0,
+             gpu_frame.avg / 1000000.0, gpu_frame.max / 1000000.0,
+             scene_scale.avg / 10.0, scene_scale.min / 10.0,
+             latency.avg, latency.max, visible.avg, visible.max, culled.avg, culled.max);
+}
+#endif // RENDERER_STATS_OVERLAY_MODE
+
 static const char *TONE_BONUS[] = {
         "d70 f150. f250. f350. f450.",
         "d70 f200. f300. f400. f500.",
@@ -74,12 +146,15 @@ PlayScene::PlayScene(int savedLevel) : Scene() {
 #ifdef TOUCH_INDICATOR_MODE
     mRectRenderer = NULL;
 #endif // TOUCH_INDICATOR_MODE
+    mTextUniformBuffer = TunnelEngine::GetInstance()->GetGfxManager()->GetUniformBuffer(
+        GfxManager::kGfxType_BasicThickLinesNoDepthTest);
     mShipSteerX = mShipSteerZ = 0.0f;
     mFilteredSteerX = mFilteredSteerZ = 0.0f;
     mMotionKeyBitmask = 0;
 
     mPlayerPos = glm::vec3(0.0f, 0.0f, 0.0f); // center
     mPlayerDir = glm::vec3(0.0f, 1.0f, 0.0f); // forward
+    mPrevPlayerPos = mPlayerPos;
     mDifficulty = 0;
 
     mCubeGeom = NULL;
@@ -119,6 +194,7 @@ PlayScene::PlayScene(int savedLevel) : Scene() {
     mLives = PLAYER_LIVES;
 
     mRollAngle = 0.0f;
+    mPrevRollAngle = 0.0f;
 
     mPlayerSpeed = 0.0f;
     mBlinkingHeart = false;
@@ -128,6 +204,8 @@ PlayScene::PlayScene(int savedLevel) : Scene() {
     mLastCrashSection = -1;
 
     mFrameClock.SetMaxDelta(MAX_DELTA_T);
+    mSimAccumulator = 0.0f;
+    SetSimTickRate(SIM_TICK_RATE);
     mLastAmbientBeepEmitted = 0;
     mMenuTouchActive = false;
 
@@ -144,6 +222,53 @@ PlayScene::PlayScene(int savedLevel) : Scene() {
     }
 }
 
+PlayScene::~PlayScene() {
+    // only set if the scene was preloaded but never installed
+    CleanUp(&mTextRenderer);
+}
+
+void PlayScene::SetSimTickRate(float ticksPerSecond) {
+    mSimStep = 1.0f / ticksPerSecond;
+}
+
+void PlayScene::OnInstall() {
+    // every session of the play scene is recorded, or played back, by the input replay
+    InputReplay::GetInstance()->BeginSession(mSavedLevel);
+
+    // synthesize the sound effects before they are first played
+    SfxMan *sfxMan = SfxMan::GetInstance();
+    for (const char *tone : TONE_BONUS) {
+        sfxMan->PrecacheTone(tone);
+    }
+    sfxMan->PrecacheTone(TONE_LEVEL_UP);
+    sfxMan->PrecacheTone(TONE_CRASHED);
+    sfxMan->PrecacheTone(TONE_GAME_OVER);
+    sfxMan->PrecacheTone(TONE_AMBIENT_0);
+    sfxMan->PrecacheTone(TONE_AMBIENT_1);
+}
+
+void PlayScene::OnUninstall() {
+    InputReplay::GetInstance()->EndSession();
+}
+
+void PlayScene::OnPreload() {
+    // the ~100 glyph and string meshes are built off the game thread, OnStartGraphics
+    // only uploads them
+    CreateTextRenderer();
+}
+
+void PlayScene::CreateTextRenderer() {
+    mTextRenderer = new TextRenderer(mTextUniformBuffer);
+    // the menu items and signs never change, cache their text meshes
+    static const char *CACHED_STRINGS[] = {
+        S_UNPAUSE, S_QUIT, S_START_OVER, S_RESUME, S_RESUME_CLOUD,
+        S_HOWTO_WITHOUT_JOY, S_GOT_BONUS, S_GAME_OVER, S_OUCH, S_CHECKPOINT_SAVED
+    };
+    for (const char *str : CACHED_STRINGS) {
+        mTextRenderer->CacheString(str);
+    }
+}
+
 static unsigned char *_gen_wall_texture() {
     static unsigned char pixel_data[WALL_TEXTURE_SIZE * WALL_TEXTURE_SIZE * 3];
     unsigned char *p;
@@ -220,11 +345,13 @@ void PlayScene::OnStartGraphics() {
     mFrameClock.Reset();
 
     // life icon geometry
-    mLifeGeom = AsciiArtToGeom(ART_LIFE, LIFE_ICON_SCALE);
+    mLifeGeom = BakedArtToGeom(BAKED_ART_LIFE, LIFE_ICON_SCALE);
 
-    // create text renderer and shape renderer
-    mTextRenderer = new TextRenderer(gfxManager->GetUniformBuffer(
-        GfxManager::kGfxType_BasicThickLinesNoDepthTest));
+    // create text renderer and shape renderer, the text renderer is usually preloaded
+    if (mTextRenderer == NULL) {
+        CreateTextRenderer();
+    }
+    mTextRenderer->Commit();
     mShapeRenderer = new ShapeRenderer(gfxManager->GetUniformBuffer(
         GfxManager::kGfxType_BasicTrisNoDepthTest));
 #ifdef TOUCH_INDICATOR_MODE
@@ -251,23 +378,68 @@ void PlayScene::OnKillGraphics() {
 
 void PlayScene::DoFrame() {
     float deltaT = mFrameClock.ReadDelta();
-    float previousY = mPlayerPos.y;
+
+    // advance the simulation in fixed steps, whatever the frame rate, unless a menu
+    // pauses the game
+    if (!mMenu) {
+        mSimAccumulator += deltaT;
+        while (mSimAccumulator >= mSimStep && !mMenu) {
+            mSimAccumulator -= mSimStep;
+            mPrevPlayerPos = mPlayerPos;
+            mPrevRollAngle = mRollAngle;
+            StepSimulation(mSimStep);
+        }
+    }
+
+    // did the game expire?
+    SceneManager *mgr = SceneManager::GetInstance();
+    if (mLives <= 0 && Clock() > mGameOverExpire && !mgr->IsSceneRequested()) {
+        mgr->RequestNewScene(new WelcomeScene());
+    }
+
+#ifdef SAVE_STRESS_MODE
+    UpdateSaveStress();
+#endif
+
+    // render the state interpolated between the last two simulation steps
+    const float alpha = Clamp(mSimAccumulator / mSimStep, 0.0f, 1.0f);
+    const glm::vec3 renderPos = glm::mix(mPrevPlayerPos, mPlayerPos, alpha);
+    float rollDelta = mRollAngle - mPrevRollAngle;
+    // the roll angle wraps around, interpolate along the shortest arc
+    if (rollDelta > M_PI) {
+        rollDelta -= 2 * M_PI;
+    } else if (rollDelta < -M_PI) {
+        rollDelta += 2 * M_PI;
+    }
+    const float renderRoll = mPrevRollAngle + alpha * rollDelta;
 
     GfxManager *gfxManager = TunnelEngine::GetInstance()->GetGfxManager();
-    gfxManager->SetMainRenderPass();
-    gfxManager->SetRenderState(GfxManager::kGfxType_OurTris);
+    gfxManager->BeginScenePass();
 
     // rotate the view matrix according to current roll angle
-    glm::vec3 upVec = glm::vec3(-sin(mRollAngle), 0, cos(mRollAngle));
+    glm::vec3 upVec = glm::vec3(-sin(renderRoll), 0, cos(renderRoll));
 
     // set up view matrix according to player's ship position and direction
-    mViewMat = glm::lookAt(mPlayerPos, mPlayerPos + mPlayerDir, upVec);
+    mViewMat = glm::lookAt(renderPos, renderPos + mPlayerDir, upVec);
+
+    // pick the tunnel sections and obstacles to render
+    CullScene();
 
     // render tunnel walls
+    CommandList& commands = RenderThread::GetInstance()->GetCommandList();
+    commands.BeginGPUScope("tunnel");
     RenderTunnel(gfxManager);
+    commands.EndGPUScope();
 
     // render obstacles
+    commands.BeginGPUScope("obstacles");
     RenderObstacles(gfxManager);
+    commands.EndGPUScope();
+
+    // upscale the scene to the display, menus and HUD render over it at full resolution
+    commands.BeginGPUScope("upscale");
+    gfxManager->EndScenePass();
+    commands.EndGPUScope();
 
     if (mMenu) {
         if (mMenu == MENU_LOADING) {
@@ -290,7 +462,9 @@ void PlayScene::DoFrame() {
     }
 
     // render HUD (lives, score, etc)
+    commands.BeginGPUScope("hud");
     RenderHUD(gfxManager);
+    commands.EndGPUScope();
 
     // deduct from the time remaining to remove a sign from the screen
     if (mSignText && mSignExpires) {
@@ -316,6 +490,10 @@ void PlayScene::DoFrame() {
     if (mBlinkingHeart && Clock() > mBlinkingHeartExpire) {
         mBlinkingHeart = false;
     }
+}
+
+void PlayScene::StepSimulation(float deltaT) {
+    float previousY = mPlayerPos.y;
 
     // update speed
     float targetSpeed = PLAYER_SPEED + PLAYER_SPEED_INC_PER_LEVEL * mDifficulty;
@@ -383,11 +561,6 @@ void PlayScene::DoFrame() {
         mRollAngle -= 2 * M_PI;
     }
 
-    // did the game expire?
-    if (mLives <= 0 && Clock() > mGameOverExpire) {
-        SceneManager::GetInstance()->RequestNewScene(new WelcomeScene());
-    }
-
     // produce the ambient sound
     int soundPoint = (int) floor(mPlayerPos.y / (TUNNEL_SECTION_LENGTH / 3));
     if (soundPoint % 3 != 0 && soundPoint > mLastAmbientBeepEmitted) {
@@ -411,137 +584,187 @@ static void _get_obs_color(int style, float *r, float *g, float *b) {
     *b = OBS_COLORS[style * 3 + 2];
 }
 
-void PlayScene::RenderTunnel(GfxManager *gfxManager) {
-    glm::mat4 modelMat;
-    glm::mat4 mvpMat;
-    int i, oi;
-
-    Renderer& renderer = Renderer::GetInstance();
+void PlayScene::CullScene() {
     const glm::mat4 &rotateMat = SceneManager::GetInstance()->GetRotationMatrix();
-    std::shared_ptr<UniformBuffer> ourBuffer =
-        gfxManager->GetUniformBuffer(GfxManager::kGfxType_OurTris);
-
-    bool useIndexBuffer = (mTunnelGeom->index_buffer_.get() != NULL);
-    if (useIndexBuffer) {
-        renderer.BindIndexBuffer(mTunnelGeom->index_buffer_);
+    mCuller.SetFrustum(rotateMat * mProjMat * mViewMat);
+    mCuller.Clear();
+    mCandidateBoxes.clear();
+
+    // tunnel sections come first. The far clip plane is at the distance where the
+    // fog turns everything black, so it also rejects sections too far away to see
+    const glm::vec3 sectionExtents(TUNNEL_HALF_W, 0.5f * TUNNEL_SECTION_LENGTH, TUNNEL_HALF_H);
+    for (int oi = 0; oi <= RENDER_TUNNEL_SECTION_COUNT; ++oi) {
+        mCuller.AddBox(glm::vec3(0.0f, GetSectionCenterY(mFirstSection + oi), 0.0f),
+                       sectionExtents);
     }
-    renderer.BindTexture(mWallTextures[0]);
-    renderer.BindVertexBuffer(mTunnelGeom->vertex_buffer_);
-
-    ourBuffer->SetBufferElementData(GfxManager::kOurUniform_Tint,
-                                    DEFAULT_TINT, UniformBuffer::kElementSize_Float4);
-    ourBuffer->SetBufferElementData(GfxManager::kOurUniform_PointLightColor,
-                                    LIGHT_OFF, UniformBuffer::kElementSize_Float4);
-    ourBuffer->SetBufferElementData(GfxManager::kOurUniform_PointLightPos,
-                                    LIGHT_POS, UniformBuffer::kElementSize_Float4);
-
-    for (i = mFirstSection, oi = 0; i <= mFirstSection + RENDER_TUNNEL_SECTION_COUNT; ++i, ++oi) {
-        float segCenterY = GetSectionCenterY(i);
-        modelMat = glm::translate(glm::mat4(1.0), glm::vec3(0.0, segCenterY, 0.0));
-        mvpMat = mProjMat * mViewMat * modelMat;
-        mvpMat = rotateMat * mvpMat;
-        const float* matrixData = glm::value_ptr(mvpMat);
+    const uint32_t sectionCount = mCuller.GetBoxCount();
 
-        Obstacle *o = oi >= mObstacleCount ? NULL : GetObstacleAt(oi);
+    // the bonus spins around the z axis, bound it by its diagonal on x and y
+    const float bonusHalfSize = 0.5f * OBS_BONUS_SIZE;
+    const float bonusHalfDiagonal = bonusHalfSize * sqrtf(2.0f);
+    const glm::vec3 bonusExtents(bonusHalfDiagonal, bonusHalfDiagonal, bonusHalfSize);
+    for (int i = 0; i < mObstacleCount; i++) {
+        Obstacle *o = GetObstacleAt(i);
+        if (o->style == Obstacle::STYLE_NULL) {
+            continue;
+        }
+        float posY = GetSectionCenterY(mFirstSection + i);
+        // visit the filled cells and the bonus cell in row major order
+        for (Obstacle::CellMask cells = o->mask | o->GetBonusMask(); cells; cells &= cells - 1) {
+            int cell = Obstacle::GetFirstCell(cells);
+            int c = Obstacle::GetCellCol(cell);
+            int r = Obstacle::GetCellRow(cell);
+            if (o->IsFilled(c, r)) {
+                mCuller.AddBox(o->GetBoxCenter(c, r, posY), 0.5f * o->GetBoxSize(c, r));
+                mCandidateBoxes.push_back({i, c, r, false});
+            } else {
+                mCuller.AddBox(o->GetBoxCenter(c, r, posY), bonusExtents);
+                mCandidateBoxes.push_back({i, c, r, true});
+            }
+        }
+    }
 
-        // the point light is given in model coordinates, which is 0,0,0 is ok (center of
-        // tunnel section)
-        if (o) {
-            float red, green, blue;
-            _get_obs_color(o->style, &red, &green, &blue);
-            const float lightColor[4] = {red, green, blue, 1.0f};
-            ourBuffer->SetBufferElementData(GfxManager::kOurUniform_PointLightColor,
-                                            lightColor, UniformBuffer::kElementSize_Float4);
+#ifdef CULLING_OFF_MODE
+    mCullResults.clear();
+    for (uint32_t index = 0; index < mCuller.GetBoxCount(); ++index) {
+        mCullResults.push_back(index);
+    }
+#else
+    mCuller.Cull(mCullResults);
+#endif
 
+    mVisibleSections.clear();
+    mVisibleBoxes.clear();
+    for (uint32_t index : mCullResults) {
+        if (index < sectionCount) {
+            mVisibleSections.push_back(static_cast<int>(index));
         } else {
-            ourBuffer->SetBufferElementData(GfxManager::kOurUniform_PointLightColor,
-                                            LIGHT_OFF, UniformBuffer::kElementSize_Float4);
-
+            mVisibleBoxes.push_back(mCandidateBoxes[index - sectionCount]);
         }
+    }
 
-        // render tunnel section
-        ourBuffer->SetBufferElementData(GfxManager::kOurUniform_MVP,
-                                        matrixData, UniformBuffer::kElementSize_Matrix44);
+    CommandList& commands = RenderThread::GetInstance()->GetCommandList();
+    const uint32_t visibleCount = static_cast<uint32_t>(mCullResults.size());
+    commands.AddStat(RendererStats::kStat_ObjectsCulled, mCuller.GetBoxCount() - visibleCount);
+    commands.AddStat(RendererStats::kStat_ObjectsVisible, visibleCount);
+}
 
-        if (useIndexBuffer) {
-            renderer.DrawIndexed(mTunnelGeom->index_buffer_->GetBufferElementCount(), 0);
-        } else {
-            renderer.Draw(mTunnelGeom->vertex_buffer_->GetBufferElementCount(), 0);
+void PlayScene::RenderTunnel(GfxManager *gfxManager) {
+    if (mVisibleSections.empty()) {
+        return;
+    }
+
+    CommandList& commands = RenderThread::GetInstance()->GetCommandList();
+    const glm::mat4 &rotateMat = SceneManager::GetInstance()->GetRotationMatrix();
+    std::shared_ptr<UniformBuffer> tunnelBuffer =
+        gfxManager->GetUniformBuffer(GfxManager::kGfxType_TunnelTris);
+
+    // the frustum is convex and the sections are laid end to end, so the visible
+    // sections are a contiguous run. Draw it as instances of its first section,
+    // each offset by one section length along the tunnel
+    const int firstSection = mVisibleSections.front();
+    const int sectionCount = mVisibleSections.back() - firstSection + 1;
+    MY_ASSERT(sectionCount <= GfxManager::kMaxTunnelSections);
+
+    const glm::mat4 viewProjMat = rotateMat * mProjMat * mViewMat;
+    const glm::mat4 mvpMat = glm::translate(viewProjMat,
+            glm::vec3(0.0f, GetSectionCenterY(mFirstSection + firstSection), 0.0f));
+    const float sectionOffset[4] = {0.0f, TUNNEL_SECTION_LENGTH, 0.0f, 0.0f};
+
+    // the point light at the center of each section takes the color of the
+    // section's obstacle
+    float sectionLights[GfxManager::kMaxTunnelSections] = {};
+    for (int instance = 0; instance < sectionCount; ++instance) {
+        int oi = firstSection + instance;
+        Obstacle *o = oi >= mObstacleCount ? NULL : GetObstacleAt(oi);
+        if (o) {
+            float red, green, blue;
+            _get_obs_color(o->style, &red, &green, &blue);
+            sectionLights[instance] = GfxManager::PackTunnelLightColor(red, green, blue);
         }
     }
+
+    gfxManager->SetRenderState(GfxManager::kGfxType_TunnelTris);
+    commands.SetBufferElementData(tunnelBuffer, GfxManager::kTunnelUniform_MVP,
+                                  glm::value_ptr(mvpMat), UniformBuffer::kElementSize_Matrix44);
+    commands.SetBufferElementData(tunnelBuffer, GfxManager::kTunnelUniform_SectionOffset,
+                                  sectionOffset, UniformBuffer::kElementSize_Float4);
+    commands.SetBufferElementData(tunnelBuffer, GfxManager::kTunnelUniform_SectionLights0,
+                                  &sectionLights[0], UniformBuffer::kElementSize_Float4);
+    commands.SetBufferElementData(tunnelBuffer, GfxManager::kTunnelUniform_SectionLights1,
+                                  &sectionLights[4], UniformBuffer::kElementSize_Float4);
+
+    commands.BindIndexBuffer(mTunnelGeom->index_buffer_);
+    commands.BindVertexBuffer(mTunnelGeom->vertex_buffer_);
+    commands.BindTexture(mWallTextures[0]);
+
+    const Renderer::DrawIndexedRecord sectionsRecord = {
+        static_cast<uint32_t>(mTunnelGeom->index_buffer_->GetBufferElementCount()),
+        static_cast<uint32_t>(sectionCount),
+        0, 0, 0
+    };
+    commands.DrawIndexedMulti(&sectionsRecord, 1);
 }
 
 void PlayScene::RenderObstacles(GfxManager *gfxManager) {
-    int i;
-    int r, c;
     float red, green, blue;
-    glm::mat4 modelMat;
-    glm::mat4 mvpMat;
 
-    Renderer& renderer = Renderer::GetInstance();
+    CommandList& commands = RenderThread::GetInstance()->GetCommandList();
     const glm::mat4 &rotateMat = SceneManager::GetInstance()->GetRotationMatrix();
 
-    std::shared_ptr<UniformBuffer> ourBuffer =
-        gfxManager->GetUniformBuffer(GfxManager::kGfxType_OurTris);
-    renderer.BindTexture(mWallTextures[0]);
-    renderer.BindVertexBuffer(mCubeGeom->vertex_buffer_);
-
-    ourBuffer->SetBufferElementData(GfxManager::kOurUniform_Tint,
-                                    DEFAULT_TINT, UniformBuffer::kElementSize_Float4);
-    ourBuffer->SetBufferElementData(GfxManager::kOurUniform_PointLightColor,
-                                    LIGHT_OFF, UniformBuffer::kElementSize_Float4);
-
-    for (i = 0; i < mObstacleCount; i++) {
-        Obstacle *o = GetObstacleAt(i);
-        float posY = GetSectionCenterY(mFirstSection + i);
-
-        if (o->style == Obstacle::STYLE_NULL) {
-            // don't render null obstacles
-            continue;
+    // build the MVPs of all the visible boxes in one batch from their model transforms
+    const glm::mat4 viewProjMat = rotateMat * mProjMat * mViewMat;
+    const float bonusAngle = Clock() * 90.0f;
+    mBoxTransforms.clear();
+    for (const ObstacleBox &box : mVisibleBoxes) {
+        Obstacle *o = GetObstacleAt(box.obstacle);
+        float posY = GetSectionCenterY(mFirstSection + box.obstacle);
+        ModelTransform transform;
+        transform.translation = o->GetBoxCenter(box.col, box.row, posY);
+        if (!box.isBonus) {
+            transform.scale = o->GetBoxSize(box.col, box.row);
+            transform.rotationZ = 0.0f;
+        } else {
+            transform.scale = glm::vec3(OBS_BONUS_SIZE, OBS_BONUS_SIZE, OBS_BONUS_SIZE);
+            transform.rotationZ = bonusAngle;
         }
+        mBoxTransforms.push_back(transform);
+    }
+    mBoxMvps.resize(mBoxTransforms.size());
+    BuildMVPs(viewProjMat, mBoxTransforms.data(), static_cast<uint32_t>(mBoxTransforms.size()),
+              nullptr, mBoxMvps.data());
 
-        for (r = 0; r < OBS_GRID_SIZE; r++) {
-            for (c = 0; c < OBS_GRID_SIZE; c++) {
-                bool isBonus = r == o->bonusRow && c == o->bonusCol;
-                if (o->grid[c][r]) {
-                    // set up matrices
-                    modelMat = glm::translate(glm::mat4(1.0f), o->GetBoxCenter(c, r, posY));
-                    modelMat = glm::scale(modelMat, o->GetBoxSize(c, r));
-                    mvpMat = mProjMat * mViewMat * modelMat;
-                    mvpMat = rotateMat * mvpMat;
-
-                    // set up color
-                    _get_obs_color(o->style, &red, &green, &blue);
-
-                    // render box
-                    const float* matrixData = glm::value_ptr(mvpMat);
-                    const float tintColor[4] = {red, green, blue, 1.0f};
-                    ourBuffer->SetBufferElementData(GfxManager::kOurUniform_MVP,
-                                                    matrixData,
-                                                    UniformBuffer::kElementSize_Matrix44);
-                    ourBuffer->SetBufferElementData(GfxManager::kOurUniform_Tint,
-                                                    tintColor, UniformBuffer::kElementSize_Float4);
-                    renderer.Draw(mCubeGeom->vertex_buffer_->GetBufferElementCount(), 0);
-                } else if (isBonus) {
-                    modelMat = glm::translate(glm::mat4(1.0f), o->GetBoxCenter(c, r, posY));
-                    modelMat = glm::scale(modelMat, glm::vec3(OBS_BONUS_SIZE, OBS_BONUS_SIZE,
-                                                              OBS_BONUS_SIZE));
-                    modelMat = glm::rotate(modelMat, Clock() * 90.0f, glm::vec3(0.0f, 0.0f, 1.0f));
-                    mvpMat = mProjMat * mViewMat * modelMat;
-                    mvpMat = rotateMat * mvpMat;
-                    const float* matrixData = glm::value_ptr(mvpMat);
-                    const float tintColor[4] = {SineWave(0.8f, 1.0f, 0.5f, 0.0f),
-                                                SineWave(0.8f, 1.0f, 0.5f, 0.0f),
-                                                SineWave(0.8f, 1.0f, 0.5f, 0.0f), 1.0f};
-                    ourBuffer->SetBufferElementData(GfxManager::kOurUniform_MVP,
-                                                    matrixData,
-                                                    UniformBuffer::kElementSize_Matrix44);
-                    ourBuffer->SetBufferElementData(GfxManager::kOurUniform_Tint,
-                                                    tintColor, UniformBuffer::kElementSize_Float4);
-                    renderer.Draw(mCubeGeom->vertex_buffer_->GetBufferElementCount(), 0);
-                }
-            }
+    std::shared_ptr<UniformBuffer> ourBuffer =
+        gfxManager->GetUniformBuffer(GfxManager::kGfxType_OurTris);
+    gfxManager->SetRenderState(GfxManager::kGfxType_OurTris);
+    commands.BindTexture(mWallTextures[0]);
+    commands.BindVertexBuffer(mCubeGeom->vertex_buffer_);
+
+    commands.SetBufferElementData(ourBuffer, GfxManager::kOurUniform_Tint,
+                                  DEFAULT_TINT, UniformBuffer::kElementSize_Float4);
+    commands.SetBufferElementData(ourBuffer, GfxManager::kOurUniform_PointLightColor,
+                                  LIGHT_OFF, UniformBuffer::kElementSize_Float4);
+
+    for (size_t i = 0; i < mVisibleBoxes.size(); ++i) {
+        const ObstacleBox &box = mVisibleBoxes[i];
+        float tintColor[4];
+        if (!box.isBonus) {
+            _get_obs_color(GetObstacleAt(box.obstacle)->style, &red, &green, &blue);
+            tintColor[0] = red;
+            tintColor[1] = green;
+            tintColor[2] = blue;
+        } else {
+            tintColor[0] = tintColor[1] = tintColor[2] = SineWave(0.8f, 1.0f, 0.5f, 0.0f);
         }
+        tintColor[3] = 1.0f;
+
+        // render box
+        commands.SetBufferElementData(ourBuffer, GfxManager::kOurUniform_MVP,
+                                      glm::value_ptr(mBoxMvps[i]),
+                                      UniformBuffer::kElementSize_Matrix44);
+        commands.SetBufferElementData(ourBuffer, GfxManager::kOurUniform_Tint,
+                                      tintColor, UniformBuffer::kElementSize_Float4);
+        commands.Draw(mCubeGeom->vertex_buffer_->GetBufferElementCount(), 0);
     }
 }
 
@@ -684,6 +907,14 @@ void PlayScene::RenderHUD(GfxManager *gfxManager) {
         modelMat = glm::translate(modelMat, glm::vec3(LIFE_SPACING_X, 0.0f, 0.0f));
     }
 
+#ifdef RENDERER_STATS_OVERLAY_MODE
+    // Average/max over recent frames, the overlay text adds to the draw count
+    static char stats_str[256];
+    FormatRendererStats(stats_str, sizeof(stats_str));
+    mTextRenderer->SetFontScale(RENDERER_STATS_FONT_SCALE);
+    mTextRenderer->RenderText(stats_str, aspect * RENDERER_STATS_POS_X, RENDERER_STATS_POS_Y);
+#endif // RENDERER_STATS_OVERLAY_MODE
+
 #ifdef TOUCH_INDICATOR_MODE
     if (mSteering == STEERING_TOUCH) {
         mRectRenderer->SetColor(1.0f, 1.0f, 0.0f);
@@ -729,7 +960,7 @@ void PlayScene::DetectCollisions(float previousY) {
     int col = o->GetColAt(mPlayerPos.x);
     int row = o->GetRowAt(mPlayerPos.z);
 
-    if (o->grid[col][row]) {
+    if (o->IsFilled(col, row)) {
         TunnelEngine::GetInstance()->GetVibrationHelper()->DoVibrateEffect();
 #ifndef GOD_MODE
         // crashed against obstacle
@@ -787,22 +1018,6 @@ void PlayScene::DetectCollisions(float previousY) {
         // player missed bonus!
         mBonusInARow = 0;
     }
-
-    // was it a close call?
-    if (!o->grid[col][row]) {
-        bool isCloseCall = false;
-        for (int i = -1; i <= 1 && !isCloseCall; i++) {
-            for (int j = -1; j <= 1; j++) {
-                int other_row = o->GetColAt(mPlayerPos.x + i * CLOSE_CALL_CALC_DELTA);
-                int other_col = o->GetRowAt(mPlayerPos.z + j * CLOSE_CALL_CALC_DELTA);
-                if (o->grid[other_col][other_row]) {
-                    isCloseCall = true;
-                    break;
-                }
-            }
-        }
-
-    }
 }
 
 bool PlayScene::OnBackKeyPressed() {
@@ -1023,6 +1238,42 @@ void PlayScene::OnScreenResized(int /*width*/, int /*height*/) {
     UpdateProjectionMatrix();
 }
 
+bool PlayScene::WantsRenderThread() {
+#if defined(RENDER_THREAD_OFF_MODE) || defined(NULL_RENDERER_MODE)
+    // the benchmarks time the submission and read the null renderer counters right
+    // after submitting
+    return false;
+#else
+    return true;
+#endif
+}
+
+// FNV-1a hash of the given bytes, continuing from hash
+static uint32_t _hash_bytes(uint32_t hash, const void *data, size_t size) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+uint32_t PlayScene::GetStateChecksum() {
+    const int32_t state[] = {mLives, (int32_t) mEncryptedScore, mDifficulty, mFirstSection,
+                             mFirstObstacle, mObstacleCount, mMenu, mMenuSel, mSteering,
+                             mBonusInARow};
+    const float motion[] = {mPlayerPos.x, mPlayerPos.y, mPlayerPos.z, mPlayerSpeed,
+                            mRollAngle, mFilteredSteerX, mFilteredSteerZ};
+    uint32_t hash = 2166136261u;
+    hash = _hash_bytes(hash, state, sizeof(state));
+    hash = _hash_bytes(hash, motion, sizeof(motion));
+    for (int i = 0; i < mObstacleCount; ++i) {
+        const Obstacle &o = mObstacleCircBuf[(mFirstObstacle + i) % MAX_OBS];
+        const int32_t obstacle[] = {(int32_t) o.mask, o.style, o.bonusRow, o.bonusCol};
+        hash = _hash_bytes(hash, obstacle, sizeof(obstacle));
+    }
+    return hash;
+}
+
 void PlayScene::UpdateProjectionMatrix() {
     SceneManager *mgr = SceneManager::GetInstance();
     mProjMat = glm::perspective(RENDER_FOV, mgr->GetScreenAspect(), RENDER_NEAR_CLIP,
@@ -18,6 +18,8 @@
 #define agdktunnel_play_scene_h
 
 #include "engine.hpp"
+#include "frustum_culler.hpp"
+#include "mvp_batch.hpp"
 #include "obstacle_generator.hpp"
 #include "obstacle.hpp"
 #include "sfxman.hpp"
@@ -39,6 +41,14 @@ public:
 
     PlayScene(int savedLevel);
 
+    virtual ~PlayScene();
+
+    virtual void OnPreload();
+
+    virtual void OnInstall();
+
+    virtual void OnUninstall();
+
     virtual void OnStartGraphics();
 
     virtual void OnKillGraphics();
@@ -55,6 +65,13 @@ public:
 
     virtual void OnScreenResized(int width, int height);
 
+    virtual bool WantsRenderThread();
+
+    virtual uint32_t GetStateChecksum();
+
+    // Sets the rate of the fixed simulation steps, independent of the frame rate
+    void SetSimTickRate(float ticksPerSecond);
+
     virtual void OnJoy(float joyX, float joyY);
 
     virtual void OnKeyDown(int keyCode);
@@ -74,6 +91,10 @@ protected:
     // shape and text renderers we use when rendering the HUD
     ShapeRenderer *mShapeRenderer;
     TextRenderer *mTextRenderer;
+
+    // uniform buffer of the text renderer, looked up on the game thread when the
+    // scene is created so OnPreload doesn't touch the GfxManager
+    std::shared_ptr<simple_renderer::UniformBuffer> mTextUniformBuffer;
 #ifdef TOUCH_INDICATOR_MODE
     // Flat color rectangle for latency measurement
     ShapeRenderer *mRectRenderer;
@@ -126,6 +147,27 @@ protected:
     // obstacle generator
     ObstacleGenerator mObstacleGen;
 
+    // an obstacle box (or bonus) selected for rendering, identified by the
+    // obstacle index and grid cell
+    struct ObstacleBox {
+        int obstacle;
+        int col;
+        int row;
+        bool isBonus;
+    };
+
+    // visibility culling of the tunnel sections and obstacle boxes: CullScene
+    // fills the visible lists that RenderTunnel and RenderObstacles draw
+    FrustumCuller mCuller;
+    std::vector<uint32_t> mCullResults;
+    std::vector<ObstacleBox> mCandidateBoxes;
+    std::vector<int> mVisibleSections;
+    std::vector<ObstacleBox> mVisibleBoxes;
+
+    // model transforms and MVPs of the visible boxes, built in one batch
+    std::vector<ModelTransform> mBoxTransforms;
+    std::vector<glm::mat4> mBoxMvps;
+
     // touch pointer ID and anchor position (where touch started)
     static const int STEERING_NONE = 0, STEERING_TOUCH = 1, STEERING_JOY = 2, STEERING_KEY = 3;
     int mSteering;  // is player steering at the moment? If so, how?
@@ -146,6 +188,14 @@ protected:
     // update stuff properly
     DeltaClock mFrameClock;
 
+    // the simulation advances in fixed steps of mSimStep seconds, mSimAccumulator holds
+    // the time not simulated yet. Frames render the player interpolated between its
+    // state before the last step (mPrev*) and its current state.
+    float mSimStep;
+    float mSimAccumulator;
+    glm::vec3 mPrevPlayerPos;
+    float mPrevRollAngle;
+
     // sign (string) that we're currently showing (NULL if none)
     const char *mSignText;
     bool mSignExpires; // does the sign expire after a while?
@@ -232,9 +282,15 @@ protected:
         SetScore(GetScore() + s);
     }
 
+    // builds the text renderer and caches the text of the menus and signs
+    void CreateTextRenderer();
+
     // generate new obstacles as needed
     void GenObstacles();
 
+    // culls the tunnel sections and obstacle boxes against the view frustum
+    void CullScene();
+
     // renders the tunnel walls
     void RenderTunnel(GfxManager *gfxManager);
 
@@ -247,6 +303,9 @@ protected:
     // renders the currently active menu
     void RenderMenu(GfxManager *gfxManager);
 
+    // advance the game by one fixed simulation step
+    void StepSimulation(float deltaT);
+
     // Shift tunnel sections if needed (this means discarding the ones the
     // player has already past and generating the obstacles for the new ones
     // that came into view)
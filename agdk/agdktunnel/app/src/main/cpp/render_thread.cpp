@@ -0,0 +1,211 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render_thread.hpp"
+#include "common.hpp"
+
+#include <algorithm>
+
+using namespace base_game_framework;
+using namespace simple_renderer;
+
+static RenderThread _renderThread;
+
+RenderThread *RenderThread::GetInstance() {
+  return &_renderThread;
+}
+
+RenderThread::RenderThread() {
+  for (int i = 0; i < FRAME_COUNT; ++i) {
+    mFreeFrames.push_back(&mFrames[i]);
+  }
+  mRecordingFrame = NULL;
+  mReleaseContext = false;
+  mQuit = false;
+  // The graphics context starts out current on the thread that created the swapchain
+  mGameThreadHasContext = true;
+  mRenderThreadHasContext = false;
+  mEnabled = false;
+  mLastExecuteTime = 0;
+  memset(mLatencies, 0, sizeof(mLatencies));
+  mLatencyCount = 0;
+  mLatencyIndex = 0;
+}
+
+RenderThread::~RenderThread() {
+  MY_ASSERT(!mThread.joinable());
+}
+
+void RenderThread::SetEnabled(bool enabled) {
+  MY_ASSERT(mRecordingFrame == NULL);
+  if (enabled == mEnabled) {
+    return;
+  }
+  ALOGI("RenderThread: %s.", enabled ? "enabled" : "disabled");
+  if (!enabled) {
+    Sync();
+  }
+  mEnabled = enabled;
+}
+
+bool RenderThread::IsRenderThread() const {
+  return mThread.joinable() && std::this_thread::get_id() == mThread.get_id();
+}
+
+void RenderThread::BeginFrame() {
+  MY_ASSERT(mRecordingFrame == NULL);
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCondition.wait(lock, [this] { return !mFreeFrames.empty(); });
+    mRecordingFrame = mFreeFrames.front();
+    mFreeFrames.pop_front();
+  }
+  mRecordingFrame->mRecordStart = std::chrono::steady_clock::now();
+}
+
+void RenderThread::SubmitFrame(DisplayManager::SwapchainHandle swapchainHandle, bool present) {
+  MY_ASSERT(mRecordingFrame != NULL);
+  Frame *frame = mRecordingFrame;
+  mRecordingFrame = NULL;
+  frame->mSwapchainHandle = swapchainHandle;
+  frame->mPresent = present;
+
+  if (!mEnabled) {
+    ExecuteFrame(*frame);
+    std::lock_guard<std::mutex> lock(mMutex);
+    mFreeFrames.push_back(frame);
+    return;
+  }
+
+  if (mGameThreadHasContext) {
+    Renderer::GetInstance().ReleaseThreadContext();
+    mGameThreadHasContext = false;
+  }
+  if (!mThread.joinable()) {
+    ALOGI("RenderThread: starting render thread.");
+    mThread = std::thread(&RenderThread::ThreadMain, this);
+  }
+  std::lock_guard<std::mutex> lock(mMutex);
+  mQueuedFrames.push_back(frame);
+  mCondition.notify_all();
+}
+
+void RenderThread::Sync() {
+  MY_ASSERT(!IsRenderThread());
+  if (mGameThreadHasContext) {
+    // Nothing was submitted to the render thread since the last sync
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mReleaseContext = true;
+    mCondition.notify_all();
+    mCondition.wait(lock, [this] { return !mReleaseContext; });
+  }
+  Renderer::GetInstance().AcquireThreadContext();
+  mGameThreadHasContext = true;
+}
+
+void RenderThread::Shutdown() {
+  if (!mThread.joinable()) {
+    return;
+  }
+  Sync();
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mQuit = true;
+    mCondition.notify_all();
+  }
+  mThread.join();
+  ALOGI("RenderThread: render thread stopped.");
+}
+
+void RenderThread::ThreadMain() {
+  std::unique_lock<std::mutex> lock(mMutex);
+  while (true) {
+    mCondition.wait(lock, [this] {
+      return mQuit || mReleaseContext || !mQueuedFrames.empty();
+    });
+
+    if (!mQueuedFrames.empty()) {
+      Frame *frame = mQueuedFrames.front();
+      mQueuedFrames.pop_front();
+      lock.unlock();
+      if (!mRenderThreadHasContext) {
+        Renderer::GetInstance().AcquireThreadContext();
+        mRenderThreadHasContext = true;
+      }
+      ExecuteFrame(*frame);
+      lock.lock();
+      mFreeFrames.push_back(frame);
+      mCondition.notify_all();
+    } else if (mReleaseContext) {
+      // Only reached once every queued frame has been presented
+      if (mRenderThreadHasContext) {
+        Renderer::GetInstance().ReleaseThreadContext();
+        mRenderThreadHasContext = false;
+      }
+      mReleaseContext = false;
+      mCondition.notify_all();
+    } else if (mQuit) {
+      break;
+    }
+  }
+}
+
+void RenderThread::ExecuteFrame(Frame &frame) {
+  Renderer &renderer = Renderer::GetInstance();
+  {
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    renderer.BeginFrame(frame.mSwapchainHandle);
+  }
+  // Renderer::BeginFrame waits for the frame fence and the swapchain image, only
+  // time the work after it
+  const auto executeStart = std::chrono::steady_clock::now();
+  frame.mCommands.Execute(renderer);
+  renderer.EndFrame();
+  const std::chrono::nanoseconds executeTime = std::chrono::steady_clock::now() - executeStart;
+  mLastExecuteTime = static_cast<uint64_t>(executeTime.count());
+
+  if (frame.mPresent) {
+    DisplayManager::GetInstance().PresentCurrentSwapchainFrame(frame.mSwapchainHandle);
+  }
+  // Release the resource references on a thread with the graphics context
+  frame.mCommands.Reset();
+
+  const std::chrono::nanoseconds latency = std::chrono::steady_clock::now() - frame.mRecordStart;
+  std::lock_guard<std::mutex> lock(mLatencyMutex);
+  mLatencies[mLatencyIndex] = static_cast<uint64_t>(latency.count());
+  mLatencyIndex = (mLatencyIndex + 1) % RENDER_THREAD_LATENCY_FRAMES;
+  mLatencyCount = std::min(mLatencyCount + 1, RENDER_THREAD_LATENCY_FRAMES);
+}
+
+RenderThread::LatencyStats RenderThread::GetLatencyStats() {
+  LatencyStats stats = {0.0f, 0.0f};
+  std::lock_guard<std::mutex> lock(mLatencyMutex);
+  if (mLatencyCount == 0) {
+    return stats;
+  }
+  uint64_t total = 0;
+  uint64_t maxLatency = 0;
+  for (int i = 0; i < mLatencyCount; ++i) {
+    total += mLatencies[i];
+    maxLatency = std::max(maxLatency, mLatencies[i]);
+  }
+  stats.avg = static_cast<float>(total / mLatencyCount) / 1000000.0f;
+  stats.max = static_cast<float>(maxLatency) / 1000000.0f;
+  return stats;
+}
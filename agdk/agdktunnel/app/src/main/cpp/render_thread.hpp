@@ -0,0 +1,142 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef agdktunnel_render_thread_hpp
+#define agdktunnel_render_thread_hpp
+
+#include "display_manager.h"
+#include "game_consts.hpp"
+#include "simple_renderer/renderer_command_list.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// Executes recorded frames on a dedicated render thread, so the game thread can
+// update and record frame N + 1 while frame N is submitted to the GPU and presented.
+// Every frame is recorded into a CommandList, between BeginFrame and SubmitFrame.
+// When the render thread is disabled the submitted frame is executed and presented
+// right away on the calling thread, which is the same as rendering without a
+// render thread.
+//
+// While the render thread is enabled, the game thread must not use the renderer
+// directly: call Sync before creating or destroying resources, changing render
+// targets or touching the swapchain. Sync waits for the queued frames and moves the
+// graphics context back to the calling thread until the next submitted frame.
+class RenderThread {
+ public:
+  // Latency from the start of recording a frame to its presentation, in milliseconds
+  struct LatencyStats {
+    float avg;
+    float max;
+  };
+
+  // returns the (singleton) instance
+  static RenderThread *GetInstance();
+
+  RenderThread();
+  ~RenderThread();
+
+  // Enable or disable executing frames on the render thread, call from the game
+  // thread outside of BeginFrame/SubmitFrame. Disabling syncs.
+  void SetEnabled(bool enabled);
+  bool IsEnabled() const { return mEnabled; }
+
+  // Returns true if called from the render thread
+  bool IsRenderThread() const;
+
+  // Start recording a frame. Waits if RENDER_THREAD_QUEUED_FRAMES frames are
+  // already waiting to be rendered.
+  void BeginFrame();
+
+  // The command list the current frame is recorded into, only valid between
+  // BeginFrame and SubmitFrame
+  simple_renderer::CommandList &GetCommandList() { return mRecordingFrame->mCommands; }
+
+  // Queue the recorded frame to be rendered and presented to the swapchain. A frame
+  // submitted with present set to false is rendered but not presented.
+  void SubmitFrame(base_game_framework::DisplayManager::SwapchainHandle swapchainHandle,
+                   bool present = true);
+
+  // Wait until every submitted frame has been presented, and make the graphics
+  // context current on the calling thread
+  void Sync();
+
+  // Present the queued frames and stop the render thread
+  void Shutdown();
+
+  // Renderer::BeginFrame updates the statistics history on the render thread, hold
+  // this lock while reading RendererStats from another thread
+  std::mutex &GetStatsMutex() { return mStatsMutex; }
+
+  // CPU time of executing the last frame through the renderer, excluding the wait for
+  // the frame fence and swapchain image in Renderer::BeginFrame and the present, in
+  // nanoseconds
+  uint64_t GetLastExecuteTime() const { return mLastExecuteTime.load(); }
+
+  // Latency of the last RENDER_THREAD_LATENCY_FRAMES presented frames
+  LatencyStats GetLatencyStats();
+
+ private:
+  struct Frame {
+    simple_renderer::CommandList mCommands;
+    base_game_framework::DisplayManager::SwapchainHandle mSwapchainHandle;
+    bool mPresent;
+    std::chrono::steady_clock::time_point mRecordStart;
+  };
+
+  // One frame recording, the others queued or executing
+  static constexpr int FRAME_COUNT = RENDER_THREAD_QUEUED_FRAMES + 1;
+
+  void ThreadMain();
+
+  void ExecuteFrame(Frame &frame);
+
+  std::thread mThread;
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  std::mutex mStatsMutex;
+
+  Frame mFrames[FRAME_COUNT];
+  std::deque<Frame *> mFreeFrames;
+  std::deque<Frame *> mQueuedFrames;
+  Frame *mRecordingFrame;
+
+  // Requests from the game thread, protected by mMutex
+  bool mReleaseContext;
+  bool mQuit;
+
+  // Which thread currently has the graphics context, each only touched by its thread
+  bool mGameThreadHasContext;
+  bool mRenderThreadHasContext;
+
+  bool mEnabled;
+
+  std::atomic<uint64_t> mLastExecuteTime;
+
+  // Ring of the latencies of recently presented frames, in nanoseconds,
+  // protected by mLatencyMutex
+  std::mutex mLatencyMutex;
+  uint64_t mLatencies[RENDER_THREAD_LATENCY_FRAMES];
+  int mLatencyCount;
+  int mLatencyIndex;
+};
+
+#endif // agdktunnel_render_thread_hpp
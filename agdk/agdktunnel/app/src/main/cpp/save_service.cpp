@@ -0,0 +1,154 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "save_service.hpp"
+#include "common.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+SaveService::SaveService(const char *saveFileName) {
+    mSaveFileName = saveFileName;
+    mTempFileName = mSaveFileName + ".tmp";
+    size_t slash = mSaveFileName.find_last_of('/');
+    mSaveDirName = slash == std::string::npos ? "." : mSaveFileName.substr(0, slash);
+    mIsActive = true;
+    mHasPending = false;
+    mIsWriting = false;
+    mPending.level = 0;
+    mCoalescedCount = 0;
+    mHasCompletion = false;
+    mThread = std::thread([this]() { ThreadMain(); });
+}
+
+SaveService::~SaveService() {
+    {
+        std::lock_guard<std::mutex> lock(mWorkMutex);
+        mIsActive = false;
+    }
+    mWorkCondition.notify_all();
+    mThread.join();
+}
+
+void SaveService::RequestSave(const SaveSnapshot &snapshot) {
+    {
+        std::lock_guard<std::mutex> lock(mWorkMutex);
+        if (mHasPending) {
+            ++mCoalescedCount;
+        }
+        mPending = snapshot;
+        mHasPending = true;
+    }
+    mWorkCondition.notify_one();
+}
+
+bool SaveService::PollCompletion(SaveCompletion *completion) {
+    std::lock_guard<std::mutex> lock(mWorkMutex);
+    if (!mHasCompletion) {
+        return false;
+    }
+    *completion = mCompletion;
+    mHasCompletion = false;
+    return true;
+}
+
+void SaveService::WaitForIdle() {
+    std::unique_lock<std::mutex> lock(mWorkMutex);
+    mIdleCondition.wait(lock, [this]() { return !mHasPending && !mIsWriting; });
+}
+
+void SaveService::ThreadMain() {
+    pthread_setname_np(pthread_self(), "SaveService");
+
+    std::unique_lock<std::mutex> lock(mWorkMutex);
+    for (;;) {
+        mWorkCondition.wait(lock, [this]() { return mHasPending || !mIsActive; });
+        if (!mHasPending) {
+            // inactive with nothing left to write
+            break;
+        }
+
+        SaveCompletion completion;
+        completion.snapshot = mPending;
+        completion.coalescedCount = mCoalescedCount;
+        mHasPending = false;
+        mCoalescedCount = 0;
+        mIsWriting = true;
+
+        // Drop the mutex while we write, so new requests never wait for storage
+        lock.unlock();
+        completion.success = WriteSnapshot(completion.snapshot);
+        lock.lock();
+
+        // The game thread may not poll for a while (e.g. without a display), only
+        // the latest completion matters: it describes what is in the file now
+        if (mHasCompletion) {
+            completion.coalescedCount += mCompletion.coalescedCount + 1;
+        }
+        mCompletion = completion;
+        mHasCompletion = true;
+
+        mIsWriting = false;
+        if (!mHasPending) {
+            mIdleCondition.notify_all();
+        }
+    }
+}
+
+static bool WriteAll(int fd, const char *data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool SaveService::WriteSnapshot(const SaveSnapshot &snapshot) {
+    char contents[32];
+    int length = snprintf(contents, sizeof(contents), "v1 %d", snapshot.level);
+
+    int fd = open(mTempFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        ALOGE("SaveService: error creating %s (errno %d)", mTempFileName.c_str(), errno);
+        return false;
+    }
+    bool ok = WriteAll(fd, contents, static_cast<size_t>(length)) && fsync(fd) == 0;
+    if (close(fd) != 0) {
+        ok = false;
+    }
+    if (!ok || rename(mTempFileName.c_str(), mSaveFileName.c_str()) != 0) {
+        ALOGE("SaveService: error writing %s (errno %d)", mSaveFileName.c_str(), errno);
+        unlink(mTempFileName.c_str());
+        return false;
+    }
+
+    // Make the rename itself durable
+    int dirFd = open(mSaveDirName.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        close(dirFd);
+    }
+    return true;
+}
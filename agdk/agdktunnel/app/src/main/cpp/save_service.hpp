@@ -0,0 +1,91 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef agdktunnel_save_service_hpp
+#define agdktunnel_save_service_hpp
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Everything written to the save file, copied by value when a save is requested
+// so the game can keep changing its own state while the copy is written
+struct SaveSnapshot {
+    int level;
+};
+
+struct SaveCompletion {
+    SaveSnapshot snapshot;
+    // false if the file could not be written, the previous save is then left intact
+    bool success;
+    // number of earlier requests replaced by this snapshot, before they were written
+    // or before their completion was polled
+    uint32_t coalescedCount;
+};
+
+// Writes save snapshots to storage on a background thread. The file is replaced
+// atomically (write a temporary file, fsync it, then rename it over the save file),
+// so a crash or power loss leaves either the old or the new save, never a partial
+// one. A request made while an earlier one is still waiting replaces it, only
+// the latest snapshot matters.
+class SaveService {
+public:
+    SaveService(const char *saveFileName);
+
+    // Writes the pending snapshot, if any, before stopping the thread
+    ~SaveService();
+
+    // Game thread. Never waits for storage, the writer thread only holds the
+    // lock to pick up or hand over a snapshot.
+    void RequestSave(const SaveSnapshot &snapshot);
+
+    // Game thread. Returns false when no save finished since the last call. Like
+    // requests, completions not polled yet are replaced by the latest one.
+    bool PollCompletion(SaveCompletion *completion);
+
+    // Blocks until every requested snapshot has been written, so a following
+    // load reads the latest save. Not to be called during gameplay.
+    void WaitForIdle();
+
+private:
+    void ThreadMain();
+
+    bool WriteSnapshot(const SaveSnapshot &snapshot);
+
+    std::string mSaveFileName;
+    std::string mTempFileName;
+    std::string mSaveDirName;
+
+    std::thread mThread;
+
+    std::mutex mWorkMutex;
+    std::condition_variable mWorkCondition;
+    std::condition_variable mIdleCondition;
+    bool mIsActive;
+    bool mHasPending;
+    bool mIsWriting;
+    SaveSnapshot mPending;
+    uint32_t mCoalescedCount;
+
+    // latest finished save, set by the writer thread and taken by the game thread
+    bool mHasCompletion;
+    SaveCompletion mCompletion;
+};
+
+#endif // agdktunnel_save_service_hpp
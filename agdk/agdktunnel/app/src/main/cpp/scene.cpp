@@ -19,6 +19,8 @@
 // These are all stubs. Subclasses should override to implement their
 // specific functionality.
 
+void Scene::OnPreload() {}
+
 void Scene::OnInstall() {}
 
 void Scene::DoFrame() {}
@@ -53,4 +55,8 @@ void Scene::OnTextInput() {}
 
 void Scene::SetInputSdkContext() {}
 
+bool Scene::WantsRenderThread() { return false; }
+
+uint32_t Scene::GetStateChecksum() { return 0; }
+
 Scene::~Scene() {}
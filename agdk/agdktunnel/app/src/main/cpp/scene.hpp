@@ -17,6 +17,8 @@
 #ifndef agdktunnel_scene_hpp
 #define agdktunnel_scene_hpp
 
+#include <cstdint>
+
 struct PointerCoords;
 
 /* Represents a scene. A scene is an object that knows how to render itself to the
@@ -25,6 +27,12 @@ struct PointerCoords;
  * screen and how input is handled. See also: SceneManager */
 class Scene {
 public:
+    // Called on a worker thread once the scene has been requested, while the
+    // previous scene keeps running; the scene is installed when this returns. Build
+    // the CPU side of resources here (meshes, tables) for OnStartGraphics to upload.
+    // Must not use the renderer nor state owned by the game thread.
+    virtual void OnPreload();
+
     // Called when graphics context is initialized. This is when textures,
     // geometry, etc should be initialized.
     virtual void OnStartGraphics();
@@ -78,6 +86,15 @@ public:
     // Called when installing the scene to specify the controls of the scene
     virtual void SetInputSdkContext();
 
+    // Return true to render the frames of the scene on the render thread. The
+    // scene must then only create or destroy graphics resources in OnStartGraphics,
+    // OnKillGraphics and OnScreenResized, see RenderThread.
+    virtual bool WantsRenderThread();
+
+    // Returns a checksum of the simulation state at the end of the frame, which lets
+    // InputReplay detect a playback diverging from the recording.
+    virtual uint32_t GetStateChecksum();
+
     // Destructor
     virtual ~Scene();
 };
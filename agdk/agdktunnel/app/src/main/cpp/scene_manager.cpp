@@ -15,8 +15,10 @@
  */
 
 #include "common.hpp"
+#include "input_replay.hpp"
 #include "scene.hpp"
 #include "scene_manager.hpp"
+#include "render_thread.hpp"
 
 static SceneManager _sceneManager;
 
@@ -29,17 +31,48 @@ SceneManager::SceneManager() {
     mRotationMatrix = glm::mat4(1.0f);
 
     mSceneToInstall = NULL;
+    mPreloadDone = false;
 
     mHasGraphics = false;
 }
 
 void SceneManager::PrepareShutdown() {
+    // drop the scene that was about to be installed
+    if (mSceneToInstall) {
+        FinishPreload();
+        delete mSceneToInstall;
+        mSceneToInstall = NULL;
+    }
     InstallScene(NULL);
 }
 
 void SceneManager::RequestNewScene(Scene *newScene) {
+    if (mSceneToInstall) {
+        // Scenes keep requesting their successor every frame until it replaces them,
+        // the first request wins
+        ALOGI("SceneManager: scene %p already requested, dropping %p", mSceneToInstall,
+              newScene);
+        delete newScene;
+        return;
+    }
+    if (!newScene) {
+        return;
+    }
+
     ALOGI("SceneManager: requesting new scene %p", newScene);
     mSceneToInstall = newScene;
+    mPreloadDone = false;
+    mPreloadThread = std::thread([this, newScene]() {
+        pthread_setname_np(pthread_self(), "ScenePreload");
+        newScene->OnPreload();
+        mPreloadDone = true;
+    });
+}
+
+void SceneManager::FinishPreload() {
+    if (mPreloadThread.joinable()) {
+        mPreloadThread.join();
+    }
 }
 
 void SceneManager::InstallScene(Scene *newScene) {
@@ -77,16 +110,27 @@ Scene *SceneManager::GetScene() {
 }
 
 void SceneManager::DoFrame() {
-    if (mSceneToInstall) {
-        InstallScene(mSceneToInstall);
+    if (mSceneToInstall && mPreloadDone) {
+        FinishPreload();
+        // the scenes create and destroy their graphics resources
+        RenderThread::GetInstance()->Sync();
+        Scene *newScene = mSceneToInstall;
         mSceneToInstall = NULL;
+        InstallScene(newScene);
     }
 
     if (mHasGraphics && mCurScene) {
+        InputReplay *replay = InputReplay::GetInstance();
+        replay->BeginFrame();
         mCurScene->DoFrame();
+        replay->EndFrame(mCurScene->GetStateChecksum());
     }
 }
 
+bool SceneManager::WantsRenderThread() {
+    return mHasGraphics && mCurScene && mCurScene->WantsRenderThread();
+}
+
 void SceneManager::KillGraphics() {
     if (mHasGraphics) {
         ALOGI("SceneManager: killing graphics.");
@@ -125,24 +169,39 @@ SceneManager *SceneManager::GetInstance() {
 }
 
 void SceneManager::OnPointerDown(int pointerId, const struct PointerCoords *coords) {
+    if (!InputReplay::GetInstance()->FilterPointerEvent(InputReplay::EVENT_POINTER_DOWN,
+            pointerId, coords)) {
+        return;
+    }
     if (mHasGraphics && mCurScene) {
         mCurScene->OnPointerDown(pointerId, coords);
     }
 }
 
 void SceneManager::OnPointerUp(int pointerId, const struct PointerCoords *coords) {
+    if (!InputReplay::GetInstance()->FilterPointerEvent(InputReplay::EVENT_POINTER_UP,
+            pointerId, coords)) {
+        return;
+    }
     if (mHasGraphics && mCurScene) {
         mCurScene->OnPointerUp(pointerId, coords);
     }
 }
 
 void SceneManager::OnPointerMove(int pointerId, const struct PointerCoords *coords) {
+    if (!InputReplay::GetInstance()->FilterPointerEvent(InputReplay::EVENT_POINTER_MOVE,
+            pointerId, coords)) {
+        return;
+    }
     if (mHasGraphics && mCurScene) {
         mCurScene->OnPointerMove(pointerId, coords);
     }
 }
 
 bool SceneManager::OnBackKeyPressed() {
+    if (!InputReplay::GetInstance()->FilterEvent(InputReplay::EVENT_BACK_KEY)) {
+        return false;
+    }
     if (mHasGraphics && mCurScene) {
         return mCurScene->OnBackKeyPressed();
     }
@@ -150,6 +209,9 @@ bool SceneManager::OnBackKeyPressed() {
 }
 
 void SceneManager::OnKeyDown(int ourKeyCode) {
+    if (!InputReplay::GetInstance()->FilterKeyEvent(InputReplay::EVENT_KEY_DOWN, ourKeyCode)) {
+        return;
+    }
     if ((ourKeyCode >= 0 && ourKeyCode < OURKEY_COUNT &&
             mHasGraphics && mCurScene)) {
         mCurScene->OnKeyDown(ourKeyCode);
@@ -163,6 +225,9 @@ void SceneManager::OnKeyDown(int ourKeyCode) {
 }
 
 void SceneManager::OnKeyUp(int ourKeyCode) {
+    if (!InputReplay::GetInstance()->FilterKeyEvent(InputReplay::EVENT_KEY_UP, ourKeyCode)) {
+        return;
+    }
     if ((ourKeyCode >= 0 && ourKeyCode < OURKEY_COUNT &&
             mHasGraphics && mCurScene)) {
         mCurScene->OnKeyUp(ourKeyCode);
@@ -170,18 +235,27 @@ void SceneManager::OnKeyUp(int ourKeyCode) {
 }
 
 void SceneManager::UpdateJoy(float joyX, float joyY) {
+    if (!InputReplay::GetInstance()->FilterJoyEvent(joyX, joyY)) {
+        return;
+    }
     if (mHasGraphics && mCurScene) {
         mCurScene->OnJoy(joyX, joyY);
     }
 }
 
 void SceneManager::OnPause() {
+    if (!InputReplay::GetInstance()->FilterEvent(InputReplay::EVENT_PAUSE)) {
+        return;
+    }
     if (mHasGraphics && mCurScene) {
         mCurScene->OnPause();
     }
 }
 
 void SceneManager::OnResume() {
+    if (!InputReplay::GetInstance()->FilterEvent(InputReplay::EVENT_RESUME)) {
+        return;
+    }
     if (mCurScene) {
         mCurScene->OnResume();
     }
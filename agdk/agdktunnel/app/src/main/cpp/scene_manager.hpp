@@ -21,6 +21,9 @@
 #include "our_key_codes.hpp"
 #include "input_util.hpp"
 
+#include <atomic>
+#include <thread>
+
 class Scene;
 
 struct PointerCoords {
@@ -45,8 +48,15 @@ private:
     bool mHasGraphics;
     Scene *mSceneToInstall;
 
+    // runs mSceneToInstall->OnPreload, mPreloadDone is set when it returns
+    std::thread mPreloadThread;
+    std::atomic<bool> mPreloadDone;
+
     void InstallScene(Scene *newScene);
 
+    // waits for the preload of mSceneToInstall to finish
+    void FinishPreload();
+
 public:
     SceneManager();
 
@@ -88,6 +98,9 @@ public:
     // Renders current scene
     void DoFrame();
 
+    // Returns true if the current scene renders on the render thread
+    bool WantsRenderThread();
+
     // Reports that a pointer (e.g. touchscreen, touchpad, etc) went down
     void OnPointerDown(int pointerId, const struct PointerCoords *coords);
 
@@ -118,9 +131,16 @@ public:
     void OnTextInput();
 
     // Requests that a new scene be installed, replacing the currently active
-    // scene. The new scene will be installed on the next DoFrame() call.
+    // scene. The new scene is preloaded in the background and installed by the
+    // first DoFrame() call after its preload completes, the current scene keeps
+    // running until then. Further requests made before that are dropped.
     void RequestNewScene(Scene *newScene);
 
+    // Returns true while a requested scene is waiting to be installed
+    bool IsSceneRequested() {
+        return mSceneToInstall != NULL;
+    }
+
     // Returns the (singleton) instance of SceneManager.
     static SceneManager *GetInstance();
 };
@@ -14,19 +14,26 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <random>
 #include "sfxman.hpp"
 
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SFXMAN_MIX_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SFXMAN_MIX_SSE2
+#endif
+
 #define MAX_SAMPLES_PER_SEC 48000 // was 8000
 #define BUF_SAMPLES_MAX MAX_SAMPLES_PER_SEC*5 // 5 seconds
 #define DEFAULT_VOLUME 0.9f
 
 static SfxMan *_instance = new SfxMan();
-static volatile int32_t _frameCount = 0;
-static volatile int32_t _frameCursor = 0;
-static volatile int32_t _sampleRate = 0;
+static int32_t _sampleRate = 0;
+// scratch buffer of the synthesis thread
 static int16_t _sample_buf[BUF_SAMPLES_MAX];
-static volatile bool _bufferActive = false;
 
 
 SfxMan *SfxMan::GetInstance() {
@@ -34,6 +41,14 @@ SfxMan *SfxMan::GetInstance() {
 }
 
 SfxMan::SfxMan() {
+    mInitOk = false;
+    mSynthQuit = false;
+    mNextVoiceId = 0;
+    for (int i = 0; i < SFX_MAX_VOICES; ++i) {
+        mVoices[i].tone = NULL;
+    }
+    mActiveVoiceCount = 0;
+
     oboe::AudioStreamBuilder audioStreamBuilder;
     audioStreamBuilder.setChannelCount(oboe::ChannelCount::Mono);
     audioStreamBuilder.setDataCallback(this);
@@ -44,17 +59,19 @@ SfxMan::SfxMan() {
     oboe::Result result = audioStreamBuilder.openStream(mAudioStream);
     if (result == oboe::Result::OK) {
         ALOGI("SfxMan: initialization complete.");
-        result = mAudioStream->requestStart();
-        if (result == oboe::Result::OK) {
-            _sampleRate = mAudioStream->getSampleRate();
-            if (_sampleRate <= MAX_SAMPLES_PER_SEC && _sampleRate != oboe::kUnspecified) {
-                ALOGI("Audio stream sample rate: %d Hz", _sampleRate);
+        _sampleRate = mAudioStream->getSampleRate();
+        if (_sampleRate <= MAX_SAMPLES_PER_SEC && _sampleRate != oboe::kUnspecified) {
+            ALOGI("Audio stream sample rate: %d Hz", _sampleRate);
+            // the sample rate must be known before synthesizing anything
+            mSynthThread = std::thread(&SfxMan::SynthThreadMain, this);
+            result = mAudioStream->requestStart();
+            if (result == oboe::Result::OK) {
                 mInitOk = true;
             } else {
-                ALOGE("Audio stream has unspecified or too high sample rate.");
+                ALOGE("Failed to start audio stream. Error: %s", oboe::convertToText(result));
             }
         } else {
-            ALOGE("Failed to start audio stream. Error: %s", oboe::convertToText(result));
+            ALOGE("Audio stream has unspecified or too high sample rate.");
         }
     } else {
         ALOGE("Failed to create audio stream. Error: %s", oboe::convertToText(result));
@@ -67,10 +84,18 @@ SfxMan::~SfxMan() {
         mAudioStream->close();
         mInitOk = false;
     }
+    if (mSynthThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mSynthMutex);
+            mSynthQuit = true;
+        }
+        mSynthCondition.notify_all();
+        mSynthThread.join();
+    }
 }
 
 bool SfxMan::IsIdle() {
-    return !_bufferActive;
+    return mActiveVoiceCount.load(std::memory_order_relaxed) == 0 && mCommands.IsEmpty();
 }
 
 static const char *_parseInt(const char *s, int *result) {
@@ -82,7 +107,8 @@ static const char *_parseInt(const char *s, int *result) {
     return s;
 }
 
-static int _synth(int frequency, int /*duration*/, float amplitude, int16_t *sample_buf, int samples) {
+static int _synth(int frequency, int /*duration*/, float amplitude, int16_t *sample_buf, int samples,
+                  std::minstd_rand &noise) {
     int i;
 
     for (i = 0; i < samples; i++) {
@@ -92,8 +118,7 @@ static int _synth(int frequency, int /*duration*/, float amplitude, int16_t *sam
             v = amplitude * sin(frequency * t * 2 * M_PI) +
                 (amplitude * 0.1f) * sin(frequency * 2 * t * 2 * M_PI);
         } else {
-            int r = rand();
-            r = r > 0 ? r : -r;
+            int r = (int) noise();
             v = amplitude * (-0.5f + (r % 1024) / 512.0f);
         }
         int value = (int) (v * 32768.0f);
@@ -128,24 +153,15 @@ static void _taper(int16_t *sample_buf, int samples) {
     }
 }
 
-void SfxMan::PlayTone(const char *tone) {
-    if (!mInitOk) {
-        ALOGW("SfxMan: not playing sound because initialization failed.");
-        return;
-    }
-    if (_bufferActive) {
-        // can't play -- the buffer is in use
-        ALOGW("SfxMan: can't play tone; buffer is active.");
-        return;
-    }
-
-    // synth the tone
+// Synthesizes a recipe (see SfxMan::PlayTone) into _sample_buf, returns the sample count
+static int _synthRecipe(const char *tone) {
     int total_samples = 0;
     int num_samples;
     int frequency = 100;
     int duration = 50;
     int volume_int;
     float amplitude = DEFAULT_VOLUME;
+    std::minstd_rand noise;
 
     while (*tone) {
         switch (*tone) {
@@ -170,7 +186,7 @@ void SfxMan::PlayTone(const char *tone) {
                     num_samples = BUF_SAMPLES_MAX - total_samples - 1;
                 }
                 num_samples = _synth(frequency, duration, amplitude, _sample_buf + total_samples,
-                                     num_samples);
+                                     num_samples, noise);
                 total_samples += num_samples;
                 tone++;
                 break;
@@ -180,46 +196,194 @@ void SfxMan::PlayTone(const char *tone) {
         }
     }
 
-    int total_size = total_samples * sizeof(int16_t);
-    if (total_size <= 0) {
-        ALOGW("Tone is empty. Not playing.");
-        return;
+    _taper(_sample_buf, total_samples);
+    return total_samples;
+}
+
+static int16_t _volumeToQ15(float volume) {
+    volume = volume < 0.0f ? 0.0f : volume > 1.0f ? 1.0f : volume;
+    return (int16_t) (volume * 32767.0f);
+}
+
+// Adds count samples scaled by volume (Q15) to out, saturating to the int16 range
+static void _mixSaturate(int16_t *out, const int16_t *in, int count, int16_t volume) {
+    int i = 0;
+#if defined(SFXMAN_MIX_NEON)
+    for (; i + 8 <= count; i += 8) {
+        const int16x8_t scaled = vqrdmulhq_n_s16(vld1q_s16(in + i), volume);
+        vst1q_s16(out + i, vqaddq_s16(vld1q_s16(out + i), scaled));
+    }
+#elif defined(SFXMAN_MIX_SSE2)
+    // mulhi drops the low 16 bits of the product, scale by twice the volume instead
+    // of Q15, which loses the lowest bit of the result
+    const __m128i volume2 = _mm_set1_epi16(volume);
+    for (; i + 8 <= count; i += 8) {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        const __m128i scaled = _mm_slli_epi16(_mm_mulhi_epi16(samples, volume2), 1);
+        const __m128i mixed = _mm_adds_epi16(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(out + i)), scaled);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), mixed);
+    }
+#endif
+    for (; i < count; ++i) {
+        const int32_t scaled = ((int32_t) in[i] * volume + (1 << 14)) >> 15;
+        const int32_t mixed = out[i] + scaled;
+        out[i] = (int16_t) (mixed < -32768 ? -32768 : mixed > 32767 ? 32767 : mixed);
     }
+}
 
-    _taper(_sample_buf, total_samples);
+void SfxMan::SynthThreadMain() {
+    std::unique_lock<std::mutex> lock(mSynthMutex);
+    while (true) {
+        mSynthCondition.wait(lock, [this] { return mSynthQuit || !mSynthQueue.empty(); });
+        if (mSynthQuit) {
+            break;
+        }
+        Tone *tone = mSynthQueue.front();
+        mSynthQueue.pop_front();
+        lock.unlock();
+
+        const int samples = _synthRecipe(tone->recipe.c_str());
+        tone->samples.assign(_sample_buf, _sample_buf + samples);
+        if (samples <= 0) {
+            ALOGW("SfxMan: tone \"%s\" is empty.", tone->recipe.c_str());
+        }
+        // publish the samples to the audio thread
+        tone->ready.store(true, std::memory_order_release);
+
+        lock.lock();
+    }
+}
+
+SfxMan::Tone *SfxMan::GetTone(const char *recipe) {
+    auto lookup = mToneLookup.find(recipe);
+    if (lookup != mToneLookup.end()) {
+        return lookup->second;
+    }
+    Tone *tone = AddTone(recipe);
+    mToneLookup.emplace(recipe, tone);
+    return tone;
+}
+
+SfxMan::Tone *SfxMan::AddTone(const char *recipe) {
+    // identical literals aren't always merged, so the same recipe can be seen at
+    // several addresses, it is only synthesized once
+    std::unique_ptr<Tone> &tone = mTones[recipe];
+    if (!tone) {
+        tone.reset(new Tone());
+        tone->recipe = recipe;
+        tone->ready = false;
+        {
+            std::lock_guard<std::mutex> lock(mSynthMutex);
+            mSynthQueue.push_back(tone.get());
+        }
+        mSynthCondition.notify_one();
+    }
+    return tone.get();
+}
+
+void SfxMan::PrecacheTone(const char *tone) {
+    if (mInitOk) {
+        GetTone(tone);
+    }
+}
 
-    _bufferActive = true;
-    _frameCursor = 0;
-    _frameCount = total_samples;
+void SfxMan::SendCommand(const Command &command) {
+    if (!mCommands.Push(command)) {
+        // only happens if the audio callback stopped running
+        ALOGW("SfxMan: sound command queue is full, command dropped.");
+    }
+}
+
+SfxMan::VoiceId SfxMan::PlayTone(const char *tone, float volume) {
+    if (!mInitOk) {
+        ALOGW("SfxMan: not playing sound because initialization failed.");
+        return 0;
+    }
+
+    Command command;
+    command.type = Command::PLAY;
+    command.voiceId = ++mNextVoiceId;
+    command.tone = GetTone(tone);
+    command.volume = _volumeToQ15(volume);
+    SendCommand(command);
+    return command.voiceId;
+}
+
+void SfxMan::StopTone(VoiceId voiceId) {
+    if (mInitOk) {
+        SendCommand({Command::STOP, voiceId, NULL, 0});
+    }
+}
+
+void SfxMan::SetToneVolume(VoiceId voiceId, float volume) {
+    if (mInitOk) {
+        SendCommand({Command::VOLUME, voiceId, NULL, _volumeToQ15(volume)});
+    }
+}
+
+void SfxMan::ProcessCommands() {
+    Command command;
+    while (mCommands.Pop(&command)) {
+        if (command.type == Command::PLAY) {
+            // take a free voice, or else the voice that has played the longest
+            Voice *voice = &mVoices[0];
+            for (int i = 0; i < SFX_MAX_VOICES; ++i) {
+                if (mVoices[i].tone == NULL) {
+                    voice = &mVoices[i];
+                    break;
+                }
+                if (mVoices[i].id < voice->id) {
+                    voice = &mVoices[i];
+                }
+            }
+            voice->tone = command.tone;
+            voice->id = command.voiceId;
+            voice->cursor = 0;
+            voice->volume = command.volume;
+            continue;
+        }
+        for (int i = 0; i < SFX_MAX_VOICES; ++i) {
+            Voice &voice = mVoices[i];
+            if (voice.tone != NULL && voice.id == command.voiceId) {
+                if (command.type == Command::STOP) {
+                    voice.tone = NULL;
+                } else {
+                    voice.volume = command.volume;
+                }
+            }
+        }
+    }
 }
 
 oboe::DataCallbackResult
 SfxMan::onAudioReady(oboe::AudioStream */*audioStream*/, void *audioData, int32_t numFrames) {
-    if (_frameCount > 0) {
-        const int32_t remainingFrames = _frameCount - _frameCursor;
-        if (numFrames < remainingFrames) {
-            memcpy(audioData, &_sample_buf[_frameCursor], numFrames * sizeof(int16_t));
-            _frameCursor += numFrames;
-        } else {
-            const int32_t paddingFrames = numFrames - remainingFrames;
-            const size_t copySize = remainingFrames * sizeof(int16_t);
-            const size_t paddingSize = paddingFrames * sizeof(int16_t);
-            uint8_t *baseBuffer = static_cast<uint8_t *>(audioData);
-            memcpy(baseBuffer, &_sample_buf[_frameCursor], copySize);
-            memset(&baseBuffer[copySize], 0, paddingSize);
-            // We've finished playing the buffer
-            _frameCount = 0;
-            _frameCursor = 0;
+    ProcessCommands();
+
+    int16_t *out = static_cast<int16_t *>(audioData);
+    memset(out, 0, numFrames * sizeof(int16_t));
+
+    int activeVoices = 0;
+    for (int i = 0; i < SFX_MAX_VOICES; ++i) {
+        Voice &voice = mVoices[i];
+        if (voice.tone == NULL) {
+            continue;
         }
-    } else {
-        const size_t paddingSize = numFrames * sizeof(int16_t);
-        memset(audioData, 0, paddingSize);
-        if (_bufferActive) {
-            // First callback after finish playing the buffer, mark the
-            // buffer as inactive
-            _bufferActive = false;
+        ++activeVoices;
+        if (!voice.tone->ready.load(std::memory_order_acquire)) {
+            // still being synthesized, the voice starts once it is ready
+            continue;
+        }
+        const uint32_t sampleCount = static_cast<uint32_t>(voice.tone->samples.size());
+        const uint32_t count = std::min(static_cast<uint32_t>(numFrames),
+                                        sampleCount - voice.cursor);
+        _mixSaturate(out, voice.tone->samples.data() + voice.cursor, count, voice.volume);
+        voice.cursor += count;
+        if (voice.cursor >= sampleCount) {
+            voice.tone = NULL;
         }
     }
+    mActiveVoiceCount.store(activeVoices, std::memory_order_relaxed);
 
     return oboe::DataCallbackResult::Continue;
 }
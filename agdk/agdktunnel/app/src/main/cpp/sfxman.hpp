@@ -20,18 +20,94 @@
 #include <oboe/Oboe.h>
 
 #include "engine.hpp"
+#include "game_consts.hpp"
+#include "spsc_ring.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 /* Sound effect manager. This class is a singleton that manages sound effect
  * playback. Sound effects are defined by recipes (which are strings) that
  * indicate frequencies and durations. See the PlayTone() method for more info.
- * Note: our sfx generation code is very simplistic and lacks a mixer, so
- * only one sound can be playing at any given time. This is not a problematic
- * limitation for this simple sample but, needless to say, doesn't scale well
- * to a more complex game. */
+ *
+ * Every recipe is synthesized once, on a worker thread, into a bank of tones. The
+ * audio callback mixes up to SFX_MAX_VOICES tones at a time. The game thread only
+ * sends play, stop and volume commands to the audio thread through a lock-free
+ * ring, it never synthesizes or waits for the audio thread. */
 class SfxMan : public oboe::AudioStreamCallback {
+public:
+    typedef uint32_t VoiceId;
+
 private:
+    // A synthesized recipe. The samples are written by the synthesis thread, and
+    // only read by the audio thread once ready is set.
+    struct Tone {
+        std::string recipe;
+        std::vector<int16_t> samples;
+        std::atomic<bool> ready;
+    };
+
+    struct Command {
+        enum Type : uint8_t {
+            PLAY,
+            STOP,
+            VOLUME
+        };
+        Type type;
+        VoiceId voiceId;
+        const Tone *tone;
+        int16_t volume; // Q15
+    };
+
+    // A tone playing on the audio thread, only touched by the audio thread
+    struct Voice {
+        const Tone *tone;
+        VoiceId id;
+        uint32_t cursor;
+        int16_t volume; // Q15
+    };
+
     bool mInitOk;
     std::shared_ptr<oboe::AudioStream> mAudioStream;
+
+    // tone bank, keyed by recipe, only touched by the game thread
+    std::unordered_map<std::string, std::unique_ptr<Tone>> mTones;
+    // tone bank entries keyed by the address of the recipe string, so playing a
+    // known recipe neither allocates nor hashes the string
+    std::unordered_map<const char *, Tone *> mToneLookup;
+
+    // tones waiting to be synthesized
+    std::thread mSynthThread;
+    std::mutex mSynthMutex;
+    std::condition_variable mSynthCondition;
+    std::deque<Tone *> mSynthQueue;
+    bool mSynthQuit;
+
+    SpscRing<Command, SFX_COMMAND_RING_SIZE> mCommands;
+    VoiceId mNextVoiceId;
+
+    Voice mVoices[SFX_MAX_VOICES];
+    std::atomic<int> mActiveVoiceCount;
+
+    // Returns the tone bank entry of the recipe, queuing its synthesis if it is new
+    Tone *GetTone(const char *recipe);
+    // GetTone for a recipe address not seen yet, looks the entry up by contents
+    Tone *AddTone(const char *recipe);
+
+    void SynthThreadMain();
+
+    void SendCommand(const Command &command);
+
+    void ProcessCommands();
+
 public:
     SfxMan();
 
@@ -56,11 +132,26 @@ public:
      * Example: "d100 f300. d50 f250. a0 d100. a100 d50 f0."
      * This will play a 300Hz tone for 100ms, followed by a 250Hz tone
      * for 50 milliseconds, followed by 100ms of silence, followed
-     * by 50 milliseconds of loud random noise. */
-    void PlayTone(const char *tone);
+     * by 50 milliseconds of loud random noise.
+     *
+     * The tone plays over any tone already playing, at the given volume (0.0 to 1.0).
+     * A recipe that was not precached starts once it has been synthesized. Returns
+     * an id to stop the tone or change its volume.
+     *
+     * Recipes are looked up by address, the string must not change or be freed while
+     * SfxMan exists: pass string literals such as the TONE_ constants. */
+    VoiceId PlayTone(const char *tone, float volume = 1.0f);
+
+    // Stops a tone before its end
+    void StopTone(VoiceId voiceId);
+
+    // Changes the volume of a playing tone
+    void SetToneVolume(VoiceId voiceId, float volume);
+
+    // Synthesizes the recipe ahead of its first PlayTone, on the synthesis thread
+    void PrecacheTone(const char *tone);
 
-    // Returns whether or not the sound effect pipeline is idle (able to play
-    // a tone right now).
+    // Returns whether or not the sound effect pipeline is idle (no tone playing).
     bool IsIdle();
 
     // Oboe AudioStreamDataCallback function
@@ -16,6 +16,8 @@
 
 #include "shape_renderer.hpp"
 #include "gfx_manager.hpp"
+#include "mvp_batch.hpp"
+#include "render_thread.hpp"
 #include "util.hpp"
 
 using namespace simple_renderer;
@@ -68,24 +70,25 @@ void ShapeRenderer::RenderRect(float centerX, float centerY, float width, float
     const glm::mat4 &rotateMat = sceneManager->GetRotationMatrix();
 
     glm::mat4 orthoMat = glm::ortho(0.0f, aspect, 0.0f, 1.0f);
-    glm::mat4 modelMat, mat;
-    modelMat = glm::translate(glm::mat4(1.0f), glm::vec3(centerX, centerY, 0.0f));
-    modelMat = glm::scale(modelMat, glm::vec3(width, height, 1.0f));
-    mat = orthoMat * modelMat;
-    mat = rotateMat * mat;
+    ModelTransform transform;
+    transform.translation = glm::vec3(centerX, centerY, 0.0f);
+    transform.scale = glm::vec3(width, height, 1.0f);
+    transform.rotationZ = 0.0f;
+    glm::mat4 mat;
+    BuildMVPs(rotateMat * orthoMat, &transform, 1, nullptr, &mat);
 
     const float* matrixData = glm::value_ptr(mat);
-    simple_renderer::Renderer& renderer = simple_renderer::Renderer::GetInstance();
+    CommandList& commands = RenderThread::GetInstance()->GetCommandList();
 
-    mUniformBuffer->SetBufferElementData(GfxManager::kBasicUniform_MVP,
-                                         matrixData, UniformBuffer::kElementSize_Matrix44);
-    mUniformBuffer->SetBufferElementData(GfxManager::kBasicUniform_Tint,
-                                         mColor, UniformBuffer::kElementSize_Float4);
-    renderer.BindVertexBuffer(mGeom->vertex_buffer_);
+    commands.SetBufferElementData(mUniformBuffer, GfxManager::kBasicUniform_MVP,
+                                  matrixData, UniformBuffer::kElementSize_Matrix44);
+    commands.SetBufferElementData(mUniformBuffer, GfxManager::kBasicUniform_Tint,
+                                  mColor, UniformBuffer::kElementSize_Float4);
+    commands.BindVertexBuffer(mGeom->vertex_buffer_);
     if (mGeom->index_buffer_.get() != nullptr) {
-        renderer.BindIndexBuffer(mGeom->index_buffer_);
-        renderer.DrawIndexed(mGeom->index_buffer_->GetBufferElementCount(), 0);
+        commands.BindIndexBuffer(mGeom->index_buffer_);
+        commands.DrawIndexed(mGeom->index_buffer_->GetBufferElementCount(), 0);
     } else {
-        renderer.Draw(mGeom->vertex_buffer_->GetBufferElementCount(), 0);
+        commands.Draw(mGeom->vertex_buffer_->GetBufferElementCount(), 0);
     }
 }
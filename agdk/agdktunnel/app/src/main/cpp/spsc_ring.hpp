@@ -0,0 +1,68 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef agdktunnel_spsc_ring_hpp
+#define agdktunnel_spsc_ring_hpp
+
+#include <atomic>
+#include <cstdint>
+
+// Fixed capacity lock-free ring buffer for a single producer thread and a single
+// consumer thread. Neither side blocks or allocates, so the consumer may be a real-time
+// thread such as the audio callback. Capacity must be a power of two.
+template<typename T, uint32_t Capacity>
+class SpscRing {
+ public:
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                "SpscRing capacity must be a power of two");
+
+  SpscRing() : mHead(0), mTail(0) {}
+
+  // Producer side, returns false if the ring is full
+  bool Push(const T &item) {
+    const uint32_t tail = mTail.load(std::memory_order_relaxed);
+    if (tail - mHead.load(std::memory_order_acquire) == Capacity) {
+      return false;
+    }
+    mItems[tail & (Capacity - 1)] = item;
+    mTail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side, returns false if the ring is empty
+  bool Pop(T *item) {
+    const uint32_t head = mHead.load(std::memory_order_relaxed);
+    if (head == mTail.load(std::memory_order_acquire)) {
+      return false;
+    }
+    *item = mItems[head & (Capacity - 1)];
+    mHead.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool IsEmpty() const {
+    return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire);
+  }
+
+ private:
+  T mItems[Capacity];
+  // Free running indices, only the producer writes mTail and only the consumer mHead
+  alignas(64) std::atomic<uint32_t> mHead;
+  alignas(64) std::atomic<uint32_t> mTail;
+};
+
+#endif // agdktunnel_spsc_ring_hpp
@@ -16,6 +16,7 @@
 
 #include "tex_quad.hpp"
 #include "gfx_manager.hpp"
+#include "render_thread.hpp"
 
 using namespace simple_renderer;
 
@@ -106,16 +107,16 @@ void TexQuad::Render(glm::mat4 *transform) {
     mat = rotateMat * mat;
 
     const float* matrixData = glm::value_ptr(mat);
-    simple_renderer::Renderer& renderer = simple_renderer::Renderer::GetInstance();
+    CommandList& commands = RenderThread::GetInstance()->GetCommandList();
 
-    mUniformBuffer->SetBufferElementData(GfxManager::kOurUniform_MVP,
-                                         matrixData, UniformBuffer::kElementSize_Matrix44);
+    commands.SetBufferElementData(mUniformBuffer, GfxManager::kOurUniform_MVP,
+                                  matrixData, UniformBuffer::kElementSize_Matrix44);
     const float tintData[4] = {1.0f, 1.0f, 1.0f, 1.0f};
-    mUniformBuffer->SetBufferElementData(GfxManager::kOurUniform_Tint,
-                                         tintData, UniformBuffer::kElementSize_Float4);
-    renderer.BindIndexBuffer(mGeom->index_buffer_);
-    renderer.BindVertexBuffer(mGeom->vertex_buffer_);
-    renderer.BindTexture(mTexture);
-    renderer.DrawIndexed(mGeom->index_buffer_->GetBufferElementCount(), 0);
+    commands.SetBufferElementData(mUniformBuffer, GfxManager::kOurUniform_Tint,
+                                  tintData, UniformBuffer::kElementSize_Float4);
+    commands.BindIndexBuffer(mGeom->index_buffer_);
+    commands.BindVertexBuffer(mGeom->vertex_buffer_);
+    commands.BindTexture(mTexture);
+    commands.DrawIndexed(mGeom->index_buffer_->GetBufferElementCount(), 0);
 
 }
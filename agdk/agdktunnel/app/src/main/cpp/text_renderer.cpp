@@ -16,6 +16,7 @@
 
 #include "ascii_to_geom.hpp"
 #include "gfx_manager.hpp"
+#include "render_thread.hpp"
 #include "scene_manager.hpp"
 #include "text_renderer.hpp"
 #include "util.hpp"
@@ -29,28 +30,50 @@
 
 #define CORRECTION_Y -0.02f
 
-TextRenderer::TextRenderer(std::shared_ptr<simple_renderer::UniformBuffer> uniformBuffer) {
+// Sized to hold the menus and signs of a scene
+#define STRING_ARENA_VERTICES 16384
+#define STRING_ARENA_INDICES 32768
+
+// floats per P3C4 vertex
+#define GLYPH_VERTEX_FLOATS 7
+
+static const simple_renderer::GeometryArena::GeometryArenaCreationParams STRING_ARENA_PARAMS = {
+    simple_renderer::VertexBuffer::kVertexFormat_P3C4, STRING_ARENA_VERTICES, STRING_ARENA_INDICES
+};
+
+TextRenderer::TextRenderer(std::shared_ptr<simple_renderer::UniformBuffer> uniformBuffer) :
+    mStringArena(STRING_ARENA_PARAMS) {
   mUniformBuffer = uniformBuffer;
-  memset(mCharGeom, 0, sizeof(mCharGeom));
+  memset(mGlyphRange, 0, sizeof(mGlyphRange));
+  memset(mHasChar, 0, sizeof(mHasChar));
   mFontScale = 1.0f;
   mMatrix = glm::mat4(1.0f);
   mColor[0] = mColor[1] = mColor[2] = mColor[3] = 1.0f;
 
   ALOGI("Loading alphabet glyphs.");
+  std::vector<float> vertices;
+  std::vector<uint16_t> indices;
   int i;
   for (i = 0; i < CHAR_CODES; ++i) {
-    if (ALPHABET_ART[i]) {
-      ALOGI("Creating glyph for chr %d.", i);
-      mCharGeom[i] = AsciiArtToGeom(ALPHABET_ART[i], ALPHABET_SCALE);
+    if (BakedGlyphToVertices(i, ALPHABET_SCALE, vertices, indices)) {
+      // add it to the packed glyph set, strings are built from it
+      mHasChar[i] = true;
+      mGlyphRange[i].first_vertex =
+          static_cast<uint32_t>(mGlyphVertices.size() / GLYPH_VERTEX_FLOATS);
+      mGlyphRange[i].vertex_count = static_cast<uint32_t>(vertices.size() / GLYPH_VERTEX_FLOATS);
+      mGlyphRange[i].first_index = static_cast<uint32_t>(mGlyphIndices.size());
+      mGlyphRange[i].index_count = static_cast<uint32_t>(indices.size());
+      mGlyphVertices.insert(mGlyphVertices.end(), vertices.begin(), vertices.end());
+      mGlyphIndices.insert(mGlyphIndices.end(), indices.begin(), indices.end());
     }
   }
+
+  ALOGI("Glyph set: %u vertices, %u indices",
+        static_cast<uint32_t>(mGlyphVertices.size() / GLYPH_VERTEX_FLOATS),
+        static_cast<uint32_t>(mGlyphIndices.size()));
 }
 
 TextRenderer::~TextRenderer() {
-  int i;
-  for (i = 0; i < CHAR_CODES; i++) {
-    CleanUp(&mCharGeom[i]);
-  }
 }
 
 void TextRenderer::SetFontScale(float scale) {
@@ -91,53 +114,141 @@ void TextRenderer::MeasureText(const char *str, float fontScale, float *outWidth
   }
 }
 
-void TextRenderer::RenderText(const char *str, float centerX, float centerY) {
-  SceneManager *sceneManager = SceneManager::GetInstance();
-  float aspect = sceneManager->GetScreenAspect();
-  const glm::mat4 &rotateMat = sceneManager->GetRotationMatrix();
-
-  glm::mat4 orthoMat = glm::ortho(0.0f, aspect, 0.0f, 1.0f);
-  glm::mat4 modelMat, mat, scaleMat;
+void TextRenderer::LayoutGlyphs(const char *str) {
   int cols, rows;
-
-  simple_renderer::Renderer& renderer = simple_renderer::Renderer::GetInstance();
-
-  centerY += CORRECTION_Y * mFontScale;
-
-  mUniformBuffer->SetBufferElementData(GfxManager::kBasicUniform_Tint, mColor,
-                                       simple_renderer::UniformBuffer::kElementSize_Float4);
-
   _count_rows_cols(str, &cols, &rows);
-  scaleMat = glm::scale(glm::mat4(1.0f), glm::vec3(mFontScale, mFontScale, 1.0f));
-  float charWidth = ALPHABET_GLYPH_COLS * ALPHABET_SCALE * mFontScale;
-  float charHeight = ALPHABET_GLYPH_ROWS * ALPHABET_SCALE * mFontScale;
+  float charWidth = ALPHABET_GLYPH_COLS * ALPHABET_SCALE;
+  float charHeight = ALPHABET_GLYPH_ROWS * ALPHABET_SCALE;
   float charSpacing = CHAR_SPACING_F * charWidth;
   float lineSpacing = LINE_SPACING_F * charHeight;
   float width = cols * charWidth + (cols - 1) * charSpacing;
   float height = rows * charHeight + (rows - 1) * lineSpacing;
-  float startX = centerX - width * 0.5f + 0.5f * charWidth;
-  float startY = centerY + height * 0.5f - 0.5f * charHeight;
+  float startX = -width * 0.5f + 0.5f * charWidth;
+  float startY = height * 0.5f - 0.5f * charHeight;
+  float x = startX;
   float y = startY;
 
-  modelMat = glm::translate(glm::mat4(1.0f), glm::vec3(startX, startY, 0.0f));
+  mGlyphCodes.clear();
+  mGlyphOffsets.clear();
   for (; *str; ++str) {
     if (*str == '\n') {
       y -= charHeight + lineSpacing;
-      modelMat = glm::translate(glm::mat4(1.0f), glm::vec3(startX, y, 0.0f));
+      x = startX;
     } else {
       int code = (int) *str;
-      if (code >= 0 && code < CHAR_CODES && mCharGeom[code]) {
-        mat = orthoMat * modelMat * scaleMat * mMatrix;
-        mat = rotateMat * mat;
-        const float* matrixData = glm::value_ptr(mat);
-        mUniformBuffer->SetBufferElementData(GfxManager::kBasicUniform_MVP,
-                                             matrixData,
-                                             simple_renderer::UniformBuffer::kElementSize_Matrix44);
-        renderer.BindIndexBuffer(mCharGeom[code]->index_buffer_);
-        renderer.BindVertexBuffer(mCharGeom[code]->vertex_buffer_);
-        renderer.DrawIndexed(mCharGeom[code]->index_buffer_->GetBufferElementCount(), 0);
+      if (code >= 0 && code < CHAR_CODES && mHasChar[code]) {
+        mGlyphCodes.push_back(code);
+        mGlyphOffsets.push_back(glm::vec2(x, y));
       }
-      modelMat = glm::translate(modelMat, glm::vec3(charWidth + charSpacing, 0.0f, 0.0f));
+      x += charWidth + charSpacing;
     }
   }
 }
+
+// FNV-1a
+uint64_t TextRenderer::HashString(const char *str) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (; *str; ++str) {
+    hash = (hash ^ static_cast<uint8_t>(*str)) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+const TextRenderer::CachedString *TextRenderer::FindCachedString(const char *str) const {
+  if (mStringCache.empty()) {
+    return NULL;
+  }
+  auto iter = mStringCache.find(HashString(str));
+  if (iter == mStringCache.end() || iter->second.text != str) {
+    return NULL;
+  }
+  return &iter->second;
+}
+
+void TextRenderer::BuildStringMesh(const char *str) {
+  // copy the glyphs into one mesh, offset to their position in the string
+  LayoutGlyphs(str);
+  mStringVertices.clear();
+  mStringIndices.clear();
+  for (size_t i = 0; i < mGlyphCodes.size(); ++i) {
+    const simple_renderer::GeometryArena::Mesh &range = mGlyphRange[mGlyphCodes[i]];
+    const glm::vec2 &offset = mGlyphOffsets[i];
+    const uint16_t baseVertex =
+        static_cast<uint16_t>(mStringVertices.size() / GLYPH_VERTEX_FLOATS);
+    const float *glyphVertex = &mGlyphVertices[range.first_vertex * GLYPH_VERTEX_FLOATS];
+    for (uint32_t v = 0; v < range.vertex_count; ++v) {
+      mStringVertices.push_back(glyphVertex[0] + offset.x);
+      mStringVertices.push_back(glyphVertex[1] + offset.y);
+      mStringVertices.insert(mStringVertices.end(), glyphVertex + 2,
+                             glyphVertex + GLYPH_VERTEX_FLOATS);
+      glyphVertex += GLYPH_VERTEX_FLOATS;
+    }
+    for (uint32_t n = 0; n < range.index_count; ++n) {
+      mStringIndices.push_back(baseVertex + mGlyphIndices[range.first_index + n]);
+    }
+  }
+}
+
+void TextRenderer::CacheString(const char *str) {
+  const uint64_t hash = HashString(str);
+  if (mStringCache.find(hash) != mStringCache.end()) {
+    // already cached, or a different string with the same hash which is left uncached
+    return;
+  }
+
+  BuildStringMesh(str);
+  CachedString cached;
+  cached.text = str;
+  if (!mStringArena.AddMesh(mStringVertices.data(),
+                            static_cast<uint32_t>(mStringVertices.size() / GLYPH_VERTEX_FLOATS),
+                            mStringIndices.data(), static_cast<uint32_t>(mStringIndices.size()),
+                            cached.mesh)) {
+    ALOGW("TextRenderer: string arena full, not caching \"%s\".", str);
+    return;
+  }
+  mStringCache[hash] = cached;
+}
+
+void TextRenderer::Commit() {
+  mStringArena.Commit();
+}
+
+void TextRenderer::RenderText(const char *str, float centerX, float centerY) {
+  SceneManager *sceneManager = SceneManager::GetInstance();
+  float aspect = sceneManager->GetScreenAspect();
+  const glm::mat4 &rotateMat = sceneManager->GetRotationMatrix();
+
+  centerY += CORRECTION_Y * mFontScale;
+
+  // glyphs are laid out around the string center, at a font scale of 1
+  glm::mat4 stringMat = rotateMat * glm::ortho(0.0f, aspect, 0.0f, 1.0f);
+  stringMat = glm::translate(stringMat, glm::vec3(centerX, centerY, 0.0f));
+  stringMat = glm::scale(stringMat, glm::vec3(mFontScale, mFontScale, 1.0f));
+  stringMat = stringMat * mMatrix;
+
+  simple_renderer::CommandList& commands = RenderThread::GetInstance()->GetCommandList();
+
+  commands.SetBufferElementData(mUniformBuffer, GfxManager::kBasicUniform_Tint, mColor,
+                                simple_renderer::UniformBuffer::kElementSize_Float4);
+
+  const CachedString *cached = FindCachedString(str);
+  if (cached) {
+    commands.SetBufferElementData(mUniformBuffer, GfxManager::kBasicUniform_MVP,
+                                  glm::value_ptr(stringMat),
+                                  simple_renderer::UniformBuffer::kElementSize_Matrix44);
+    mStringArena.Bind(commands);
+    mStringArena.DrawMesh(cached->mesh, commands);
+    return;
+  }
+
+  // not cached, build the mesh and draw it from the renderer's geometry ring
+  BuildStringMesh(str);
+  commands.SetBufferElementData(mUniformBuffer, GfxManager::kBasicUniform_MVP,
+                                glm::value_ptr(stringMat),
+                                simple_renderer::UniformBuffer::kElementSize_Matrix44);
+  commands.DrawIndexedDynamic(simple_renderer::VertexBuffer::kVertexFormat_P3C4,
+                              mStringVertices.data(),
+                              static_cast<uint32_t>(mStringVertices.size() / GLYPH_VERTEX_FLOATS),
+                              mStringIndices.data(),
+                              static_cast<uint32_t>(mStringIndices.size()));
+}
@@ -18,32 +18,83 @@
 #define agdktunnel_text_renderer_hpp
 
 #include "common.hpp"
-#include "simplegeom.hpp"
+#include "simple_renderer/renderer_geometry_arena.h"
 #include "simple_renderer/renderer_uniform_buffer.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 /* Renders text to the screen. Uses the "normalized 2D coordinate system" as
- * described in the README. */
+ * described in the README.
+ *
+ * Strings registered with CacheString are built into a single mesh, looked up by
+ * content when rendered and drawn with one draw call. Other strings, like the score,
+ * are built into a mesh each time they are rendered and drawn with one dynamic draw
+ * (Renderer::DrawIndexedDynamic).
+ *
+ * Construction and CacheString only build meshes on the CPU and may run on a worker
+ * thread (see Scene::OnPreload), the GPU buffers are created by Commit. */
 class TextRenderer {
  public:
   static const int CHAR_CODES = 128;
-  SimpleGeom *mCharGeom[CHAR_CODES];
+  // Vertices (P3C4) and line indices of every glyph of the alphabet packed together,
+  // cached strings are built from them
+  std::vector<float> mGlyphVertices;
+  std::vector<uint16_t> mGlyphIndices;
+  simple_renderer::GeometryArena::Mesh mGlyphRange[CHAR_CODES];
+  bool mHasChar[CHAR_CODES];
+
+  // Meshes of the cached strings, keyed by the hash of their text
+  struct CachedString {
+    std::string text;
+    simple_renderer::GeometryArena::Mesh mesh;
+  };
+  simple_renderer::GeometryArena mStringArena;
+  std::unordered_map<uint64_t, CachedString> mStringCache;
 
   float mFontScale;
   float mColor[4];
   glm::mat4 mMatrix;
   std::shared_ptr<simple_renderer::UniformBuffer> mUniformBuffer;
 
+  // Glyphs of the string being laid out, and the mesh built from them
+  std::vector<int> mGlyphCodes;
+  std::vector<glm::vec2> mGlyphOffsets;
+  std::vector<float> mStringVertices;
+  std::vector<uint16_t> mStringIndices;
+
+  // Fill mGlyphCodes and mGlyphOffsets with the glyphs of str, positioned relative
+  // to the center of the string at a font scale of 1
+  void LayoutGlyphs(const char *str);
+
+  // Fill mStringVertices and mStringIndices with the mesh of str, copied from the
+  // packed glyph set
+  void BuildStringMesh(const char *str);
+
+  const CachedString *FindCachedString(const char *str) const;
+
+  static uint64_t HashString(const char *str);
+
  public:
   TextRenderer(std::shared_ptr<simple_renderer::UniformBuffer> uniformBuffer);
 
   ~TextRenderer();
 
+  // Transform applied to the whole string around its center, before the font scale
   void SetMatrix(glm::mat4 mat);
 
   void SetFontScale(float size);
 
   void RenderText(const char *str, float centerX, float centerY);
 
+  // Build the mesh of a string that does not change, so rendering it takes a single
+  // draw. Only touches the CPU copy of the meshes, which is uploaded by Commit.
+  void CacheString(const char *str);
+
+  // Upload the strings cached since the last call in one batch. Creates graphics resources: call when graphics start, not while recording
+  // a frame. Must be called before the first RenderText.
+  void Commit();
+
   void SetColor(float r, float g, float b) {
     mColor[0] = r, mColor[1] = g, mColor[2] = b;
   }
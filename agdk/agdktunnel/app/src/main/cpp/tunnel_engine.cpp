@@ -15,7 +15,10 @@
  */
 
 #include "tunnel_engine.hpp"
+#include "game_consts.hpp"
+#include "input_replay.hpp"
 #include "loader_scene.hpp"
+#include "render_thread.hpp"
 #include "welcome_scene.hpp"
 
 #include "filesystem_manager.h"
@@ -80,6 +83,12 @@ TunnelEngine::TunnelEngine(struct android_app *app) : NativeEngine(app) {
   FilesystemManager::kRootPathInternalStorage).c_str();
   mDataStateMachine = new DataLoaderStateMachine(mCloudSaveEnabled, internalStorage);
 
+#if defined(REPLAY_BENCHMARK_MODE)
+  InputReplay::GetInstance()->Init(InputReplay::MODE_PLAYBACK, internalStorage);
+#elif defined(REPLAY_RECORD_MODE)
+  InputReplay::GetInstance()->Init(InputReplay::MODE_RECORD, internalStorage);
+#endif
+
   GameActivity_setImeEditorInfo(app->activity, TYPE_CLASS_TEXT,
                                 IME_ACTION_NONE, IME_FLAG_NO_FULLSCREEN);
 
@@ -91,6 +100,10 @@ TunnelEngine::TunnelEngine(struct android_app *app) : NativeEngine(app) {
 }
 
 TunnelEngine::~TunnelEngine() {
+  // Drain and stop the render thread before any graphics resources it may
+  // still reference are released
+  RenderThread::GetInstance()->Shutdown();
+
   // Make sure any active scene is deleted to release references to its
   // graphic resources
   SceneManager::GetInstance()->PrepareShutdown();
@@ -129,6 +142,7 @@ void TunnelEngine::GameLoop() {
       PlatformEventLoop::GetInstance().PollEvents();
       PollGameController();
       mGameAssetManager->UpdateGameAssetManager();
+      ProcessSaveCompletions();
       if (mApp->textInputState) {
         struct CookedEvent ev;
         ev.type = COOKED_EVENT_TYPE_TEXT_INPUT;
@@ -161,11 +175,15 @@ void TunnelEngine::DoFirstFrameSetup() {
 void TunnelEngine::InitializeGfxManager() {
   // Initialize renderer and resources once we have a valid surface to render to
   simple_renderer::Renderer::SetSwapchainHandle(mSwapchainHandle);
+#ifdef NULL_RENDERER_MODE
+  simple_renderer::Renderer::SetRendererAPI(simple_renderer::Renderer::kAPI_Null);
+#else
   if (mIsVulkan) {
     simple_renderer::Renderer::SetRendererAPI(simple_renderer::Renderer::kAPI_Vulkan);
   } else {
     simple_renderer::Renderer::SetRendererAPI(simple_renderer::Renderer::kAPI_GLES);
   }
+#endif
   mGfxManager = new GfxManager(mIsVulkan, mSurfWidth, mSurfHeight);
   if (mTextureManager == NULL) {
     mTextureManager = new TextureManager();
@@ -212,16 +230,29 @@ bool TunnelEngine::SaveProgress(int level, bool forceSave) {
     }
   }
 
-  // Save state locally and to the cloud if it is enabled
+  // Save state locally, the cloud save follows when the local file is written
   ALOGI("Saving progress to LOCAL FILE: level %d", level);
   mDataStateMachine->SaveLocalProgress(level);
-  if (IsCloudSaveEnabled()) {
-    ALOGI("Saving progress to the cloud: level %d", level);
-    SaveGameToCloud(level);
-  }
   return true;
 }
 
+void TunnelEngine::ProcessSaveCompletions() {
+  SaveCompletion completion;
+  while (mDataStateMachine->PollSaveCompletion(&completion)) {
+    const int level = completion.snapshot.level;
+    if (completion.success) {
+      ALOGI("Progress saved to LOCAL FILE: level %d (%u earlier saves coalesced)",
+            level, completion.coalescedCount);
+    } else {
+      ALOGE("Failed to save progress to LOCAL FILE: level %d", level);
+    }
+    if (IsCloudSaveEnabled()) {
+      ALOGI("Saving progress to the cloud: level %d", level);
+      SaveGameToCloud(level);
+    }
+  }
+}
+
 void TunnelEngine::SaveGameToCloud(int level) {
   MY_ASSERT(GetJniEnv() && IsCloudSaveEnabled());
   ALOGI("Scheduling task to save cloud data through JNI");
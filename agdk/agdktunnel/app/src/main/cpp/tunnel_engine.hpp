@@ -66,7 +66,8 @@ class TunnelEngine : public NativeEngine {
   // Returns if cloud save is enabled
   bool IsCloudSaveEnabled() { return mCloudSaveEnabled; }
 
-  // Saves data to local storage and to cloud if it is enabled
+  // Queues a save of data to local storage, and to cloud if it is enabled once
+  // the local save has been written. Returns whether a save was queued.
   bool SaveProgress(int level, bool forceSave = false);
 
   void SetInputSdkContext(int context);
@@ -76,6 +77,9 @@ class TunnelEngine : public NativeEngine {
 
   void InitializeGfxManager();
 
+  // Handles the local saves written since the last frame
+  void ProcessSaveCompletions();
+
   // Save the checkpoint level in the cloud
   void SaveGameToCloud(int level);
 
@@ -41,6 +41,8 @@ UiScene::UiScene() {
     mFocusWidget = -1;
     mTextRenderer = NULL;
     mShapeRenderer = NULL;
+    mTextUniformBuffer = TunnelEngine::GetInstance()->GetGfxManager()->GetUniformBuffer(
+        GfxManager::kGfxType_BasicThickLinesNoDepthTest);
     mDefaultButton = -1;
     mPointerDown = false;
     mWaitScreen = false;
@@ -48,7 +50,9 @@ UiScene::UiScene() {
 }
 
 UiScene::~UiScene() {
-    // note: cleanup for graphics-related stuff goes in OnKillGraphics
+    // note: cleanup for graphics-related stuff goes in OnKillGraphics, only a
+    // scene preloaded but never installed still has its text renderer
+    CleanUp(&mTextRenderer);
 
     int i;
     for (i = 0; i < mWidgetCount; ++i) {
@@ -64,10 +68,22 @@ UiWidget *UiScene::NewWidget() {
     return widget;
 }
 
+void UiScene::CreateTextRenderer() {
+    mTextRenderer = new TextRenderer(mTextUniformBuffer);
+    mTextRenderer->CacheString(S_PLEASE_WAIT);
+}
+
+void UiScene::OnPreload() {
+    // build the glyph meshes off the game thread, OnStartGraphics uploads them
+    CreateTextRenderer();
+}
+
 void UiScene::OnStartGraphics() {
+    if (mTextRenderer == NULL) {
+        // graphics were restarted, the text renderer went with them
+        CreateTextRenderer();
+    }
     GfxManager *gfxManager = TunnelEngine::GetInstance()->GetGfxManager();
-    mTextRenderer = new TextRenderer(gfxManager->GetUniformBuffer(
-        GfxManager::kGfxType_BasicThickLinesNoDepthTest));
     mShapeRenderer = new ShapeRenderer(gfxManager->GetUniformBuffer(
         GfxManager::kGfxType_BasicTrisNoDepthTest));
 
@@ -80,6 +96,14 @@ void UiScene::OnStartGraphics() {
         // time to create our widgets
         OnCreateWidgets();
     }
+
+    // the widget labels rarely change, cache their text meshes
+    for (int i = 0; i < mWidgetCount; ++i) {
+        if (mWidgets[i]->GetText()) {
+            mTextRenderer->CacheString(mWidgets[i]->GetText());
+        }
+    }
+    mTextRenderer->Commit();
 }
 
 void UiScene::OnKillGraphics() {
@@ -53,6 +53,10 @@ protected:
     TextRenderer *mTextRenderer;
     ShapeRenderer *mShapeRenderer;
 
+    // uniform buffer of the text renderer, looked up on the game thread when the
+    // scene is created so OnPreload doesn't touch the GfxManager
+    std::shared_ptr<simple_renderer::UniformBuffer> mTextUniformBuffer;
+
     // if true, shows a "please wait" screen instead of the interface
     bool mWaitScreen;
 
@@ -91,12 +95,17 @@ protected:
     // subclasses must override these to create their widgets
     virtual void OnCreateWidgets();
 
+    // builds the text renderer and caches the strings known before widgets exist
+    void CreateTextRenderer();
+
 public:
     UiScene();
 
     virtual ~UiScene();
 
 
+    virtual void OnPreload();
+
     virtual void OnStartGraphics();
 
     virtual void OnKillGraphics();
@@ -200,6 +209,8 @@ public:
 
     float GetHeight() { return mHeight; }
 
+    const char *GetText() { return mText; }
+
     bool IsButton() { return mIsButton; }
 
     int GetNav(int dir) { return dir >= 0 && dir < 4 ? mNav[dir] : -1; }
@@ -14,23 +14,57 @@
  * limitations under the License.
  */
 
-#include <cstdlib>
 #include <ctime>
 
 #include "util.hpp"
 
+// xorshift32 generator, unlike rand() its whole state can be saved and restored
+static uint32_t _randomState = 1;
+
+static uint32_t NextRandom() {
+    uint32_t x = _randomState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    _randomState = x;
+    return x;
+}
+
 int Random(int uboundExclusive) {
-    int r = rand();
-    return r % uboundExclusive;
+    return (int) (NextRandom() % (uint32_t) uboundExclusive);
 }
 
 int Random(int lbound, int uboundExclusive) {
-    int r = rand();
-    r = r % (uboundExclusive - lbound);
+    int r = (int) (NextRandom() % (uint32_t) (uboundExclusive - lbound));
     return lbound + r;
 }
 
+uint32_t GetRandomState() {
+    return _randomState;
+}
+
+void SetRandomState(uint32_t state) {
+    // xorshift never leaves the all zero state
+    _randomState = state != 0 ? state : 1;
+}
+
+static bool _clockFrozen = false;
+static float _frozenTime = 0.0f;
+
 float Clock() {
+    return _clockFrozen ? _frozenTime : WallClock();
+}
+
+void FreezeClock(float time) {
+    _clockFrozen = true;
+    _frozenTime = time;
+}
+
+void UnfreezeClock() {
+    _clockFrozen = false;
+}
+
+float WallClock() {
     static struct timespec _base;
     static bool firstCall = true;
 
@@ -17,6 +17,7 @@
 #ifndef agdktunnel_util_hpp
 #define agdktunnel_util_hpp
 
+#include <cstdint>
 #include <ctime>
 #include <cmath>
 
@@ -33,6 +34,12 @@ int Random(int uboundExclusive);
 
 int Random(int lbound, int uboundExclusive);
 
+// State of the generator behind Random(). Restoring a saved state replays the same
+// sequence of random numbers (see InputReplay).
+uint32_t GetRandomState();
+
+void SetRandomState(uint32_t state);
+
 template<typename T>
 T Max(T a, T b) { return a > b ? a : b; }
 
@@ -78,9 +85,20 @@ T Abs(T f) {
     return f > static_cast<T>(0) ? f : -f;
 }
 
-// Returns current wall clock time (seconds elapsed since an arbitrary fixed point in the past).
+// Returns current game time (seconds elapsed since an arbitrary fixed point in the past).
+// This is the wall clock time, unless the clock is frozen.
 float Clock();
 
+// Returns current wall clock time, even while the clock is frozen.
+float WallClock();
+
+// Make Clock() return the given time until UnfreezeClock() is called. While a replay
+// session is active the clock only advances once per frame, so that the game sees the
+// same times when the session is played back.
+void FreezeClock(float time);
+
+void UnfreezeClock();
+
 float SineWave(float min, float max, float period, float phase);
 
 bool BlinkFunc(float period);
@@ -17,6 +17,7 @@
 #include "anim.hpp"
 #include "dialog_scene.hpp"
 #include "gfx_manager.hpp"
+#include "input_replay.hpp"
 #include "play_scene.hpp"
 #include "tunnel_engine.hpp"
 #include "welcome_scene.hpp"
@@ -181,6 +182,15 @@ void WelcomeScene::OnTextInput() {
 }
 
 void WelcomeScene::DoFrame() {
+#ifdef REPLAY_BENCHMARK_MODE
+    // start the next pass over the recorded session
+    InputReplay *replay = InputReplay::GetInstance();
+    SceneManager *mgr = SceneManager::GetInstance();
+    if (replay->GetMode() == InputReplay::MODE_PLAYBACK && !mgr->IsSceneRequested()) {
+        mgr->RequestNewScene(new PlayScene(replay->GetSavedLevel()));
+    }
+#endif
+
     // update widget states based on signed-in status
     UpdateWidgetStates();
 
@@ -24,23 +24,34 @@ layout (location = 4) in float v_FogFactor;
 
 layout (binding = 1) uniform sampler2D u_Sampler;
 
-layout(push_constant, std430) uniform PushConstants {
-  layout(offset = 80) vec4 u_PointLightColor;
-  layout(offset = 96) vec4 u_Tint;
-} u_PushConstants;
+layout(set = 1, binding = 0, std140) uniform OurUniforms {
+  mat4 u_MVP;
+  vec4 u_PointLightPos;
+  vec4 u_PointLightColor;
+  vec4 u_Tint;
+} u_Uniforms;
 
 layout (location = 0) out vec4 o_FragColor;
 
+// Feature keywords, set by the shader variant through specialization constants
+layout (constant_id = 0) const bool FEATURE_POINT_LIGHT = true;
+layout (constant_id = 1) const bool FEATURE_FOG = true;
+
 float ATT_FACT_2 = 0.005;
 float ATT_FACT_1 = 0.00;
 float SRGB_INVERSE_GAMMA_APPROX = 2.2;
 
 void main()
 {
-  float d = distance(v_PointLightPos, v_Pos);
-  float att = 1.0/(ATT_FACT_1 * d + ATT_FACT_2 * d * d);
-  vec4 frag_color = mix(v_Color * u_PushConstants.u_Tint * texture(u_Sampler, v_TexCoord) +
-                     u_PushConstants.u_PointLightColor * att, vec4(0), v_FogFactor);
+  vec4 frag_color = v_Color * u_Uniforms.u_Tint * texture(u_Sampler, v_TexCoord);
+  if (FEATURE_POINT_LIGHT) {
+    float d = distance(v_PointLightPos, v_Pos);
+    float att = 1.0/(ATT_FACT_1 * d + ATT_FACT_2 * d * d);
+    frag_color += u_Uniforms.u_PointLightColor * att;
+  }
+  if (FEATURE_FOG) {
+    frag_color = mix(frag_color, vec4(0), v_FogFactor);
+  }
 
   // The original GL sample was linear color space, but Vulkan is using a
   // sRGB framebuffer, do an approximation conversion
@@ -26,10 +26,16 @@ layout (location = 2) out vec4 v_PointLightPos;
 layout (location = 3) out vec2 v_TexCoord;
 layout (location = 4) out float v_FogFactor;
 
-layout(push_constant, std430) uniform PushConstants {
-  layout(offset = 0) mat4 u_MVP;
-  layout(offset = 64) vec4 u_PointLightPos;
-} u_PushConstants;
+layout(set = 1, binding = 0, std140) uniform OurUniforms {
+  mat4 u_MVP;
+  vec4 u_PointLightPos;
+  vec4 u_PointLightColor;
+  vec4 u_Tint;
+} u_Uniforms;
+
+// Feature keywords, set by the shader variant through specialization constants
+layout (constant_id = 0) const bool FEATURE_POINT_LIGHT = true;
+layout (constant_id = 1) const bool FEATURE_FOG = true;
 
 float FOG_START = 100.0;
 float FOG_END = 200.0;
@@ -37,10 +43,11 @@ float FOG_END = 200.0;
 void main()
 {
   v_Color = a_Color;
-  vec4 position = u_PushConstants.u_MVP * vec4(a_Position.x, a_Position.y, a_Position.z, 1.0);
+  vec4 position = u_Uniforms.u_MVP * vec4(a_Position.x, a_Position.y, a_Position.z, 1.0);
   gl_Position = position;
   v_Pos = position;
-  v_PointLightPos = u_PushConstants.u_MVP * u_PushConstants.u_PointLightPos;
+  v_PointLightPos = FEATURE_POINT_LIGHT ? u_Uniforms.u_MVP * u_Uniforms.u_PointLightPos : position;
   v_TexCoord = a_TexCoord;
-  v_FogFactor = clamp((v_Pos.z - FOG_START) / (FOG_END - FOG_START), 0.0, 1.0);
+  v_FogFactor = FEATURE_FOG ?
+      clamp((v_Pos.z - FOG_START) / (FOG_END - FOG_START), 0.0, 1.0) : 0.0;
 }
\ No newline at end of file
@@ -19,14 +19,14 @@
 layout (location = 0) in vec3 a_Position;
 layout (location = 1) in vec4 a_Color;
 
-layout (push_constant, std430) uniform PushConstants {
+layout(set = 1, binding = 0, std140) uniform BasicUniforms {
   mat4 u_MVP;
   vec4 u_Tint;
-} u_PushConstants;
+} u_Uniforms;
 
 layout(location = 0) out vec4 v_Color;
 
 void main() {
-  v_Color = a_Color * u_PushConstants.u_Tint;
-  gl_Position = u_PushConstants.u_MVP * vec4(a_Position.x, a_Position.y, a_Position.z, 1.0);
+  v_Color = a_Color * u_Uniforms.u_Tint;
+  gl_Position = u_Uniforms.u_MVP * vec4(a_Position.x, a_Position.y, a_Position.z, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#version 450
+
+// The tunnel sections visible in a frame are drawn as instances of a single
+// section, each offset along the tunnel and lit by the obstacle of its section
+
+layout (location = 0) in vec3 a_Position;
+layout (location = 1) in vec2 a_TexCoord;
+layout (location = 2) in vec4 a_Color;
+
+layout (location = 0) out vec4 v_Color;
+layout (location = 1) out vec4 v_Pos;
+layout (location = 2) out vec4 v_PointLightPos;
+layout (location = 3) out vec2 v_TexCoord;
+layout (location = 4) out float v_FogFactor;
+layout (location = 5) flat out vec4 v_PointLightColor;
+
+// u_MVP transforms the first instance, u_SectionOffset is the model space
+// offset between instances and u_SectionLights holds the point light color of
+// each instance, packed as r + g * 256 + b * 65536 with 8 bits per channel
+layout(set = 1, binding = 0, std140) uniform TunnelUniforms {
+  mat4 u_MVP;
+  vec4 u_SectionOffset;
+  vec4 u_SectionLights[2];
+} u_Uniforms;
+
+float FOG_START = 100.0;
+float FOG_END = 200.0;
+
+void main()
+{
+  int section = gl_InstanceIndex;
+  vec4 offset = vec4(u_Uniforms.u_SectionOffset.xyz * float(section), 0.0);
+  float packedLight = u_Uniforms.u_SectionLights[section / 4][section % 4];
+  vec3 lightColor = mod(floor(packedLight / vec3(1.0, 256.0, 65536.0)), 256.0) / 255.0;
+
+  v_Color = a_Color;
+  vec4 position = u_Uniforms.u_MVP * (vec4(a_Position, 1.0) + offset);
+  gl_Position = position;
+  v_Pos = position;
+  // The point light is at the center of the section
+  v_PointLightPos = u_Uniforms.u_MVP * (vec4(0.0, 0.0, 0.0, 1.0) + offset);
+  v_PointLightColor = vec4(lightColor, packedLight > 0.0 ? 1.0 : 0.0);
+  v_TexCoord = a_TexCoord;
+  v_FogFactor = clamp((v_Pos.z - FOG_START) / (FOG_END - FOG_START), 0.0, 1.0);
+}
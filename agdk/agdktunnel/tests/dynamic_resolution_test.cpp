@@ -0,0 +1,195 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// Tests of DynamicResolution on synthetic frame times: the scale drops after a run of
+// over budget frames and rises after a longer run of frames with time to spare, a frame
+// within budget resets both runs, the scale stays within its limits, and the thermal
+// headroom lowers the maximum scale. host/android/thermal.h declares the thermal API,
+// defined here to return a headroom set by each test.
+
+#include "dynamic_resolution.hpp"
+#include "game_consts.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      ++failures; \
+    } \
+  } while (0)
+
+static float sFakeHeadroom = NAN;
+static AThermalManager *const kFakeManager = reinterpret_cast<AThermalManager *>(0x1);
+
+AThermalManager *AThermal_acquireManager() {
+  return kFakeManager;
+}
+
+void AThermal_releaseManager(AThermalManager *) {
+}
+
+float AThermal_getThermalHeadroom(AThermalManager *, int) {
+  return sFakeHeadroom;
+}
+
+// A 60 Hz frame budget, in nanoseconds
+static const uint64_t TARGET = 16666667;
+// Frame times for each load band
+static const uint64_t OVER_BUDGET = TARGET;
+static const uint64_t IN_BUDGET = static_cast<uint64_t>(TARGET * 0.8);
+static const uint64_t UNDER_BUDGET = TARGET / 2;
+
+static bool ScaleIs(const float scale, const float expected) {
+  return std::fabs(scale - expected) < 1e-4f;
+}
+
+// Feeds count frames with the same GPU time and a small CPU time, returns the last scale
+static float RunFrames(DynamicResolution &dynres, const uint64_t gpuFrameTime, const int count) {
+  float scale = dynres.GetScale();
+  for (int i = 0; i < count; ++i) {
+    scale = dynres.Update(gpuFrameTime, UNDER_BUDGET / 4, TARGET);
+  }
+  return scale;
+}
+
+static void TestDownscaleHysteresis() {
+  sFakeHeadroom = NAN;
+  DynamicResolution dynres;
+  CHECK(ScaleIs(dynres.GetScale(), DYNRES_MAX_SCALE));
+
+  // A run one frame short of the threshold, broken by a frame within budget
+  RunFrames(dynres, OVER_BUDGET, DYNRES_DOWNSCALE_FRAMES - 1);
+  CHECK(ScaleIs(dynres.GetScale(), DYNRES_MAX_SCALE));
+  RunFrames(dynres, IN_BUDGET, 1);
+  RunFrames(dynres, OVER_BUDGET, DYNRES_DOWNSCALE_FRAMES - 1);
+  CHECK(ScaleIs(dynres.GetScale(), DYNRES_MAX_SCALE));
+
+  // The frame completing a run drops one step, and the run starts over
+  RunFrames(dynres, OVER_BUDGET, 1);
+  CHECK(ScaleIs(dynres.GetScale(), DYNRES_MAX_SCALE - DYNRES_SCALE_STEP));
+  RunFrames(dynres, OVER_BUDGET, DYNRES_DOWNSCALE_FRAMES - 1);
+  CHECK(ScaleIs(dynres.GetScale(), DYNRES_MAX_SCALE - DYNRES_SCALE_STEP));
+  RunFrames(dynres, OVER_BUDGET, 1);
+  CHECK(ScaleIs(dynres.GetScale(), DYNRES_MAX_SCALE - 2 * DYNRES_SCALE_STEP));
+
+  // Frames within budget hold the scale indefinitely
+  RunFrames(dynres, IN_BUDGET, DYNRES_UPSCALE_FRAMES * 3);
+  CHECK(ScaleIs(dynres.GetScale(), DYNRES_MAX_SCALE - 2 * DYNRES_SCALE_STEP));
+}
+
+static void TestUpscaleHysteresis() {
+  sFakeHeadroom = NAN;
+  DynamicResolution dynres;
+  RunFrames(dynres, OVER_BUDGET, DYNRES_DOWNSCALE_FRAMES * 2);
+  const float lowered = DYNRES_MAX_SCALE - 2 * DYNRES_SCALE_STEP;
+  CHECK(ScaleIs(dynres.GetScale(), lowered));
+
+  // Headroom has to last DYNRES_UPSCALE_FRAMES, an over budget frame restarts the run
+  RunFrames(dynres, UNDER_BUDGET, DYNRES_UPSCALE_FRAMES - 1);
+  CHECK(ScaleIs(dynres.GetScale(), lowered));
+  RunFrames(dynres, OVER_BUDGET, 1);
+  RunFrames(dynres, UNDER_BUDGET, DYNRES_UPSCALE_FRAMES - 1);
+  CHECK(ScaleIs(dynres.GetScale(), lowered));
+  RunFrames(dynres, UNDER_BUDGET, 1);
+  CHECK(ScaleIs(dynres.GetScale(), lowered + DYNRES_SCALE_STEP));
+}
+
+static void TestClamp() {
+  sFakeHeadroom = NAN;
+  DynamicResolution dynres;
+  const int stepCount = static_cast<int>((DYNRES_MAX_SCALE - DYNRES_MIN_SCALE) /
+                                         DYNRES_SCALE_STEP + 0.5f);
+  // Far more over budget runs than steps to the minimum
+  RunFrames(dynres, OVER_BUDGET, DYNRES_DOWNSCALE_FRAMES * (stepCount + 10));
+  CHECK(ScaleIs(dynres.GetScale(), DYNRES_MIN_SCALE));
+  CHECK(dynres.GetScale() >= DYNRES_MIN_SCALE);
+
+  RunFrames(dynres, UNDER_BUDGET, DYNRES_UPSCALE_FRAMES * (stepCount + 10));
+  CHECK(ScaleIs(dynres.GetScale(), DYNRES_MAX_SCALE));
+  CHECK(dynres.GetScale() <= DYNRES_MAX_SCALE);
+}
+
+static void TestFrameTimes() {
+  sFakeHeadroom = NAN;
+  DynamicResolution dynres;
+  // The slower of the GPU and CPU decides, a GPU time of 0 reuses the last one
+  for (int i = 0; i < DYNRES_DOWNSCALE_FRAMES; ++i) {
+    dynres.Update(UNDER_BUDGET, OVER_BUDGET, TARGET);
+  }
+  CHECK(ScaleIs(dynres.GetScale(), DYNRES_MAX_SCALE - DYNRES_SCALE_STEP));
+  dynres.Update(OVER_BUDGET, UNDER_BUDGET, TARGET);
+  for (int i = 1; i < DYNRES_DOWNSCALE_FRAMES; ++i) {
+    dynres.Update(0, UNDER_BUDGET, TARGET);
+  }
+  CHECK(ScaleIs(dynres.GetScale(), DYNRES_MAX_SCALE - 2 * DYNRES_SCALE_STEP));
+
+  // Without a frame budget the load is unknown and the scale is left alone
+  for (int i = 0; i < DYNRES_DOWNSCALE_FRAMES * 2; ++i) {
+    dynres.Update(OVER_BUDGET, OVER_BUDGET, 0);
+  }
+  CHECK(ScaleIs(dynres.GetScale(), DYNRES_MAX_SCALE - 2 * DYNRES_SCALE_STEP));
+}
+
+// Maximum scale and first frame scale at a thermal headroom
+static void CheckThermalMaxScale(const float headroom, const float expectedMax) {
+  sFakeHeadroom = headroom;
+  DynamicResolution dynres;
+  const float scale = dynres.Update(IN_BUDGET, IN_BUDGET, TARGET);
+  if (!ScaleIs(dynres.GetMaxScale(), expectedMax) || !ScaleIs(scale, expectedMax)) {
+    fprintf(stderr, "headroom %g: max scale %g and scale %g, expected %g\n", headroom,
+            dynres.GetMaxScale(), scale, expectedMax);
+    ++failures;
+  }
+}
+
+static void TestThermalHeadroom() {
+  const float range = DYNRES_MAX_SCALE - DYNRES_MIN_SCALE;
+  const float midHeadroom = (DYNRES_THERMAL_HEADROOM_START + 1.0f) / 2.0f;
+  // Headroom unavailable, or far from throttling, leaves the full range
+  CheckThermalMaxScale(NAN, DYNRES_MAX_SCALE);
+  CheckThermalMaxScale(0.2f, DYNRES_MAX_SCALE);
+  CheckThermalMaxScale(DYNRES_THERMAL_HEADROOM_START, DYNRES_MAX_SCALE);
+  // Then the maximum falls linearly to the minimum scale at severe throttling
+  CheckThermalMaxScale(midHeadroom, DYNRES_MAX_SCALE - range / 2.0f);
+  CheckThermalMaxScale(1.0f, DYNRES_MIN_SCALE);
+  CheckThermalMaxScale(1.5f, DYNRES_MIN_SCALE);
+
+  // Headroom to spare does not raise the scale past the thermal maximum
+  sFakeHeadroom = midHeadroom;
+  DynamicResolution dynres;
+  RunFrames(dynres, UNDER_BUDGET, DYNRES_UPSCALE_FRAMES * 4);
+  CHECK(ScaleIs(dynres.GetScale(), DYNRES_MAX_SCALE - range / 2.0f));
+}
+
+int main() {
+  TestDownscaleHysteresis();
+  TestUpscaleHysteresis();
+  TestClamp();
+  TestFrameTimes();
+  TestThermalHeadroom();
+  if (failures != 0) {
+    fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  printf("DynamicResolution tests passed\n");
+  return 0;
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// Host replacement of the NDK thermal API, for the sources under test that query the
+// thermal headroom. The test defines the functions and controls the headroom returned.
+
+#ifndef agdktunnel_host_android_thermal_h
+#define agdktunnel_host_android_thermal_h
+
+struct AThermalManager;
+
+AThermalManager *AThermal_acquireManager();
+void AThermal_releaseManager(AThermalManager *manager);
+float AThermal_getThermalHeadroom(AThermalManager *manager, int forecastSeconds);
+
+#endif // agdktunnel_host_android_thermal_h
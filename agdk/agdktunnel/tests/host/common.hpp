@@ -0,0 +1,39 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host replacement of the common.hpp of agdktunnel, which pulls in the Android headers.
+// Provides the logging macros and headers used by the sources under test. It is included
+// ahead of every source and shares the include guard of the real common.hpp, so the
+// sources' own #include "common.hpp" finds it already included.
+
+#ifndef agdktunnel_common_hpp
+#define agdktunnel_common_hpp
+
+#include <pthread.h>
+
+#include <cstdio>
+
+#define ALOGI(...) do { fprintf(stdout, __VA_ARGS__); fputc('\n', stdout); } while (0)
+#define ALOGW(...) do { fprintf(stderr, __VA_ARGS__); fputc('\n', stderr); } while (0)
+#define ALOGE(...) do { fprintf(stderr, __VA_ARGS__); fputc('\n', stderr); } while (0)
+
+// Android API level checks, the host replacements of the APIs they guard are always
+// present. Clang accepts __builtin_available for other platforms, GCC has no such builtin
+#if !defined(__clang__)
+#define __builtin_available(...) true
+#endif
+
+#endif // agdktunnel_common_hpp
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Tests of SaveService, writing the save file on a background thread: the file contents,
+// coalescing of requests and completions that were not polled, write failures and the
+// final write on destruction.
+
+#include "save_service.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      ++failures; \
+    } \
+  } while (0)
+
+// Level in the save file, -1 if it cannot be read
+static int ReadSavedLevel(const std::string &fileName) {
+  int level = -1;
+  FILE *f = fopen(fileName.c_str(), "r");
+  if (f != nullptr) {
+    if (fscanf(f, "v1 %d", &level) != 1) {
+      level = -1;
+    }
+    fclose(f);
+  }
+  return level;
+}
+
+static void TestWrite(const std::string &dir) {
+  const std::string fileName = dir + "/write.dat";
+  SaveService service(fileName.c_str());
+  SaveCompletion completion;
+  CHECK(!service.PollCompletion(&completion));
+
+  service.RequestSave({3});
+  service.WaitForIdle();
+  CHECK(ReadSavedLevel(fileName) == 3);
+  CHECK(access((fileName + ".tmp").c_str(), F_OK) != 0);
+
+  CHECK(service.PollCompletion(&completion));
+  CHECK(completion.snapshot.level == 3 && completion.success);
+  CHECK(completion.coalescedCount == 0);
+  CHECK(!service.PollCompletion(&completion));
+}
+
+// Requests and completions are merged differently depending on how far the writer got,
+// but nothing is lost: one completion with the latest level accounts for every request
+static void TestCoalescing(const std::string &dir) {
+  const std::string fileName = dir + "/coalesce.dat";
+  SaveService service(fileName.c_str());
+  const int requestCount = 200;
+  for (int level = 1; level <= requestCount; ++level) {
+    service.RequestSave({level});
+    if (level % 10 == 0) {
+      usleep(500);
+    }
+  }
+  service.WaitForIdle();
+  CHECK(ReadSavedLevel(fileName) == requestCount);
+
+  SaveCompletion completion;
+  CHECK(service.PollCompletion(&completion));
+  CHECK(completion.snapshot.level == requestCount && completion.success);
+  CHECK(completion.coalescedCount == requestCount - 1);
+  CHECK(!service.PollCompletion(&completion));
+}
+
+static void TestFailure(const std::string &dir) {
+  const std::string fileName = dir + "/missing/fail.dat";
+  SaveService service(fileName.c_str());
+  service.RequestSave({5});
+  service.WaitForIdle();
+
+  SaveCompletion completion;
+  CHECK(service.PollCompletion(&completion));
+  CHECK(completion.snapshot.level == 5 && !completion.success);
+}
+
+static void TestDestructorWritesPending(const std::string &dir) {
+  const std::string fileName = dir + "/shutdown.dat";
+  {
+    SaveService service(fileName.c_str());
+    service.RequestSave({1});
+    service.RequestSave({7});
+  }
+  CHECK(ReadSavedLevel(fileName) == 7);
+}
+
+int main() {
+  char dirTemplate[] = "/tmp/save_service_test.XXXXXX";
+  if (mkdtemp(dirTemplate) == nullptr) {
+    perror("mkdtemp");
+    return 1;
+  }
+  const std::string dir = dirTemplate;
+
+  TestWrite(dir);
+  TestCoalescing(dir);
+  TestFailure(dir);
+  TestDestructorWritesPending(dir);
+
+  const std::string removeCommand = "rm -rf " + dir;
+  if (system(removeCommand.c_str()) != 0) {
+    fprintf(stderr, "could not remove %s\n", dir.c_str());
+  }
+  if (failures != 0) {
+    fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  printf("SaveService tests passed\n");
+  return 0;
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Tests of SpscRing, the lock-free queue between the game thread and the audio callback:
+// empty and full rings, FIFO order across wrap arounds, then a producer and a consumer
+// thread passing a million sequence numbers through a small ring.
+
+#include "spsc_ring.hpp"
+
+#include <cstdio>
+#include <thread>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      ++failures; \
+    } \
+  } while (0)
+
+static void TestEmptyAndFull() {
+  SpscRing<int, 4> ring;
+  int item = -1;
+  CHECK(ring.IsEmpty());
+  CHECK(!ring.Pop(&item) && item == -1);
+
+  for (int i = 0; i < 4; ++i) {
+    CHECK(ring.Push(i));
+  }
+  CHECK(!ring.Push(4));
+  CHECK(!ring.IsEmpty());
+
+  for (int i = 0; i < 4; ++i) {
+    CHECK(ring.Pop(&item) && item == i);
+  }
+  CHECK(!ring.Pop(&item));
+  CHECK(ring.IsEmpty());
+}
+
+static void TestWrapAround() {
+  SpscRing<int, 8> ring;
+  int next_push = 0;
+  int next_pop = 0;
+  // Uneven batches so the head and tail cross the end of the storage at every offset
+  for (int round = 0; round < 1000; ++round) {
+    const int pushes = 1 + round % 8;
+    for (int i = 0; i < pushes; ++i) {
+      if (ring.Push(next_push)) {
+        ++next_push;
+      }
+    }
+    const int pops = 1 + (round * 3) % 8;
+    int item = 0;
+    for (int i = 0; i < pops && ring.Pop(&item); ++i) {
+      CHECK(item == next_pop);
+      ++next_pop;
+    }
+    CHECK(next_push - next_pop >= 0 && next_push - next_pop <= 8);
+  }
+}
+
+static void TestTwoThreads() {
+  static const uint32_t kItemCount = 1000000;
+  SpscRing<uint32_t, 64> ring;
+  uint32_t mismatches = 0;
+
+  std::thread consumer([&ring, &mismatches]() {
+    uint32_t expected = 0;
+    while (expected < kItemCount) {
+      uint32_t item = 0;
+      if (ring.Pop(&item)) {
+        mismatches += (item != expected) ? 1 : 0;
+        ++expected;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  for (uint32_t i = 0; i < kItemCount;) {
+    if (ring.Push(i)) {
+      ++i;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  consumer.join();
+
+  CHECK(mismatches == 0);
+  CHECK(ring.IsEmpty());
+}
+
+int main() {
+  TestEmptyAndFull();
+  TestWrapAround();
+  TestTwoThreads();
+  if (failures != 0) {
+    fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  printf("SpscRing tests passed\n");
+  return 0;
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// Bakes the ASCII art of agdktunnel (alphabet.inl and ascii_art.inl) into the vertex
+// and index tables of data/ascii_art_baked.inl, using the same parser as the game,
+// so the game does not parse any art at startup.
+//
+// Usage: ascii_art_bake [--check] <output.inl>
+// With --check the file is not written; the tool fails if its contents differ from
+// the freshly baked tables.
+
+#include "ascii_art_parser.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "alphabet.inl"
+#include "ascii_art.inl"
+
+static const int ALPHABET_SIZE = 128;
+static_assert(sizeof(ALPHABET_ART) / sizeof(ALPHABET_ART[0]) == ALPHABET_SIZE,
+              "unexpected alphabet size");
+
+struct ArtSource {
+  const char *name;
+  const char *art;
+};
+
+// Indexed by BakedArt
+static const ArtSource BAKED_ART_SOURCES[BAKED_ART_COUNT] = {
+    {"BAKED_ART_LIFE", ART_LIFE},
+};
+
+static const char *LICENSE_HEADER =
+    "/*\n"
+    " * Copyright 2023 The Android Open Source Project\n"
+    " *\n"
+    " * Licensed under the Apache License, Version 2.0 (the \"License\");\n"
+    " * you may not use this file except in compliance with the License.\n"
+    " * You may obtain a copy of the License at\n"
+    " *\n"
+    " *     https://www.apache.org/licenses/LICENSE-2.0\n"
+    " *\n"
+    " * Unless required by applicable law or agreed to in writing, software\n"
+    " * distributed under the License is distributed on an \"AS IS\" BASIS,\n"
+    " * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.\n"
+    " * See the License for the specific language governing permissions and\n"
+    " * limitations under the License.\n"
+    " */\n";
+
+class Baker {
+ public:
+  // Parse a piece of art at a scale of 1 and append it to the tables
+  bool Add(const char *art, BakedAsciiArt &baked) {
+    std::vector<float> positions;
+    std::vector<uint16_t> indices;
+    if (!ParseAsciiArt(art, 1.0f, positions, indices)) {
+      return false;
+    }
+    baked.firstVertex = static_cast<uint32_t>(mPositions.size() / 2);
+    baked.vertexCount = static_cast<uint32_t>(positions.size() / 2);
+    baked.firstIndex = static_cast<uint32_t>(mIndices.size());
+    baked.indexCount = static_cast<uint32_t>(indices.size());
+    mPositions.insert(mPositions.end(), positions.begin(), positions.end());
+    mIndices.insert(mIndices.end(), indices.begin(), indices.end());
+    return true;
+  }
+
+  void WritePositions(std::ostringstream &out) const {
+    out << "// XY positions at a scale of 1, two floats per vertex\n";
+    out << "static const float BAKED_ART_POSITIONS[] = {\n";
+    for (size_t i = 0; i < mPositions.size(); i += 2) {
+      char line[64];
+      snprintf(line, sizeof(line), "    %s, %s,\n", FormatFloat(mPositions[i]).c_str(),
+               FormatFloat(mPositions[i + 1]).c_str());
+      out << line;
+    }
+    out << "};\n\n";
+  }
+
+  void WriteIndices(std::ostringstream &out) const {
+    out << "// Pairs of line indices, relative to the first vertex of each art\n";
+    out << "static const uint16_t BAKED_ART_INDICES[] = {\n";
+    for (size_t i = 0; i < mIndices.size(); i += 2) {
+      out << "    " << mIndices[i] << ", " << mIndices[i + 1] << ",\n";
+    }
+    out << "};\n\n";
+  }
+
+ private:
+  static std::string FormatFloat(const float value) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.9g", value);
+    std::string result(text);
+    if (result.find_first_of(".e") == std::string::npos) {
+      result += ".0";
+    }
+    return result + "f";
+  }
+
+  std::vector<float> mPositions;
+  std::vector<uint16_t> mIndices;
+};
+
+static void WriteBakedArt(std::ostringstream &out, const BakedAsciiArt &baked,
+                          const char *comment) {
+  out << "    {" << baked.firstVertex << ", " << baked.vertexCount << ", " <<
+      baked.firstIndex << ", " << baked.indexCount << "}, // " << comment << "\n";
+}
+
+static bool Bake(std::string &result) {
+  Baker baker;
+  BakedAsciiArt glyphs[ALPHABET_SIZE];
+  memset(glyphs, 0, sizeof(glyphs));
+  for (int i = 0; i < ALPHABET_SIZE; ++i) {
+    if (ALPHABET_ART[i] && !baker.Add(ALPHABET_ART[i], glyphs[i])) {
+      fprintf(stderr, "ascii_art_bake: invalid art for chr %d\n", i);
+      return false;
+    }
+  }
+  BakedAsciiArt arts[BAKED_ART_COUNT];
+  for (int i = 0; i < BAKED_ART_COUNT; ++i) {
+    if (!baker.Add(BAKED_ART_SOURCES[i].art, arts[i])) {
+      fprintf(stderr, "ascii_art_bake: invalid art for %s\n", BAKED_ART_SOURCES[i].name);
+      return false;
+    }
+  }
+
+  std::ostringstream out;
+  out << LICENSE_HEADER << "\n";
+  out << "// Generated by tools/ascii_art_bake from alphabet.inl and ascii_art.inl, do not\n";
+  out << "// edit. Rebuild the bake_ascii_art target of the tool after changing the art.\n\n";
+  out << "#ifndef agdktunnel_ascii_art_baked_inl\n";
+  out << "#define agdktunnel_ascii_art_baked_inl\n\n";
+  out << "#include \"ascii_art_parser.hpp\"\n\n";
+  baker.WritePositions(out);
+  baker.WriteIndices(out);
+  out << "// Alphabet glyphs indexed by character code, a vertex count of 0 means no glyph\n";
+  out << "static const BakedAsciiArt BAKED_ALPHABET[" << ALPHABET_SIZE << "] = {\n";
+  for (int i = 0; i < ALPHABET_SIZE; ++i) {
+    char comment[16];
+    snprintf(comment, sizeof(comment), "chr %d", i);
+    WriteBakedArt(out, glyphs[i], comment);
+  }
+  out << "};\n\n";
+  out << "// Indexed by BakedArt\n";
+  out << "static const BakedAsciiArt BAKED_ARTS[BAKED_ART_COUNT] = {\n";
+  for (int i = 0; i < BAKED_ART_COUNT; ++i) {
+    WriteBakedArt(out, arts[i], BAKED_ART_SOURCES[i].name);
+  }
+  out << "};\n\n";
+  out << "#endif\n";
+
+  result = out.str();
+  return true;
+}
+
+int main(int argc, char **argv) {
+  bool check = false;
+  const char *path = NULL;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--check") == 0) {
+      check = true;
+    } else {
+      path = argv[i];
+    }
+  }
+  if (!path) {
+    fprintf(stderr, "Usage: ascii_art_bake [--check] <output.inl>\n");
+    return 2;
+  }
+
+  std::string baked;
+  if (!Bake(baked)) {
+    return 1;
+  }
+
+  if (check) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    if (!file || contents.str() != baked) {
+      fprintf(stderr, "ascii_art_bake: %s is out of date, rebuild bake_ascii_art\n", path);
+      return 1;
+    }
+    printf("ascii_art_bake: %s is up to date\n", path);
+    return 0;
+  }
+
+  std::ofstream file(path, std::ios::binary);
+  file << baked;
+  if (!file) {
+    fprintf(stderr, "ascii_art_bake: failed to write %s\n", path);
+    return 1;
+  }
+  printf("ascii_art_bake: wrote %s\n", path);
+  return 0;
+}
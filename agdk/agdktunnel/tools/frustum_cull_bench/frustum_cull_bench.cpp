@@ -0,0 +1,154 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks FrustumCuller::Cull, which tests four boxes at a time with NEON or SSE,
+// against FrustumCuller::CullScalar on random frustums and boxes, then times both.
+// Both paths perform the same operations in the same order, so they must keep exactly
+// the same boxes. Every culled box is also checked to have all of its corners behind
+// one frustum plane.
+//
+// Usage: frustum_cull_bench [box count] [seed]
+// Exits with a failure status on the first mismatch.
+
+#include "frustum_culler.hpp"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+static const int FRUSTUM_COUNT = 16;
+static const int TIMED_PASSES = 5;
+
+// Allowed distance in front of the plane for the corners of a culled box, relative to
+// the magnitude of their clip space coordinates, for the float rounding of the culler
+static const double CORNER_TOLERANCE = 1e-5;
+
+// Whether all the corners of the box are behind one of the clip space planes
+static bool IsBoxOutside(const glm::mat4 &worldToClip, const glm::vec3 &center,
+                         const glm::vec3 &halfExtents) {
+  for (int axis = 0; axis < 3; ++axis) {
+    for (int side = -1; side <= 1; side += 2) {
+      bool allBehind = true;
+      for (int corner = 0; corner < 8 && allBehind; ++corner) {
+        const glm::vec3 point(center.x + ((corner & 1) ? halfExtents.x : -halfExtents.x),
+                              center.y + ((corner & 2) ? halfExtents.y : -halfExtents.y),
+                              center.z + ((corner & 4) ? halfExtents.z : -halfExtents.z));
+        double clip[4];
+        for (int row = 0; row < 4; ++row) {
+          clip[row] = (double) worldToClip[0][row] * point.x +
+                      (double) worldToClip[1][row] * point.y +
+                      (double) worldToClip[2][row] * point.z + (double) worldToClip[3][row];
+        }
+        // Inside the plane when -w <= x, y or z (side -1) or x, y or z <= w (side 1)
+        allBehind = clip[3] - side * clip[axis] <
+                    CORNER_TOLERANCE * (fabs(clip[3]) + fabs(clip[axis]));
+      }
+      if (allBehind) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Best of TIMED_PASSES, in nanoseconds per box
+static double TimeCull(const FrustumCuller &culler, bool scalar,
+                       std::vector<uint32_t> &visible) {
+  double best = 0.0;
+  for (int pass = 0; pass < TIMED_PASSES; ++pass) {
+    auto start = std::chrono::steady_clock::now();
+    if (scalar) {
+      culler.CullScalar(visible);
+    } else {
+      culler.Cull(visible);
+    }
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (pass == 0 || seconds < best) {
+      best = seconds;
+    }
+  }
+  return best * 1e9 / culler.GetBoxCount();
+}
+
+int main(int argc, char **argv) {
+  size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+  unsigned seed = argc > 2 ? (unsigned) strtoul(argv[2], nullptr, 10) : 1;
+  if (count == 0) {
+    fprintf(stderr, "usage: %s [box count] [seed]\n", argv[0]);
+    return 1;
+  }
+
+  // Boxes of the sizes of tunnel sections and obstacle boxes, scattered around and
+  // inside the frustums, so many of them straddle a plane
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> position(-150.0f, 150.0f);
+  std::uniform_real_distribution<float> size(0.01f, 20.0f);
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+  FrustumCuller culler;
+  std::vector<glm::vec3> centers(count), halfExtents(count);
+  for (size_t i = 0; i < count; ++i) {
+    centers[i] = glm::vec3(position(rng), position(rng), position(rng));
+    halfExtents[i] = glm::vec3(size(rng), size(rng), size(rng));
+    culler.AddBox(centers[i], halfExtents[i]);
+  }
+
+  std::vector<uint32_t> visible, visibleScalar;
+  double cullTime = 0.0, scalarTime = 0.0;
+  size_t visibleCount = 0;
+  for (int frustum = 0; frustum < FRUSTUM_COUNT; ++frustum) {
+    const glm::vec3 eye(unit(rng) * 20.0f, unit(rng) * 20.0f, unit(rng) * 20.0f);
+    const glm::vec3 target(unit(rng) * 100.0f, unit(rng) * 100.0f, unit(rng) * 100.0f);
+    const glm::mat4 worldToClip =
+        glm::perspective(0.6f + 0.5f * unit(rng), 16.0f / 9.0f, 0.1f, 250.0f) *
+        glm::lookAt(eye, target, glm::vec3(0.0f, 0.0f, 1.0f));
+    culler.SetFrustum(worldToClip);
+
+    culler.Cull(visible);
+    culler.CullScalar(visibleScalar);
+    if (visible != visibleScalar) {
+      fprintf(stderr, "frustum %d: Cull keeps %zu boxes, CullScalar %zu\n", frustum,
+              visible.size(), visibleScalar.size());
+      return 1;
+    }
+
+    size_t next = 0;
+    for (uint32_t index = 0; index < count; ++index) {
+      if (next < visible.size() && visible[next] == index) {
+        ++next;
+      } else if (!IsBoxOutside(worldToClip, centers[index], halfExtents[index])) {
+        fprintf(stderr, "frustum %d: box %u is culled but not behind any plane\n", frustum,
+                index);
+        return 1;
+      }
+    }
+
+    cullTime += TimeCull(culler, false, visible);
+    scalarTime += TimeCull(culler, true, visibleScalar);
+    visibleCount += visible.size();
+  }
+
+  printf("%zu boxes, %d frustums (seed %u): Cull matches CullScalar, %zu boxes visible\n",
+         count, FRUSTUM_COUNT, seed, visibleCount);
+  printf("CullScalar %.2f ns per box, Cull %.2f ns per box (%.2fx)\n",
+         scalarTime / FRUSTUM_COUNT, cullTime / FRUSTUM_COUNT, scalarTime / cullTime);
+  return 0;
+}
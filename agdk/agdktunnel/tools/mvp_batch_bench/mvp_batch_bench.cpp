@@ -0,0 +1,164 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks BuildMVPs and BuildMVPsScalar against each other and against the glm matrix
+// products they replace, then times the three of them on the same random batch.
+// The SIMD and scalar paths perform the same operations in the same order, so their
+// results must be bit identical; glm multiplies full matrices in another order, so it
+// is compared with a tolerance.
+//
+// Usage: mvp_batch_bench [matrix count] [seed]
+// Exits with a failure status on the first mismatch.
+
+#include "mvp_batch.hpp"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+static const int TIMED_PASSES = 5;
+
+// Relative tolerance against glm, scaled by the largest element of the glm matrix
+static const float GLM_TOLERANCE = 1e-5f;
+
+static void BuildMVPsGlm(const glm::mat4 &viewProj, const ModelTransform *transforms,
+                         const uint32_t count, const glm::mat4 *local, glm::mat4 *outMvps) {
+  for (uint32_t i = 0; i < count; ++i) {
+    const ModelTransform &transform = transforms[i];
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), transform.translation);
+    model = glm::scale(model, transform.scale);
+    model = glm::rotate(model, transform.rotationZ, glm::vec3(0.0f, 0.0f, 1.0f));
+    outMvps[i] = local == nullptr ? viewProj * model : viewProj * model * (*local);
+  }
+}
+
+static const char *PathName(bool withLocal) {
+  return withLocal ? "with local matrix" : "without local matrix";
+}
+
+static bool CheckMVPs(const std::vector<glm::mat4> &simd, const std::vector<glm::mat4> &scalar,
+                      const std::vector<glm::mat4> &reference, bool withLocal) {
+  float maxError = 0.0f;
+  for (size_t i = 0; i < reference.size(); ++i) {
+    if (memcmp(&simd[i], &scalar[i], sizeof(glm::mat4)) != 0) {
+      fprintf(stderr, "matrix %zu %s: BuildMVPs and BuildMVPsScalar differ\n", i,
+              PathName(withLocal));
+      return false;
+    }
+    float magnitude = 1.0f;
+    for (int c = 0; c < 4; ++c) {
+      for (int r = 0; r < 4; ++r) {
+        magnitude = std::max(magnitude, fabsf(reference[i][c][r]));
+      }
+    }
+    for (int c = 0; c < 4; ++c) {
+      for (int r = 0; r < 4; ++r) {
+        float error = fabsf(scalar[i][c][r] - reference[i][c][r]) / magnitude;
+        maxError = std::max(maxError, error);
+        if (!(error <= GLM_TOLERANCE)) {
+          fprintf(stderr, "matrix %zu %s: [%d][%d] is %g, glm gives %g\n", i,
+                  PathName(withLocal), c, r, scalar[i][c][r], reference[i][c][r]);
+          return false;
+        }
+      }
+    }
+  }
+  printf("%s: SIMD and scalar bit identical, max relative error to glm %g\n",
+         PathName(withLocal), maxError);
+  return true;
+}
+
+typedef void (*BuildFunction)(const glm::mat4 &, const ModelTransform *, const uint32_t,
+                              const glm::mat4 *, glm::mat4 *);
+
+// Best of TIMED_PASSES, in nanoseconds per matrix
+static double TimeBuild(BuildFunction build, const glm::mat4 &viewProj,
+                        const std::vector<ModelTransform> &transforms, const glm::mat4 *local,
+                        std::vector<glm::mat4> &out) {
+  double best = 0.0;
+  for (int pass = 0; pass < TIMED_PASSES; ++pass) {
+    auto start = std::chrono::steady_clock::now();
+    build(viewProj, transforms.data(), static_cast<uint32_t>(transforms.size()), local,
+          out.data());
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (pass == 0 || seconds < best) {
+      best = seconds;
+    }
+  }
+  return best * 1e9 / transforms.size();
+}
+
+int main(int argc, char **argv) {
+  size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+  unsigned seed = argc > 2 ? (unsigned) strtoul(argv[2], nullptr, 10) : 1;
+  if (count == 0) {
+    fprintf(stderr, "usage: %s [matrix count] [seed]\n", argv[0]);
+    return 1;
+  }
+
+  // A camera and objects like the ones of the play scene
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+  std::uniform_real_distribution<float> size(0.1f, 10.0f);
+  std::uniform_real_distribution<float> angle(-6.3f, 6.3f);
+  const glm::mat4 viewProj =
+      glm::perspective(1.0f, 16.0f / 9.0f, 0.1f, 500.0f) *
+      glm::lookAt(glm::vec3(1.0f, -5.0f, 2.0f), glm::vec3(0.0f, 50.0f, 0.0f),
+                  glm::vec3(0.0f, 0.0f, 1.0f));
+  const glm::mat4 local = glm::rotate(glm::translate(glm::mat4(1.0f),
+                                                     glm::vec3(0.5f, -0.25f, 1.0f)),
+                                      0.7f, glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f)));
+
+  std::vector<ModelTransform> transforms(count);
+  for (size_t i = 0; i < count; ++i) {
+    ModelTransform &transform = transforms[i];
+    transform.translation = glm::vec3(position(rng), position(rng), position(rng));
+    transform.scale = glm::vec3(size(rng), size(rng), size(rng));
+    // Most objects of the game are not rotated, which skips the sine and cosine
+    transform.rotationZ = (i % 4 == 0) ? angle(rng) : 0.0f;
+  }
+
+  const uint32_t batchSize = static_cast<uint32_t>(count);
+  std::vector<glm::mat4> simd(count), scalar(count), reference(count);
+  for (int withLocal = 0; withLocal <= 1; ++withLocal) {
+    const glm::mat4 *localMatrix = withLocal ? &local : nullptr;
+    BuildMVPs(viewProj, transforms.data(), batchSize, localMatrix, simd.data());
+    BuildMVPsScalar(viewProj, transforms.data(), batchSize, localMatrix, scalar.data());
+    BuildMVPsGlm(viewProj, transforms.data(), batchSize, localMatrix, reference.data());
+    if (!CheckMVPs(simd, scalar, reference, withLocal)) {
+      return 1;
+    }
+  }
+
+  for (int withLocal = 0; withLocal <= 1; ++withLocal) {
+    const glm::mat4 *localMatrix = withLocal ? &local : nullptr;
+    double glmTime = TimeBuild(BuildMVPsGlm, viewProj, transforms, localMatrix, reference);
+    double scalarTime = TimeBuild(BuildMVPsScalar, viewProj, transforms, localMatrix, scalar);
+    double simdTime = TimeBuild(BuildMVPs, viewProj, transforms, localMatrix, simd);
+    printf("%zu matrices %s: glm %.2f ns, scalar %.2f ns (%.2fx), BuildMVPs %.2f ns "
+           "(%.2fx)\n", count, PathName(withLocal), glmTime, scalarTime,
+           glmTime / scalarTime, simdTime, glmTime / simdTime);
+  }
+  return 0;
+}
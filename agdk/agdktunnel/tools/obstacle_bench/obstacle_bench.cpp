@@ -0,0 +1,198 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Generates millions of obstacles with the game's ObstacleGenerator and checks the
+// bitmask obstacle code against straightforward per-cell versions of the same logic:
+// the dilation behind the bonus candidates, the choice of the bonus cell and the cell
+// lookups of the collision test. Then it times the generation and the collision tests.
+//
+// Usage: obstacle_bench [obstacle count] [seed]
+// Exits with a failure status on the first mismatch.
+
+#include "obstacle.hpp"
+#include "obstacle_generator.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static const int MAX_DIFFICULTY = 12;
+static const int POSITIONS_PER_OBSTACLE = 16;
+
+// Mirrors BONUS_PROBABILITY in obstacle.cpp
+static const float BONUS_PROBABILITY = 0.7f;
+
+typedef bool CellGrid[OBS_GRID_SIZE][OBS_GRID_SIZE];  // [col][row]
+
+static void MaskToGrid(Obstacle::CellMask mask, CellGrid grid) {
+  for (int c = 0; c < OBS_GRID_SIZE; c++) {
+    for (int r = 0; r < OBS_GRID_SIZE; r++) {
+      grid[c][r] = (mask >> (r * OBS_GRID_SIZE + c)) & 1;
+    }
+  }
+}
+
+// The cells within one step of a filled cell, by scanning the 3x3 neighbourhood
+static void ReferenceDilate(const CellGrid grid, CellGrid dilated) {
+  for (int c = 0; c < OBS_GRID_SIZE; c++) {
+    for (int r = 0; r < OBS_GRID_SIZE; r++) {
+      dilated[c][r] = false;
+      for (int j = c - 1; j <= c + 1; j++) {
+        for (int i = r - 1; i <= r + 1; i++) {
+          if (i >= 0 && i < OBS_GRID_SIZE && j >= 0 && j < OBS_GRID_SIZE && grid[j][i]) {
+            dilated[c][r] = true;
+          }
+        }
+      }
+    }
+  }
+}
+
+// Obstacle::PutRandomBonus on a per-cell grid, drawing the same random numbers
+static void ReferencePutRandomBonus(const CellGrid grid, int *bonusCol, int *bonusRow) {
+  *bonusCol = *bonusRow = -1;
+  if (Random(100) * 0.01f > BONUS_PROBABILITY) {
+    return;
+  }
+  CellGrid candidate;
+  ReferenceDilate(grid, candidate);
+  int r0 = Random(0, OBS_GRID_SIZE);
+  int c0 = Random(0, OBS_GRID_SIZE);
+  for (int rd = 0; rd < OBS_GRID_SIZE && *bonusRow < 0; rd++) {
+    for (int cd = 0; cd < OBS_GRID_SIZE; cd++) {
+      int r = (r0 + rd) % OBS_GRID_SIZE;
+      int c = (c0 + cd) % OBS_GRID_SIZE;
+      if (!grid[c][r] && candidate[c][r]) {
+        *bonusRow = r;
+        *bonusCol = c;
+        break;
+      }
+    }
+  }
+}
+
+static bool CheckObstacle(Obstacle &o, size_t index) {
+  if ((o.mask & ~Obstacle::ALL_CELLS) != 0 || o.style < 1 || o.style > 7) {
+    fprintf(stderr, "obstacle %zu: bad mask 0x%x or style %d\n", index, o.mask, o.style);
+    return false;
+  }
+
+  CellGrid grid, dilated;
+  MaskToGrid(o.mask, grid);
+  ReferenceDilate(grid, dilated);
+  Obstacle::CellMask dilatedMask = Obstacle::Dilate(o.mask);
+  for (int c = 0; c < OBS_GRID_SIZE; c++) {
+    for (int r = 0; r < OBS_GRID_SIZE; r++) {
+      if (dilated[c][r] != ((dilatedMask & Obstacle::GetCellMask(c, r)) != 0)) {
+        fprintf(stderr, "obstacle %zu: Dilate(0x%x) differs at col %d row %d\n",
+                index, o.mask, c, r);
+        return false;
+      }
+    }
+  }
+
+  // Pick the bonus again both ways from the same random state
+  uint32_t state = GetRandomState();
+  Obstacle rebonused = o;
+  rebonused.DeleteBonus();
+  rebonused.PutRandomBonus();
+  uint32_t stateAfter = GetRandomState();
+  SetRandomState(state);
+  int bonusCol, bonusRow;
+  ReferencePutRandomBonus(grid, &bonusCol, &bonusRow);
+  if (rebonused.bonusCol != bonusCol || rebonused.bonusRow != bonusRow ||
+      GetRandomState() != stateAfter) {
+    fprintf(stderr, "obstacle %zu: bonus of 0x%x at (%d, %d), expected (%d, %d)\n", index,
+            o.mask, rebonused.bonusCol, rebonused.bonusRow, bonusCol, bonusRow);
+    return false;
+  }
+  return true;
+}
+
+static float RandomCoord(float halfSize) {
+  return (Random(10000) / 10000.0f * 2.0f - 1.0f) * halfSize;
+}
+
+int main(int argc, char **argv) {
+  size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 3000000;
+  uint32_t seed = argc > 2 ? (uint32_t) strtoul(argv[2], nullptr, 10) : 1;
+  if (count == 0) {
+    fprintf(stderr, "usage: %s [obstacle count] [seed]\n", argv[0]);
+    return 1;
+  }
+
+  std::vector<Obstacle> obstacles(count);
+  ObstacleGenerator generator;
+  SetRandomState(seed);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < count; i++) {
+    generator.SetDifficulty(i % (MAX_DIFFICULTY + 1));
+    generator.Generate(&obstacles[i]);
+  }
+  double generateSeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  for (size_t i = 0; i < count; i++) {
+    if (!CheckObstacle(obstacles[i], i)) {
+      return 1;
+    }
+  }
+
+  // The lookups of PlayScene::DetectCollisions at random player positions
+  std::vector<float> positions(POSITIONS_PER_OBSTACLE * 2);
+  for (float &p : positions) {
+    p = RandomCoord(TUNNEL_HALF_W);
+  }
+  size_t hits = 0, bonuses = 0;
+  start = std::chrono::steady_clock::now();
+  for (Obstacle &o : obstacles) {
+    for (int p = 0; p < POSITIONS_PER_OBSTACLE; p++) {
+      int col = o.GetColAt(positions[p * 2]);
+      int row = o.GetRowAt(positions[p * 2 + 1]);
+      Obstacle::CellMask cell = Obstacle::GetCellMask(col, row);
+      hits += (o.mask & cell) != 0;
+      bonuses += (o.GetBonusMask() & cell) != 0;
+    }
+  }
+  double testSeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  size_t referenceHits = 0, referenceBonuses = 0;
+  for (Obstacle &o : obstacles) {
+    CellGrid grid;
+    MaskToGrid(o.mask, grid);
+    for (int p = 0; p < POSITIONS_PER_OBSTACLE; p++) {
+      int col = o.GetColAt(positions[p * 2]);
+      int row = o.GetRowAt(positions[p * 2 + 1]);
+      referenceHits += grid[col][row];
+      referenceBonuses += !grid[col][row] && o.bonusCol == col && o.bonusRow == row;
+    }
+  }
+  if (hits != referenceHits || bonuses != referenceBonuses) {
+    fprintf(stderr, "collision tests: %zu hits and %zu bonuses, expected %zu and %zu\n",
+            hits, bonuses, referenceHits, referenceBonuses);
+    return 1;
+  }
+
+  size_t tests = count * POSITIONS_PER_OBSTACLE;
+  printf("%zu obstacles (seed %u) match the per-cell reference\n", count, seed);
+  printf("generate: %.3f s, %.1f ns per obstacle\n", generateSeconds,
+         generateSeconds * 1e9 / count);
+  printf("collision tests: %zu in %.3f s, %.2f ns per test (%zu hits, %zu bonuses)\n",
+         tests, testSeconds, testSeconds * 1e9 / tests, hits, bonuses);
+  return 0;
+}
@@ -262,6 +262,9 @@ class DisplayManager {
     kSwapchain_Gained_Window = 1,
     /** @brief Swapchain was lost and needs to be recreated */
     kSwapchain_Needs_Recreation = 2,
+    /** @brief Swapchain is about to lose its window, sent before the window surface is
+     * destroyed. Stop any rendering to the swapchain from other threads before returning */
+    kSwapchain_Losing_Window = 3,
   };
 
   /** @brief Enum of possible swapchain present modes */
@@ -45,7 +45,11 @@ class GraphicsAPIFeatures {
     /** @brief Bit flag if 16-bit integer/float storage is supported in shader input/output */
     kGraphicsFeature_F16_I16_Input_Output,
     /** @brief Bit flag if wide lines are supported */
-    kGraphicsFeature_Wide_Lines
+    kGraphicsFeature_Wide_Lines,
+    /** @brief Bit flag if an indirect draw can execute more than one draw record */
+    kGraphicsFeature_Multi_Draw_Indirect,
+    /** @brief Bit flag if indirect draw records can specify a first instance other than 0 */
+    kGraphicsFeature_Draw_Indirect_First_Instance
   };
 
 /**
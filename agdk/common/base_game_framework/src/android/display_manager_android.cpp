@@ -22,6 +22,10 @@ namespace base_game_framework {
 void DisplayManager::HandlePlatformDisplayChange(const DisplayChangeMessage& change_message) {
   if (api_ != nullptr) {
     if (change_message == kDisplay_Change_Window_Terminate) {
+      // Let the application stop rendering to the surface before it goes away
+      if (api_->GetAPIStatus() == kGraphicsAPI_Active) {
+        api_->SwapchainChanged(kSwapchain_Losing_Window);
+      }
       // We need to kill our surface and disassociate the native window
       if (active_api_ == kGraphicsAPI_GLES && api_->GetAPIStatus() == kGraphicsAPI_Active) {
         api_gles_->LostSurfaceGLES();
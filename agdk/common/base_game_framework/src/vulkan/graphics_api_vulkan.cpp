@@ -262,6 +262,13 @@ void GraphicsAPIVulkan::QueryDeviceCapabilities(VkPhysicalDevice physical_device
   if (device_features.features.wideLines == VK_TRUE) {
     api_features_.SetGraphicsFeature(GraphicsAPIFeatures::kGraphicsFeature_Wide_Lines);
   }
+  if (device_features.features.multiDrawIndirect == VK_TRUE) {
+    api_features_.SetGraphicsFeature(GraphicsAPIFeatures::kGraphicsFeature_Multi_Draw_Indirect);
+  }
+  if (device_features.features.drawIndirectFirstInstance == VK_TRUE) {
+    api_features_.SetGraphicsFeature(
+        GraphicsAPIFeatures::kGraphicsFeature_Draw_Indirect_First_Instance);
+  }
 
   const uint32_t api_version = PlatformUtilVulkan::GetVulkanApiVersion();
   DetermineAPILevel(api_version, device_properties.properties.apiVersion);
@@ -809,6 +816,14 @@ bool GraphicsAPIVulkan::CreateDevice(bool is_preflight_check,
   if (api_features_.HasGraphicsFeature(GraphicsAPIFeatures::kGraphicsFeature_Wide_Lines)) {
     device_features.wideLines = VK_TRUE;
   }
+  if (api_features_.HasGraphicsFeature(
+      GraphicsAPIFeatures::kGraphicsFeature_Multi_Draw_Indirect)) {
+    device_features.multiDrawIndirect = VK_TRUE;
+  }
+  if (api_features_.HasGraphicsFeature(
+      GraphicsAPIFeatures::kGraphicsFeature_Draw_Indirect_First_Instance)) {
+    device_features.drawIndirectFirstInstance = VK_TRUE;
+  }
 
   const std::vector<const char *> required_device_extensions =
       PlatformUtilVulkan::GetRequiredDeviceExtensions(vk_physical_device_);
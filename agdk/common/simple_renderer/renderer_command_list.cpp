@@ -0,0 +1,227 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "renderer_command_list.h"
+#include "renderer_debug.h"
+
+namespace simple_renderer {
+
+CommandList::CommandList() {
+}
+
+CommandList::~CommandList() {
+}
+
+void CommandList::AddCommand(const CommandType type, const uint32_t resource_index,
+                             const uint32_t arg0, const uint32_t arg1, const uint32_t arg2) {
+  commands_.push_back({type, resource_index, {arg0, arg1, arg2}});
+}
+
+void CommandList::SetRenderPass(const std::shared_ptr<RenderPass>& render_pass) {
+  render_passes_.push_back(render_pass);
+  AddCommand(kCommand_SetRenderPass, static_cast<uint32_t>(render_passes_.size() - 1));
+}
+
+void CommandList::SetRenderState(const std::shared_ptr<RenderState>& render_state) {
+  render_states_.push_back(render_state);
+  AddCommand(kCommand_SetRenderState, static_cast<uint32_t>(render_states_.size() - 1));
+}
+
+void CommandList::BindIndexBuffer(const std::shared_ptr<IndexBuffer>& index_buffer) {
+  index_buffers_.push_back(index_buffer);
+  AddCommand(kCommand_BindIndexBuffer, static_cast<uint32_t>(index_buffers_.size() - 1));
+}
+
+void CommandList::BindVertexBuffer(const std::shared_ptr<VertexBuffer>& vertex_buffer) {
+  vertex_buffers_.push_back(vertex_buffer);
+  AddCommand(kCommand_BindVertexBuffer, static_cast<uint32_t>(vertex_buffers_.size() - 1));
+}
+
+void CommandList::BindTexture(const std::shared_ptr<Texture>& texture) {
+  textures_.push_back(texture);
+  AddCommand(kCommand_BindTexture, static_cast<uint32_t>(textures_.size() - 1));
+}
+
+void CommandList::SetBufferElementData(const std::shared_ptr<UniformBuffer>& uniform_buffer,
+                                       const uint32_t index, const float* data,
+                                       const size_t size) {
+  RENDERER_ASSERT((size % sizeof(float)) == 0)
+  // Consecutive writes to the same buffer are common, only keep one reference
+  if (uniform_buffers_.empty() || uniform_buffers_.back() != uniform_buffer) {
+    uniform_buffers_.push_back(uniform_buffer);
+  }
+  const size_t offset = uniform_data_.size();
+  uniform_data_.insert(uniform_data_.end(), data, data + (size / sizeof(float)));
+  AddCommand(kCommand_SetBufferElementData, static_cast<uint32_t>(uniform_buffers_.size() - 1),
+             index, static_cast<uint32_t>(offset), static_cast<uint32_t>(size));
+}
+
+void CommandList::SetRenderArea(const std::shared_ptr<RenderPass>& render_pass,
+                                const uint32_t width, const uint32_t height) {
+  render_passes_.push_back(render_pass);
+  AddCommand(kCommand_SetRenderArea, static_cast<uint32_t>(render_passes_.size() - 1),
+             width, height);
+}
+
+void CommandList::SetViewport(const std::shared_ptr<RenderState>& render_state,
+                              const RenderState::Viewport& viewport) {
+  render_states_.push_back(render_state);
+  viewports_.push_back(viewport);
+  AddCommand(kCommand_SetViewport, static_cast<uint32_t>(render_states_.size() - 1),
+             static_cast<uint32_t>(viewports_.size() - 1));
+}
+
+void CommandList::SetScissorRect(const std::shared_ptr<RenderState>& render_state,
+                                 const RenderState::ScissorRect& scissor_rect) {
+  render_states_.push_back(render_state);
+  scissor_rects_.push_back(scissor_rect);
+  AddCommand(kCommand_SetScissorRect, static_cast<uint32_t>(render_states_.size() - 1),
+             static_cast<uint32_t>(scissor_rects_.size() - 1));
+}
+
+void CommandList::Draw(const uint32_t vertex_count, const uint32_t first_vertex) {
+  AddCommand(kCommand_Draw, 0, vertex_count, first_vertex);
+}
+
+void CommandList::DrawIndexed(const uint32_t index_count, const uint32_t first_index) {
+  AddCommand(kCommand_DrawIndexed, 0, index_count, first_index);
+}
+
+void CommandList::DrawIndexed(const uint32_t index_count, const uint32_t first_index,
+                              const uint32_t base_vertex) {
+  AddCommand(kCommand_DrawIndexed, 0, index_count, first_index, base_vertex);
+}
+
+void CommandList::DrawIndexedMulti(const Renderer::DrawIndexedRecord* records,
+                                   const uint32_t record_count) {
+  const size_t offset = draw_records_.size();
+  draw_records_.insert(draw_records_.end(), records, records + record_count);
+  AddCommand(kCommand_DrawIndexedMulti, 0, static_cast<uint32_t>(offset), record_count);
+}
+
+void CommandList::DrawIndexedDynamic(const VertexBuffer::VertexFormat vertex_format,
+                                     const void* vertex_data, const uint32_t vertex_count,
+                                     const uint16_t* index_data, const uint32_t index_count) {
+  DynamicDraw draw;
+  draw.vertex_format = vertex_format;
+  draw.vertex_offset = static_cast<uint32_t>(dynamic_vertex_data_.size());
+  draw.vertex_count = vertex_count;
+  draw.index_offset = static_cast<uint32_t>(dynamic_index_data_.size());
+  draw.index_count = index_count;
+  const uint8_t* vertex_bytes = static_cast<const uint8_t*>(vertex_data);
+  dynamic_vertex_data_.insert(dynamic_vertex_data_.end(), vertex_bytes,
+      vertex_bytes + vertex_count * VertexBuffer::GetVertexFormatStride(vertex_format));
+  dynamic_index_data_.insert(dynamic_index_data_.end(), index_data, index_data + index_count);
+  dynamic_draws_.push_back(draw);
+  AddCommand(kCommand_DrawIndexedDynamic, static_cast<uint32_t>(dynamic_draws_.size() - 1));
+}
+
+void CommandList::BeginGPUScope(const char* name) {
+  scope_names_.push_back(name);
+  AddCommand(kCommand_BeginGPUScope, static_cast<uint32_t>(scope_names_.size() - 1));
+}
+
+void CommandList::EndGPUScope() {
+  AddCommand(kCommand_EndGPUScope, 0);
+}
+
+void CommandList::AddStat(const RendererStats::StatType stat, const uint32_t value) {
+  AddCommand(kCommand_AddStat, 0, stat, value);
+}
+
+void CommandList::Execute(Renderer& renderer) const {
+  for (const Command& command : commands_) {
+    const uint32_t* args = command.args;
+    switch (command.type) {
+      case kCommand_SetRenderPass:
+        renderer.SetRenderPass(render_passes_[command.resource_index]);
+        break;
+      case kCommand_SetRenderState:
+        renderer.SetRenderState(render_states_[command.resource_index]);
+        break;
+      case kCommand_BindIndexBuffer:
+        renderer.BindIndexBuffer(index_buffers_[command.resource_index]);
+        break;
+      case kCommand_BindVertexBuffer:
+        renderer.BindVertexBuffer(vertex_buffers_[command.resource_index]);
+        break;
+      case kCommand_BindTexture:
+        renderer.BindTexture(textures_[command.resource_index]);
+        break;
+      case kCommand_SetBufferElementData:
+        uniform_buffers_[command.resource_index]->SetBufferElementData(
+            args[0], &uniform_data_[args[1]], args[2]);
+        break;
+      case kCommand_SetRenderArea:
+        render_passes_[command.resource_index]->SetRenderArea(args[0], args[1]);
+        break;
+      case kCommand_SetViewport:
+        render_states_[command.resource_index]->SetViewport(viewports_[args[0]]);
+        break;
+      case kCommand_SetScissorRect:
+        render_states_[command.resource_index]->SetScissorRect(scissor_rects_[args[0]]);
+        break;
+      case kCommand_Draw:
+        renderer.Draw(args[0], args[1]);
+        break;
+      case kCommand_DrawIndexed:
+        renderer.DrawIndexed(args[0], args[1], args[2]);
+        break;
+      case kCommand_DrawIndexedMulti:
+        renderer.DrawIndexedMulti(&draw_records_[args[0]], args[1]);
+        break;
+      case kCommand_DrawIndexedDynamic: {
+        const DynamicDraw& draw = dynamic_draws_[command.resource_index];
+        renderer.DrawIndexedDynamic(draw.vertex_format,
+                                    dynamic_vertex_data_.data() + draw.vertex_offset,
+                                    draw.vertex_count,
+                                    dynamic_index_data_.data() + draw.index_offset,
+                                    draw.index_count);
+        break;
+      }
+      case kCommand_BeginGPUScope:
+        renderer.BeginGPUScope(scope_names_[command.resource_index]);
+        break;
+      case kCommand_EndGPUScope:
+        renderer.EndGPUScope();
+        break;
+      case kCommand_AddStat:
+        renderer.GetStats().Add(static_cast<RendererStats::StatType>(args[0]), args[1]);
+        break;
+    }
+  }
+}
+
+void CommandList::Reset() {
+  commands_.clear();
+  render_passes_.clear();
+  render_states_.clear();
+  index_buffers_.clear();
+  vertex_buffers_.clear();
+  textures_.clear();
+  uniform_buffers_.clear();
+  uniform_data_.clear();
+  draw_records_.clear();
+  dynamic_draws_.clear();
+  dynamic_vertex_data_.clear();
+  dynamic_index_data_.clear();
+  viewports_.clear();
+  scissor_rects_.clear();
+  scope_names_.clear();
+}
+
+}
@@ -0,0 +1,253 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SIMPLERENDERER_COMMAND_LIST_H_
+#define SIMPLERENDERER_COMMAND_LIST_H_
+
+#include "renderer_interface.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace simple_renderer {
+
+/**
+ * @brief A `CommandList` records a full frame of render pass, render state, bind, uniform
+ * and draw calls without touching the `Renderer`, and replays them later through the
+ * `Renderer` interface with ::Execute. This allows a game thread to record frame N + 1
+ * while a render thread executes frame N. Unlike a `RecordingContext`, a command list
+ * is not tied to a render pass or to a renderer frame, and works with every renderer API.
+ * A `CommandList` must only be used by one thread at a time. Calling ::Reset keeps the
+ * allocated storage, so a command list that is reused every frame stops allocating
+ * once it has grown to the size of a frame.
+ */
+class CommandList {
+ public:
+  CommandList();
+  ~CommandList();
+
+  /**
+   * @brief Record Renderer::SetRenderPass.
+   * @param render_pass A shared pointer to a renderer `RenderPass`.
+   */
+  void SetRenderPass(const std::shared_ptr<RenderPass>& render_pass);
+  /**
+   * @brief Record Renderer::SetRenderState.
+   * @param render_state A shared pointer to a renderer `RenderState`.
+   */
+  void SetRenderState(const std::shared_ptr<RenderState>& render_state);
+
+  /**
+   * @brief Record Renderer::BindIndexBuffer.
+   * @param index_buffer A shared pointer to a renderer `IndexBuffer`.
+   */
+  void BindIndexBuffer(const std::shared_ptr<IndexBuffer>& index_buffer);
+  /**
+   * @brief Record Renderer::BindVertexBuffer.
+   * @param vertex_buffer A shared pointer to a renderer `VertexBuffer`.
+   */
+  void BindVertexBuffer(const std::shared_ptr<VertexBuffer>& vertex_buffer);
+  /**
+   * @brief Record Renderer::BindTexture.
+   * @param texture A shared pointer to a renderer `Texture`.
+   */
+  void BindTexture(const std::shared_ptr<Texture>& texture);
+
+  /**
+   * @brief Record UniformBuffer::SetBufferElementData. The element data is copied
+   * into the command list, the buffer itself is only written when the list is executed.
+   * Uniform buffers used by a command list must only be written through the list
+   * until it has been executed.
+   * @param uniform_buffer A shared pointer to a renderer `UniformBuffer`.
+   * @param index Index of the element in the uniform buffer.
+   * @param data Pointer to the element data.
+   * @param size Size of the element data in bytes.
+   */
+  void SetBufferElementData(const std::shared_ptr<UniformBuffer>& uniform_buffer,
+                            const uint32_t index, const float* data, const size_t size);
+
+  /**
+   * @brief Record RenderPass::SetRenderArea.
+   * @param render_pass A shared pointer to a renderer `RenderPass`.
+   * @param width Width of the render area in pixels, 0 to use the full target width.
+   * @param height Height of the render area in pixels, 0 to use the full target height.
+   */
+  void SetRenderArea(const std::shared_ptr<RenderPass>& render_pass, const uint32_t width,
+                     const uint32_t height);
+  /**
+   * @brief Record RenderState::SetViewport.
+   * @param render_state A shared pointer to a renderer `RenderState`.
+   * @param viewport The new viewport of the render state.
+   */
+  void SetViewport(const std::shared_ptr<RenderState>& render_state,
+                   const RenderState::Viewport& viewport);
+  /**
+   * @brief Record RenderState::SetScissorRect.
+   * @param render_state A shared pointer to a renderer `RenderState`.
+   * @param scissor_rect The new scissor rect of the render state.
+   */
+  void SetScissorRect(const std::shared_ptr<RenderState>& render_state,
+                      const RenderState::ScissorRect& scissor_rect);
+
+  /**
+   * @brief Record Renderer::Draw.
+   * @param vertex_count Number of vertices to draw from the bound vertex buffer.
+   * @param first_vertex Vertex offset into the bound vertex buffer to begin drawing from.
+   */
+  void Draw(const uint32_t vertex_count, const uint32_t first_vertex);
+  /**
+   * @brief Record Renderer::DrawIndexed.
+   * @param index_count Number of indices to draw from the bound index buffer.
+   * @param first_index Index offset into the bound index buffer to begin drawing from.
+   */
+  void DrawIndexed(const uint32_t index_count, const uint32_t first_index);
+  /**
+   * @brief Record Renderer::DrawIndexed with a base vertex.
+   * @param index_count Number of indices to draw from the bound index buffer.
+   * @param first_index Index offset into the bound index buffer to begin drawing from.
+   * @param base_vertex Value added to each index before reading from the bound vertex buffer.
+   */
+  void DrawIndexed(const uint32_t index_count, const uint32_t first_index,
+                   const uint32_t base_vertex);
+  /**
+   * @brief Record Renderer::DrawIndexedMulti. The records are copied into the command list.
+   * @param records Pointer to an array of `DrawIndexedRecord` structures.
+   * @param record_count Number of records in the array.
+   */
+  void DrawIndexedMulti(const Renderer::DrawIndexedRecord* records,
+                        const uint32_t record_count);
+  /**
+   * @brief Record Renderer::DrawIndexedDynamic. The vertices and indices are copied into
+   * the command list.
+   * @param vertex_format The vertex format of `vertex_data`, must match the render state.
+   * @param vertex_data Vertex data in `vertex_format`.
+   * @param vertex_count Number of vertices in `vertex_data`.
+   * @param index_data 16-bit index values relative to the first vertex of `vertex_data`.
+   * @param index_count Number of indices in `index_data`.
+   */
+  void DrawIndexedDynamic(const VertexBuffer::VertexFormat vertex_format,
+                          const void* vertex_data, const uint32_t vertex_count,
+                          const uint16_t* index_data, const uint32_t index_count);
+
+  /**
+   * @brief Record Renderer::BeginGPUScope.
+   * @param name Name of the scope, must remain valid for several frames (use a string literal).
+   */
+  void BeginGPUScope(const char* name);
+  /**
+   * @brief Record Renderer::EndGPUScope.
+   */
+  void EndGPUScope();
+
+  /**
+   * @brief Record an addition to a statistic of the renderer, the value is added to the
+   * statistics of the frame the command list is executed in. Use for counters of work
+   * done by the recording thread, such as visibility culling.
+   * @param stat The statistic to add to.
+   * @param value The amount to add.
+   */
+  void AddStat(const RendererStats::StatType stat, const uint32_t value);
+
+  /**
+   * @brief Replay the recorded commands through the renderer, in recording order. Must be
+   * called between Renderer::BeginFrame and Renderer::EndFrame, from the thread calling
+   * Renderer::BeginFrame. The commands are kept until ::Reset is called.
+   * @param renderer The renderer to execute the commands with.
+   */
+  void Execute(Renderer& renderer) const;
+
+  /**
+   * @brief Discard the recorded commands and release their resource references.
+   * On GLES, call from a thread with the context current, as releasing the last
+   * reference to a resource deletes its API objects.
+   */
+  void Reset();
+
+  /**
+   * @brief Retrieve the number of commands recorded since the last ::Reset.
+   * @return Number of recorded commands.
+   */
+  size_t GetCommandCount() const { return commands_.size(); }
+
+ private:
+  enum CommandType : uint32_t {
+    kCommand_SetRenderPass = 0,
+    kCommand_SetRenderState,
+    kCommand_BindIndexBuffer,
+    kCommand_BindVertexBuffer,
+    kCommand_BindTexture,
+    kCommand_SetBufferElementData,
+    kCommand_SetRenderArea,
+    kCommand_SetViewport,
+    kCommand_SetScissorRect,
+    kCommand_Draw,
+    kCommand_DrawIndexed,
+    kCommand_DrawIndexedMulti,
+    kCommand_DrawIndexedDynamic,
+    kCommand_BeginGPUScope,
+    kCommand_EndGPUScope,
+    kCommand_AddStat
+  };
+
+  struct Command {
+    CommandType type;
+    // Index into the resource array matching the command type
+    uint32_t resource_index;
+    // Command arguments, meaning depends on the command type:
+    // draws: count, first, base vertex
+    // uniform data: element index, offset into uniform_data_ in floats, size in bytes
+    // render area: width, height
+    // multi-draw: offset into draw_records_, record count
+    // dynamic draw: index into dynamic_draws_
+    // viewport, scissor rect: index into viewports_ or scissor_rects_
+    // stat: stat type, value
+    uint32_t args[3];
+  };
+
+  // Geometry of a recorded DrawIndexedDynamic, in dynamic_vertex_data_ and dynamic_index_data_
+  struct DynamicDraw {
+    VertexBuffer::VertexFormat vertex_format;
+    uint32_t vertex_offset;
+    uint32_t vertex_count;
+    uint32_t index_offset;
+    uint32_t index_count;
+  };
+
+  void AddCommand(const CommandType type, const uint32_t resource_index,
+                  const uint32_t arg0 = 0, const uint32_t arg1 = 0, const uint32_t arg2 = 0);
+
+  std::vector<Command> commands_;
+  std::vector<std::shared_ptr<RenderPass> > render_passes_;
+  std::vector<std::shared_ptr<RenderState> > render_states_;
+  std::vector<std::shared_ptr<IndexBuffer> > index_buffers_;
+  std::vector<std::shared_ptr<VertexBuffer> > vertex_buffers_;
+  std::vector<std::shared_ptr<Texture> > textures_;
+  std::vector<std::shared_ptr<UniformBuffer> > uniform_buffers_;
+  std::vector<float> uniform_data_;
+  std::vector<Renderer::DrawIndexedRecord> draw_records_;
+  std::vector<DynamicDraw> dynamic_draws_;
+  std::vector<uint8_t> dynamic_vertex_data_;
+  std::vector<uint16_t> dynamic_index_data_;
+  std::vector<RenderState::Viewport> viewports_;
+  std::vector<RenderState::ScissorRect> scissor_rects_;
+  std::vector<const char*> scope_names_;
+};
+
+}
+
+#endif // SIMPLERENDERER_COMMAND_LIST_H_
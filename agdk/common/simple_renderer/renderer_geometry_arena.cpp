@@ -0,0 +1,183 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "renderer_geometry_arena.h"
+#include "renderer_debug.h"
+#include "renderer_interface.h"
+
+#include <cstring>
+
+namespace simple_renderer {
+
+GeometryArena::GeometryArena(const GeometryArenaCreationParams& params) :
+    vertex_format_(params.vertex_format),
+    vertex_stride_(VertexBuffer::GetVertexFormatStride(params.vertex_format)),
+    vertex_allocator_(params.vertex_capacity),
+    index_allocator_(params.index_capacity),
+    vertex_data_(params.vertex_capacity * vertex_stride_),
+    index_data_(params.index_capacity),
+    vertex_buffer_(),
+    index_buffer_(),
+    mesh_count_(0),
+    dirty_(false) {
+}
+
+GeometryArena::~GeometryArena() {
+  Renderer& renderer = Renderer::GetInstance();
+  if (vertex_buffer_ != nullptr) {
+    renderer.DestroyVertexBuffer(vertex_buffer_);
+    vertex_buffer_ = nullptr;
+  }
+  if (index_buffer_ != nullptr) {
+    renderer.DestroyIndexBuffer(index_buffer_);
+    index_buffer_ = nullptr;
+  }
+}
+
+bool GeometryArena::AddMesh(const void* vertex_data, const uint32_t vertex_count,
+                            const uint16_t* index_data, const uint32_t index_count,
+                            Mesh& mesh) {
+  RENDERER_ASSERT(vertex_data != nullptr || vertex_count == 0)
+  RENDERER_ASSERT(index_data != nullptr || index_count == 0)
+  uint32_t first_vertex = 0;
+  if (!vertex_allocator_.Allocate(vertex_count, first_vertex)) {
+    RENDERER_ERROR("GeometryArena out of vertex space for %u vertices", vertex_count)
+    return false;
+  }
+  uint32_t first_index = 0;
+  if (!index_allocator_.Allocate(index_count, first_index)) {
+    vertex_allocator_.Free(first_vertex, vertex_count);
+    RENDERER_ERROR("GeometryArena out of index space for %u indices", index_count)
+    return false;
+  }
+
+  if (vertex_count > 0) {
+    memcpy(&vertex_data_[first_vertex * vertex_stride_], vertex_data,
+           vertex_count * vertex_stride_);
+  }
+  if (index_count > 0) {
+    memcpy(&index_data_[first_index], index_data, index_count * sizeof(uint16_t));
+  }
+  mesh = {first_vertex, vertex_count, first_index, index_count};
+  ++mesh_count_;
+  dirty_ = true;
+  return true;
+}
+
+void GeometryArena::RemoveMesh(const Mesh& mesh) {
+  RENDERER_ASSERT(mesh_count_ > 0)
+  vertex_allocator_.Free(mesh.first_vertex, mesh.vertex_count);
+  index_allocator_.Free(mesh.first_index, mesh.index_count);
+  --mesh_count_;
+  dirty_ = true;
+}
+
+void GeometryArena::Commit() {
+  if (!dirty_) {
+    return;
+  }
+  dirty_ = false;
+
+  // VertexBuffer and IndexBuffer contents are immutable, replace them. Deletion
+  // of the old buffers is deferred until frames using them have completed.
+  Renderer& renderer = Renderer::GetInstance();
+  if (vertex_buffer_ != nullptr) {
+    renderer.DestroyVertexBuffer(vertex_buffer_);
+    vertex_buffer_ = nullptr;
+  }
+  if (index_buffer_ != nullptr) {
+    renderer.DestroyIndexBuffer(index_buffer_);
+    index_buffer_ = nullptr;
+  }
+
+  const uint32_t vertex_count = vertex_allocator_.GetHighWaterMark();
+  if (vertex_count > 0) {
+    VertexBuffer::VertexBufferCreationParams vertex_params = {
+        vertex_data_.data(), vertex_format_, vertex_count * vertex_stride_
+    };
+    vertex_buffer_ = renderer.CreateVertexBuffer(vertex_params);
+  }
+  const uint32_t index_count = index_allocator_.GetHighWaterMark();
+  if (index_count > 0) {
+    IndexBuffer::IndexBufferCreationParams index_params = {
+        index_data_.data(), index_count * sizeof(uint16_t)
+    };
+    index_buffer_ = renderer.CreateIndexBuffer(index_params);
+  }
+}
+
+void GeometryArena::Bind() const {
+  RENDERER_ASSERT(!dirty_)
+  Renderer& renderer = Renderer::GetInstance();
+  if (vertex_buffer_ != nullptr) {
+    renderer.BindVertexBuffer(vertex_buffer_);
+  }
+  if (index_buffer_ != nullptr) {
+    renderer.BindIndexBuffer(index_buffer_);
+  }
+}
+
+void GeometryArena::DrawMesh(const Mesh& mesh) const {
+  Renderer& renderer = Renderer::GetInstance();
+  if (mesh.index_count > 0) {
+    renderer.DrawIndexed(mesh.index_count, mesh.first_index, mesh.first_vertex);
+  } else if (mesh.vertex_count > 0) {
+    renderer.Draw(mesh.vertex_count, mesh.first_vertex);
+  }
+}
+
+void GeometryArena::Bind(CommandList& command_list) const {
+  RENDERER_ASSERT(!dirty_)
+  if (vertex_buffer_ != nullptr) {
+    command_list.BindVertexBuffer(vertex_buffer_);
+  }
+  if (index_buffer_ != nullptr) {
+    command_list.BindIndexBuffer(index_buffer_);
+  }
+}
+
+void GeometryArena::DrawMesh(const Mesh& mesh, CommandList& command_list) const {
+  if (mesh.index_count > 0) {
+    command_list.DrawIndexed(mesh.index_count, mesh.first_index, mesh.first_vertex);
+  } else if (mesh.vertex_count > 0) {
+    command_list.Draw(mesh.vertex_count, mesh.first_vertex);
+  }
+}
+
+Renderer::DrawIndexedRecord GeometryArena::GetDrawRecord(const Mesh& mesh,
+                                                         const uint32_t first_instance) {
+  RENDERER_ASSERT(mesh.index_count > 0)
+  return {mesh.index_count, 1, mesh.first_index, static_cast<int32_t>(mesh.first_vertex),
+          first_instance};
+}
+
+GeometryArena::ArenaStats GeometryArena::GetStats() const {
+  ArenaStats stats;
+  stats.mesh_count = mesh_count_;
+  stats.vertex_capacity = vertex_allocator_.GetCapacity();
+  stats.vertices_used = vertex_allocator_.GetUsed();
+  stats.vertex_free_blocks = vertex_allocator_.GetFreeBlockCount();
+  stats.largest_free_vertex_block = vertex_allocator_.GetLargestFreeBlock();
+  stats.vertex_fragmentation = vertex_allocator_.GetFragmentation();
+  stats.index_capacity = index_allocator_.GetCapacity();
+  stats.indices_used = index_allocator_.GetUsed();
+  stats.index_free_blocks = index_allocator_.GetFreeBlockCount();
+  stats.largest_free_index_block = index_allocator_.GetLargestFreeBlock();
+  stats.index_fragmentation = index_allocator_.GetFragmentation();
+  return stats;
+}
+
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SIMPLERENDERER_GEOMETRY_ARENA_H_
+#define SIMPLERENDERER_GEOMETRY_ARENA_H_
+
+#include "renderer_command_list.h"
+#include "renderer_index_buffer.h"
+#include "renderer_interface.h"
+#include "renderer_range_allocator.h"
+#include "renderer_vertex_buffer.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace simple_renderer {
+
+/**
+ * @brief A `GeometryArena` suballocates the vertices and indices of many small static meshes
+ * from a single shared `VertexBuffer` and `IndexBuffer` pair, so that a whole set of meshes
+ * (a font, a set of UI shapes) renders with one buffer bind. Meshes are added and removed
+ * on the CPU copy of the arena; ::Commit uploads the contents, recreating the GPU buffers
+ * if anything changed. Indices of a mesh are relative to its first vertex and are drawn
+ * with Renderer::DrawIndexed using a base vertex. All meshes in an arena share a single
+ * vertex format.
+ */
+class GeometryArena {
+ public:
+  /**
+   * @brief A structure holding required parameters to create a new `GeometryArena`.
+   */
+  struct GeometryArenaCreationParams {
+    /** @brief The vertex format of every mesh in the arena */
+    VertexBuffer::VertexFormat vertex_format;
+    /** @brief The maximum number of vertices the arena can hold */
+    uint32_t vertex_capacity;
+    /** @brief The maximum number of 16-bit indices the arena can hold */
+    uint32_t index_capacity;
+  };
+
+  /**
+   * @brief The location of a mesh suballocated from the arena. A mesh with an
+   * `index_count` of zero is drawn without indices.
+   */
+  struct Mesh {
+    /** @brief Offset of the first vertex of the mesh in the arena vertex buffer */
+    uint32_t first_vertex;
+    /** @brief Number of vertices in the mesh */
+    uint32_t vertex_count;
+    /** @brief Offset of the first index of the mesh in the arena index buffer */
+    uint32_t first_index;
+    /** @brief Number of indices in the mesh */
+    uint32_t index_count;
+  };
+
+  /**
+   * @brief Occupancy and fragmentation statistics of an arena, in vertices and indices.
+   * Fragmentation is 1 minus the ratio of the largest free block to the total free space,
+   * 0 means all free space is contiguous.
+   */
+  struct ArenaStats {
+    /** @brief Number of meshes in the arena */
+    uint32_t mesh_count;
+    /** @brief Maximum number of vertices */
+    uint32_t vertex_capacity;
+    /** @brief Number of vertices allocated to meshes */
+    uint32_t vertices_used;
+    /** @brief Number of separate free vertex blocks */
+    uint32_t vertex_free_blocks;
+    /** @brief Size of the largest free vertex block */
+    uint32_t largest_free_vertex_block;
+    /** @brief Fragmentation of the free vertex space, 0.0 to 1.0 */
+    float vertex_fragmentation;
+    /** @brief Maximum number of indices */
+    uint32_t index_capacity;
+    /** @brief Number of indices allocated to meshes */
+    uint32_t indices_used;
+    /** @brief Number of separate free index blocks */
+    uint32_t index_free_blocks;
+    /** @brief Size of the largest free index block */
+    uint32_t largest_free_index_block;
+    /** @brief Fragmentation of the free index space, 0.0 to 1.0 */
+    float index_fragmentation;
+  };
+
+  /**
+   * @brief Create an empty arena. No GPU buffers are created until ::Commit is called.
+   * @param params Creation parameters of the arena.
+   */
+  explicit GeometryArena(const GeometryArenaCreationParams& params);
+
+  /**
+   * @brief Destroys the arena buffers through the `Renderer`.
+   */
+  ~GeometryArena();
+
+  /**
+   * @brief Suballocate a mesh from the arena and copy its data to the CPU copy of the arena.
+   * The data is uploaded at the next call to ::Commit.
+   * @param vertex_data Vertex data in the vertex format of the arena.
+   * @param vertex_count Number of vertices in `vertex_data`.
+   * @param index_data 16-bit index values relative to the first vertex of the mesh,
+   * may be nullptr if `index_count` is 0.
+   * @param index_count Number of indices in `index_data`.
+   * @param mesh Receives the location of the mesh in the arena.
+   * @return true if the mesh was added, false if the arena does not have a large enough
+   * free block of vertices or indices.
+   */
+  bool AddMesh(const void* vertex_data, const uint32_t vertex_count,
+               const uint16_t* index_data, const uint32_t index_count, Mesh& mesh);
+
+  /**
+   * @brief Return the space used by a mesh to the arena. The freed space can be reused
+   * by ::AddMesh; the mesh must not be drawn after the next call to ::Commit.
+   * @param mesh A mesh previously returned by ::AddMesh.
+   */
+  void RemoveMesh(const Mesh& mesh);
+
+  /**
+   * @brief Upload the arena contents if meshes were added or removed since the last commit.
+   * The GPU buffers are sized to the highest used vertex and index, and the previous buffers
+   * are destroyed through the deferred destruction of the `Renderer`.
+   */
+  void Commit();
+
+  /**
+   * @brief Bind the arena vertex and index buffers for use in draw calls.
+   */
+  void Bind() const;
+
+  /**
+   * @brief Draw a mesh using the current render state. The arena must be bound.
+   * @param mesh A mesh previously returned by ::AddMesh.
+   */
+  void DrawMesh(const Mesh& mesh) const;
+  /**
+   * @brief Record binding the arena vertex and index buffers into a `CommandList`.
+   * @param command_list The command list to record into.
+   */
+  void Bind(CommandList& command_list) const;
+  /**
+   * @brief Record a draw of a mesh into a `CommandList`, see ::DrawMesh.
+   * @param mesh A mesh previously returned by ::AddMesh.
+   * @param command_list The command list to record into.
+   */
+  void DrawMesh(const Mesh& mesh, CommandList& command_list) const;
+
+  /**
+   * @brief Build a draw record of an indexed mesh, so several arena meshes can be drawn with
+   * a single Renderer::DrawIndexedMulti call. The arena must be bound when the records are drawn.
+   * @param mesh A mesh with indices previously returned by ::AddMesh.
+   * @param first_instance Offset of the per-draw data of the record.
+   * @return A `DrawIndexedRecord` drawing a single instance of the mesh.
+   */
+  static Renderer::DrawIndexedRecord GetDrawRecord(const Mesh& mesh,
+                                                   const uint32_t first_instance);
+
+  /**
+   * @brief Retrieve the occupancy and fragmentation statistics of the arena.
+   * @return An `ArenaStats` structure.
+   */
+  ArenaStats GetStats() const;
+
+  /**
+   * @brief Get the vertex buffer of the arena, nullptr until the first ::Commit.
+   * @return A shared pointer to the arena `VertexBuffer`.
+   */
+  const std::shared_ptr<VertexBuffer>& GetVertexBuffer() const { return vertex_buffer_; }
+
+  /**
+   * @brief Get the index buffer of the arena, nullptr if no mesh has indices.
+   * @return A shared pointer to the arena `IndexBuffer`.
+   */
+  const std::shared_ptr<IndexBuffer>& GetIndexBuffer() const { return index_buffer_; }
+
+ private:
+  VertexBuffer::VertexFormat vertex_format_;
+  size_t vertex_stride_;
+  RangeAllocator vertex_allocator_;
+  RangeAllocator index_allocator_;
+  std::vector<uint8_t> vertex_data_;
+  std::vector<uint16_t> index_data_;
+  std::shared_ptr<VertexBuffer> vertex_buffer_;
+  std::shared_ptr<IndexBuffer> index_buffer_;
+  uint32_t mesh_count_;
+  bool dirty_;
+};
+
+}
+
+#endif // SIMPLERENDERER_GEOMETRY_ARENA_H_
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "renderer_geometry_ring_buffer_gles.h"
+#include "renderer_debug.h"
+#include "renderer_state_cache_gles.h"
+
+namespace simple_renderer {
+
+GeometryRingBufferGLES::GeometryRingBufferGLES(StateCacheGLES& state_cache) :
+    vertex_buffer_(0),
+    index_buffer_(0),
+    vertex_segment_start_(0),
+    vertex_write_offset_(0),
+    index_segment_start_(0),
+    index_write_offset_(0),
+    overflow_reported_(false) {
+  glGenBuffers(1, &vertex_buffer_);
+  glGenBuffers(1, &index_buffer_);
+  RENDERER_CHECK_GLES("glGenBuffers");
+  state_cache.BindBuffer(GL_ARRAY_BUFFER, vertex_buffer_);
+  glBufferData(GL_ARRAY_BUFFER, kVertexSegmentSize * kFrameSegmentCount, nullptr,
+               GL_DYNAMIC_DRAW);
+  state_cache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, kIndexSegmentSize * kFrameSegmentCount, nullptr,
+               GL_DYNAMIC_DRAW);
+  RENDERER_CHECK_GLES("glBufferData");
+}
+
+GeometryRingBufferGLES::~GeometryRingBufferGLES() {
+  if (vertex_buffer_ != 0) {
+    glDeleteBuffers(1, &vertex_buffer_);
+    vertex_buffer_ = 0;
+  }
+  if (index_buffer_ != 0) {
+    glDeleteBuffers(1, &index_buffer_);
+    index_buffer_ = 0;
+  }
+}
+
+void GeometryRingBufferGLES::BeginFrame(const uint64_t frame_number) {
+  const uint32_t segment = static_cast<uint32_t>(frame_number % kFrameSegmentCount);
+  vertex_segment_start_ = segment * kVertexSegmentSize;
+  vertex_write_offset_ = vertex_segment_start_;
+  index_segment_start_ = segment * kIndexSegmentSize;
+  index_write_offset_ = index_segment_start_;
+  overflow_reported_ = false;
+}
+
+bool GeometryRingBufferGLES::Write(StateCacheGLES& state_cache, const void* vertex_data,
+                                   const size_t vertex_stride, const uint32_t vertex_count,
+                                   const uint16_t* index_data, const uint32_t index_count,
+                                   uint32_t& first_vertex, uint32_t& first_index) {
+  // Vertices start on a multiple of the stride, so the draw can address them with
+  // a base vertex from the start of the buffer
+  const uint32_t stride = static_cast<uint32_t>(vertex_stride);
+  const uint32_t vertex_offset = ((vertex_write_offset_ + stride - 1) / stride) * stride;
+  const size_t vertex_size = vertex_count * vertex_stride;
+  const size_t index_size = index_count * sizeof(uint16_t);
+  if (vertex_offset + vertex_size > vertex_segment_start_ + kVertexSegmentSize ||
+      index_write_offset_ + index_size > index_segment_start_ + kIndexSegmentSize) {
+    if (!overflow_reported_) {
+      RENDERER_ERROR("Geometry ring segment full (%u vertex bytes, %u index bytes)",
+                     kVertexSegmentSize, kIndexSegmentSize)
+      overflow_reported_ = true;
+    }
+    return false;
+  }
+
+  state_cache.BindBuffer(GL_ARRAY_BUFFER, vertex_buffer_);
+  glBufferSubData(GL_ARRAY_BUFFER, vertex_offset, vertex_size, vertex_data);
+  state_cache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+  glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, index_write_offset_, index_size, index_data);
+  RENDERER_CHECK_GLES("glBufferSubData");
+
+  first_vertex = vertex_offset / stride;
+  first_index = index_write_offset_ / static_cast<uint32_t>(sizeof(uint16_t));
+  vertex_write_offset_ = vertex_offset + static_cast<uint32_t>(vertex_size);
+  index_write_offset_ += static_cast<uint32_t>(index_size);
+  return true;
+}
+
+} // namespace simple_renderer
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SIMPLERENDERER_GEOMETRY_RING_BUFFER_GLES_H_
+#define SIMPLERENDERER_GEOMETRY_RING_BUFFER_GLES_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <GLES3/gl3.h>
+
+namespace simple_renderer {
+
+class StateCacheGLES;
+
+// A GL_ARRAY_BUFFER and a GL_ELEMENT_ARRAY_BUFFER each divided into one segment per
+// frame, rotated each frame like UniformRingBufferGLES. Renderer::DrawIndexedDynamic
+// copies its vertices and indices into the active segments with glBufferSubData and
+// draws them from there.
+class GeometryRingBufferGLES {
+ public:
+  static constexpr uint32_t kFrameSegmentCount = 3;
+  static constexpr uint32_t kVertexSegmentSize = 256 * 1024;
+  static constexpr uint32_t kIndexSegmentSize = 64 * 1024;
+
+  GeometryRingBufferGLES(StateCacheGLES& state_cache);
+  ~GeometryRingBufferGLES();
+
+  void BeginFrame(const uint64_t frame_number);
+
+  // Copy vertices and 16-bit indices into the active frame segments, returns false if
+  // either segment is full. On success both ring buffers are left bound, and first_vertex
+  // and first_index receive the position of the copies in them.
+  bool Write(StateCacheGLES& state_cache, const void* vertex_data, const size_t vertex_stride,
+             const uint32_t vertex_count, const uint16_t* index_data,
+             const uint32_t index_count, uint32_t& first_vertex, uint32_t& first_index);
+
+ private:
+  GLuint vertex_buffer_;
+  GLuint index_buffer_;
+  uint32_t vertex_segment_start_;
+  uint32_t vertex_write_offset_;
+  uint32_t index_segment_start_;
+  uint32_t index_write_offset_;
+  bool overflow_reported_;
+};
+
+} // namespace simple_renderer
+
+#endif // SIMPLERENDERER_GEOMETRY_RING_BUFFER_GLES_H_
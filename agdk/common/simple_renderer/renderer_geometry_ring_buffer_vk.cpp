@@ -0,0 +1,86 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "renderer_geometry_ring_buffer_vk.h"
+#include "renderer_debug.h"
+
+namespace simple_renderer {
+
+GeometryRingBufferVk::GeometryRingBufferVk(VmaAllocator allocator,
+                                           const uint32_t in_flight_frame_count) :
+    allocator_(allocator),
+    buffer_(VK_NULL_HANDLE),
+    buffer_alloc_(VK_NULL_HANDLE),
+    mapped_data_(nullptr),
+    in_flight_frame_count_(in_flight_frame_count),
+    segment_start_(0),
+    write_offset_(0),
+    overflow_reported_(false) {
+  VkBufferCreateInfo create_info = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+  create_info.size = kFrameSegmentSize * in_flight_frame_count_;
+  create_info.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+  create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  VmaAllocationCreateInfo alloc_info = {};
+  alloc_info.usage = VMA_MEMORY_USAGE_AUTO;
+  alloc_info.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+      VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+  VmaAllocationInfo buffer_info = {};
+  const VkResult alloc_result = vmaCreateBuffer(allocator_, &create_info, &alloc_info,
+                                                &buffer_, &buffer_alloc_, &buffer_info);
+  RENDERER_CHECK_VK(alloc_result, "vmaCreateBuffer (geometry ring)");
+  RENDERER_ASSERT(buffer_info.pMappedData != nullptr)
+  mapped_data_ = reinterpret_cast<uint8_t*>(buffer_info.pMappedData);
+}
+
+GeometryRingBufferVk::~GeometryRingBufferVk() {
+  if (buffer_ != VK_NULL_HANDLE) {
+    vmaDestroyBuffer(allocator_, buffer_, buffer_alloc_);
+    buffer_ = VK_NULL_HANDLE;
+  }
+}
+
+void GeometryRingBufferVk::BeginFrame(const uint32_t frame_index) {
+  RENDERER_ASSERT(frame_index < in_flight_frame_count_)
+  segment_start_ = frame_index * kFrameSegmentSize;
+  write_offset_ = segment_start_;
+  overflow_reported_ = false;
+}
+
+void GeometryRingBufferVk::EndFrame() {
+  if (write_offset_ > segment_start_) {
+    // No-op for host coherent memory
+    vmaFlushAllocation(allocator_, buffer_alloc_, segment_start_, write_offset_ - segment_start_);
+  }
+}
+
+uint32_t GeometryRingBufferVk::Write(const void* data, const size_t size) {
+  // 4 byte alignment covers the float vertex attributes and 16-bit index offsets
+  const uint32_t offset = (write_offset_ + 3) & ~3u;
+  if (offset + size > segment_start_ + kFrameSegmentSize) {
+    if (!overflow_reported_) {
+      RENDERER_ERROR("Geometry ring segment full (%u bytes)", kFrameSegmentSize)
+      overflow_reported_ = true;
+    }
+    return kInvalidOffset;
+  }
+  memcpy(mapped_data_ + offset, data, size);
+  write_offset_ = offset + static_cast<uint32_t>(size);
+  return offset;
+}
+
+} // namespace simple_renderer
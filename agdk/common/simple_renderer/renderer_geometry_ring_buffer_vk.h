@@ -0,0 +1,64 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SIMPLERENDERER_GEOMETRY_RING_BUFFER_VK_H_
+#define SIMPLERENDERER_GEOMETRY_RING_BUFFER_VK_H_
+
+#include <cstdint>
+#include "renderer_vk_includes.h"
+
+namespace simple_renderer {
+
+// A persistently mapped, host visible vertex and index buffer divided into one segment
+// per in-flight frame. Renderer::DrawIndexedDynamic copies its vertices and indices into
+// the segment of the active frame and binds them from there. Only written by the render
+// thread.
+class GeometryRingBufferVk {
+ public:
+  // Size of each per-frame segment
+  static constexpr uint32_t kFrameSegmentSize = 256 * 1024;
+  // Returned by Write if the frame segment is full
+  static constexpr uint32_t kInvalidOffset = 0xFFFFFFFF;
+
+  GeometryRingBufferVk(VmaAllocator allocator, const uint32_t in_flight_frame_count);
+  ~GeometryRingBufferVk();
+
+  // Start writing into the segment of the specified in-flight frame, the frame fence
+  // must have been waited on
+  void BeginFrame(const uint32_t frame_index);
+  // Flush the data written this frame, if the memory isn't host coherent
+  void EndFrame();
+
+  // Copy data into the active frame segment at a multiple of 4 bytes, returns the buffer
+  // offset of the copy, or kInvalidOffset if the segment is full
+  uint32_t Write(const void* data, const size_t size);
+
+  VkBuffer GetBuffer() const { return buffer_; }
+
+ private:
+  VmaAllocator allocator_;
+  VkBuffer buffer_;
+  VmaAllocation buffer_alloc_;
+  uint8_t* mapped_data_;
+  uint32_t in_flight_frame_count_;
+  uint32_t segment_start_;
+  uint32_t write_offset_;
+  bool overflow_reported_;
+};
+
+} // namespace simple_renderer
+
+#endif // SIMPLERENDERER_GEOMETRY_RING_BUFFER_VK_H_
@@ -17,9 +17,11 @@
 #include "renderer_gles.h"
 #include "renderer_debug.h"
 #include "renderer_index_buffer_gles.h"
+#include "renderer_recording_context_gles.h"
 #include "renderer_render_pass_gles.h"
 #include "renderer_render_state_gles.h"
 #include "renderer_shader_program_gles.h"
+#include "renderer_state_cache_gles.h"
 #include "renderer_texture_gles.h"
 #include "renderer_uniform_buffer_gles.h"
 #include "renderer_vertex_buffer_gles.h"
@@ -31,8 +33,26 @@ using namespace base_game_framework;
 namespace simple_renderer {
 
 static const char *kAstcExtensionString = "GL_OES_texture_compression_astc";
+static constexpr const char* kRenderPassGPUScopeName = "render pass";
 
-RendererGLES::RendererGLES() {
+static_assert(sizeof(Renderer::DrawIndexedRecord) == 5 * sizeof(GLuint),
+              "DrawIndexedRecord must match DrawElementsIndirectCommand");
+
+RendererGLES& RendererGLES::GetInstanceGLES() {
+  return *(static_cast<RendererGLES*>(Renderer::GetInstancePtr()));
+}
+
+RendererGLES::RendererGLES() :
+    resources_(stats_),
+    state_cache_(),
+    state_cache_frame_counters_({0, 0}),
+    uniform_ring_(),
+    geometry_ring_(),
+    indirect_ring_(),
+    gpu_profiler_(),
+    render_pass_gpu_scope_(GPUProfiler::kInvalidScope),
+    frame_number_(0),
+    vertex_array_(0) {
   GraphicsAPIResourcesGLES graphics_api_resources_gles;
   SwapchainFrameResourcesGLES swapchain_frame_resources_gles;
   DisplayManager& display_manager = DisplayManager::GetInstance();
@@ -47,6 +67,25 @@ RendererGLES::RendererGLES() {
   // Call BeginFrame to make sure the context is set in case the user starts creating resources
   // immediately after initialization
   BeginFrame(Renderer::GetSwapchainHandle());
+
+  glGenVertexArrays(1, &vertex_array_);
+  RENDERER_CHECK_GLES("glGenVertexArrays");
+  glBindVertexArray(vertex_array_);
+
+  uniform_ring_.reset(new UniformRingBufferGLES(state_cache_));
+  uniform_ring_->BeginFrame(frame_number_);
+  geometry_ring_.reset(new GeometryRingBufferGLES(state_cache_));
+  geometry_ring_->BeginFrame(frame_number_);
+
+  GLint major_version = 0;
+  GLint minor_version = 0;
+  glGetIntegerv(GL_MAJOR_VERSION, &major_version);
+  glGetIntegerv(GL_MINOR_VERSION, &minor_version);
+  if (major_version > 3 || (major_version == 3 && minor_version >= 1)) {
+    indirect_ring_.reset(new IndirectRingBufferGLES());
+    indirect_ring_->BeginFrame(frame_number_);
+  }
+  gpu_profiler_.reset(new GPUProfilerGLES());
 }
 
 RendererGLES::~RendererGLES() {
@@ -56,6 +95,21 @@ void RendererGLES::PrepareShutdown() {
   render_pass_ = nullptr;
   render_state_ = nullptr;
   resources_.ProcessDeleteQueue();
+  uniform_ring_.reset();
+  geometry_ring_.reset();
+  indirect_ring_.reset();
+  gpu_profiler_.reset();
+  if (vertex_array_ != 0) {
+    glBindVertexArray(0);
+    glDeleteVertexArrays(1, &vertex_array_);
+    vertex_array_ = 0;
+  }
+  state_cache_.Invalidate();
+}
+
+void RendererGLES::SetStateCacheEnabled(const bool enabled) {
+  state_cache_.SetEnabled(enabled);
+  state_cache_.Invalidate();
 }
 
 bool RendererGLES::GetFeatureAvailable(const RendererFeature feature) {
@@ -75,6 +129,15 @@ bool RendererGLES::GetFeatureAvailable(const RendererFeature feature) {
       }
     }
       break;
+    case Renderer::kFeature_GPUTimestamps:
+      supported = (gpu_profiler_.get() != nullptr && gpu_profiler_->GetEnabled());
+      break;
+    case Renderer::kFeature_DrawIndirect:
+      supported = (indirect_ring_.get() != nullptr);
+      break;
+    case Renderer::kFeature_MultiDrawIndirect:
+      supported = (indirect_ring_.get() != nullptr && indirect_ring_->GetMultiDrawSupported());
+      break;
     default:
       break;
   }
@@ -83,12 +146,38 @@ bool RendererGLES::GetFeatureAvailable(const RendererFeature feature) {
 
 void RendererGLES::BeginFrame(
     const base_game_framework::DisplayManager::SwapchainHandle /*swapchain_handle*/) {
+  RendererStats::ScopedTimer begin_frame_timer(stats_, RendererStats::kStat_BeginFrameTime);
+  stats_.BeginFrame(frame_number_ + 1);
   resources_.ProcessDeleteQueue();
   EGLBoolean result = eglMakeCurrent(egl_display_, egl_surface_, egl_surface_, egl_context_);
   if (result == EGL_FALSE) {
     RENDERER_ERROR("eglMakeCurrent failed: %d", eglGetError())
   }
 
+  // GL state may have been changed outside of the renderer since the last frame
+  state_cache_.Invalidate();
+  state_cache_frame_counters_ = state_cache_.GetCounters();
+  state_cache_.ResetCounters();
+
+  if (vertex_array_ != 0) {
+    glBindVertexArray(vertex_array_);
+  }
+
+  ++frame_number_;
+  if (uniform_ring_.get() != nullptr) {
+    uniform_ring_->BeginFrame(frame_number_);
+  }
+  if (geometry_ring_.get() != nullptr) {
+    geometry_ring_->BeginFrame(frame_number_);
+  }
+  if (indirect_ring_.get() != nullptr) {
+    indirect_ring_->BeginFrame(frame_number_);
+  }
+  if (gpu_profiler_.get() != nullptr) {
+    gpu_profiler_->BeginFrame(frame_number_ % GPUProfilerGLES::kFrameSlotCount, stats_);
+  }
+  render_pass_gpu_scope_ = GPUProfiler::kInvalidScope;
+
   // Make sure errors are cleared at top of frame
   GLenum gl_error = glGetError();
   while (gl_error != GL_NO_ERROR) {
@@ -97,7 +186,12 @@ void RendererGLES::BeginFrame(
 }
 
 void RendererGLES::EndFrame() {
+  RendererStats::ScopedTimer end_frame_timer(stats_, RendererStats::kStat_EndFrameTime);
   EndRenderPass();
+  if (gpu_profiler_.get() != nullptr) {
+    gpu_profiler_->EndFrame();
+  }
+  render_pass_gpu_scope_ = GPUProfiler::kInvalidScope;
 
   // Clear current render pass
   render_pass_ = nullptr;
@@ -107,11 +201,22 @@ void RendererGLES::SwapchainRecreated() {
 
 }
 
+void RendererGLES::AcquireThreadContext() {
+  EGLBoolean result = eglMakeCurrent(egl_display_, egl_surface_, egl_surface_, egl_context_);
+  if (result == EGL_FALSE) {
+    RENDERER_ERROR("eglMakeCurrent failed: %d", eglGetError())
+  }
+}
+
+void RendererGLES::ReleaseThreadContext() {
+  eglMakeCurrent(egl_display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+}
+
 void RendererGLES::EndRenderPass() {
   // Unbind any current render state
   if (render_state_ != nullptr) {
     RenderStateGLES& previous_state = *(static_cast<RenderStateGLES*>(render_state_.get()));
-    previous_state.UnbindRenderState();
+    previous_state.UnbindRenderState(state_cache_);
   }
   // Clear current render state
   render_state_ = nullptr;
@@ -125,95 +230,241 @@ void RendererGLES::EndRenderPass() {
 void RendererGLES::Draw(const uint32_t vertex_count, const uint32_t first_vertex) {
   // Update any uniform data that might have changed between draw calls
   RenderStateGLES& state = *(static_cast<RenderStateGLES*>(render_state_.get()));
-  state.UpdateUniformData(true);
+  state.BindVertexAttributes(state_cache_, 0);
+  state.UpdateUniformData(state_cache_, false);
 
   glDrawArrays(state.GetPrimitiveType(), first_vertex, vertex_count);
   RENDERER_CHECK_GLES("glDrawArrays");
+  stats_.AddDraw(state.GetPrimitiveType() == GL_TRIANGLES, vertex_count);
 }
 
 void RendererGLES::DrawIndexed(const uint32_t index_count, const uint32_t first_index) {
-  // Update any uniform data that might have changed between draw calls
+  DrawIndexed(index_count, first_index, 0);
+}
+
+void RendererGLES::DrawIndexed(const uint32_t index_count, const uint32_t first_index,
+                               const uint32_t base_vertex) {
+  // GLES 3.0 has no base vertex draw, offset the attribute pointers instead
   RenderStateGLES& state = *(static_cast<RenderStateGLES*>(render_state_.get()));
-  state.UpdateUniformData(true);
+  state.BindVertexAttributes(state_cache_, base_vertex);
+  // Update any uniform data that might have changed between draw calls
+  state.UpdateUniformData(state_cache_, false);
 
   // Currently fixed to 16-bit index values
   const void* first_index_offset = reinterpret_cast<const void*>((first_index * sizeof(uint16_t)));
   glDrawElements(state.GetPrimitiveType(),
                  index_count, GL_UNSIGNED_SHORT, first_index_offset);
   RENDERER_CHECK_GLES("glDrawElements");
+  stats_.AddDraw(state.GetPrimitiveType() == GL_TRIANGLES, index_count);
 }
 
-void RendererGLES::SetRenderPass(std::shared_ptr<RenderPass> render_pass) {
+void RendererGLES::DrawIndexedMulti(const DrawIndexedRecord* records,
+                                    const uint32_t record_count) {
+  if (record_count == 0) {
+    return;
+  }
+  RenderStateGLES& state = *(static_cast<RenderStateGLES*>(render_state_.get()));
+  const bool triangle_list = (state.GetPrimitiveType() == GL_TRIANGLES);
+  // Update any uniform data that might have changed between draw calls
+  state.UpdateUniformData(state_cache_, false);
+
+  uint32_t indirect_offset = IndirectRingBufferGLES::kInvalidOffset;
+  if (indirect_ring_.get() != nullptr) {
+    indirect_offset = indirect_ring_->Write(records, record_count);
+  }
+  if (indirect_offset != IndirectRingBufferGLES::kInvalidOffset) {
+    // Indirect draws apply the base vertex of each record themselves
+    state.BindVertexAttributes(state_cache_, 0);
+    const uint32_t draw_calls = indirect_ring_->Draw(state.GetPrimitiveType(), indirect_offset,
+                                                     record_count);
+    AddMultiDrawStats(records, record_count, triangle_list, draw_calls);
+    return;
+  }
+
+  // GLES 3.0, or the indirect ring is full, draw each record with the attribute
+  // pointers offset by its base vertex
+  for (uint32_t i = 0; i < record_count; ++i) {
+    const DrawIndexedRecord& record = records[i];
+    RENDERER_ASSERT(record.base_vertex >= 0)
+    state.BindVertexAttributes(state_cache_, static_cast<uint32_t>(record.base_vertex));
+    const void* first_index_offset =
+        reinterpret_cast<const void*>((record.first_index * sizeof(uint16_t)));
+    glDrawElementsInstanced(state.GetPrimitiveType(), record.index_count, GL_UNSIGNED_SHORT,
+                            first_index_offset, record.instance_count);
+  }
+  RENDERER_CHECK_GLES("glDrawElementsInstanced");
+  AddMultiDrawStats(records, record_count, triangle_list, record_count);
+}
+
+void RendererGLES::DrawIndexedDynamic(const VertexBuffer::VertexFormat vertex_format,
+                                      const void* vertex_data, const uint32_t vertex_count,
+                                      const uint16_t* index_data, const uint32_t index_count) {
+  if (index_count == 0) {
+    return;
+  }
+  const size_t vertex_stride = VertexBuffer::GetVertexFormatStride(vertex_format);
+  uint32_t first_vertex = 0;
+  uint32_t first_index = 0;
+  if (!geometry_ring_->Write(state_cache_, vertex_data, vertex_stride, vertex_count,
+                             index_data, index_count, first_vertex, first_index)) {
+    return;
+  }
+  stats_.Add(RendererStats::kStat_BufferBytesUploaded,
+             vertex_count * vertex_stride + index_count * sizeof(uint16_t));
+
+  // The ring buffers are now bound, draw from them like DrawIndexed with a base vertex
+  RenderStateGLES& state = *(static_cast<RenderStateGLES*>(render_state_.get()));
+  state.BindVertexAttributes(state_cache_, first_vertex);
+  state.UpdateUniformData(state_cache_, false);
+
+  const void* first_index_offset = reinterpret_cast<const void*>((first_index * sizeof(uint16_t)));
+  glDrawElements(state.GetPrimitiveType(),
+                 index_count, GL_UNSIGNED_SHORT, first_index_offset);
+  RENDERER_CHECK_GLES("glDrawElements");
+  stats_.AddDraw(state.GetPrimitiveType() == GL_TRIANGLES, index_count);
+}
+
+void RendererGLES::SetRenderPass(const std::shared_ptr<RenderPass>& render_pass) {
   // End any currently active render pass
   EndRenderPass();
+  if (gpu_profiler_.get() != nullptr) {
+    gpu_profiler_->CloseScope(render_pass_gpu_scope_);
+  }
+  render_pass_gpu_scope_ = GPUProfiler::kInvalidScope;
 
   render_pass_ = render_pass;
   // Call BeginRenderPass on the new one
   if (render_pass != nullptr) {
+    if (gpu_profiler_.get() != nullptr) {
+      render_pass_gpu_scope_ = gpu_profiler_->OpenScope(kRenderPassGPUScopeName);
+    }
     render_pass->BeginRenderPass();
   }
 }
 
-void RendererGLES::SetRenderState(std::shared_ptr<RenderState> render_state) {
+void RendererGLES::SetRenderState(const std::shared_ptr<RenderState>& render_state) {
   // Exit early if we are setting a render state that is already the current one
   if (render_state_.get() == render_state.get()) {
     return;
   }
 
-  // Unbind resources from any currently active render state
-  if (render_state_ != nullptr) {
-    RenderStateGLES& previous_state = *(static_cast<RenderStateGLES*>(render_state_.get()));
-    previous_state.UnbindRenderState();
-  }
-
-  // Set the new state and bind its resources
+  // Set the new state and bind its resources, the state cache takes care of
+  // only changing state that differs from the previous render state
   render_state_ = render_state;
   RenderStateGLES& state = *(static_cast<RenderStateGLES*>(render_state.get()));
-  state.BindRenderState();
+  state.BindRenderState(state_cache_);
+  stats_.Add(RendererStats::kStat_PipelineBinds, 1);
 }
 
-void RendererGLES::BindIndexBuffer(std::shared_ptr<IndexBuffer> index_buffer) {
+void RendererGLES::BindIndexBuffer(const std::shared_ptr<IndexBuffer>& index_buffer) {
   if (index_buffer == nullptr) {
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    RENDERER_CHECK_GLES("glBindBuffer GL_ELEMENT_ARRAY_BUFFER reset");
+    state_cache_.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
   } else {
     const IndexBufferGLES& index = *static_cast<IndexBufferGLES *>(index_buffer.get());
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index.GetIndexBufferObject());
-    RENDERER_CHECK_GLES("glBindBuffer GL_ELEMENT_ARRAY_BUFFER");
+    state_cache_.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, index.GetIndexBufferObject());
   }
 }
 
-void RendererGLES::BindVertexBuffer(std::shared_ptr<VertexBuffer> vertex_buffer) {
+void RendererGLES::BindVertexBuffer(const std::shared_ptr<VertexBuffer>& vertex_buffer) {
   if (vertex_buffer == nullptr) {
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    RENDERER_CHECK_GLES("glBindBuffer GL_ARRAY_BUFFER reset");
+    state_cache_.BindBuffer(GL_ARRAY_BUFFER, 0);
   } else {
     const VertexBufferGLES& vertex = *static_cast<VertexBufferGLES *>(vertex_buffer.get());
-    glBindBuffer(GL_ARRAY_BUFFER, vertex.GetVertexBufferObject());
-    RENDERER_CHECK_GLES("glBindBuffer GL_ARRAY_BUFFER");
+    state_cache_.BindBuffer(GL_ARRAY_BUFFER, vertex.GetVertexBufferObject());
   }
 }
 
-void RendererGLES::BindTexture(std::shared_ptr<Texture> texture) {
+void RendererGLES::BindTexture(const std::shared_ptr<Texture>& texture) {
   if (texture == nullptr) {
-    glBindTexture(GL_TEXTURE_2D, 0);
-    RENDERER_CHECK_GLES("glBindTexture reset");
+    state_cache_.BindTexture(0);
   } else {
     const TextureGLES& tex = *static_cast<TextureGLES *>(texture.get());
-    glBindTexture(GL_TEXTURE_2D, tex.GetTextureObject());
-    RENDERER_CHECK_GLES("glBindTexture");
+    state_cache_.BindTexture(tex.GetTextureObject());
+  }
+}
+
+void RendererGLES::SetRenderPass(const RenderPassHandle render_pass) {
+  if (!resources_.Validate(render_pass)) {
+    return;
+  }
+  SetRenderPass(resources_.GetRenderPass(render_pass));
+}
+
+void RendererGLES::SetRenderState(const RenderStateHandle render_state) {
+  if (!resources_.Validate(render_state)) {
+    return;
+  }
+  SetRenderState(resources_.GetRenderState(render_state));
+}
+
+void RendererGLES::BindIndexBuffer(const IndexBufferHandle index_buffer) {
+  if (!resources_.Validate(index_buffer)) {
+    return;
+  }
+  BindIndexBuffer(resources_.GetIndexBuffer(index_buffer));
+}
+
+void RendererGLES::BindVertexBuffer(const VertexBufferHandle vertex_buffer) {
+  if (!resources_.Validate(vertex_buffer)) {
+    return;
+  }
+  BindVertexBuffer(resources_.GetVertexBuffer(vertex_buffer));
+}
+
+void RendererGLES::BindTexture(const TextureHandle texture) {
+  if (!resources_.Validate(texture)) {
+    return;
+  }
+  BindTexture(resources_.GetTexture(texture));
+}
+
+void RendererGLES::ExecuteRecordingContexts(std::shared_ptr<RenderPass> render_pass,
+                                            const std::shared_ptr<RecordingContext>* contexts,
+                                            const uint32_t context_count) {
+  if (render_pass.get() != render_pass_.get()) {
+    SetRenderPass(render_pass);
+  }
+  // Recorded commands are replayed immediately, in context array order
+  for (uint32_t i = 0; i < context_count; ++i) {
+    RecordingContextGLES& context = *(static_cast<RecordingContextGLES*>(contexts[i].get()));
+    context.Execute(*this, render_pass.get());
+  }
+}
+
+void RendererGLES::BeginGPUScope(const char* name) {
+  if (gpu_profiler_.get() != nullptr) {
+    gpu_profiler_->BeginScope(name);
+  }
+}
+
+void RendererGLES::EndGPUScope() {
+  if (gpu_profiler_.get() != nullptr) {
+    gpu_profiler_->EndScope();
   }
 }
 
 std::shared_ptr<IndexBuffer> RendererGLES::CreateIndexBuffer(
     const IndexBuffer::IndexBufferCreationParams& params) {
-  return resources_.AddIndexBuffer(new IndexBufferGLES(params));
+  stats_.Add(RendererStats::kStat_BufferBytesUploaded, params.data_byte_size);
+  std::shared_ptr<IndexBuffer> index_buffer =
+      resources_.AddIndexBuffer(new IndexBufferGLES(params));
+  // Buffer creation binds the new buffer outside of the state cache
+  state_cache_.InvalidateBufferBinding(GL_ELEMENT_ARRAY_BUFFER);
+  return index_buffer;
 }
 
 void RendererGLES::DestroyIndexBuffer(std::shared_ptr<IndexBuffer> index_buffer) {
   resources_.QueueDeleteIndexBuffer(index_buffer);
 }
 
+std::shared_ptr<RecordingContext> RendererGLES::CreateRecordingContext() {
+  return resources_.AddRecordingContext(new RecordingContextGLES());
+}
+
+void RendererGLES::DestroyRecordingContext(std::shared_ptr<RecordingContext> recording_context) {
+  resources_.QueueDeleteRecordingContext(recording_context);
+}
+
 std::shared_ptr<RenderPass> RendererGLES::CreateRenderPass(
     const RenderPass::RenderPassCreationParams& params) {
   return resources_.AddRenderPass(new RenderPassGLES(params));
@@ -225,7 +476,11 @@ void RendererGLES::DestroyRenderPass(std::shared_ptr<RenderPass> render_pass) {
 
 std::shared_ptr<RenderState> RendererGLES::CreateRenderState(
     const RenderState::RenderStateCreationParams& params) {
-  return resources_.AddRenderState(new RenderStateGLES(params));
+  std::shared_ptr<RenderState> render_state =
+      resources_.AddRenderState(new RenderStateGLES(params));
+  // Render state creation binds the program to query locations
+  state_cache_.InvalidateProgram();
+  return render_state;
 }
 
 void RendererGLES::DestroyRenderState(std::shared_ptr<RenderState> render_state) {
@@ -242,7 +497,18 @@ void RendererGLES::DestroyShaderProgram(std::shared_ptr<ShaderProgram> shader_pr
 }
 
 std::shared_ptr<Texture> RendererGLES::CreateTexture(const Texture::TextureCreationParams& params) {
-  return resources_.AddTexture(new TextureGLES(params));
+  stats_.AddTextureUpload(params);
+  std::shared_ptr<Texture> texture = resources_.AddTexture(new TextureGLES(params));
+  // Texture creation binds the new texture outside of the state cache
+  state_cache_.InvalidateTextureBinding();
+  return texture;
+}
+
+std::shared_ptr<Texture> RendererGLES::CreateRenderTarget(
+    const Texture::RenderTargetCreationParams& params) {
+  std::shared_ptr<Texture> texture = resources_.AddTexture(new TextureGLES(params));
+  state_cache_.InvalidateTextureBinding();
+  return texture;
 }
 
 void RendererGLES::DestroyTexture(std::shared_ptr<Texture> texture) {
@@ -260,7 +526,12 @@ void RendererGLES::DestroyUniformBuffer(std::shared_ptr<UniformBuffer> uniform_b
 
 std::shared_ptr<VertexBuffer> RendererGLES::CreateVertexBuffer(
     const VertexBuffer::VertexBufferCreationParams& params) {
-  return resources_.AddVertexBuffer(new VertexBufferGLES(params));
+  stats_.Add(RendererStats::kStat_BufferBytesUploaded, params.data_byte_size);
+  std::shared_ptr<VertexBuffer> vertex_buffer =
+      resources_.AddVertexBuffer(new VertexBufferGLES(params));
+  // Buffer creation binds the new buffer outside of the state cache
+  state_cache_.InvalidateBufferBinding(GL_ARRAY_BUFFER);
+  return vertex_buffer;
 }
 
 void RendererGLES::DestroyVertexBuffer(std::shared_ptr<VertexBuffer> vertex_buffer) {
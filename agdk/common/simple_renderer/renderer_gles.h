@@ -17,8 +17,13 @@
 #ifndef SIMPLERENDERER_GLES_H_
 #define SIMPLERENDERER_GLES_H_
 
+#include "renderer_geometry_ring_buffer_gles.h"
+#include "renderer_gpu_profiler_gles.h"
+#include "renderer_indirect_ring_buffer_gles.h"
 #include "renderer_interface.h"
 #include "renderer_resources.h"
+#include "renderer_state_cache_gles.h"
+#include "renderer_uniform_ring_buffer_gles.h"
 #include <EGL/egl.h>
 #include <GLES3/gl3.h>
 
@@ -33,6 +38,18 @@ class RendererGLES : public Renderer {
   RendererGLES();
   virtual ~RendererGLES();
 
+  static RendererGLES& GetInstanceGLES();
+
+  // Issued/elided GL call counts of the GL state cache for the last completed frame
+  const StateCacheGLES::Counters& GetStateCacheFrameCounters() const {
+    return state_cache_frame_counters_;
+  }
+  // Disabling the state cache issues every GL call, used to compare the call counts
+  void SetStateCacheEnabled(const bool enabled);
+
+  uint64_t GetFrameNumber() const { return frame_number_; }
+  UniformRingBufferGLES& GetUniformRing() const { return *uniform_ring_; }
+
   virtual bool GetFeatureAvailable(const RendererFeature feature);
 
   virtual void BeginFrame(
@@ -41,22 +58,47 @@ class RendererGLES : public Renderer {
 
   virtual void SwapchainRecreated();
 
+  virtual void AcquireThreadContext();
+  virtual void ReleaseThreadContext();
+
   virtual void Draw(const uint32_t vertex_count, const uint32_t first_vertex);
   virtual void DrawIndexed(const uint32_t index_count, const uint32_t first_index);
+  virtual void DrawIndexed(const uint32_t index_count, const uint32_t first_index,
+                           const uint32_t base_vertex);
+  virtual void DrawIndexedMulti(const DrawIndexedRecord* records, const uint32_t record_count);
+  virtual void DrawIndexedDynamic(const VertexBuffer::VertexFormat vertex_format,
+                                  const void* vertex_data, const uint32_t vertex_count,
+                                  const uint16_t* index_data, const uint32_t index_count);
 
-  virtual void SetRenderPass(std::shared_ptr<RenderPass> render_pass);
-  virtual void SetRenderState(std::shared_ptr<RenderState> render_state);
+  virtual void SetRenderPass(const std::shared_ptr<RenderPass>& render_pass);
+  virtual void SetRenderState(const std::shared_ptr<RenderState>& render_state);
 
   // Resource binds
-  virtual void BindIndexBuffer(std::shared_ptr<IndexBuffer> index_buffer);
-  virtual void BindVertexBuffer(std::shared_ptr<VertexBuffer> vertex_buffer);
-  virtual void BindTexture(std::shared_ptr<Texture> texture);
+  virtual void BindIndexBuffer(const std::shared_ptr<IndexBuffer>& index_buffer);
+  virtual void BindVertexBuffer(const std::shared_ptr<VertexBuffer>& vertex_buffer);
+  virtual void BindTexture(const std::shared_ptr<Texture>& texture);
+
+  virtual void SetRenderPass(const RenderPassHandle render_pass);
+  virtual void SetRenderState(const RenderStateHandle render_state);
+  virtual void BindIndexBuffer(const IndexBufferHandle index_buffer);
+  virtual void BindVertexBuffer(const VertexBufferHandle vertex_buffer);
+  virtual void BindTexture(const TextureHandle texture);
+
+  virtual void ExecuteRecordingContexts(std::shared_ptr<RenderPass> render_pass,
+                                        const std::shared_ptr<RecordingContext>* contexts,
+                                        const uint32_t context_count);
+
+  virtual void BeginGPUScope(const char* name);
+  virtual void EndGPUScope();
 
   // Resource creation and destruction
   virtual std::shared_ptr<IndexBuffer> CreateIndexBuffer(
       const IndexBuffer::IndexBufferCreationParams& params);
   virtual void DestroyIndexBuffer(std::shared_ptr<IndexBuffer> index_buffer);
 
+  virtual std::shared_ptr<RecordingContext> CreateRecordingContext();
+  virtual void DestroyRecordingContext(std::shared_ptr<RecordingContext> recording_context);
+
   virtual std::shared_ptr<RenderPass> CreateRenderPass(
       const RenderPass::RenderPassCreationParams& params);
   virtual void DestroyRenderPass(std::shared_ptr<RenderPass> render_pass);
@@ -71,6 +113,8 @@ class RendererGLES : public Renderer {
 
   virtual std::shared_ptr<Texture> CreateTexture(
       const Texture::TextureCreationParams& params);
+  virtual std::shared_ptr<Texture> CreateRenderTarget(
+      const Texture::RenderTargetCreationParams& params);
   virtual void DestroyTexture(std::shared_ptr<Texture> texture);
 
   virtual std::shared_ptr<UniformBuffer> CreateUniformBuffer(
@@ -88,6 +132,18 @@ class RendererGLES : public Renderer {
   void EndRenderPass();
 
   RendererResources resources_;
+  StateCacheGLES state_cache_;
+  StateCacheGLES::Counters state_cache_frame_counters_;
+  std::unique_ptr<UniformRingBufferGLES> uniform_ring_;
+  std::unique_ptr<GeometryRingBufferGLES> geometry_ring_;
+  // Only created on OpenGL ES 3.1 or later
+  std::unique_ptr<IndirectRingBufferGLES> indirect_ring_;
+  std::unique_ptr<GPUProfilerGLES> gpu_profiler_;
+  uint32_t render_pass_gpu_scope_;
+  uint64_t frame_number_;
+  // Bound for the lifetime of the renderer, indirect draws fail with the default
+  // vertex array object
+  GLuint vertex_array_;
 
   std::shared_ptr<RenderPass> render_pass_;
   std::shared_ptr<RenderState> render_state_;
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "renderer_gpu_profiler.h"
+#include "renderer_debug.h"
+
+namespace simple_renderer {
+
+GPUProfiler::GPUProfiler(const uint32_t frame_slot_count) :
+    enabled_(false),
+    frame_slots_(frame_slot_count),
+    user_scope_stack_(),
+    timestamps_(kMaxQueriesPerFrame),
+    scope_timings_(),
+    active_slot_(0),
+    open_scope_count_(0),
+    frame_scope_(kInvalidScope),
+    frame_active_(false) {
+  for (FrameSlot& slot : frame_slots_) {
+    slot.scopes.reserve(kMaxScopesPerFrame);
+    slot.query_count = 0;
+    slot.pending = false;
+  }
+  user_scope_stack_.reserve(kMaxScopesPerFrame);
+  scope_timings_.reserve(kMaxScopesPerFrame);
+}
+
+GPUProfiler::~GPUProfiler() {
+}
+
+void GPUProfiler::BeginFrame(const uint32_t frame_slot, RendererStats& stats) {
+  if (!enabled_) {
+    return;
+  }
+  RENDERER_ASSERT(frame_slot < frame_slots_.size())
+  FrameSlot& slot = frame_slots_[frame_slot];
+  if (slot.pending) {
+    PublishResults(slot, frame_slot, stats);
+  }
+  slot.scopes.clear();
+  slot.query_count = 0;
+  slot.pending = false;
+  user_scope_stack_.clear();
+  open_scope_count_ = 0;
+  active_slot_ = frame_slot;
+  ResetQueries(frame_slot);
+  frame_active_ = true;
+  frame_scope_ = OpenScope(kFrameScopeName);
+}
+
+void GPUProfiler::EndFrame() {
+  if (!frame_active_) {
+    return;
+  }
+  FrameSlot& slot = frame_slots_[active_slot_];
+  for (uint32_t i = 0; i < slot.scopes.size(); ++i) {
+    if (i != frame_scope_ && slot.scopes[i].end_query == kNoQuery) {
+      CloseScope(i);
+    }
+  }
+  CloseScope(frame_scope_);
+  frame_scope_ = kInvalidScope;
+  user_scope_stack_.clear();
+  slot.pending = (slot.query_count > 0);
+  frame_active_ = false;
+}
+
+uint32_t GPUProfiler::OpenScope(const char* name) {
+  if (!frame_active_) {
+    return kInvalidScope;
+  }
+  FrameSlot& slot = frame_slots_[active_slot_];
+  if (slot.scopes.size() >= kMaxScopesPerFrame) {
+    return kInvalidScope;
+  }
+  const uint32_t scope = static_cast<uint32_t>(slot.scopes.size());
+  const uint32_t begin_query = slot.query_count++;
+  slot.scopes.push_back({name, open_scope_count_, begin_query, kNoQuery});
+  ++open_scope_count_;
+  WriteTimestamp(active_slot_, begin_query);
+  return scope;
+}
+
+void GPUProfiler::CloseScope(const uint32_t scope) {
+  if (!frame_active_ || scope == kInvalidScope) {
+    return;
+  }
+  FrameSlot& slot = frame_slots_[active_slot_];
+  RENDERER_ASSERT(scope < slot.scopes.size())
+  if (slot.scopes[scope].end_query != kNoQuery) {
+    return;
+  }
+  const uint32_t end_query = slot.query_count++;
+  slot.scopes[scope].end_query = end_query;
+  --open_scope_count_;
+  WriteTimestamp(active_slot_, end_query);
+}
+
+void GPUProfiler::BeginScope(const char* name) {
+  // Invalid scopes are pushed too, to keep the matching EndScope balanced
+  user_scope_stack_.push_back(OpenScope(name));
+}
+
+void GPUProfiler::EndScope() {
+  if (user_scope_stack_.empty()) {
+    return;
+  }
+  CloseScope(user_scope_stack_.back());
+  user_scope_stack_.pop_back();
+}
+
+void GPUProfiler::PublishResults(FrameSlot& slot, const uint32_t frame_slot,
+                                 RendererStats& stats) {
+  if (!GetTimestamps(frame_slot, slot.query_count, timestamps_.data())) {
+    return;
+  }
+  scope_timings_.clear();
+  for (const Scope& scope : slot.scopes) {
+    const uint64_t begin_time = timestamps_[scope.begin_query];
+    const uint64_t end_time = timestamps_[scope.end_query];
+    const uint64_t gpu_time = (end_time > begin_time) ? (end_time - begin_time) : 0;
+    scope_timings_.push_back({scope.name, scope.depth, gpu_time});
+  }
+  stats.SetGPUScopeTimings(scope_timings_);
+}
+
+} // namespace simple_renderer
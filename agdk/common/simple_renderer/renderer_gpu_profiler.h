@@ -0,0 +1,105 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SIMPLERENDERER_GPU_PROFILER_H_
+#define SIMPLERENDERER_GPU_PROFILER_H_
+
+#include "renderer_stats.h"
+#include <cstdint>
+#include <vector>
+
+namespace simple_renderer {
+
+// Tracks named, nestable GPU timing scopes for a ring of frame slots, one slot
+// per frame that can be in flight. Each scope writes a timestamp query at its
+// start and end. When a slot is reused its results are read back without
+// waiting, frames whose results are not available yet are dropped, and the
+// scope times are published to RendererStats. The API specific subclasses
+// implement the timestamp queries.
+class GPUProfiler {
+ public:
+  static constexpr uint32_t kMaxScopesPerFrame = 64;
+  static constexpr uint32_t kMaxQueriesPerFrame = kMaxScopesPerFrame * 2;
+  // Name of the scope enclosing all work submitted during a frame
+  static constexpr const char* kFrameScopeName = "frame";
+
+  GPUProfiler(const uint32_t frame_slot_count);
+  virtual ~GPUProfiler();
+
+  bool GetEnabled() const { return enabled_; }
+
+  // Resolves the previous results of frame_slot and opens the frame scope
+  void BeginFrame(const uint32_t frame_slot, RendererStats& stats);
+  // Closes any scopes still open, the frame scope last
+  void EndFrame();
+
+  // Open a scope, returns an identifier for CloseScope, or kInvalidScope if the
+  // profiler is disabled or the frame already has kMaxScopesPerFrame scopes.
+  // name must remain valid until the results have been published, string
+  // literals are expected.
+  uint32_t OpenScope(const char* name);
+  // Scopes opened with OpenScope do not have to be closed in order
+  void CloseScope(const uint32_t scope);
+
+  // Scopes opened by the renderer user, closed in reverse order of opening
+  void BeginScope(const char* name);
+  void EndScope();
+
+  static constexpr uint32_t kInvalidScope = 0xFFFFFFFF;
+
+ protected:
+  // Called at the start of BeginFrame, before any timestamp is written to the slot
+  virtual void ResetQueries(const uint32_t frame_slot) = 0;
+  virtual void WriteTimestamp(const uint32_t frame_slot, const uint32_t query_index) = 0;
+  // Retrieve query_count timestamps in nanoseconds without waiting, returns
+  // false if the results are not available or not valid
+  virtual bool GetTimestamps(const uint32_t frame_slot, const uint32_t query_count,
+                             uint64_t* timestamps) = 0;
+
+  bool enabled_;
+
+ private:
+  static constexpr uint32_t kNoQuery = 0xFFFFFFFF;
+
+  struct Scope {
+    const char* name;
+    uint32_t depth;
+    uint32_t begin_query;
+    uint32_t end_query;
+  };
+
+  struct FrameSlot {
+    std::vector<Scope> scopes;
+    uint32_t query_count;
+    bool pending;
+  };
+
+  void PublishResults(FrameSlot& slot, const uint32_t frame_slot, RendererStats& stats);
+
+  std::vector<FrameSlot> frame_slots_;
+  std::vector<uint32_t> user_scope_stack_;
+  std::vector<uint64_t> timestamps_;
+  std::vector<RendererStats::GPUScopeTiming> scope_timings_;
+  uint32_t active_slot_;
+  uint32_t open_scope_count_;
+  uint32_t frame_scope_;
+  bool frame_active_;
+};
+
+} // namespace simple_renderer
+
+#endif // SIMPLERENDERER_GPU_PROFILER_H_
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "renderer_gpu_profiler_gles.h"
+#include "renderer_debug.h"
+#include <EGL/egl.h>
+#include <cstring>
+
+namespace simple_renderer {
+
+static const char* kTimerQueryExtensionString = "GL_EXT_disjoint_timer_query";
+
+static bool HasExtension(const char* extension_name) {
+  GLint extension_count = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &extension_count);
+  for (GLint i = 0; i < extension_count; ++i) {
+    const GLubyte* extension_string = glGetStringi(GL_EXTENSIONS, i);
+    if (strcmp(reinterpret_cast<const char*>(extension_string), extension_name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+GPUProfilerGLES::GPUProfilerGLES() :
+    GPUProfiler(kFrameSlotCount),
+    queries_(),
+    query_counter_(nullptr),
+    get_query_object_ui64v_(nullptr) {
+  if (!HasExtension(kTimerQueryExtensionString)) {
+    RENDERER_LOG("GPU timestamps not supported, %s not available", kTimerQueryExtensionString)
+    return;
+  }
+  query_counter_ = reinterpret_cast<PFNGLQUERYCOUNTEREXTPROC>(
+      eglGetProcAddress("glQueryCounterEXT"));
+  get_query_object_ui64v_ = reinterpret_cast<PFNGLGETQUERYOBJECTUI64VEXTPROC>(
+      eglGetProcAddress("glGetQueryObjectui64vEXT"));
+  PFNGLGETQUERYIVEXTPROC get_query_iv = reinterpret_cast<PFNGLGETQUERYIVEXTPROC>(
+      eglGetProcAddress("glGetQueryivEXT"));
+  if (query_counter_ == nullptr || get_query_object_ui64v_ == nullptr ||
+      get_query_iv == nullptr) {
+    RENDERER_ERROR("Failed to load %s entry points", kTimerQueryExtensionString)
+    return;
+  }
+
+  // Some implementations only support GL_TIME_ELAPSED_EXT, which can't be nested
+  GLint timestamp_bits = 0;
+  get_query_iv(GL_TIMESTAMP_EXT, GL_QUERY_COUNTER_BITS_EXT, &timestamp_bits);
+  if (timestamp_bits == 0) {
+    RENDERER_LOG("GPU timestamps not supported, GL_TIMESTAMP_EXT has no counter bits")
+    return;
+  }
+
+  queries_.resize(kFrameSlotCount * kMaxQueriesPerFrame);
+  glGenQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+  RENDERER_CHECK_GLES("glGenQueries");
+  enabled_ = true;
+}
+
+GPUProfilerGLES::~GPUProfilerGLES() {
+  if (!queries_.empty()) {
+    glDeleteQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+  }
+}
+
+void GPUProfilerGLES::ResetQueries(const uint32_t /*frame_slot*/) {
+  // Timestamp query objects are overwritten by the next glQueryCounterEXT
+}
+
+void GPUProfilerGLES::WriteTimestamp(const uint32_t frame_slot, const uint32_t query_index) {
+  query_counter_(queries_[frame_slot * kMaxQueriesPerFrame + query_index], GL_TIMESTAMP_EXT);
+}
+
+bool GPUProfilerGLES::GetTimestamps(const uint32_t frame_slot, const uint32_t query_count,
+                                    uint64_t* timestamps) {
+  // Reading the disjoint state also clears it
+  GLint disjoint = 0;
+  glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+  if (disjoint != 0) {
+    return false;
+  }
+
+  // Queries complete in order, if the last one is available they all are
+  const GLuint* slot_queries = &queries_[frame_slot * kMaxQueriesPerFrame];
+  GLuint available = GL_FALSE;
+  glGetQueryObjectuiv(slot_queries[query_count - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+  if (available == GL_FALSE) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < query_count; ++i) {
+    GLuint64 timestamp = 0;
+    get_query_object_ui64v_(slot_queries[i], GL_QUERY_RESULT, &timestamp);
+    timestamps[i] = static_cast<uint64_t>(timestamp);
+  }
+  return true;
+}
+
+} // namespace simple_renderer
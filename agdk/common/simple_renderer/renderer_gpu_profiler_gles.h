@@ -0,0 +1,54 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SIMPLERENDERER_GPU_PROFILER_GLES_H_
+#define SIMPLERENDERER_GPU_PROFILER_GLES_H_
+
+#include "renderer_gpu_profiler.h"
+#include <GLES3/gl3.h>
+#include <GLES2/gl2ext.h>
+#include <vector>
+
+namespace simple_renderer {
+
+// Writes timestamps with glQueryCounterEXT from EXT_disjoint_timer_query, using
+// a set of query objects per frame slot. Results are read back when a slot is
+// reused, if GL_QUERY_RESULT_AVAILABLE_EXT reports them ready, and dropped if the
+// GPU reported a disjoint operation. Disabled if the extension is not available
+// or its timestamp counter has no bits.
+class GPUProfilerGLES : public GPUProfiler {
+ public:
+  static constexpr uint32_t kFrameSlotCount = 3;
+
+  GPUProfilerGLES();
+  virtual ~GPUProfilerGLES();
+
+ protected:
+  virtual void ResetQueries(const uint32_t frame_slot);
+  virtual void WriteTimestamp(const uint32_t frame_slot, const uint32_t query_index);
+  virtual bool GetTimestamps(const uint32_t frame_slot, const uint32_t query_count,
+                             uint64_t* timestamps);
+
+ private:
+  std::vector<GLuint> queries_;
+  PFNGLQUERYCOUNTEREXTPROC query_counter_;
+  PFNGLGETQUERYOBJECTUI64VEXTPROC get_query_object_ui64v_;
+};
+
+} // namespace simple_renderer
+
+#endif // SIMPLERENDERER_GPU_PROFILER_GLES_H_
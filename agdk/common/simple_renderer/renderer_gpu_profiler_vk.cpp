@@ -0,0 +1,100 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "renderer_gpu_profiler_vk.h"
+#include "renderer_debug.h"
+
+namespace simple_renderer {
+
+GPUProfilerVk::GPUProfilerVk(VkDevice device, VkPhysicalDevice physical_device,
+                             const uint32_t queue_family_index,
+                             const uint32_t in_flight_frame_count) :
+    GPUProfiler(in_flight_frame_count),
+    device_(device),
+    command_buffer_(VK_NULL_HANDLE),
+    query_pools_(),
+    timestamp_period_(0.0),
+    timestamp_mask_(0) {
+  VkPhysicalDeviceProperties device_properties;
+  vkGetPhysicalDeviceProperties(physical_device, &device_properties);
+
+  uint32_t queue_family_count = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, nullptr);
+  std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+  vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count,
+                                           queue_families.data());
+  const uint32_t valid_bits = (queue_family_index < queue_family_count) ?
+      queue_families[queue_family_index].timestampValidBits : 0;
+  if (valid_bits == 0 || device_properties.limits.timestampPeriod <= 0.0f) {
+    RENDERER_LOG("GPU timestamps not supported by the graphics queue")
+    return;
+  }
+  timestamp_period_ = static_cast<double>(device_properties.limits.timestampPeriod);
+  timestamp_mask_ = (valid_bits >= 64) ? UINT64_MAX : ((1ULL << valid_bits) - 1);
+
+  query_pools_.resize(in_flight_frame_count, VK_NULL_HANDLE);
+  for (VkQueryPool& query_pool : query_pools_) {
+    VkQueryPoolCreateInfo query_pool_info = {};
+    query_pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    query_pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    query_pool_info.queryCount = kMaxQueriesPerFrame;
+    const VkResult pool_result = vkCreateQueryPool(device_, &query_pool_info, nullptr,
+                                                   &query_pool);
+    RENDERER_CHECK_VK(pool_result, "vkCreateQueryPool");
+  }
+  enabled_ = true;
+}
+
+GPUProfilerVk::~GPUProfilerVk() {
+  for (VkQueryPool query_pool : query_pools_) {
+    vkDestroyQueryPool(device_, query_pool, nullptr);
+  }
+}
+
+void GPUProfilerVk::ResetQueries(const uint32_t frame_slot) {
+  vkCmdResetQueryPool(command_buffer_, query_pools_[frame_slot], 0, kMaxQueriesPerFrame);
+}
+
+void GPUProfilerVk::WriteTimestamp(const uint32_t frame_slot, const uint32_t query_index) {
+  // Both ends of a scope are written at the bottom of the pipe, measuring the
+  // time between the completion of the work preceding each timestamp
+  vkCmdWriteTimestamp(command_buffer_, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                      query_pools_[frame_slot], query_index);
+}
+
+bool GPUProfilerVk::GetTimestamps(const uint32_t frame_slot, const uint32_t query_count,
+                                  uint64_t* timestamps) {
+  const VkResult query_result = vkGetQueryPoolResults(device_, query_pools_[frame_slot], 0,
+                                                      query_count,
+                                                      query_count * sizeof(uint64_t),
+                                                      timestamps, sizeof(uint64_t),
+                                                      VK_QUERY_RESULT_64_BIT);
+  if (query_result != VK_SUCCESS) {
+    // VK_NOT_READY, drop the frame rather than wait
+    return false;
+  }
+  // Convert relative to the first timestamp of the frame, which keeps the tick
+  // counts small enough to convert precisely and handles counter wrap
+  const uint64_t first_timestamp = timestamps[0];
+  for (uint32_t i = 0; i < query_count; ++i) {
+    const uint64_t ticks = (timestamps[i] - first_timestamp) & timestamp_mask_;
+    timestamps[i] = static_cast<uint64_t>(static_cast<double>(ticks) * timestamp_period_);
+  }
+  return true;
+}
+
+} // namespace simple_renderer
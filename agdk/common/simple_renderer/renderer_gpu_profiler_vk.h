@@ -0,0 +1,58 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SIMPLERENDERER_GPU_PROFILER_VK_H_
+#define SIMPLERENDERER_GPU_PROFILER_VK_H_
+
+#include "renderer_gpu_profiler.h"
+#include "renderer_vk_includes.h"
+#include <vector>
+
+namespace simple_renderer {
+
+// Writes timestamps with vkCmdWriteTimestamp into one query pool per in-flight
+// frame. A pool is only reset and read back once the frame fence of its frame
+// has been waited on, so the results are normally available without stalling.
+// Disabled if the graphics queue family doesn't support timestamps.
+class GPUProfilerVk : public GPUProfiler {
+ public:
+  GPUProfilerVk(VkDevice device, VkPhysicalDevice physical_device,
+                const uint32_t queue_family_index, const uint32_t in_flight_frame_count);
+  virtual ~GPUProfilerVk();
+
+  // Queries are reset and written in command_buffer, which must be in the recording
+  // state and outside of a render pass when BeginFrame is called
+  void SetCommandBuffer(VkCommandBuffer command_buffer) { command_buffer_ = command_buffer; }
+
+ protected:
+  virtual void ResetQueries(const uint32_t frame_slot);
+  virtual void WriteTimestamp(const uint32_t frame_slot, const uint32_t query_index);
+  virtual bool GetTimestamps(const uint32_t frame_slot, const uint32_t query_count,
+                             uint64_t* timestamps);
+
+ private:
+  VkDevice device_;
+  VkCommandBuffer command_buffer_;
+  std::vector<VkQueryPool> query_pools_;
+  // Nanoseconds per timestamp tick
+  double timestamp_period_;
+  uint64_t timestamp_mask_;
+};
+
+} // namespace simple_renderer
+
+#endif // SIMPLERENDERER_GPU_PROFILER_VK_H_
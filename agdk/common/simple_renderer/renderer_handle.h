@@ -0,0 +1,101 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SIMPLERENDERER_HANDLE_H_
+#define SIMPLERENDERER_HANDLE_H_
+
+#include <cstdint>
+
+namespace simple_renderer {
+
+/**
+ * @brief A typed 32-bit handle to a renderer resource. The low bits index a slot in the
+ * dense per-type resource pool of the `Renderer`, the high bits hold the generation of
+ * the slot, which is advanced when the resource is destroyed so stale handles can be
+ * detected. Retrieve the handle of a resource with its `GetHandle` function; handles
+ * can be passed to the `Renderer` bind functions in place of shared pointers, which
+ * avoids reference count traffic in the draw loop. A default constructed handle is
+ * invalid.
+ */
+template <typename T>
+class RendererHandle {
+ public:
+  /** @brief Number of bits of the handle used for the slot index. */
+  static constexpr uint32_t kIndexBits = 20;
+  /** @brief Mask of the slot index bits. */
+  static constexpr uint32_t kIndexMask = (1u << kIndexBits) - 1;
+  /** @brief Mask of the generation bits, after shifting down by ::kIndexBits. */
+  static constexpr uint32_t kGenerationMask = (1u << (32 - kIndexBits)) - 1;
+
+  RendererHandle() : value_(0) {}
+  RendererHandle(const uint32_t index, const uint32_t generation) :
+      value_(((generation & kGenerationMask) << kIndexBits) | (index & kIndexMask)) {}
+
+  /**
+   * @brief Retrieve the slot index of the handle.
+   * @return The slot index.
+   */
+  uint32_t GetIndex() const { return value_ & kIndexMask; }
+
+  /**
+   * @brief Retrieve the generation of the handle. Valid handles have a non-zero generation.
+   * @return The generation.
+   */
+  uint32_t GetGeneration() const { return value_ >> kIndexBits; }
+
+  /**
+   * @brief Retrieve the packed 32-bit value of the handle.
+   * @return The packed value.
+   */
+  uint32_t GetValue() const { return value_; }
+
+  /**
+   * @brief Whether the handle was ever assigned to a resource. This does not
+   * check whether the resource has since been destroyed.
+   * @return true if the handle is not the default invalid handle.
+   */
+  bool IsValid() const { return value_ != 0; }
+
+  bool operator==(const RendererHandle& other) const { return value_ == other.value_; }
+  bool operator!=(const RendererHandle& other) const { return value_ != other.value_; }
+
+ private:
+  uint32_t value_;
+};
+
+class IndexBuffer;
+class RecordingContext;
+class RenderPass;
+class RenderState;
+class ShaderProgram;
+class Texture;
+class UniformBuffer;
+class VertexBuffer;
+
+typedef RendererHandle<IndexBuffer> IndexBufferHandle;
+typedef RendererHandle<RecordingContext> RecordingContextHandle;
+typedef RendererHandle<RenderPass> RenderPassHandle;
+typedef RendererHandle<RenderState> RenderStateHandle;
+typedef RendererHandle<ShaderProgram> ShaderProgramHandle;
+typedef RendererHandle<Texture> TextureHandle;
+typedef RendererHandle<UniformBuffer> UniformBufferHandle;
+typedef RendererHandle<VertexBuffer> VertexBufferHandle;
+
+template <typename T>
+class RendererResourcePool;
+}
+
+#endif // SIMPLERENDERER_HANDLE_H_
@@ -18,6 +18,7 @@
 #define SIMPLERENDERER_INDEX_BUFFER_H_
 
 #include "renderer_buffer.h"
+#include "renderer_handle.h"
 
 namespace simple_renderer
 {
@@ -45,6 +46,14 @@ class IndexBuffer : public RendererBuffer {
 
   virtual ~IndexBuffer() {}
 
+  /**
+   * @brief Retrieve the handle of the `IndexBuffer`. The handle can be passed to the
+   * `Renderer` bind functions instead of the shared pointer, and becomes stale once
+   * the `IndexBuffer` is destroyed.
+   * @return An `IndexBufferHandle`.
+   */
+  IndexBufferHandle GetHandle() const { return handle_; }
+
  protected:
   IndexBuffer(const IndexBufferCreationParams& params) :
       RendererBuffer(params.data_byte_size / kIndexElementSize,
@@ -56,6 +65,9 @@ class IndexBuffer : public RendererBuffer {
   static constexpr size_t kIndexElementSize = sizeof(uint16_t);
 
   IndexBuffer() : RendererBuffer(0, 0, 0) {}
+
+  template <typename T> friend class RendererResourcePool;
+  IndexBufferHandle handle_;
 };
 } // namespace simple_renderer
 
@@ -0,0 +1,33 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "renderer_index_buffer_null.h"
+#include "renderer_debug.h"
+
+namespace simple_renderer {
+
+IndexBufferNull::IndexBufferNull(const IndexBuffer::IndexBufferCreationParams& params) :
+    IndexBuffer(params),
+    index_data_(params.data_byte_size / sizeof(uint16_t)) {
+  RENDERER_ASSERT(params.index_data != nullptr)
+  memcpy(index_data_.data(), params.index_data, index_data_.size() * sizeof(uint16_t));
+}
+
+IndexBufferNull::~IndexBufferNull() {
+}
+
+}
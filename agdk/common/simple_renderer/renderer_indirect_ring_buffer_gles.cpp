@@ -0,0 +1,134 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "renderer_indirect_ring_buffer_gles.h"
+#include "renderer_debug.h"
+#include <EGL/egl.h>
+#include <cstring>
+
+namespace simple_renderer {
+
+static const char* kMultiDrawIndirectExtensionString = "GL_EXT_multi_draw_indirect";
+
+static bool HasExtension(const char* extension_name) {
+  GLint extension_count = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &extension_count);
+  for (GLint i = 0; i < extension_count; ++i) {
+    const GLubyte* extension_string = glGetStringi(GL_EXTENSIONS, i);
+    if (strcmp(reinterpret_cast<const char*>(extension_string), extension_name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+IndirectRingBufferGLES::IndirectRingBufferGLES() :
+    buffer_(0),
+    segment_start_(0),
+    write_offset_(0),
+    overflow_reported_(false),
+    staging_records_(),
+    draw_elements_indirect_(nullptr),
+    multi_draw_elements_indirect_(nullptr) {
+  // Loaded at runtime, the application may be linked against a library
+  // that only exports OpenGL ES 3.0 entry points
+  draw_elements_indirect_ = reinterpret_cast<PFNGLDRAWELEMENTSINDIRECTPROC>(
+      eglGetProcAddress("glDrawElementsIndirect"));
+  if (draw_elements_indirect_ == nullptr) {
+    RENDERER_ERROR("Failed to load glDrawElementsIndirect")
+  }
+  if (HasExtension(kMultiDrawIndirectExtensionString)) {
+    multi_draw_elements_indirect_ = reinterpret_cast<PFNGLMULTIDRAWELEMENTSINDIRECTEXTPROC>(
+        eglGetProcAddress("glMultiDrawElementsIndirectEXT"));
+  }
+  if (multi_draw_elements_indirect_ == nullptr) {
+    RENDERER_LOG("Multi-draw indirect not supported, %s not available",
+                 kMultiDrawIndirectExtensionString)
+  }
+
+  glGenBuffers(1, &buffer_);
+  RENDERER_CHECK_GLES("glGenBuffers");
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer_);
+  glBufferData(GL_DRAW_INDIRECT_BUFFER, kFrameSegmentSize * kFrameSegmentCount, nullptr,
+               GL_DYNAMIC_DRAW);
+  RENDERER_CHECK_GLES("glBufferData");
+}
+
+IndirectRingBufferGLES::~IndirectRingBufferGLES() {
+  if (buffer_ != 0) {
+    glDeleteBuffers(1, &buffer_);
+    buffer_ = 0;
+  }
+}
+
+void IndirectRingBufferGLES::BeginFrame(const uint64_t frame_number) {
+  segment_start_ = static_cast<uint32_t>(frame_number % kFrameSegmentCount) * kFrameSegmentSize;
+  write_offset_ = segment_start_;
+  overflow_reported_ = false;
+}
+
+uint32_t IndirectRingBufferGLES::Write(const Renderer::DrawIndexedRecord* records,
+                                       const uint32_t record_count) {
+  if (draw_elements_indirect_ == nullptr) {
+    return kInvalidOffset;
+  }
+  const size_t size = record_count * sizeof(Renderer::DrawIndexedRecord);
+  const uint32_t offset = write_offset_;
+  if (offset + size > segment_start_ + kFrameSegmentSize) {
+    if (!overflow_reported_) {
+      RENDERER_ERROR("Indirect ring segment full (%u bytes)", kFrameSegmentSize)
+      overflow_reported_ = true;
+    }
+    return kInvalidOffset;
+  }
+  write_offset_ += static_cast<uint32_t>(size);
+
+  // The first instance field is reserved and must be zero in OpenGL ES
+  staging_records_.assign(records, records + record_count);
+  for (Renderer::DrawIndexedRecord& record : staging_records_) {
+    record.first_instance = 0;
+  }
+
+  // The draw indirect binding isn't tracked by the state cache, nothing
+  // else in the renderer uses it
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer_);
+  glBufferSubData(GL_DRAW_INDIRECT_BUFFER, offset, size, staging_records_.data());
+  RENDERER_CHECK_GLES("glBufferSubData");
+  return offset;
+}
+
+uint32_t IndirectRingBufferGLES::Draw(const GLenum mode, const uint32_t offset,
+                                      const uint32_t record_count) {
+  const uintptr_t indirect_offset = offset;
+  if (multi_draw_elements_indirect_ != nullptr) {
+    multi_draw_elements_indirect_(mode, GL_UNSIGNED_SHORT,
+                                  reinterpret_cast<const void*>(indirect_offset),
+                                  static_cast<GLsizei>(record_count),
+                                  sizeof(Renderer::DrawIndexedRecord));
+    RENDERER_CHECK_GLES("glMultiDrawElementsIndirectEXT");
+    return 1;
+  }
+  for (uint32_t i = 0; i < record_count; ++i) {
+    const uintptr_t record_offset = indirect_offset + i * sizeof(Renderer::DrawIndexedRecord);
+    draw_elements_indirect_(mode, GL_UNSIGNED_SHORT,
+                            reinterpret_cast<const void*>(record_offset));
+  }
+  RENDERER_CHECK_GLES("glDrawElementsIndirect");
+  return record_count;
+}
+
+} // namespace simple_renderer
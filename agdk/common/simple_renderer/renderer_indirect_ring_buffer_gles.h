@@ -0,0 +1,72 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SIMPLERENDERER_INDIRECT_RING_BUFFER_GLES_H_
+#define SIMPLERENDERER_INDIRECT_RING_BUFFER_GLES_H_
+
+#include "renderer_interface.h"
+#include <cstdint>
+#include <vector>
+#include <GLES3/gl31.h>
+#include <GLES2/gl2ext.h>
+
+namespace simple_renderer {
+
+// A GL_DRAW_INDIRECT_BUFFER divided into one segment per frame, rotated each frame
+// like UniformRingBufferGLES. Renderer::DrawIndexedMulti copies its records into
+// the active segment and draws them with glMultiDrawElementsIndirectEXT if
+// GL_EXT_multi_draw_indirect is available, or one glDrawElementsIndirect per record.
+// Indirect draws need OpenGL ES 3.1, and a vertex array object other than 0 bound.
+class IndirectRingBufferGLES {
+ public:
+  static constexpr uint32_t kFrameSegmentCount = 3;
+  static constexpr uint32_t kFrameSegmentSize = 64 * 1024;
+  // Returned by Write if the frame segment is full
+  static constexpr uint32_t kInvalidOffset = 0xFFFFFFFF;
+
+  // Only construct on an OpenGL ES 3.1 or later context
+  IndirectRingBufferGLES();
+  ~IndirectRingBufferGLES();
+
+  // true if all records of a Draw are submitted with a single draw call
+  bool GetMultiDrawSupported() const { return multi_draw_elements_indirect_ != nullptr; }
+
+  void BeginFrame(const uint64_t frame_number);
+
+  // Copy records into the active frame segment, returns the offset of the copy,
+  // or kInvalidOffset if the segment is full. Leaves the buffer bound to
+  // GL_DRAW_INDIRECT_BUFFER.
+  uint32_t Write(const Renderer::DrawIndexedRecord* records, const uint32_t record_count);
+
+  // Draw the records copied at offset with 16-bit indices, returns the
+  // number of draw calls made
+  uint32_t Draw(const GLenum mode, const uint32_t offset, const uint32_t record_count);
+
+ private:
+  GLuint buffer_;
+  uint32_t segment_start_;
+  uint32_t write_offset_;
+  bool overflow_reported_;
+  // Staging copy of the records with the reserved fields cleared
+  std::vector<Renderer::DrawIndexedRecord> staging_records_;
+  PFNGLDRAWELEMENTSINDIRECTPROC draw_elements_indirect_;
+  PFNGLMULTIDRAWELEMENTSINDIRECTEXTPROC multi_draw_elements_indirect_;
+};
+
+} // namespace simple_renderer
+
+#endif // SIMPLERENDERER_INDIRECT_RING_BUFFER_GLES_H_
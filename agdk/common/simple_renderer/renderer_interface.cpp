@@ -15,8 +15,12 @@
  */
 
 #include "renderer_interface.h"
+#include "renderer_null.h"
+// Host builds (see tests) define SIMPLERENDERER_NULL_ONLY to build without a graphics API
+#if !defined(SIMPLERENDERER_NULL_ONLY)
 #include "renderer_gles.h"
 #include "renderer_vk.h"
+#endif
 
 namespace simple_renderer {
 
@@ -36,11 +40,16 @@ void Renderer::SetSwapchainHandle(
 
 Renderer &Renderer::GetInstance() {
   if (!instance_) {
+#if !defined(SIMPLERENDERER_NULL_ONLY)
     if (renderer_api_ == Renderer::kAPI_GLES) {
       instance_ = std::unique_ptr<Renderer>(new RendererGLES());
     } else if (renderer_api_ == Renderer::kAPI_Vulkan) {
       instance_ = std::unique_ptr<Renderer>(new RendererVk());
     }
+#endif
+    if (renderer_api_ == Renderer::kAPI_Null) {
+      instance_ = std::unique_ptr<Renderer>(new RendererNull());
+    }
   }
   return *instance_;
 }
@@ -50,6 +59,22 @@ void Renderer::ShutdownInstance() {
   Renderer::instance_.reset();
 }
 
+void Renderer::AddMultiDrawStats(const DrawIndexedRecord* records, const uint32_t record_count,
+                                 const bool triangle_list, const uint32_t draw_calls) {
+  uint64_t instance_count = 0;
+  uint64_t triangle_count = 0;
+  for (uint32_t i = 0; i < record_count; ++i) {
+    instance_count += records[i].instance_count;
+    triangle_count += static_cast<uint64_t>(records[i].index_count / 3) *
+        records[i].instance_count;
+  }
+  stats_.Add(RendererStats::kStat_DrawCalls, draw_calls);
+  stats_.Add(RendererStats::kStat_Instances, instance_count);
+  if (triangle_list) {
+    stats_.Add(RendererStats::kStat_Triangles, triangle_count);
+  }
+}
+
 Renderer::Renderer() {
 
 }
@@ -18,9 +18,11 @@
 #define SIMPLERENDERER_INTERFACE_H_
 
 #include "renderer_index_buffer.h"
+#include "renderer_recording_context.h"
 #include "renderer_render_pass.h"
 #include "renderer_render_state.h"
 #include "renderer_shader_program.h"
+#include "renderer_stats.h"
 #include "renderer_texture.h"
 #include "renderer_uniform_buffer.h"
 #include "renderer_vertex_buffer.h"
@@ -43,7 +45,8 @@ class Renderer {
   */
   enum RendererAPI : int32_t {
     kAPI_GLES = 0, ///< Use the OpenGL ES 3.0 API
-    kAPI_Vulkan ///< Use the Vulkan 1.0 API
+    kAPI_Vulkan, ///< Use the Vulkan 1.0 API
+    kAPI_Null ///< Make no graphics API calls, only record and count commands
   };
 
   /**
@@ -51,7 +54,32 @@ class Renderer {
    * if the device supports a particular feature
    */
   enum RendererFeature : int32_t {
-    kFeature_ASTC = 0 ///< Does the device support ASTC textures
+    kFeature_ASTC = 0, ///< Does the device support ASTC textures
+    kFeature_GPUTimestamps, ///< Does the device support GPU timing of ::BeginGPUScope scopes
+    kFeature_DrawIndirect, ///< Does ::DrawIndexedMulti read its records from an indirect buffer
+    kFeature_MultiDrawIndirect ///< Does ::DrawIndexedMulti submit all records in one draw call
+  };
+
+  /**
+   * @brief A single draw of ::DrawIndexedMulti. The layout matches
+   * `VkDrawIndexedIndirectCommand` and the OpenGL ES `DrawElementsIndirectCommand`,
+   * so records can be copied directly into the indirect buffer of the renderer.
+   */
+  struct DrawIndexedRecord {
+    /** @brief Number of indices to draw from the bound index buffer */
+    uint32_t index_count;
+    /** @brief Number of instances to draw, 1 for a non-instanced draw */
+    uint32_t instance_count;
+    /** @brief Index offset into the bound index buffer to begin drawing from */
+    uint32_t first_index;
+    /** @brief Value added to each index before reading from the bound vertex buffer */
+    int32_t base_vertex;
+    /**
+     * @brief Offset added to the instance index, used by shaders to locate the per-draw
+     * data of the record. OpenGL ES 3.x has no base instance, the value is ignored
+     * by the GLES renderer and the instance index always starts at 0.
+     */
+    uint32_t first_instance;
   };
 
 /**
@@ -107,6 +135,13 @@ class Renderer {
  */
   virtual bool GetFeatureAvailable(const RendererFeature feature) = 0;
 
+/**
+ * @brief Retrieve the per-frame statistics of the work submitted through the renderer.
+ * Statistics are recorded by every renderer API.
+ * @return Reference to the `RendererStats` of the renderer.
+ */
+  RendererStats& GetStats() { return stats_; }
+
 /**
  * @brief Tell the renderer to set up to begin rendering a frame of draw calls.
  */
@@ -122,6 +157,19 @@ class Renderer {
  */
   virtual void SwapchainRecreated() = 0;
 
+/**
+ * @brief Make the graphics API context of the renderer current on the calling thread, so
+ * rendering and resource calls can be made from it. On GLES the context can only be current
+ * on one thread at a time, call ::ReleaseThreadContext on the thread that last used the
+ * renderer before moving to another thread. Has no effect on other renderer APIs.
+ */
+  virtual void AcquireThreadContext() = 0;
+/**
+ * @brief Release the graphics API context of the renderer from the calling thread, see
+ * ::AcquireThreadContext.
+ */
+  virtual void ReleaseThreadContext() = 0;
+
 /**
  * @brief Draw a sequence of vertices using bound resources and the current render state.
  * @param vertex_count Number of vertices to draw from the bound vertex buffer.
@@ -134,36 +182,135 @@ class Renderer {
  * @param first_index Index offset into the bound index buffer to begin drawing from.
  */
   virtual void DrawIndexed(const uint32_t index_count, const uint32_t first_index) = 0;
+/**
+ * @brief Draw a sequence of indexed vertices, adding a base vertex to each index value before
+ * fetching from the bound vertex buffer. Allows meshes suballocated from shared buffers, such
+ * as a `GeometryArena`, to keep indices relative to their first vertex.
+ * @param index_count Number of indices to draw from the bound index buffer.
+ * @param first_index Index offset into the bound index buffer to begin drawing from.
+ * @param base_vertex Value added to each index before reading from the bound vertex buffer.
+ */
+  virtual void DrawIndexed(const uint32_t index_count, const uint32_t first_index,
+                           const uint32_t base_vertex) = 0;
+/**
+ * @brief Draw an array of indexed draw records using bound resources and the current render
+ * state. Records are written to an indirect buffer owned by the renderer and submitted with
+ * as few draw calls as the device allows, see `kFeature_DrawIndirect` and
+ * `kFeature_MultiDrawIndirect`. Devices without indirect draw support fall back to a loop
+ * of ::DrawIndexed calls. Every record uses the uniform data of the current render state.
+ * @param records Pointer to an array of `DrawIndexedRecord` structures.
+ * @param record_count Number of records in the array.
+ */
+  virtual void DrawIndexedMulti(const DrawIndexedRecord* records,
+                                const uint32_t record_count) = 0;
+/**
+ * @brief Draw vertices and 16-bit indices supplied for this draw only, using the current
+ * render state. The data is copied into a geometry ring buffer owned by the renderer, with
+ * one segment per in-flight frame, so geometry that changes every frame (such as dynamic
+ * text) is drawn with a single draw call without creating buffers. The ring replaces the
+ * bound vertex and index buffers, bind them again before the next ::Draw or ::DrawIndexed.
+ * Nothing is drawn if the segment of the frame is full.
+ * @param vertex_format The vertex format of `vertex_data`, must match the render state.
+ * @param vertex_data Vertex data in `vertex_format`.
+ * @param vertex_count Number of vertices in `vertex_data`.
+ * @param index_data 16-bit index values relative to the first vertex of `vertex_data`.
+ * @param index_count Number of indices in `index_data`.
+ */
+  virtual void DrawIndexedDynamic(const VertexBuffer::VertexFormat vertex_format,
+                                  const void* vertex_data, const uint32_t vertex_count,
+                                  const uint16_t* index_data, const uint32_t index_count) = 0;
 
 /**
  * @brief Set a render pass as the current one for rendering. Binds the drawable resources
  * associated with the render pass.
  * @param render_pass A shared pointer to a renderer `RenderPass`.
  */
-  virtual void SetRenderPass(std::shared_ptr<RenderPass> render_pass) = 0;
+  virtual void SetRenderPass(const std::shared_ptr<RenderPass>& render_pass) = 0;
 /**
  * @brief Set the current render state to use for rendering. Binds resources associated with
  * the render state. Note that the `RenderPass` object associated with the `RenderState` being
  * used must have previously been set as current using the ::SetRenderPass function.
  * @param render_state A shared pointer to a renderer `RenderState`.
  */
-  virtual void SetRenderState(std::shared_ptr<RenderState> render_state) = 0;
+  virtual void SetRenderState(const std::shared_ptr<RenderState>& render_state) = 0;
 
 /**
  * @brief Bind an index buffer for use in draw calls.
  * @param index_buffer A shared pointer to a renderer `IndexBuffer`.
  */
-  virtual void BindIndexBuffer(std::shared_ptr<IndexBuffer> index_buffer) = 0;
+  virtual void BindIndexBuffer(const std::shared_ptr<IndexBuffer>& index_buffer) = 0;
 /**
  * @brief Bind a vertex buffer for use in draw calls.
  * @param vertex_buffer A shared pointer to a renderer `VertexBuffer`.
  */
-  virtual void BindVertexBuffer(std::shared_ptr<VertexBuffer> vertex_buffer) = 0;
+  virtual void BindVertexBuffer(const std::shared_ptr<VertexBuffer>& vertex_buffer) = 0;
 /**
  * @brief Bind a texture for use in draw calls.
  * @param texture A shared pointer to a renderer `Texture`.
  */
-  virtual void BindTexture(std::shared_ptr<Texture> texture) = 0;
+  virtual void BindTexture(const std::shared_ptr<Texture>& texture) = 0;
+
+/**
+ * @brief Set a render pass as the current one for rendering, see ::SetRenderPass.
+ * @param render_pass The handle of a renderer `RenderPass`, from RenderPass::GetHandle.
+ */
+  virtual void SetRenderPass(const RenderPassHandle render_pass) = 0;
+/**
+ * @brief Set the current render state to use for rendering, see ::SetRenderState.
+ * @param render_state The handle of a renderer `RenderState`, from RenderState::GetHandle.
+ */
+  virtual void SetRenderState(const RenderStateHandle render_state) = 0;
+
+/**
+ * @brief Bind an index buffer for use in draw calls. Binding by handle avoids
+ * the shared pointer reference counting of the other bind functions. Debug builds
+ * assert if the handle is stale.
+ * @param index_buffer The handle of a renderer `IndexBuffer`, from IndexBuffer::GetHandle.
+ */
+  virtual void BindIndexBuffer(const IndexBufferHandle index_buffer) = 0;
+/**
+ * @brief Bind a vertex buffer for use in draw calls, see ::BindIndexBuffer.
+ * @param vertex_buffer The handle of a renderer `VertexBuffer`, from VertexBuffer::GetHandle.
+ */
+  virtual void BindVertexBuffer(const VertexBufferHandle vertex_buffer) = 0;
+/**
+ * @brief Bind a texture for use in draw calls, see ::BindIndexBuffer.
+ * @param texture The handle of a renderer `Texture`, from Texture::GetHandle.
+ */
+  virtual void BindTexture(const TextureHandle texture) = 0;
+
+/**
+ * @brief Execute the draws recorded by a list of `RecordingContext` objects inside the
+ * specified render pass. Contexts are executed in array order, so the final draw order
+ * is deterministic regardless of which thread recorded each context. The render pass
+ * becomes the current render pass, but only recorded draws may be issued into it: call
+ * ::SetRenderPass with a different pass (or ::EndFrame) before issuing further draws
+ * through the `Renderer` interface. The pass must not be the current pass set by
+ * ::SetRenderPass, recorded draws can't follow draws issued directly in the same pass.
+ * Must be called from the thread calling ::BeginFrame.
+ * @param render_pass A shared pointer to the renderer `RenderPass` the contexts recorded
+ * against.
+ * @param contexts An array of shared pointers to renderer `RecordingContext` objects
+ * that have finished recording.
+ * @param context_count The number of contexts in the `contexts` array.
+ */
+  virtual void ExecuteRecordingContexts(std::shared_ptr<RenderPass> render_pass,
+                                        const std::shared_ptr<RecordingContext>* contexts,
+                                        const uint32_t context_count) = 0;
+
+/**
+ * @brief Begin a named GPU timing scope. Scopes nest, and must be ended with ::EndGPUScope
+ * in reverse order of beginning, before ::EndFrame. Every frame is enclosed in a `frame`
+ * scope, and every render pass in a `render pass` scope. Results are reported through
+ * RendererStats::GetGPUScopeTimings once available, a few frames later. Has no effect if
+ * ::GetFeatureAvailable reports `kFeature_GPUTimestamps` as unsupported.
+ * @param name Name of the scope, must remain valid for several frames (use a string literal).
+ */
+  virtual void BeginGPUScope(const char* name) = 0;
+/**
+ * @brief End the most recently begun GPU timing scope.
+ */
+  virtual void EndGPUScope() = 0;
 
 /**
  * @brief Create a renderer `IndexBuffer`.
@@ -181,6 +328,21 @@ class Renderer {
  */
   virtual void DestroyIndexBuffer(std::shared_ptr<IndexBuffer> index_buffer) = 0;
 
+/**
+ * @brief Create a renderer `RecordingContext`. Create one context for each thread
+ * that will record draw calls.
+ * @return A shared pointer to a renderer `RecordingContext`.
+ */
+  virtual std::shared_ptr<RecordingContext> CreateRecordingContext() = 0;
+/**
+ * @brief Destroy a renderer `RecordingContext`.
+ * @param recording_context A shared pointer to a renderer `RecordingContext`. Do not retain
+ * any other instances of the shared pointer after calling the destroy function. The resources
+ * is not immediately deleted, but put in a delete queue. Deletion will happen at the
+ * next ::BeginFrame or ::ShutdownInstance.
+ */
+  virtual void DestroyRecordingContext(std::shared_ptr<RecordingContext> recording_context) = 0;
+
 /**
  * @brief Create a renderer `RenderPass`.
  * @param params A reference to a `RenderPassCreationParams` struct with creation parameters.
@@ -236,6 +398,14 @@ class Renderer {
  */
   virtual std::shared_ptr<Texture> CreateTexture(
       const Texture::TextureCreationParams& params) = 0;
+/**
+ * @brief Create a renderer `Texture` to use as a color or depth render target of a
+ * `RenderPass`. Destroy it with ::DestroyTexture.
+ * @param params A reference to a `RenderTargetCreationParams` struct with creation parameters.
+ * @return A shared pointer to a renderer `Texture`.
+ */
+  virtual std::shared_ptr<Texture> CreateRenderTarget(
+      const Texture::RenderTargetCreationParams& params) = 0;
 /**
  * @brief Destroy a renderer `Texture`.
  * @param texture A shared pointer to a renderer `Texture`. Do not retain any other
@@ -284,6 +454,13 @@ class Renderer {
 
   static Renderer* GetInstancePtr() { return instance_.get(); }
 
+  // Add the draw call, instance and triangle counts of records submitted
+  // with draw_calls API draw calls to the frame statistics
+  void AddMultiDrawStats(const DrawIndexedRecord* records, const uint32_t record_count,
+                         const bool triangle_list, const uint32_t draw_calls);
+
+  RendererStats stats_;
+
  private:
   static RendererAPI renderer_api_;
   static base_game_framework::DisplayManager::SwapchainHandle swapchain_handle_;
@@ -0,0 +1,365 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "renderer_null.h"
+#include "renderer_debug.h"
+#include "renderer_index_buffer_null.h"
+#include "renderer_recording_context_null.h"
+#include "renderer_render_pass_null.h"
+#include "renderer_render_state_null.h"
+#include "renderer_shader_program_null.h"
+#include "renderer_texture_null.h"
+#include "renderer_uniform_buffer_null.h"
+#include "renderer_vertex_buffer_null.h"
+
+namespace simple_renderer {
+
+static constexpr RendererNull::Counters kZeroCounters = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+RendererNull& RendererNull::GetInstanceNull() {
+  return *(static_cast<RendererNull*>(Renderer::GetInstancePtr()));
+}
+
+RendererNull::RendererNull() :
+    resources_(stats_),
+    commands_(),
+    counters_(kZeroCounters),
+    frame_counters_(kZeroCounters),
+    frame_number_(0),
+    command_stream_enabled_(true) {
+}
+
+RendererNull::~RendererNull() {
+}
+
+void RendererNull::PrepareShutdown() {
+  render_pass_ = nullptr;
+  render_state_ = nullptr;
+  resources_.ProcessDeleteQueue();
+  commands_.clear();
+}
+
+bool RendererNull::GetFeatureAvailable(const RendererFeature feature) {
+  bool supported = false;
+  switch (feature) {
+    case Renderer::kFeature_ASTC:
+      // Texel data is never decoded, any format is accepted
+      supported = true;
+      break;
+    case Renderer::kFeature_DrawIndirect:
+    case Renderer::kFeature_MultiDrawIndirect:
+      // Records are only counted, as a single draw call
+      supported = true;
+      break;
+    default:
+      break;
+  }
+  return supported;
+}
+
+void RendererNull::BeginFrame(
+    const base_game_framework::DisplayManager::SwapchainHandle /*swapchain_handle*/) {
+  RendererStats::ScopedTimer begin_frame_timer(stats_, RendererStats::kStat_BeginFrameTime);
+  stats_.BeginFrame(frame_number_ + 1);
+  resources_.ProcessDeleteQueue();
+  ++frame_number_;
+  // Keep the allocation, the stream is usually about the same size every frame
+  commands_.clear();
+  counters_ = kZeroCounters;
+}
+
+void RendererNull::EndFrame() {
+  RendererStats::ScopedTimer end_frame_timer(stats_, RendererStats::kStat_EndFrameTime);
+  if (render_pass_ != nullptr) {
+    render_pass_->EndRenderPass();
+  }
+  render_pass_ = nullptr;
+  render_state_ = nullptr;
+  frame_counters_ = counters_;
+}
+
+void RendererNull::SwapchainRecreated() {
+}
+
+void RendererNull::AcquireThreadContext() {
+}
+
+void RendererNull::ReleaseThreadContext() {
+}
+
+void RendererNull::AddCommand(const CommandType type, const void* resource,
+                              const uint32_t count, const uint32_t first,
+                              const uint32_t base_vertex) {
+  if (command_stream_enabled_) {
+    commands_.push_back({type, resource, count, first, base_vertex});
+  }
+}
+
+void RendererNull::CountDraw(const uint32_t count) {
+  RENDERER_ASSERT(render_state_ != nullptr)
+  RenderStateNull& state = *(static_cast<RenderStateNull*>(render_state_.get()));
+  ++counters_.draw_calls;
+  stats_.AddDraw(state.GetPrimitiveType() == RenderState::kTriangleList, count);
+  if (state.GetPrimitiveType() == RenderState::kTriangleList) {
+    counters_.triangles += count / 3;
+  } else {
+    counters_.lines += count / 2;
+  }
+
+  CountUniformData(state);
+}
+
+void RendererNull::CountUniformData(RenderStateNull& state) {
+  // Count the uniform data a backend would have had to deliver for this draw
+  UniformBufferNull& buffer = state.GetUniformBuffer();
+  if (buffer.GetBufferDirty()) {
+    counters_.uniform_bytes += buffer.GetBufferSizeInBytes();
+    stats_.Add(RendererStats::kStat_UniformBytes, buffer.GetBufferSizeInBytes());
+    buffer.SetBufferDirty(false);
+  }
+}
+
+void RendererNull::Draw(const uint32_t vertex_count, const uint32_t first_vertex) {
+  CountDraw(vertex_count);
+  AddCommand(kCommand_Draw, render_state_.get(), vertex_count, first_vertex, 0);
+}
+
+void RendererNull::DrawIndexed(const uint32_t index_count, const uint32_t first_index) {
+  DrawIndexed(index_count, first_index, 0);
+}
+
+void RendererNull::DrawIndexed(const uint32_t index_count, const uint32_t first_index,
+                               const uint32_t base_vertex) {
+  CountDraw(index_count);
+  AddCommand(kCommand_DrawIndexed, render_state_.get(), index_count, first_index, base_vertex);
+}
+
+void RendererNull::DrawIndexedMulti(const DrawIndexedRecord* records,
+                                    const uint32_t record_count) {
+  RENDERER_ASSERT(render_state_ != nullptr)
+  if (record_count == 0) {
+    return;
+  }
+  // Counted as the single draw call of a device with multi-draw indirect support,
+  // the records are expanded into DrawIndexed commands in the stream
+  RenderStateNull& state = *(static_cast<RenderStateNull*>(render_state_.get()));
+  const bool triangle_list = (state.GetPrimitiveType() == RenderState::kTriangleList);
+  ++counters_.draw_calls;
+  AddMultiDrawStats(records, record_count, triangle_list, 1);
+  for (uint32_t i = 0; i < record_count; ++i) {
+    const DrawIndexedRecord& record = records[i];
+    const uint64_t count = static_cast<uint64_t>(record.index_count) * record.instance_count;
+    if (triangle_list) {
+      counters_.triangles += count / 3;
+    } else {
+      counters_.lines += count / 2;
+    }
+    AddCommand(kCommand_DrawIndexed, render_state_.get(), record.index_count, record.first_index,
+               static_cast<uint32_t>(record.base_vertex));
+  }
+  CountUniformData(state);
+}
+
+void RendererNull::DrawIndexedDynamic(const VertexBuffer::VertexFormat vertex_format,
+                                      const void* /*vertex_data*/, const uint32_t vertex_count,
+                                      const uint16_t* /*index_data*/,
+                                      const uint32_t index_count) {
+  if (index_count == 0) {
+    return;
+  }
+  stats_.Add(RendererStats::kStat_BufferBytesUploaded,
+             vertex_count * VertexBuffer::GetVertexFormatStride(vertex_format) +
+             index_count * sizeof(uint16_t));
+  CountDraw(index_count);
+  // The geometry ring isn't a resource, it replaces the bound buffers with null ones
+  // in the stream so a later draw without new binds is visible
+  AddCommand(kCommand_BindVertexBuffer, nullptr, 0, 0, 0);
+  AddCommand(kCommand_BindIndexBuffer, nullptr, 0, 0, 0);
+  AddCommand(kCommand_DrawIndexed, render_state_.get(), index_count, 0, 0);
+}
+
+void RendererNull::SetRenderPass(const std::shared_ptr<RenderPass>& render_pass) {
+  if (render_pass_ != nullptr) {
+    render_pass_->EndRenderPass();
+  }
+  render_pass_ = render_pass;
+  render_state_ = nullptr;
+  if (render_pass != nullptr) {
+    render_pass->BeginRenderPass();
+  }
+  ++counters_.render_pass_changes;
+  AddCommand(kCommand_SetRenderPass, render_pass.get(), 0, 0, 0);
+}
+
+void RendererNull::SetRenderState(const std::shared_ptr<RenderState>& render_state) {
+  if (render_state_.get() == render_state.get()) {
+    return;
+  }
+  render_state_ = render_state;
+  ++counters_.render_state_binds;
+  stats_.Add(RendererStats::kStat_PipelineBinds, 1);
+  AddCommand(kCommand_SetRenderState, render_state.get(), 0, 0, 0);
+}
+
+void RendererNull::BindIndexBuffer(const std::shared_ptr<IndexBuffer>& index_buffer) {
+  ++counters_.index_buffer_binds;
+  AddCommand(kCommand_BindIndexBuffer, index_buffer.get(), 0, 0, 0);
+}
+
+void RendererNull::BindVertexBuffer(const std::shared_ptr<VertexBuffer>& vertex_buffer) {
+  ++counters_.vertex_buffer_binds;
+  AddCommand(kCommand_BindVertexBuffer, vertex_buffer.get(), 0, 0, 0);
+}
+
+void RendererNull::BindTexture(const std::shared_ptr<Texture>& texture) {
+  ++counters_.texture_binds;
+  AddCommand(kCommand_BindTexture, texture.get(), 0, 0, 0);
+}
+
+void RendererNull::SetRenderPass(const RenderPassHandle render_pass) {
+  if (!resources_.Validate(render_pass)) {
+    return;
+  }
+  SetRenderPass(resources_.GetRenderPass(render_pass));
+}
+
+void RendererNull::SetRenderState(const RenderStateHandle render_state) {
+  if (!resources_.Validate(render_state)) {
+    return;
+  }
+  SetRenderState(resources_.GetRenderState(render_state));
+}
+
+void RendererNull::BindIndexBuffer(const IndexBufferHandle index_buffer) {
+  if (!resources_.Validate(index_buffer)) {
+    return;
+  }
+  BindIndexBuffer(resources_.GetIndexBuffer(index_buffer));
+}
+
+void RendererNull::BindVertexBuffer(const VertexBufferHandle vertex_buffer) {
+  if (!resources_.Validate(vertex_buffer)) {
+    return;
+  }
+  BindVertexBuffer(resources_.GetVertexBuffer(vertex_buffer));
+}
+
+void RendererNull::BindTexture(const TextureHandle texture) {
+  if (!resources_.Validate(texture)) {
+    return;
+  }
+  BindTexture(resources_.GetTexture(texture));
+}
+
+void RendererNull::ExecuteRecordingContexts(std::shared_ptr<RenderPass> render_pass,
+                                            const std::shared_ptr<RecordingContext>* contexts,
+                                            const uint32_t context_count) {
+  if (render_pass.get() != render_pass_.get()) {
+    SetRenderPass(render_pass);
+  }
+  for (uint32_t i = 0; i < context_count; ++i) {
+    RecordingContextNull& context = *(static_cast<RecordingContextNull*>(contexts[i].get()));
+    context.Execute(*this, render_pass.get());
+  }
+}
+
+void RendererNull::BeginGPUScope(const char* /*name*/) {
+  // No GPU work to time, kFeature_GPUTimestamps is unsupported
+}
+
+void RendererNull::EndGPUScope() {
+}
+
+std::shared_ptr<IndexBuffer> RendererNull::CreateIndexBuffer(
+    const IndexBuffer::IndexBufferCreationParams& params) {
+  stats_.Add(RendererStats::kStat_BufferBytesUploaded, params.data_byte_size);
+  return resources_.AddIndexBuffer(new IndexBufferNull(params));
+}
+
+void RendererNull::DestroyIndexBuffer(std::shared_ptr<IndexBuffer> index_buffer) {
+  resources_.QueueDeleteIndexBuffer(index_buffer);
+}
+
+std::shared_ptr<RecordingContext> RendererNull::CreateRecordingContext() {
+  return resources_.AddRecordingContext(new RecordingContextNull());
+}
+
+void RendererNull::DestroyRecordingContext(std::shared_ptr<RecordingContext> recording_context) {
+  resources_.QueueDeleteRecordingContext(recording_context);
+}
+
+std::shared_ptr<RenderPass> RendererNull::CreateRenderPass(
+    const RenderPass::RenderPassCreationParams& params) {
+  return resources_.AddRenderPass(new RenderPassNull(params));
+}
+
+void RendererNull::DestroyRenderPass(std::shared_ptr<RenderPass> render_pass) {
+  resources_.QueueDeleteRenderPass(render_pass);
+}
+
+std::shared_ptr<RenderState> RendererNull::CreateRenderState(
+    const RenderState::RenderStateCreationParams& params) {
+  return resources_.AddRenderState(new RenderStateNull(params));
+}
+
+void RendererNull::DestroyRenderState(std::shared_ptr<RenderState> render_state) {
+  resources_.QueueDeleteRenderState(render_state);
+}
+
+std::shared_ptr<ShaderProgram> RendererNull::CreateShaderProgram(
+    const ShaderProgram::ShaderProgramCreationParams& params) {
+  return resources_.AddShaderProgram(new ShaderProgramNull(params));
+}
+
+void RendererNull::DestroyShaderProgram(std::shared_ptr<ShaderProgram> shader_program) {
+  resources_.QueueDeleteShaderProgram(shader_program);
+}
+
+std::shared_ptr<Texture> RendererNull::CreateTexture(const Texture::TextureCreationParams& params) {
+  stats_.AddTextureUpload(params);
+  return resources_.AddTexture(new TextureNull(params));
+}
+
+std::shared_ptr<Texture> RendererNull::CreateRenderTarget(
+    const Texture::RenderTargetCreationParams& params) {
+  return resources_.AddTexture(new TextureNull(params));
+}
+
+void RendererNull::DestroyTexture(std::shared_ptr<Texture> texture) {
+  resources_.QueueDeleteTexture(texture);
+}
+
+std::shared_ptr<UniformBuffer> RendererNull::CreateUniformBuffer(
+    const UniformBuffer::UniformBufferCreationParams& params) {
+  return resources_.AddUniformBuffer(new UniformBufferNull(params));
+}
+
+void RendererNull::DestroyUniformBuffer(std::shared_ptr<UniformBuffer> uniform_buffer) {
+  resources_.QueueDeleteUniformBuffer(uniform_buffer);
+}
+
+std::shared_ptr<VertexBuffer> RendererNull::CreateVertexBuffer(
+    const VertexBuffer::VertexBufferCreationParams& params) {
+  stats_.Add(RendererStats::kStat_BufferBytesUploaded, params.data_byte_size);
+  return resources_.AddVertexBuffer(new VertexBufferNull(params));
+}
+
+void RendererNull::DestroyVertexBuffer(std::shared_ptr<VertexBuffer> vertex_buffer) {
+  resources_.QueueDeleteVertexBuffer(vertex_buffer);
+}
+
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SIMPLERENDERER_NULL_H_
+#define SIMPLERENDERER_NULL_H_
+
+#include "renderer_interface.h"
+#include "renderer_resources.h"
+#include <vector>
+
+namespace simple_renderer {
+
+class RenderStateNull;
+
+/**
+ * @brief A subclass implementation of the base Renderer class that makes no
+ * graphics API calls. Resources are CPU side objects, and draws are recorded
+ * into a command stream and counted. Used to measure the CPU cost of the
+ * rendering code and to run it without a GPU. This class should not be used directly.
+ */
+class RendererNull : public Renderer {
+ public:
+  enum CommandType : uint32_t {
+    kCommand_SetRenderPass = 0,
+    kCommand_SetRenderState,
+    kCommand_BindIndexBuffer,
+    kCommand_BindVertexBuffer,
+    kCommand_BindTexture,
+    kCommand_Draw,
+    kCommand_DrawIndexed
+  };
+
+  struct Command {
+    CommandType type;
+    // Resource set or bound by the command, the render state for draws
+    const void* resource;
+    // Vertex or index count, first vertex or index and base vertex for draws
+    uint32_t count;
+    uint32_t first;
+    uint32_t base_vertex;
+  };
+
+  struct Counters {
+    uint64_t draw_calls;
+    uint64_t render_pass_changes;
+    uint64_t render_state_binds;
+    uint64_t index_buffer_binds;
+    uint64_t vertex_buffer_binds;
+    uint64_t texture_binds;
+    // Bytes of uniform buffer data that changed between draws
+    uint64_t uniform_bytes;
+    uint64_t triangles;
+    uint64_t lines;
+  };
+
+  RendererNull();
+  virtual ~RendererNull();
+
+  static RendererNull& GetInstanceNull();
+
+  // Counters for the last completed frame, and for the frame in progress
+  const Counters& GetFrameCounters() const { return frame_counters_; }
+  const Counters& GetCurrentCounters() const { return counters_; }
+
+  // Commands recorded since BeginFrame, still available after EndFrame until
+  // the next BeginFrame
+  const std::vector<Command>& GetCommandStream() const { return commands_; }
+  // Disabling the command stream leaves only the counters
+  void SetCommandStreamEnabled(const bool enabled) { command_stream_enabled_ = enabled; }
+
+  uint64_t GetFrameNumber() const { return frame_number_; }
+
+  virtual bool GetFeatureAvailable(const RendererFeature feature);
+
+  virtual void BeginFrame(
+      const base_game_framework::DisplayManager::SwapchainHandle swapchain_handle);
+  virtual void EndFrame();
+
+  virtual void SwapchainRecreated();
+
+  virtual void AcquireThreadContext();
+  virtual void ReleaseThreadContext();
+
+  virtual void Draw(const uint32_t vertex_count, const uint32_t first_vertex);
+  virtual void DrawIndexed(const uint32_t index_count, const uint32_t first_index);
+  virtual void DrawIndexed(const uint32_t index_count, const uint32_t first_index,
+                           const uint32_t base_vertex);
+  virtual void DrawIndexedMulti(const DrawIndexedRecord* records, const uint32_t record_count);
+  virtual void DrawIndexedDynamic(const VertexBuffer::VertexFormat vertex_format,
+                                  const void* vertex_data, const uint32_t vertex_count,
+                                  const uint16_t* index_data, const uint32_t index_count);
+
+  virtual void SetRenderPass(const std::shared_ptr<RenderPass>& render_pass);
+  virtual void SetRenderState(const std::shared_ptr<RenderState>& render_state);
+
+  // Resource binds
+  virtual void BindIndexBuffer(const std::shared_ptr<IndexBuffer>& index_buffer);
+  virtual void BindVertexBuffer(const std::shared_ptr<VertexBuffer>& vertex_buffer);
+  virtual void BindTexture(const std::shared_ptr<Texture>& texture);
+
+  virtual void SetRenderPass(const RenderPassHandle render_pass);
+  virtual void SetRenderState(const RenderStateHandle render_state);
+  virtual void BindIndexBuffer(const IndexBufferHandle index_buffer);
+  virtual void BindVertexBuffer(const VertexBufferHandle vertex_buffer);
+  virtual void BindTexture(const TextureHandle texture);
+
+  virtual void ExecuteRecordingContexts(std::shared_ptr<RenderPass> render_pass,
+                                        const std::shared_ptr<RecordingContext>* contexts,
+                                        const uint32_t context_count);
+
+  virtual void BeginGPUScope(const char* name);
+  virtual void EndGPUScope();
+
+  // Resource creation and destruction
+  virtual std::shared_ptr<IndexBuffer> CreateIndexBuffer(
+      const IndexBuffer::IndexBufferCreationParams& params);
+  virtual void DestroyIndexBuffer(std::shared_ptr<IndexBuffer> index_buffer);
+
+  virtual std::shared_ptr<RecordingContext> CreateRecordingContext();
+  virtual void DestroyRecordingContext(std::shared_ptr<RecordingContext> recording_context);
+
+  virtual std::shared_ptr<RenderPass> CreateRenderPass(
+      const RenderPass::RenderPassCreationParams& params);
+  virtual void DestroyRenderPass(std::shared_ptr<RenderPass> render_pass);
+
+  virtual std::shared_ptr<RenderState> CreateRenderState(
+      const RenderState::RenderStateCreationParams& params);
+  virtual void DestroyRenderState(std::shared_ptr<RenderState> render_state);
+
+  virtual std::shared_ptr<ShaderProgram> CreateShaderProgram(
+      const ShaderProgram::ShaderProgramCreationParams& params);
+  virtual void DestroyShaderProgram(std::shared_ptr<ShaderProgram> shader_program);
+
+  virtual std::shared_ptr<Texture> CreateTexture(
+      const Texture::TextureCreationParams& params);
+  virtual std::shared_ptr<Texture> CreateRenderTarget(
+      const Texture::RenderTargetCreationParams& params);
+  virtual void DestroyTexture(std::shared_ptr<Texture> texture);
+
+  virtual std::shared_ptr<UniformBuffer> CreateUniformBuffer(
+      const UniformBuffer::UniformBufferCreationParams& params);
+  virtual void DestroyUniformBuffer(std::shared_ptr<UniformBuffer> uniform_buffer);
+
+  virtual std::shared_ptr<VertexBuffer> CreateVertexBuffer(
+      const VertexBuffer::VertexBufferCreationParams& params);
+  virtual void DestroyVertexBuffer(std::shared_ptr<VertexBuffer> vertex_buffer);
+
+ protected:
+  virtual void PrepareShutdown();
+
+ private:
+  void AddCommand(const CommandType type, const void* resource,
+                  const uint32_t count, const uint32_t first, const uint32_t base_vertex);
+  void CountDraw(const uint32_t count);
+  void CountUniformData(RenderStateNull& state);
+
+  RendererResources resources_;
+
+  std::shared_ptr<RenderPass> render_pass_;
+  std::shared_ptr<RenderState> render_state_;
+
+  std::vector<Command> commands_;
+  Counters counters_;
+  Counters frame_counters_;
+  uint64_t frame_number_;
+  bool command_stream_enabled_;
+};
+
+} // namespace simple_renderer
+
+#endif // SIMPLERENDERER_NULL_H_
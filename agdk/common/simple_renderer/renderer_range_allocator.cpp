@@ -0,0 +1,104 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "renderer_range_allocator.h"
+#include "renderer_debug.h"
+
+namespace simple_renderer {
+
+RangeAllocator::RangeAllocator(const uint32_t capacity) :
+    free_ranges_(),
+    capacity_(capacity),
+    used_(0) {
+  if (capacity > 0) {
+    free_ranges_.push_back({0, capacity});
+  }
+}
+
+bool RangeAllocator::Allocate(const uint32_t count, uint32_t& offset) {
+  if (count == 0) {
+    offset = 0;
+    return true;
+  }
+  for (auto iter = free_ranges_.begin(); iter != free_ranges_.end(); ++iter) {
+    if (iter->count >= count) {
+      offset = iter->offset;
+      iter->offset += count;
+      iter->count -= count;
+      if (iter->count == 0) {
+        free_ranges_.erase(iter);
+      }
+      used_ += count;
+      return true;
+    }
+  }
+  return false;
+}
+
+void RangeAllocator::Free(const uint32_t offset, const uint32_t count) {
+  if (count == 0) {
+    return;
+  }
+  RENDERER_ASSERT(offset + count <= capacity_ && count <= used_)
+  used_ -= count;
+
+  // Insert in offset order, then merge with the neighbouring free ranges
+  auto iter = free_ranges_.begin();
+  while (iter != free_ranges_.end() && iter->offset < offset) {
+    ++iter;
+  }
+  iter = free_ranges_.insert(iter, {offset, count});
+  auto next = iter + 1;
+  if (next != free_ranges_.end() && iter->offset + iter->count == next->offset) {
+    iter->count += next->count;
+    free_ranges_.erase(next);
+  }
+  if (iter != free_ranges_.begin()) {
+    auto previous = iter - 1;
+    if (previous->offset + previous->count == iter->offset) {
+      previous->count += iter->count;
+      free_ranges_.erase(iter);
+    }
+  }
+}
+
+uint32_t RangeAllocator::GetHighWaterMark() const {
+  if (!free_ranges_.empty()) {
+    const Range& last = free_ranges_.back();
+    if (last.offset + last.count == capacity_) {
+      return last.offset;
+    }
+  }
+  return capacity_;
+}
+
+uint32_t RangeAllocator::GetLargestFreeBlock() const {
+  uint32_t largest = 0;
+  for (const Range& range : free_ranges_) {
+    largest = (range.count > largest) ? range.count : largest;
+  }
+  return largest;
+}
+
+float RangeAllocator::GetFragmentation() const {
+  const uint32_t free_count = capacity_ - used_;
+  if (free_count == 0) {
+    return 0.0f;
+  }
+  return 1.0f - (static_cast<float>(GetLargestFreeBlock()) / static_cast<float>(free_count));
+}
+
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SIMPLERENDERER_RANGE_ALLOCATOR_H_
+#define SIMPLERENDERER_RANGE_ALLOCATOR_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace simple_renderer {
+
+/**
+ * @brief A `RangeAllocator` is a first fit allocator over a range of elements, such as the
+ * vertices or indices of a `GeometryArena`. Free ranges are kept sorted by offset and merged
+ * with their neighbours when freed. It only tracks offsets and does not own any memory.
+ */
+class RangeAllocator {
+ public:
+  /**
+   * @brief Create an allocator with all of its elements free.
+   * @param capacity Number of elements in the range.
+   */
+  explicit RangeAllocator(const uint32_t capacity);
+
+  /**
+   * @brief Allocate a contiguous block from the lowest free range large enough to hold it.
+   * @param count Number of elements to allocate, a count of 0 always succeeds at offset 0.
+   * @param offset Receives the offset of the first allocated element.
+   * @return true if the block was allocated, false if no free range is large enough.
+   */
+  bool Allocate(const uint32_t count, uint32_t& offset);
+
+  /**
+   * @brief Return a block previously returned by ::Allocate to the free ranges.
+   * @param offset Offset of the block.
+   * @param count Number of elements in the block.
+   */
+  void Free(const uint32_t offset, const uint32_t count);
+
+  uint32_t GetCapacity() const { return capacity_; }
+  uint32_t GetUsed() const { return used_; }
+  /** @brief One past the highest allocated element */
+  uint32_t GetHighWaterMark() const;
+  uint32_t GetFreeBlockCount() const { return static_cast<uint32_t>(free_ranges_.size()); }
+  uint32_t GetLargestFreeBlock() const;
+  /**
+   * @brief 1 minus the ratio of the largest free block to the total free space, 0 means all
+   * free space is contiguous.
+   */
+  float GetFragmentation() const;
+
+ private:
+  struct Range {
+    uint32_t offset;
+    uint32_t count;
+  };
+
+  std::vector<Range> free_ranges_;
+  uint32_t capacity_;
+  uint32_t used_;
+};
+
+}
+
+#endif // SIMPLERENDERER_RANGE_ALLOCATOR_H_
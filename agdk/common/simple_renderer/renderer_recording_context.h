@@ -0,0 +1,126 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SIMPLERENDERER_RECORDING_CONTEXT_H_
+#define SIMPLERENDERER_RECORDING_CONTEXT_H_
+
+#include "renderer_handle.h"
+#include "renderer_index_buffer.h"
+#include "renderer_render_pass.h"
+#include "renderer_render_state.h"
+#include "renderer_texture.h"
+#include "renderer_vertex_buffer.h"
+
+#include <cstdint>
+#include <memory>
+
+namespace simple_renderer {
+
+/**
+ * @brief The base class definition for the `RecordingContext` class of SimpleRenderer.
+ * A `RecordingContext` records draw calls for a render pass independently of the
+ * `Renderer` command stream, which allows recording to happen on a worker thread.
+ * Use the `Renderer` class interface to create and destroy `RecordingContext` objects,
+ * and Renderer::ExecuteRecordingContexts to submit the recorded draws. A single
+ * `RecordingContext` must only be used by one thread at a time; create one
+ * per worker thread.
+ */
+class RecordingContext {
+ public:
+  /**
+   * @brief Base class destructor, do not call directly.
+   */
+  virtual ~RecordingContext() {}
+
+  /**
+   * @brief Retrieve the handle identifying the `RecordingContext` in the resource pool of
+   * the `Renderer`. The handle becomes stale once the `RecordingContext` is destroyed.
+   * @return A `RecordingContextHandle`.
+   */
+  RecordingContextHandle GetHandle() const { return handle_; }
+
+  /**
+   * @brief Begin recording draw calls that will be executed inside the specified
+   * render pass during the current frame. Must be called after Renderer::BeginFrame
+   * and before the context is passed to Renderer::ExecuteRecordingContexts.
+   * @param render_pass A shared pointer to the renderer `RenderPass` the recorded
+   * draws will be executed in.
+   */
+  virtual void BeginRecording(std::shared_ptr<RenderPass> render_pass) = 0;
+  /**
+   * @brief Finish recording draw calls. Must be called before the context is
+   * passed to Renderer::ExecuteRecordingContexts.
+   */
+  virtual void EndRecording() = 0;
+
+  /**
+   * @brief Record a draw of a sequence of vertices using the bound resources and
+   * the current render state of this context.
+   * @param vertex_count Number of vertices to draw from the bound vertex buffer.
+   * @param first_vertex Vertex offset into the bound vertex buffer to begin drawing from.
+   */
+  virtual void Draw(const uint32_t vertex_count, const uint32_t first_vertex) = 0;
+  /**
+   * @brief Record a draw of a sequence of indexed vertices using the bound resources
+   * and the current render state of this context.
+   * @param index_count Number of indices to draw from the bound index buffer.
+   * @param first_index Index offset into the bound index buffer to begin drawing from.
+   */
+  virtual void DrawIndexed(const uint32_t index_count, const uint32_t first_index) = 0;
+  /**
+   * @brief Record a draw of a sequence of indexed vertices, adding a base vertex to each
+   * index value, see Renderer::DrawIndexed.
+   * @param index_count Number of indices to draw from the bound index buffer.
+   * @param first_index Index offset into the bound index buffer to begin drawing from.
+   * @param base_vertex Value added to each index before reading from the bound vertex buffer.
+   */
+  virtual void DrawIndexed(const uint32_t index_count, const uint32_t first_index,
+                           const uint32_t base_vertex) = 0;
+
+  /**
+   * @brief Set the current render state of this context. The uniform buffer
+   * associated with the render state is read when a draw is recorded, it must not be
+   * modified by other threads while this context is recording.
+   * @param render_state A shared pointer to a renderer `RenderState`.
+   */
+  virtual void SetRenderState(const std::shared_ptr<RenderState>& render_state) = 0;
+
+  /**
+   * @brief Bind an index buffer for use in draw calls recorded by this context.
+   * @param index_buffer A shared pointer to a renderer `IndexBuffer`.
+   */
+  virtual void BindIndexBuffer(const std::shared_ptr<IndexBuffer>& index_buffer) = 0;
+  /**
+   * @brief Bind a vertex buffer for use in draw calls recorded by this context.
+   * @param vertex_buffer A shared pointer to a renderer `VertexBuffer`.
+   */
+  virtual void BindVertexBuffer(const std::shared_ptr<VertexBuffer>& vertex_buffer) = 0;
+  /**
+   * @brief Bind a texture for use in draw calls recorded by this context.
+   * @param texture A shared pointer to a renderer `Texture`.
+   */
+  virtual void BindTexture(const std::shared_ptr<Texture>& texture) = 0;
+
+ protected:
+  RecordingContext() {}
+
+ private:
+  template <typename T> friend class RendererResourcePool;
+  RecordingContextHandle handle_;
+};
+}
+
+#endif // SIMPLERENDERER_RECORDING_CONTEXT_H_
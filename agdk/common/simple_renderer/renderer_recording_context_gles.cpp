@@ -0,0 +1,192 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "renderer_recording_context_gles.h"
+#include "renderer_debug.h"
+#include "renderer_gles.h"
+#include "renderer_render_state_gles.h"
+#include "renderer_uniform_buffer_gles.h"
+
+namespace simple_renderer {
+
+RecordingContextGLES::RecordingContextGLES() :
+    command_lists_(),
+    commands_(),
+    uniform_data_(),
+    saved_uniform_data_(),
+    render_states_(),
+    index_buffers_(),
+    vertex_buffers_(),
+    textures_(),
+    render_pass_(nullptr),
+    first_command_(0),
+    render_state_(nullptr) {
+}
+
+RecordingContextGLES::~RecordingContextGLES() {
+  Reset();
+}
+
+void RecordingContextGLES::Reset() {
+  command_lists_.clear();
+  commands_.clear();
+  uniform_data_.clear();
+  render_states_.clear();
+  index_buffers_.clear();
+  vertex_buffers_.clear();
+  textures_.clear();
+}
+
+void RecordingContextGLES::BeginRecording(std::shared_ptr<RenderPass> render_pass) {
+  RENDERER_ASSERT(render_pass_ == nullptr)
+  RENDERER_ASSERT(render_pass.get() != nullptr)
+  render_pass_ = render_pass.get();
+  first_command_ = commands_.size();
+  render_state_ = nullptr;
+}
+
+void RecordingContextGLES::EndRecording() {
+  RENDERER_ASSERT(render_pass_ != nullptr)
+  command_lists_.push_back({render_pass_, first_command_, commands_.size() - first_command_});
+  render_pass_ = nullptr;
+  render_state_ = nullptr;
+}
+
+void RecordingContextGLES::AddDrawCommand(const CommandType type, const uint32_t count,
+                                          const uint32_t first, const uint32_t base_vertex) {
+  RENDERER_ASSERT(render_state_ != nullptr)
+  // Capture the uniform data as it is at the time of the draw, the buffer
+  // will likely be modified again before the context is executed
+  const RenderStateGLES& state = *(static_cast<RenderStateGLES*>(render_state_));
+  UniformData uniform_data;
+  memcpy(uniform_data.data, state.GetUniformBuffer().GetBufferData(), sizeof(uniform_data.data));
+  uniform_data_.push_back(uniform_data);
+  commands_.push_back({type, static_cast<uint32_t>(uniform_data_.size() - 1), count, first,
+                       base_vertex});
+}
+
+void RecordingContextGLES::Draw(const uint32_t vertex_count, const uint32_t first_vertex) {
+  AddDrawCommand(kCommand_Draw, vertex_count, first_vertex, 0);
+}
+
+void RecordingContextGLES::DrawIndexed(const uint32_t index_count, const uint32_t first_index) {
+  AddDrawCommand(kCommand_DrawIndexed, index_count, first_index, 0);
+}
+
+void RecordingContextGLES::DrawIndexed(const uint32_t index_count, const uint32_t first_index,
+                                       const uint32_t base_vertex) {
+  AddDrawCommand(kCommand_DrawIndexed, index_count, first_index, base_vertex);
+}
+
+void RecordingContextGLES::SetRenderState(const std::shared_ptr<RenderState>& render_state) {
+  if (render_state.get() == render_state_) {
+    return;
+  }
+  render_state_ = render_state.get();
+  render_states_.push_back(render_state);
+  commands_.push_back({kCommand_SetRenderState,
+                       static_cast<uint32_t>(render_states_.size() - 1), 0, 0, 0});
+}
+
+void RecordingContextGLES::BindIndexBuffer(const std::shared_ptr<IndexBuffer>& index_buffer) {
+  index_buffers_.push_back(index_buffer);
+  commands_.push_back({kCommand_BindIndexBuffer,
+                       static_cast<uint32_t>(index_buffers_.size() - 1), 0, 0, 0});
+}
+
+void RecordingContextGLES::BindVertexBuffer(const std::shared_ptr<VertexBuffer>& vertex_buffer) {
+  vertex_buffers_.push_back(vertex_buffer);
+  commands_.push_back({kCommand_BindVertexBuffer,
+                       static_cast<uint32_t>(vertex_buffers_.size() - 1), 0, 0, 0});
+}
+
+void RecordingContextGLES::BindTexture(const std::shared_ptr<Texture>& texture) {
+  textures_.push_back(texture);
+  commands_.push_back({kCommand_BindTexture,
+                       static_cast<uint32_t>(textures_.size() - 1), 0, 0, 0});
+}
+
+void RecordingContextGLES::ReplayUniformData(UniformBufferGLES& buffer,
+                                      const UniformData& uniform_data) {
+  bool saved = false;
+  for (const SavedUniformData& saved_data : saved_uniform_data_) {
+    saved |= (saved_data.buffer == &buffer);
+  }
+  if (!saved) {
+    SavedUniformData saved_data;
+    saved_data.buffer = &buffer;
+    memcpy(saved_data.data.data, buffer.GetBufferData(), sizeof(saved_data.data.data));
+    saved_uniform_data_.push_back(saved_data);
+  }
+  buffer.SetBufferData(uniform_data.data);
+}
+
+void RecordingContextGLES::Execute(RendererGLES& renderer, const RenderPass* render_pass) {
+  RENDERER_ASSERT(render_pass_ == nullptr)
+  bool pending_lists = false;
+  for (CommandList& command_list : command_lists_) {
+    if (command_list.render_pass != render_pass) {
+      pending_lists |= (command_list.render_pass != nullptr);
+      continue;
+    }
+
+    RenderStateGLES* state = nullptr;
+    const size_t end_command = command_list.first_command + command_list.command_count;
+    for (size_t i = command_list.first_command; i < end_command; ++i) {
+      const Command& command = commands_[i];
+      switch (command.type) {
+        case kCommand_SetRenderState:
+          renderer.SetRenderState(render_states_[command.resource_index]);
+          state = static_cast<RenderStateGLES*>(render_states_[command.resource_index].get());
+          break;
+        case kCommand_BindIndexBuffer:
+          renderer.BindIndexBuffer(index_buffers_[command.resource_index]);
+          break;
+        case kCommand_BindVertexBuffer:
+          renderer.BindVertexBuffer(vertex_buffers_[command.resource_index]);
+          break;
+        case kCommand_BindTexture:
+          renderer.BindTexture(textures_[command.resource_index]);
+          break;
+        case kCommand_Draw:
+          ReplayUniformData(state->GetUniformBuffer(), uniform_data_[command.resource_index]);
+          renderer.Draw(command.count, command.first);
+          break;
+        case kCommand_DrawIndexed:
+          ReplayUniformData(state->GetUniformBuffer(), uniform_data_[command.resource_index]);
+          renderer.DrawIndexed(command.count, command.first, command.base_vertex);
+          break;
+      }
+    }
+    // Mark as executed
+    command_list.render_pass = nullptr;
+  }
+
+  // The render states may still be used directly after this, restore the contents
+  // the game set. A buffer that differs from the last replayed draw is marked dirty
+  // and uploaded again by the next draw.
+  for (const SavedUniformData& saved_data : saved_uniform_data_) {
+    saved_data.buffer->SetBufferData(saved_data.data.data);
+  }
+  saved_uniform_data_.clear();
+
+  // Release the resource references once everything recorded has been executed
+  if (!pending_lists) {
+    Reset();
+  }
+}
+
+}
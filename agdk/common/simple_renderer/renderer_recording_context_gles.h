@@ -0,0 +1,116 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SIMPLERENDERER_RECORDING_CONTEXT_GLES_H_
+#define SIMPLERENDERER_RECORDING_CONTEXT_GLES_H_
+
+#include "renderer_recording_context.h"
+#include "renderer_uniform_buffer.h"
+#include <vector>
+
+namespace simple_renderer {
+
+class RendererGLES;
+class UniformBufferGLES;
+
+// GLES has no equivalent of secondary command buffers and the context is
+// bound to the render thread, so calls are recorded into a command list that
+// is replayed serially through RendererGLES when the context is executed.
+// Uniform buffer contents are captured at each draw, and the buffers are restored
+// after the replay, so the game sees the contents it last set.
+class RecordingContextGLES : public RecordingContext {
+ public:
+  RecordingContextGLES();
+  virtual ~RecordingContextGLES();
+
+  virtual void BeginRecording(std::shared_ptr<RenderPass> render_pass);
+  virtual void EndRecording();
+
+  virtual void Draw(const uint32_t vertex_count, const uint32_t first_vertex);
+  virtual void DrawIndexed(const uint32_t index_count, const uint32_t first_index);
+  virtual void DrawIndexed(const uint32_t index_count, const uint32_t first_index,
+                           const uint32_t base_vertex);
+
+  virtual void SetRenderState(const std::shared_ptr<RenderState>& render_state);
+
+  virtual void BindIndexBuffer(const std::shared_ptr<IndexBuffer>& index_buffer);
+  virtual void BindVertexBuffer(const std::shared_ptr<VertexBuffer>& vertex_buffer);
+  virtual void BindTexture(const std::shared_ptr<Texture>& texture);
+
+  // Replays the commands recorded against render_pass and releases them
+  void Execute(RendererGLES& renderer, const RenderPass* render_pass);
+
+ private:
+  enum CommandType : uint32_t {
+    kCommand_SetRenderState = 0,
+    kCommand_BindIndexBuffer,
+    kCommand_BindVertexBuffer,
+    kCommand_BindTexture,
+    kCommand_Draw,
+    kCommand_DrawIndexed
+  };
+
+  struct Command {
+    CommandType type;
+    // Index into the resource array matching the command type, or
+    // into uniform_data_ (in units of a full uniform buffer) for draws
+    uint32_t resource_index;
+    uint32_t count;
+    uint32_t first;
+    uint32_t base_vertex;
+  };
+
+  struct UniformData {
+    float data[UniformBuffer::kMaxUniformBufferFloatSize];
+  };
+
+  struct CommandList {
+    const RenderPass* render_pass;
+    size_t first_command;
+    size_t command_count;
+  };
+
+  // Uniform buffer contents before Execute replaced them
+  struct SavedUniformData {
+    UniformBufferGLES* buffer;
+    UniformData data;
+  };
+
+  void AddDrawCommand(const CommandType type, const uint32_t count, const uint32_t first,
+                      const uint32_t base_vertex);
+  // Set the captured contents of a draw, saving the buffer contents the first time
+  void ReplayUniformData(UniformBufferGLES& buffer, const UniformData& uniform_data);
+
+  void Reset();
+
+  std::vector<CommandList> command_lists_;
+  std::vector<Command> commands_;
+  std::vector<UniformData> uniform_data_;
+  std::vector<SavedUniformData> saved_uniform_data_;
+  std::vector<std::shared_ptr<RenderState> > render_states_;
+  std::vector<std::shared_ptr<IndexBuffer> > index_buffers_;
+  std::vector<std::shared_ptr<VertexBuffer> > vertex_buffers_;
+  std::vector<std::shared_ptr<Texture> > textures_;
+
+  // Active recording state
+  const RenderPass* render_pass_;
+  size_t first_command_;
+  RenderState* render_state_;
+};
+
+}
+
+#endif // SIMPLERENDERER_RECORDING_CONTEXT_GLES_H_
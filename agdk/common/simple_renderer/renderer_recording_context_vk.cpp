@@ -0,0 +1,264 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "renderer_recording_context_vk.h"
+#include "renderer_debug.h"
+#include "renderer_index_buffer_vk.h"
+#include "renderer_render_pass_vk.h"
+#include "renderer_render_state_vk.h"
+#include "renderer_texture_vk.h"
+#include "renderer_uniform_ring_buffer_vk.h"
+#include "renderer_vertex_buffer_vk.h"
+#include "renderer_vk.h"
+
+namespace simple_renderer {
+
+static constexpr uint64_t kNoFrameNumber = ~0ULL;
+
+RecordingContextVk::RecordingContextVk() :
+    frame_pools_(),
+    recorded_command_buffers_(),
+    recorded_frame_number_(kNoFrameNumber),
+    render_pass_(nullptr),
+    command_buffer_(VK_NULL_HANDLE),
+    bound_descriptor_set_(VK_NULL_HANDLE),
+    bound_image_view_(VK_NULL_HANDLE),
+    dirty_descriptor_set_(false),
+    bound_uniform_ring_offset_(UniformRingBufferVk::kInvalidOffset) {
+  RendererVk& renderer = RendererVk::GetInstanceVk();
+  frame_pools_.resize(renderer.GetInFlightFrameCount());
+
+  // Transient since the buffers are re-recorded every frame, the whole pool
+  // is reset at once when it is reused for a new frame
+  VkCommandPoolCreateInfo command_pool_info = {};
+  command_pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  command_pool_info.queueFamilyIndex = renderer.GetGraphicsQueueIndex();
+  command_pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+  for (FrameCommandPool& frame_pool : frame_pools_) {
+    frame_pool.command_pool = VK_NULL_HANDLE;
+    frame_pool.used_command_buffer_count = 0;
+    frame_pool.frame_number = kNoFrameNumber;
+    const VkResult result = vkCreateCommandPool(renderer.GetDevice(), &command_pool_info,
+                                                nullptr, &frame_pool.command_pool);
+    RENDERER_CHECK_VK(result, "vkCreateCommandPool (RecordingContextVk)");
+  }
+}
+
+RecordingContextVk::~RecordingContextVk() {
+  RENDERER_ASSERT(command_buffer_ == VK_NULL_HANDLE)
+  VkDevice device = RendererVk::GetInstanceVk().GetDevice();
+  for (FrameCommandPool& frame_pool : frame_pools_) {
+    if (!frame_pool.command_buffers.empty()) {
+      vkFreeCommandBuffers(device, frame_pool.command_pool, frame_pool.command_buffers.size(),
+                           frame_pool.command_buffers.data());
+      frame_pool.command_buffers.clear();
+    }
+    vkDestroyCommandPool(device, frame_pool.command_pool, nullptr);
+    frame_pool.command_pool = VK_NULL_HANDLE;
+  }
+  render_state_ = nullptr;
+}
+
+VkCommandBuffer RecordingContextVk::AcquireCommandBuffer() {
+  RendererVk& renderer = RendererVk::GetInstanceVk();
+  const uint64_t frame_number = renderer.GetFrameNumber();
+  RENDERER_ASSERT(renderer.GetFrameIndex() < frame_pools_.size())
+  FrameCommandPool& frame_pool = frame_pools_[renderer.GetFrameIndex()];
+
+  // First use of this pool since its frame slot was last submitted, the frame fence
+  // has already been waited on by BeginFrame so the buffers can be recycled
+  if (frame_pool.frame_number != frame_number) {
+    const VkResult reset_result = vkResetCommandPool(renderer.GetDevice(),
+                                                     frame_pool.command_pool, 0);
+    RENDERER_CHECK_VK(reset_result, "vkResetCommandPool (RecordingContextVk)");
+    frame_pool.used_command_buffer_count = 0;
+    frame_pool.frame_number = frame_number;
+  }
+
+  if (frame_pool.used_command_buffer_count == frame_pool.command_buffers.size()) {
+    VkCommandBufferAllocateInfo command_buffer_info = {};
+    command_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    command_buffer_info.commandPool = frame_pool.command_pool;
+    command_buffer_info.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+    command_buffer_info.commandBufferCount = 1;
+    VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+    const VkResult allocate_result = vkAllocateCommandBuffers(renderer.GetDevice(),
+                                                              &command_buffer_info,
+                                                              &command_buffer);
+    RENDERER_CHECK_VK(allocate_result, "vkAllocateCommandBuffers (RecordingContextVk)");
+    frame_pool.command_buffers.push_back(command_buffer);
+  }
+  return frame_pool.command_buffers[frame_pool.used_command_buffer_count++];
+}
+
+void RecordingContextVk::BeginRecording(std::shared_ptr<RenderPass> render_pass) {
+  RENDERER_ASSERT(command_buffer_ == VK_NULL_HANDLE)
+  RENDERER_ASSERT(render_pass.get() != nullptr)
+  RendererVk& renderer = RendererVk::GetInstanceVk();
+  const uint64_t frame_number = renderer.GetFrameNumber();
+  if (recorded_frame_number_ != frame_number) {
+    recorded_command_buffers_.clear();
+    recorded_frame_number_ = frame_number;
+  }
+
+  render_pass_ = render_pass.get();
+  command_buffer_ = AcquireCommandBuffer();
+
+  // The framebuffer is left null, it isn't known until the render pass is begun
+  // on the main thread and is optional in the inheritance info
+  const RenderPassVk& render_pass_vk = *(static_cast<RenderPassVk*>(render_pass.get()));
+  VkCommandBufferInheritanceInfo inheritance_info = {};
+  inheritance_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+  inheritance_info.renderPass = render_pass_vk.GetRenderPassVk();
+  inheritance_info.subpass = 0;
+  inheritance_info.framebuffer = VK_NULL_HANDLE;
+
+  VkCommandBufferBeginInfo command_buffer_begin_info = {};
+  command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  command_buffer_begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+      VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+  command_buffer_begin_info.pInheritanceInfo = &inheritance_info;
+  const VkResult begin_result = vkBeginCommandBuffer(command_buffer_, &command_buffer_begin_info);
+  RENDERER_CHECK_VK(begin_result, "vkBeginCommandBuffer (RecordingContextVk)");
+
+  // Dynamic state is not inherited from the primary command buffer
+  render_pass_vk.SetViewportAndScissor(command_buffer_);
+
+  render_state_ = nullptr;
+  bound_descriptor_set_ = VK_NULL_HANDLE;
+  bound_image_view_ = VK_NULL_HANDLE;
+  dirty_descriptor_set_ = false;
+  bound_uniform_ring_offset_ = UniformRingBufferVk::kInvalidOffset;
+}
+
+void RecordingContextVk::EndRecording() {
+  RENDERER_ASSERT(command_buffer_ != VK_NULL_HANDLE)
+  const VkResult end_result = vkEndCommandBuffer(command_buffer_);
+  RENDERER_CHECK_VK(end_result, "vkEndCommandBuffer (RecordingContextVk)");
+  recorded_command_buffers_.push_back({render_pass_, command_buffer_});
+
+  render_pass_ = nullptr;
+  command_buffer_ = VK_NULL_HANDLE;
+  render_state_ = nullptr;
+}
+
+const std::vector<RecordingContextVk::RecordedCommandBuffer>&
+    RecordingContextVk::GetRecordedCommandBuffers(const uint64_t frame_number) const {
+  static const std::vector<RecordedCommandBuffer> kNoCommandBuffers;
+  RENDERER_ASSERT(command_buffer_ == VK_NULL_HANDLE)
+  if (recorded_frame_number_ != frame_number) {
+    return kNoCommandBuffers;
+  }
+  return recorded_command_buffers_;
+}
+
+void RecordingContextVk::Draw(const uint32_t vertex_count, const uint32_t first_vertex) {
+  RenderStateVk& state = *(static_cast<RenderStateVk*>(render_state_.get()));
+  if (dirty_descriptor_set_) {
+    // Nothing to bind after BindTexture(nullptr), VK_NULL_HANDLE is not a valid set
+    if (bound_descriptor_set_ != VK_NULL_HANDLE) {
+      vkCmdBindDescriptorSets(command_buffer_, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                              state.GetPipelineLayout(), 0, 1, &bound_descriptor_set_,
+                              0, nullptr);
+    }
+    dirty_descriptor_set_ = false;
+  }
+
+  // The uniform buffer ring copy bookkeeping belongs to the render thread,
+  // always write a private copy of the data from here
+  state.UpdateUniformData(command_buffer_, true, false, bound_uniform_ring_offset_);
+
+  vkCmdDraw(command_buffer_, vertex_count, 1, first_vertex, 0);
+  RendererVk::GetInstanceVk().GetStats().AddDraw(
+      state.GetPrimitiveTopology() == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, vertex_count);
+}
+
+void RecordingContextVk::DrawIndexed(const uint32_t index_count, const uint32_t first_index) {
+  DrawIndexed(index_count, first_index, 0);
+}
+
+void RecordingContextVk::DrawIndexed(const uint32_t index_count, const uint32_t first_index,
+                                     const uint32_t base_vertex) {
+  RenderStateVk& state = *(static_cast<RenderStateVk*>(render_state_.get()));
+  if (dirty_descriptor_set_) {
+    // Nothing to bind after BindTexture(nullptr), VK_NULL_HANDLE is not a valid set
+    if (bound_descriptor_set_ != VK_NULL_HANDLE) {
+      vkCmdBindDescriptorSets(command_buffer_, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                              state.GetPipelineLayout(), 0, 1, &bound_descriptor_set_,
+                              0, nullptr);
+    }
+    dirty_descriptor_set_ = false;
+  }
+
+  // The uniform buffer ring copy bookkeeping belongs to the render thread,
+  // always write a private copy of the data from here
+  state.UpdateUniformData(command_buffer_, true, false, bound_uniform_ring_offset_);
+
+  vkCmdDrawIndexed(command_buffer_, index_count, 1, first_index,
+                   static_cast<int32_t>(base_vertex), 0);
+  RendererVk::GetInstanceVk().GetStats().AddDraw(
+      state.GetPrimitiveTopology() == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, index_count);
+}
+
+void RecordingContextVk::SetRenderState(const std::shared_ptr<RenderState>& render_state) {
+  if (render_state.get() != render_state_.get()) {
+    render_state_ = render_state;
+    RenderStateVk& state = *(static_cast<RenderStateVk*>(render_state_.get()));
+    vkCmdBindPipeline(command_buffer_, VK_PIPELINE_BIND_POINT_GRAPHICS, state.GetPipeline());
+    RendererVk::GetInstanceVk().GetStats().Add(RendererStats::kStat_PipelineBinds, 1);
+    bound_descriptor_set_ = VK_NULL_HANDLE;
+    bound_image_view_ = VK_NULL_HANDLE;
+    bound_uniform_ring_offset_ = UniformRingBufferVk::kInvalidOffset;
+  }
+}
+
+void RecordingContextVk::BindIndexBuffer(const std::shared_ptr<IndexBuffer>& index_buffer) {
+  IndexBufferVk& index_buffer_vk = *(static_cast<IndexBufferVk*>(index_buffer.get()));
+  vkCmdBindIndexBuffer(command_buffer_, index_buffer_vk.GetIndexBuffer(),
+                       0, VK_INDEX_TYPE_UINT16);
+}
+
+void RecordingContextVk::BindVertexBuffer(const std::shared_ptr<VertexBuffer>& vertex_buffer) {
+  VertexBufferVk& vertex_buffer_vk = *(static_cast<VertexBufferVk*>(vertex_buffer.get()));
+  VkBuffer vertex_buffers[] = {vertex_buffer_vk.GetVertexBuffer()};
+  VkDeviceSize vertex_offsets[] = {0};
+  vkCmdBindVertexBuffers(command_buffer_, 0, 1, vertex_buffers, vertex_offsets);
+}
+
+void RecordingContextVk::BindTexture(const std::shared_ptr<Texture>& texture) {
+  if (texture.get() == nullptr) {
+    bound_descriptor_set_ = VK_NULL_HANDLE;
+    bound_image_view_ = VK_NULL_HANDLE;
+    dirty_descriptor_set_ = true;
+    return;
+  }
+
+  TextureVk& texture_vk = *(static_cast<TextureVk*>(texture.get()));
+  const VkImageView texture_image_view = texture_vk.GetImageView();
+  if (texture_image_view == bound_image_view_) {
+    return;
+  }
+  bound_image_view_ = texture_image_view;
+
+  // Descriptor sets come from the shared per-frame pool of the renderer
+  RenderStateVk& state = *(static_cast<RenderStateVk*>(render_state_.get()));
+  bound_descriptor_set_ = RendererVk::GetInstanceVk().GetTextureDescriptorSet(
+      texture_vk, state.GetDescriptorSetLayout());
+  dirty_descriptor_set_ = true;
+}
+
+}
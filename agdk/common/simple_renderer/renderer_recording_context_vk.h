@@ -0,0 +1,83 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SIMPLERENDERER_RECORDING_CONTEXT_VK_H_
+#define SIMPLERENDERER_RECORDING_CONTEXT_VK_H_
+
+#include "renderer_recording_context.h"
+#include "renderer_vk_includes.h"
+#include <vector>
+
+namespace simple_renderer {
+
+// Records into secondary command buffers allocated from a command pool owned
+// by the context, one pool per in-flight frame. Pools are only touched by the
+// thread doing the recording, so no locking is required.
+class RecordingContextVk : public RecordingContext {
+ public:
+  struct RecordedCommandBuffer {
+    const RenderPass* render_pass;
+    VkCommandBuffer command_buffer;
+  };
+
+  RecordingContextVk();
+  virtual ~RecordingContextVk();
+
+  virtual void BeginRecording(std::shared_ptr<RenderPass> render_pass);
+  virtual void EndRecording();
+
+  virtual void Draw(const uint32_t vertex_count, const uint32_t first_vertex);
+  virtual void DrawIndexed(const uint32_t index_count, const uint32_t first_index);
+  virtual void DrawIndexed(const uint32_t index_count, const uint32_t first_index,
+                           const uint32_t base_vertex);
+
+  virtual void SetRenderState(const std::shared_ptr<RenderState>& render_state);
+
+  virtual void BindIndexBuffer(const std::shared_ptr<IndexBuffer>& index_buffer);
+  virtual void BindVertexBuffer(const std::shared_ptr<VertexBuffer>& vertex_buffer);
+  virtual void BindTexture(const std::shared_ptr<Texture>& texture);
+
+  // Secondary command buffers finished during the specified frame
+  const std::vector<RecordedCommandBuffer>& GetRecordedCommandBuffers(
+      const uint64_t frame_number) const;
+
+ private:
+  struct FrameCommandPool {
+    VkCommandPool command_pool;
+    std::vector<VkCommandBuffer> command_buffers;
+    uint32_t used_command_buffer_count;
+    uint64_t frame_number;
+  };
+
+  VkCommandBuffer AcquireCommandBuffer();
+
+  std::vector<FrameCommandPool> frame_pools_;
+  std::vector<RecordedCommandBuffer> recorded_command_buffers_;
+  uint64_t recorded_frame_number_;
+
+  // Active recording resources
+  const RenderPass* render_pass_;
+  VkCommandBuffer command_buffer_;
+  std::shared_ptr<RenderState> render_state_;
+  VkDescriptorSet bound_descriptor_set_;
+  VkImageView bound_image_view_;
+  bool dirty_descriptor_set_;
+  uint32_t bound_uniform_ring_offset_;
+};
+
+}
+
+#endif // SIMPLERENDERER_RECORDING_CONTEXT_VK_H_
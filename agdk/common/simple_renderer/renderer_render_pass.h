@@ -21,13 +21,16 @@
 #include <memory>
 #include <string>
 
+#include "renderer_handle.h"
+#include "renderer_texture.h"
+
 namespace simple_renderer {
 
 /**
  * @brief The base class definition for the `RenderPass` class of SimpleRenderer.
  * Use the `Renderer` class interface to create and destroy `RenderPass` objects.
- * The `RenderPass` class does not currently support configuring render targets,
- * it is assumed you are rendering to the default drawable attachments
+ * A `RenderPass` renders to the default drawable attachments unless render target
+ * `Texture` objects are specified in its creation parameters.
  */
 class RenderPass {
  public:
@@ -50,7 +53,9 @@ class RenderPass {
     /** @brief Don't care what happens when loading the color attachment */
     kRenderPassColorLoad_DontCare = 0,
     /** @brief Clear the color attachment when it is loaded */
-    kRenderPassColorLoad_Clear
+    kRenderPassColorLoad_Clear,
+    /** @brief Preserve the existing contents of the color attachment when it is loaded */
+    kRenderPassColorLoad_Load
   };
 
   /**
@@ -70,7 +75,9 @@ class RenderPass {
     /** @brief Don't care what happens when loading the depth buffer attachment */
     kRenderPassDepthLoad_DontCare = 0,
     /** @brief Clear the depth buffer attachment when it is loaded */
-    kRenderPassDepthLoad_Clear
+    kRenderPassDepthLoad_Clear,
+    /** @brief Preserve the existing contents of the depth buffer attachment when it is loaded */
+    kRenderPassDepthLoad_Load
   };
 
   /**
@@ -90,7 +97,9 @@ class RenderPass {
     /** @brief Don't care what happens when loading the stencil buffer attachment */
     kRenderPassStencilLoad_DontCare = 0,
     /** @brief Clear the depth buffer attachment when it is loaded */
-    kRenderPassStencilLoad_Clear
+    kRenderPassStencilLoad_Clear,
+    /** @brief Preserve the existing contents of the stencil buffer attachment when it is loaded */
+    kRenderPassStencilLoad_Load
   };
 
   /**
@@ -128,6 +137,18 @@ class RenderPass {
     float depth_clear;
     /** @brief The stencil value to use when clearing a stencil buffer attachment */
     int32_t stencil_clear;
+    /** @brief Optional render target `Texture` for the color attachment, if neither
+     * `color_target` or `depth_target` is set the pass renders to the default drawable
+     * attachments */
+    std::shared_ptr<Texture> color_target;
+    /** @brief Optional render target `Texture` for the depth/stencil attachment,
+     * must have the same dimensions and sample count as `color_target` */
+    std::shared_ptr<Texture> depth_target;
+    /** @brief Optional single sample render target `Texture` the multisampled
+     * `color_target` is resolved to at the end of the pass. If `color_target` is
+     * multisampled and no `resolve_target` is set, it is resolved to the default
+     * drawable color attachment */
+    std::shared_ptr<Texture> resolve_target;
   };
 
   /**
@@ -135,6 +156,14 @@ class RenderPass {
    */
   virtual ~RenderPass() {}
 
+  /**
+   * @brief Retrieve the handle of the `RenderPass`. The handle can be passed to the
+   * `Renderer` bind functions instead of the shared pointer, and becomes stale once
+   * the `RenderPass` is destroyed.
+   * @return A `RenderPassHandle`.
+   */
+  RenderPassHandle GetHandle() const { return handle_; }
+
   /**
    * @brief Begin render pass initialization function, do not call directly.
    */
@@ -144,6 +173,49 @@ class RenderPass {
    */
   virtual void EndRenderPass() = 0;
 
+  /**
+   * @brief Whether the `RenderPass` renders to the default drawable attachments.
+   * @return true if the `RenderPass` has no color or depth render target
+   */
+  bool IsDrawablePass() const {
+    return (pass_params_.color_target.get() == nullptr &&
+            pass_params_.depth_target.get() == nullptr);
+  }
+
+  /**
+   * @brief Whether the `RenderPass` resolves a multisampled color render target to the
+   * default drawable color attachment.
+   * @return true if the `RenderPass` resolves to the drawable
+   */
+  bool ResolvesToDrawable() const {
+    return (pass_params_.color_target.get() != nullptr &&
+            pass_params_.color_target->GetSampleCount() > 1 &&
+            pass_params_.resolve_target.get() == nullptr);
+  }
+
+  /**
+   * @brief Restrict rendering to the `width` x `height` pixels at the origin of the
+   * render target attachments, for example to render at a reduced resolution without
+   * recreating the targets. Drawable passes always cover the full drawable. GLES takes
+   * the viewport from the `RenderState`, set its viewport and scissor rect to match.
+   * @param width Width of the render area in pixels, 0 to use the full target width.
+   * @param height Height of the render area in pixels, 0 to use the full target height.
+   */
+  void SetRenderArea(const uint32_t width, const uint32_t height) {
+    render_area_width_ = width;
+    render_area_height_ = height;
+  }
+  /**
+   * @brief Retrieve the render area width set by SetRenderArea.
+   * @return The render area width in pixels, 0 if unrestricted.
+   */
+  uint32_t GetRenderAreaWidth() const { return render_area_width_; }
+  /**
+   * @brief Retrieve the render area height set by SetRenderArea.
+   * @return The render area height in pixels, 0 if unrestricted.
+   */
+  uint32_t GetRenderAreaHeight() const { return render_area_height_; }
+
   /**
    * @brief Retrieve the debug name string associated with the `RenderPass`
    * @result A string containing the debug name.
@@ -157,15 +229,19 @@ class RenderPass {
 
  protected:
 
-  RenderPass() {
+  RenderPass() : pass_params_(), render_area_width_(0), render_area_height_(0) {
     render_pass_debug_name_ = "noname";
-    memset(&pass_params_, 0, sizeof(RenderPassCreationParams));
   }
 
   RenderPassCreationParams pass_params_;
+  uint32_t render_area_width_;
+  uint32_t render_area_height_;
 
  private:
   std::string render_pass_debug_name_;
+
+  template <typename T> friend class RendererResourcePool;
+  RenderPassHandle handle_;
 };
 }
 
@@ -16,17 +16,124 @@
 
 #include "renderer_render_pass_gles.h"
 #include "renderer_debug.h"
+#include "renderer_texture_gles.h"
 
 namespace simple_renderer {
 
-RenderPassGLES::RenderPassGLES(const RenderPassCreationParams& params) : RenderPass() {
+static GLenum GetDepthAttachmentPoint(const Texture& depth_target) {
+  return (depth_target.GetTextureFormat() == Texture::kTextureFormat_Depth24_Stencil8) ?
+         GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+}
+
+static void CheckFramebufferComplete() {
+  const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+  if (status != GL_FRAMEBUFFER_COMPLETE) {
+    RENDERER_ERROR("Render pass framebuffer incomplete: 0x%x", status)
+  }
+}
+
+RenderPassGLES::RenderPassGLES(const RenderPassCreationParams& params)
+    : RenderPass(),
+      framebuffer_object_(0),
+      resolve_framebuffer_object_(0),
+      resolve_color_(false) {
   pass_params_ = params;
+  if (IsDrawablePass()) {
+    return;
+  }
+
+  glGenFramebuffers(1, &framebuffer_object_);
+  RENDERER_CHECK_GLES("glGenFramebuffers");
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_object_);
+  RENDERER_CHECK_GLES("glBindFramebuffer");
+  if (params.color_target.get() != nullptr) {
+    AttachRenderTarget(GL_COLOR_ATTACHMENT0, *params.color_target);
+  } else {
+    const GLenum no_draw_buffer = GL_NONE;
+    glDrawBuffers(1, &no_draw_buffer);
+    RENDERER_CHECK_GLES("glDrawBuffers");
+  }
+  if (params.depth_target.get() != nullptr) {
+    AttachRenderTarget(GetDepthAttachmentPoint(*params.depth_target), *params.depth_target);
+  }
+  CheckFramebufferComplete();
+
+  // Multisampled color is resolved with a blit when the pass ends
+  resolve_color_ = (params.color_target.get() != nullptr &&
+                    params.color_target->GetSampleCount() > 1);
+  if (resolve_color_ && params.resolve_target.get() != nullptr) {
+    glGenFramebuffers(1, &resolve_framebuffer_object_);
+    RENDERER_CHECK_GLES("glGenFramebuffers");
+    glBindFramebuffer(GL_FRAMEBUFFER, resolve_framebuffer_object_);
+    RENDERER_CHECK_GLES("glBindFramebuffer");
+    AttachRenderTarget(GL_COLOR_ATTACHMENT0, *params.resolve_target);
+    CheckFramebufferComplete();
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  RENDERER_CHECK_GLES("glBindFramebuffer");
 }
 
 RenderPassGLES::~RenderPassGLES() {
+  if (framebuffer_object_ != 0) {
+    glDeleteFramebuffers(1, &framebuffer_object_);
+    RENDERER_CHECK_GLES("glDeleteFramebuffers");
+    framebuffer_object_ = 0;
+  }
+  if (resolve_framebuffer_object_ != 0) {
+    glDeleteFramebuffers(1, &resolve_framebuffer_object_);
+    RENDERER_CHECK_GLES("glDeleteFramebuffers");
+    resolve_framebuffer_object_ = 0;
+  }
+}
+
+void RenderPassGLES::AttachRenderTarget(const GLenum attachment, const Texture& render_target) {
+  const TextureGLES& target_gles = static_cast<const TextureGLES&>(render_target);
+  RENDERER_ASSERT(target_gles.IsRenderTarget())
+  if (target_gles.GetRenderbufferObject() != 0) {
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER,
+                              target_gles.GetRenderbufferObject());
+    RENDERER_CHECK_GLES("glFramebufferRenderbuffer");
+  } else {
+    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D,
+                           target_gles.GetTextureObject(), 0);
+    RENDERER_CHECK_GLES("glFramebufferTexture2D");
+  }
+}
+
+void RenderPassGLES::InvalidateAttachments(const bool color, const bool depth,
+                                           const bool stencil) const {
+  // The default framebuffer uses different attachment names
+  const bool drawable = (framebuffer_object_ == 0);
+  GLenum attachments[3];
+  GLsizei attachment_count = 0;
+  if (color && (drawable || pass_params_.color_target.get() != nullptr)) {
+    attachments[attachment_count++] = drawable ? GL_COLOR : GL_COLOR_ATTACHMENT0;
+  }
+  if (drawable || pass_params_.depth_target.get() != nullptr) {
+    if (depth) {
+      attachments[attachment_count++] = drawable ? GL_DEPTH : GL_DEPTH_ATTACHMENT;
+    }
+    if (stencil && (drawable || pass_params_.depth_target->GetTextureFormat() ==
+        Texture::kTextureFormat_Depth24_Stencil8)) {
+      attachments[attachment_count++] = drawable ? GL_STENCIL : GL_STENCIL_ATTACHMENT;
+    }
+  }
+  if (attachment_count > 0) {
+    glInvalidateFramebuffer(GL_FRAMEBUFFER, attachment_count, attachments);
+    RENDERER_CHECK_GLES("glInvalidateFramebuffer");
+  }
 }
 
 void RenderPassGLES::BeginRenderPass() {
+  if (framebuffer_object_ != 0) {
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_object_);
+    RENDERER_CHECK_GLES("glBindFramebuffer");
+  }
+  // Contents that are neither loaded or cleared don't need to be read into tile memory
+  InvalidateAttachments(pass_params_.color_load == kRenderPassColorLoad_DontCare,
+                        pass_params_.depth_load == kRenderPassDepthLoad_DontCare,
+                        pass_params_.stencil_load == kRenderPassStencilLoad_DontCare);
+
   GLbitfield mask = 0;
   if (pass_params_.color_load == kRenderPassColorLoad_Clear) {
     mask = GL_COLOR_BUFFER_BIT;
@@ -50,7 +157,26 @@ void RenderPassGLES::BeginRenderPass() {
 }
 
 void RenderPassGLES::EndRenderPass() {
-
+  if (resolve_color_) {
+    const TextureGLES& color_target =
+        *(static_cast<const TextureGLES*>(pass_params_.color_target.get()));
+    const GLint width = static_cast<GLint>(color_target.GetTextureWidth());
+    const GLint height = static_cast<GLint>(color_target.GetTextureHeight());
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, resolve_framebuffer_object_);
+    RENDERER_CHECK_GLES("glBindFramebuffer");
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    RENDERER_CHECK_GLES("glBlitFramebuffer");
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_object_);
+    RENDERER_CHECK_GLES("glBindFramebuffer");
+  }
+  // Contents that are not stored don't need to be written back from tile memory
+  InvalidateAttachments(pass_params_.color_store == kRenderPassColorStore_DontCare,
+                        pass_params_.depth_store == kRenderPassDepthStore_DontCare,
+                        pass_params_.stencil_store == kRenderPassStencilStore_DontCare);
+  if (framebuffer_object_ != 0) {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    RENDERER_CHECK_GLES("glBindFramebuffer");
+  }
 }
 
 }
\ No newline at end of file
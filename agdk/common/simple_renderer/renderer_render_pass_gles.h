@@ -17,6 +17,7 @@
 #ifndef SIMPLERENDERER_RENDER_PASS_GLES_H_
 #define SIMPLERENDERER_RENDER_PASS_GLES_H_
 
+#include <GLES3/gl3.h>
 #include "renderer_render_pass.h"
 
 namespace simple_renderer {
@@ -28,7 +29,20 @@ class RenderPassGLES : public RenderPass {
 
   virtual void BeginRenderPass();
   virtual void EndRenderPass();
+
  private:
+  // Attaches a render target texture or renderbuffer to the bound framebuffer
+  static void AttachRenderTarget(const GLenum attachment, const Texture& render_target);
+
+  // Invalidates the attachments of the bound framebuffer whose contents are
+  // not needed, so tiled GPUs can skip loading or storing them
+  void InvalidateAttachments(const bool color, const bool depth, const bool stencil) const;
+
+  // Framebuffer the pass renders to, 0 for the default drawable framebuffer
+  GLuint framebuffer_object_;
+  // Framebuffer a multisampled color target is resolved to, 0 for the drawable
+  GLuint resolve_framebuffer_object_;
+  bool resolve_color_;
 };
 }
 
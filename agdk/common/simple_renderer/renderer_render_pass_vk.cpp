@@ -16,91 +16,209 @@
 
 #include "renderer_render_pass_vk.h"
 #include "renderer_debug.h"
+#include "renderer_texture_vk.h"
 #include "renderer_vk.h"
 
-#define ARRAY_COUNTOF(array) (sizeof(array) / sizeof(array[0]))
-
 namespace simple_renderer {
 
+static constexpr uint32_t kNoAttachment = 3;
+
+static VkAttachmentLoadOp GetVkLoadOp(const uint32_t load_operation) {
+  // The load enums of the color, depth and stencil attachments share values
+  switch (load_operation) {
+    case RenderPass::kRenderPassColorLoad_Clear:
+      return VK_ATTACHMENT_LOAD_OP_CLEAR;
+    case RenderPass::kRenderPassColorLoad_Load:
+      return VK_ATTACHMENT_LOAD_OP_LOAD;
+    default:
+      break;
+  }
+  return VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+}
+
+static VkAttachmentStoreOp GetVkStoreOp(const uint32_t store_operation) {
+  return (store_operation == RenderPass::kRenderPassColorStore_Write) ?
+         VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+}
+
 RenderPassVk::RenderPassVk(const RenderPassCreationParams& params)
     : RenderPass()
+    , render_pass_(VK_NULL_HANDLE)
+    , attachment_count_(0)
+    , color_attachment_(kNoAttachment)
+    , depth_attachment_(kNoAttachment)
+    , resolve_attachment_(kNoAttachment)
+    , sample_count_(VK_SAMPLE_COUNT_1_BIT)
+    , uses_swapchain_color_(false)
+    , uses_swapchain_depth_(false)
     , framebuffer_cache_() {
+  static_assert(kNoAttachment == kMaxAttachmentCount, "Attachment count mismatch");
   pass_params_ = params;
   RendererVk &renderer = RendererVk::GetInstanceVk();
 
-  VkAttachmentDescription attachment_array[2];
+  const bool drawable_pass = IsDrawablePass();
+  const TextureVk* color_target = static_cast<const TextureVk*>(params.color_target.get());
+  const TextureVk* depth_target = static_cast<const TextureVk*>(params.depth_target.get());
+  const TextureVk* resolve_target = static_cast<const TextureVk*>(params.resolve_target.get());
+  const bool has_depth = drawable_pass ?
+      ((params.attachment_flags &
+       (RenderPass::kRenderPassAttachment_Depth | RenderPass::kRenderPassAttachment_Stencil)) != 0 &&
+       renderer.GetSwapchainDepthStencilFormat() != VK_FORMAT_UNDEFINED) :
+      (depth_target != nullptr);
+  uses_swapchain_color_ = drawable_pass || ResolvesToDrawable();
+  uses_swapchain_depth_ = drawable_pass && has_depth;
+  if (color_target != nullptr) {
+    sample_count_ = color_target->GetSampleCountVk();
+  } else if (depth_target != nullptr) {
+    sample_count_ = depth_target->GetSampleCountVk();
+  }
+  RENDERER_ASSERT(depth_target == nullptr || depth_target->GetSampleCountVk() == sample_count_)
+  RENDERER_ASSERT(resolve_target == nullptr || sample_count_ != VK_SAMPLE_COUNT_1_BIT)
+
+  VkAttachmentDescription attachment_array[kMaxAttachmentCount];
   memset(attachment_array, 0, sizeof(attachment_array));
 
-  attachment_array[0].format = renderer.GetSwapchainColorFormat();
-  attachment_array[0].samples = VK_SAMPLE_COUNT_1_BIT;
-  attachment_array[0].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-  attachment_array[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-  attachment_array[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-  attachment_array[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-  attachment_array[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-  attachment_array[0].finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-  attachment_array[1].format = renderer.GetSwapchainDepthStencilFormat();
-  attachment_array[1].samples = VK_SAMPLE_COUNT_1_BIT;
-  attachment_array[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-  attachment_array[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-  attachment_array[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-  attachment_array[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-  attachment_array[1].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-  attachment_array[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+  if (drawable_pass || color_target != nullptr) {
+    color_attachment_ = attachment_count_++;
+    VkAttachmentDescription& color = attachment_array[color_attachment_];
+    color.samples = sample_count_;
+    color.loadOp = GetVkLoadOp(params.color_load);
+    color.storeOp = GetVkStoreOp(params.color_store);
+    color.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    color.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    if (color_target == nullptr) {
+      color.format = renderer.GetSwapchainColorFormat();
+      color.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    } else {
+      RENDERER_ASSERT(!color_target->IsDepthFormat())
+      color.format = color_target->GetFormatVk();
+      color.finalLayout = color_target->GetImageLayout();
+    }
+    color.initialLayout = (color.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD) ?
+                          color.finalLayout : VK_IMAGE_LAYOUT_UNDEFINED;
+  }
+
+  if (has_depth) {
+    depth_attachment_ = attachment_count_++;
+    VkAttachmentDescription& depth = attachment_array[depth_attachment_];
+    depth.samples = sample_count_;
+    depth.loadOp = GetVkLoadOp(params.depth_load);
+    depth.storeOp = GetVkStoreOp(params.depth_store);
+    depth.stencilLoadOp = GetVkLoadOp(params.stencil_load);
+    depth.stencilStoreOp = GetVkStoreOp(params.stencil_store);
+    if (depth_target == nullptr) {
+      depth.format = renderer.GetSwapchainDepthStencilFormat();
+      depth.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    } else {
+      RENDERER_ASSERT(depth_target->IsDepthFormat())
+      depth.format = depth_target->GetFormatVk();
+      depth.finalLayout = depth_target->GetImageLayout();
+    }
+    const bool loads_depth = (depth.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD ||
+                              depth.stencilLoadOp == VK_ATTACHMENT_LOAD_OP_LOAD);
+    depth.initialLayout = loads_depth ? depth.finalLayout : VK_IMAGE_LAYOUT_UNDEFINED;
+  }
+
+  // Multisampled color is resolved at the end of the subpass, which lets tiled
+  // GPUs write out only the resolved pixels
+  if (sample_count_ != VK_SAMPLE_COUNT_1_BIT && color_target != nullptr) {
+    resolve_attachment_ = attachment_count_++;
+    VkAttachmentDescription& resolve = attachment_array[resolve_attachment_];
+    resolve.samples = VK_SAMPLE_COUNT_1_BIT;
+    resolve.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    resolve.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    resolve.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    resolve.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    resolve.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (resolve_target == nullptr) {
+      resolve.format = renderer.GetSwapchainColorFormat();
+      resolve.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    } else {
+      RENDERER_ASSERT(resolve_target->GetSampleCountVk() == VK_SAMPLE_COUNT_1_BIT)
+      resolve.format = resolve_target->GetFormatVk();
+      resolve.finalLayout = resolve_target->GetImageLayout();
+    }
+  }
 
   VkAttachmentReference color_attachment_reference = {};
-  color_attachment_reference.attachment = 0;
+  color_attachment_reference.attachment = color_attachment_;
   color_attachment_reference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
   VkAttachmentReference depth_attachment_reference = {};
-  depth_attachment_reference.attachment = 1;
+  depth_attachment_reference.attachment = depth_attachment_;
   depth_attachment_reference.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
+  VkAttachmentReference resolve_attachment_reference = {};
+  resolve_attachment_reference.attachment = resolve_attachment_;
+  resolve_attachment_reference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
   VkSubpassDescription subpass_description = {};
   subpass_description.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-  subpass_description.colorAttachmentCount = 1;
-  subpass_description.pColorAttachments = &color_attachment_reference;
-  subpass_description.pDepthStencilAttachment = &depth_attachment_reference;
-
-  VkSubpassDependency subpass_dependency{};
-  subpass_dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-  subpass_dependency.dstSubpass = 0;
-  subpass_dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-  subpass_dependency.srcAccessMask = 0;
-  subpass_dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-  subpass_dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+  if (color_attachment_ != kNoAttachment) {
+    subpass_description.colorAttachmentCount = 1;
+    subpass_description.pColorAttachments = &color_attachment_reference;
+    if (resolve_attachment_ != kNoAttachment) {
+      subpass_description.pResolveAttachments = &resolve_attachment_reference;
+    }
+  }
+  if (depth_attachment_ != kNoAttachment) {
+    subpass_description.pDepthStencilAttachment = &depth_attachment_reference;
+  }
+
+  VkSubpassDependency subpass_dependencies[2] = {};
+  uint32_t dependency_count = 1;
+  subpass_dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+  subpass_dependencies[0].dstSubpass = 0;
+  subpass_dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  subpass_dependencies[0].srcAccessMask = 0;
+  subpass_dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+  subpass_dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+  if (!drawable_pass) {
+    // Render targets may have been written by an earlier pass, or sampled by
+    // one in the previous frame
+    subpass_dependencies[0].srcStageMask |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    subpass_dependencies[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    subpass_dependencies[0].dstAccessMask |= VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+
+    // Make the attachment writes visible to later passes sampling the targets
+    subpass_dependencies[1].srcSubpass = 0;
+    subpass_dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    subpass_dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    subpass_dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    subpass_dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    subpass_dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    dependency_count = 2;
+  }
 
   VkRenderPassCreateInfo render_pass_create_info =
       { VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO };
-  render_pass_create_info.attachmentCount = ARRAY_COUNTOF(attachment_array);
+  render_pass_create_info.attachmentCount = attachment_count_;
   render_pass_create_info.pAttachments = attachment_array;
   render_pass_create_info.subpassCount = 1;
   render_pass_create_info.pSubpasses = &subpass_description;
-  render_pass_create_info.dependencyCount = 1;
-  render_pass_create_info.pDependencies = &subpass_dependency;
+  render_pass_create_info.dependencyCount = dependency_count;
+  render_pass_create_info.pDependencies = subpass_dependencies;
   const VkResult create_result = vkCreateRenderPass(renderer.GetDevice(), &render_pass_create_info,
                                                     nullptr, &render_pass_);
   RENDERER_CHECK_VK(create_result, "vkCreateRenderPass");
 
-  for (uint32_t i = 0; i < kClearAttachmentCount; ++i) {
-    clear_values_[i].color.float32[0] = 0.0f;
-    clear_values_[i].color.float32[1] = 0.0f;
-    clear_values_[i].color.float32[2] = 0.0f;
-    clear_values_[i].color.float32[3] = 0.0f;
-    clear_values_[i].depthStencil.depth = 0.0f;
-    clear_values_[i].depthStencil.stencil = 0;
-  }
-  if ((params.attachment_flags & RenderPass::kRenderPassAttachment_Color) != 0) {
-    clear_values_[kClearAttachmentColor].color.float32[0] = params.color_clear[0];
-    clear_values_[kClearAttachmentColor].color.float32[1] = params.color_clear[1];
-    clear_values_[kClearAttachmentColor].color.float32[2] = params.color_clear[2];
-    clear_values_[kClearAttachmentColor].color.float32[3] = params.color_clear[3];
-  }
-  if ((params.attachment_flags &
-      (RenderPass::kRenderPassAttachment_Depth | RenderPass::kRenderPassAttachment_Stencil)) != 0) {
-    clear_values_[kClearAttachmentDepthStencil].depthStencil.depth = params.depth_clear;
-    clear_values_[kClearAttachmentDepthStencil].depthStencil.stencil = params.stencil_clear;
+  // Clear values are indexed by attachment, entries for attachments that
+  // aren't cleared are ignored
+  memset(clear_values_, 0, sizeof(clear_values_));
+  if (color_attachment_ != kNoAttachment) {
+    clear_values_[color_attachment_].color.float32[0] = params.color_clear[0];
+    clear_values_[color_attachment_].color.float32[1] = params.color_clear[1];
+    clear_values_[color_attachment_].color.float32[2] = params.color_clear[2];
+    clear_values_[color_attachment_].color.float32[3] = params.color_clear[3];
+  }
+  if (depth_attachment_ != kNoAttachment) {
+    clear_values_[depth_attachment_].depthStencil.depth = params.depth_clear;
+    clear_values_[depth_attachment_].depthStencil.stencil = params.stencil_clear;
   }
 }
 
@@ -114,70 +232,27 @@ RenderPassVk::~RenderPassVk() {
 }
 
 void RenderPassVk::BeginRenderPass() {
-  RendererVk &renderer = RendererVk::GetInstanceVk();
-  const base_game_framework::SwapchainFrameResourcesVk& swap_resources =
-      renderer.GetSwapchainResources();
-
-  // Create framebuffers on demand for a given swapchain image view and cache them
-  VkFramebuffer framebuffer = VK_NULL_HANDLE;
-  for (const FramebufferCache& cache : framebuffer_cache_) {
-    if (cache.swapchain_image_view == swap_resources.swapchain_color_image_view) {
-      framebuffer = cache.framebuffer;
-      break;
-    }
-  }
-
-  if (framebuffer == VK_NULL_HANDLE) {
-    VkImageView attachments[] = {swap_resources.swapchain_color_image_view,
-                                 swap_resources.swapchain_depth_stencil_image_view};
+  BeginRenderPass(VK_SUBPASS_CONTENTS_INLINE);
+}
 
-    VkFramebufferCreateInfo framebuffer_create_info{};
-    framebuffer_create_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-    framebuffer_create_info.renderPass = render_pass_;
-    framebuffer_create_info.attachmentCount =
-        (swap_resources.swapchain_depth_stencil_image_view != VK_NULL_HANDLE) ? 2 : 1;
-    framebuffer_create_info.pAttachments = attachments;
-    framebuffer_create_info.width = swap_resources.swapchain_extent.width;
-    framebuffer_create_info.height = swap_resources.swapchain_extent.height;
-    framebuffer_create_info.layers = 1;
+void RenderPassVk::BeginRenderPass(const VkSubpassContents contents) {
+  RendererVk &renderer = RendererVk::GetInstanceVk();
+  VkCommandBuffer command_buffer = renderer.GetRenderCommandBuffer();
 
-    VkResult create_result = vkCreateFramebuffer(renderer.GetDevice(), &framebuffer_create_info,
-                                                 nullptr, &framebuffer);
-    RENDERER_CHECK_VK(create_result, "vkCreateFramebuffer");
-
-    framebuffer_cache_.push_back({swap_resources.swapchain_color_image_view, framebuffer});
-  }
+  // Dynamic state set outside the pass carries into it for inline contents
+  SetViewportAndScissor(command_buffer);
 
   VkRenderPassBeginInfo render_pass_begin_info = {};
   render_pass_begin_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
   render_pass_begin_info.renderPass = render_pass_;
-  render_pass_begin_info.framebuffer = framebuffer;
+  render_pass_begin_info.framebuffer = GetFramebuffer();
   render_pass_begin_info.renderArea.offset.x = 0;
   render_pass_begin_info.renderArea.offset.y = 0;
-  render_pass_begin_info.renderArea.extent = swap_resources.swapchain_extent;
-
-  uint32_t clear_count = 0;
-  VkClearValue* clear_values = nullptr;
-
-  if ((pass_params_.attachment_flags & RenderPass::kRenderPassAttachment_Color) != 0) {
-    ++clear_count;
-    clear_values = clear_values_;
-    if ((pass_params_.attachment_flags &
-        (RenderPass::kRenderPassAttachment_Depth |
-         RenderPass::kRenderPassAttachment_Stencil)) != 0) {
-      ++clear_count;
-    }
-  } else if ((pass_params_.attachment_flags &
-      (RenderPass::kRenderPassAttachment_Depth | RenderPass::kRenderPassAttachment_Stencil)) != 0) {
-    // Only depth/stencil, no color
-    clear_count = 1;
-    clear_values = &clear_values_[kClearAttachmentDepthStencil];
-  }
-  render_pass_begin_info.clearValueCount = clear_count;
-  render_pass_begin_info.pClearValues = clear_values;
+  render_pass_begin_info.renderArea.extent = GetRenderExtent();
+  render_pass_begin_info.clearValueCount = attachment_count_;
+  render_pass_begin_info.pClearValues = clear_values_;
 
-  vkCmdBeginRenderPass(renderer.GetRenderCommandBuffer(),
-                       &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+  vkCmdBeginRenderPass(command_buffer, &render_pass_begin_info, contents);
 }
 
 void RenderPassVk::EndRenderPass() {
@@ -185,6 +260,93 @@ void RenderPassVk::EndRenderPass() {
   vkCmdEndRenderPass(renderer.GetRenderCommandBuffer());
 }
 
+VkExtent2D RenderPassVk::GetAttachmentExtent() const {
+  const Texture* target = (pass_params_.color_target.get() != nullptr) ?
+                          pass_params_.color_target.get() : pass_params_.depth_target.get();
+  if (target == nullptr) {
+    return RendererVk::GetInstanceVk().GetSwapchainResources().swapchain_extent;
+  }
+  VkExtent2D extent;
+  extent.width = target->GetTextureWidth();
+  extent.height = target->GetTextureHeight();
+  return extent;
+}
+
+VkExtent2D RenderPassVk::GetRenderExtent() const {
+  VkExtent2D extent = GetAttachmentExtent();
+  if (!IsDrawablePass()) {
+    if (render_area_width_ > 0 && render_area_width_ < extent.width) {
+      extent.width = render_area_width_;
+    }
+    if (render_area_height_ > 0 && render_area_height_ < extent.height) {
+      extent.height = render_area_height_;
+    }
+  }
+  return extent;
+}
+
+void RenderPassVk::SetViewportAndScissor(VkCommandBuffer command_buffer) const {
+  RendererVk::GetInstanceVk().SetViewportAndScissor(command_buffer, GetRenderExtent(),
+                                                    FlipsViewport());
+}
+
+VkFramebuffer RenderPassVk::GetFramebuffer() {
+  RendererVk &renderer = RendererVk::GetInstanceVk();
+  const base_game_framework::SwapchainFrameResourcesVk& swap_resources =
+      renderer.GetSwapchainResources();
+  const VkExtent2D extent = GetAttachmentExtent();
+
+  // Framebuffers are created on demand and cached by swapchain image view,
+  // passes that only use render targets have a single entry
+  const VkImageView swapchain_image_view = uses_swapchain_color_ ?
+      swap_resources.swapchain_color_image_view : VK_NULL_HANDLE;
+  for (const FramebufferCache& cache : framebuffer_cache_) {
+    if (cache.swapchain_image_view == swapchain_image_view) {
+      return cache.framebuffer;
+    }
+  }
+
+  if (ResolvesToDrawable()) {
+    RENDERER_ASSERT(extent.width == swap_resources.swapchain_extent.width &&
+                    extent.height == swap_resources.swapchain_extent.height)
+  }
+
+  VkImageView attachments[kMaxAttachmentCount] = {};
+  if (color_attachment_ != kNoAttachment) {
+    attachments[color_attachment_] = (pass_params_.color_target.get() != nullptr) ?
+        static_cast<const TextureVk*>(pass_params_.color_target.get())->GetImageView() :
+        swap_resources.swapchain_color_image_view;
+  }
+  if (depth_attachment_ != kNoAttachment) {
+    attachments[depth_attachment_] = uses_swapchain_depth_ ?
+        swap_resources.swapchain_depth_stencil_image_view :
+        static_cast<const TextureVk*>(pass_params_.depth_target.get())->GetImageView();
+    RENDERER_ASSERT(attachments[depth_attachment_] != VK_NULL_HANDLE)
+  }
+  if (resolve_attachment_ != kNoAttachment) {
+    attachments[resolve_attachment_] = (pass_params_.resolve_target.get() != nullptr) ?
+        static_cast<const TextureVk*>(pass_params_.resolve_target.get())->GetImageView() :
+        swap_resources.swapchain_color_image_view;
+  }
+
+  VkFramebufferCreateInfo framebuffer_create_info{};
+  framebuffer_create_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+  framebuffer_create_info.renderPass = render_pass_;
+  framebuffer_create_info.attachmentCount = attachment_count_;
+  framebuffer_create_info.pAttachments = attachments;
+  framebuffer_create_info.width = extent.width;
+  framebuffer_create_info.height = extent.height;
+  framebuffer_create_info.layers = 1;
+
+  VkFramebuffer framebuffer = VK_NULL_HANDLE;
+  VkResult create_result = vkCreateFramebuffer(renderer.GetDevice(), &framebuffer_create_info,
+                                               nullptr, &framebuffer);
+  RENDERER_CHECK_VK(create_result, "vkCreateFramebuffer");
+
+  framebuffer_cache_.push_back({swapchain_image_view, framebuffer});
+  return framebuffer;
+}
+
 void RenderPassVk::PurgeFramebufferCache() {
   RendererVk &renderer = RendererVk::GetInstanceVk();
   for (const FramebufferCache& cache : framebuffer_cache_) {
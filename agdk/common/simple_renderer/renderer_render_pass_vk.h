@@ -31,7 +31,28 @@ class RenderPassVk : public RenderPass {
   virtual void BeginRenderPass();
   virtual void EndRenderPass();
 
+  // Begin the pass with either inline or secondary command buffer contents
+  void BeginRenderPass(const VkSubpassContents contents);
+
   VkRenderPass GetRenderPassVk() const { return render_pass_; }
+  VkSampleCountFlagBits GetSampleCountVk() const { return sample_count_; }
+  bool HasColorAttachment() const { return color_attachment_ != kMaxAttachmentCount; }
+
+  // Passes that end up on the swapchain flip the viewport to match the GL
+  // coordinate system, offscreen passes don't so render targets are sampled
+  // with the same orientation as GLES. Pipelines for an unflipped pass swap
+  // their front face to compensate.
+  bool FlipsViewport() const { return uses_swapchain_color_; }
+
+  // Pixel dimensions of the attachments of the pass
+  VkExtent2D GetAttachmentExtent() const;
+
+  // Pixel dimensions of the area rendered by the pass, the attachment extent
+  // clamped to the render area if one is set
+  VkExtent2D GetRenderExtent() const;
+
+  // Sets the viewport and scissor to cover the attachments of the pass
+  void SetViewportAndScissor(VkCommandBuffer command_buffer) const;
 
   void PurgeFramebufferCache();
 
@@ -42,14 +63,20 @@ class RenderPassVk : public RenderPass {
     VkFramebuffer framebuffer;
   };
 
-  enum ClearAttachment {
-    kClearAttachmentColor = 0,
-    kClearAttachmentDepthStencil,
-    kClearAttachmentCount
-  };
+  static constexpr uint32_t kMaxAttachmentCount = 3;
+
+  VkFramebuffer GetFramebuffer();
 
   VkRenderPass render_pass_;
-  VkClearValue clear_values_[kClearAttachmentCount];
+  VkClearValue clear_values_[kMaxAttachmentCount];
+  uint32_t attachment_count_;
+  // Attachment indices, kMaxAttachmentCount if the pass has no such attachment
+  uint32_t color_attachment_;
+  uint32_t depth_attachment_;
+  uint32_t resolve_attachment_;
+  VkSampleCountFlagBits sample_count_;
+  bool uses_swapchain_color_;
+  bool uses_swapchain_depth_;
   std::vector<FramebufferCache> framebuffer_cache_;
 };
 }
@@ -21,6 +21,7 @@
 #include <memory>
 #include <string>
 
+#include "renderer_handle.h"
 #include "renderer_render_pass.h"
 #include "renderer_shader_program.h"
 #include "renderer_uniform_buffer.h"
@@ -221,6 +222,14 @@ class RenderState {
    */
   virtual ~RenderState() {}
 
+  /**
+   * @brief Retrieve the handle of the `RenderState`. The handle can be passed to the
+   * `Renderer` bind functions instead of the shared pointer, and becomes stale once
+   * the `RenderState` is destroyed.
+   * @return A `RenderStateHandle`.
+   */
+  RenderStateHandle GetHandle() const { return handle_; }
+
   /**
    * @brief Retrieve the debug name string associated with the `RenderState`
    * @result A string containing the debug name.
@@ -237,6 +246,9 @@ class RenderState {
 
  private:
   std::string render_state_debug_name_;
+
+  template <typename T> friend class RendererResourcePool;
+  RenderStateHandle handle_;
 };
 }
 
@@ -16,6 +16,7 @@
 
 #include "renderer_render_state_gles.h"
 #include "renderer_debug.h"
+#include "renderer_gles.h"
 
 namespace simple_renderer {
 
@@ -97,6 +98,9 @@ RenderStateGLES::RenderStateGLES(const RenderStateCreationParams& params) :
     state_uniform_(params.state_uniform),
     state_vertex_layout_(params.state_vertex_layout),
     primitive_type_(primitive_values[params.primitive_type]),
+    vertex_attribute_mask_(0),
+    uploaded_uniform_data_(),
+    uploaded_uniform_data_valid_(false),
     cull_function_(cull_function_values[params.cull_face]),
     depth_function_(depth_function_values[params.depth_function]),
     front_face_(front_facing_values[params.front_face]),
@@ -108,10 +112,6 @@ RenderStateGLES::RenderStateGLES(const RenderStateCreationParams& params) :
     depth_test_(params.depth_test),
     depth_write_(params.depth_write),
     scissor_test_(params.scissor_test) {
-  for (uint32_t i = 0; i < kAttribute_Count; ++i) {
-    vertex_attribute_enabled_[i] = false;
-  }
-
   const ShaderProgramGLES& program = GetShaderProgram();
   const GLuint program_handle = program.GetProgramHandle();
   glUseProgram(program_handle);
@@ -120,6 +120,12 @@ RenderStateGLES::RenderStateGLES(const RenderStateCreationParams& params) :
   InitializeAttributes(program_handle);
   InitializeUniforms(program_handle);
 
+  for (uint32_t i = 0; i < kAttribute_Count; ++i) {
+    if (vertex_attribute_locations_[i] >= 0) {
+      vertex_attribute_mask_ |= (1U << vertex_attribute_locations_[i]);
+    }
+  }
+
   glUseProgram(0);
   RENDERER_CHECK_GLES("glUseProgram");
 }
@@ -137,6 +143,10 @@ const UniformBufferGLES& RenderStateGLES::GetUniformBuffer() const {
   return *(static_cast<UniformBufferGLES *>(state_uniform_.get()));
 }
 
+UniformBufferGLES& RenderStateGLES::GetUniformBuffer() {
+  return *(static_cast<UniformBufferGLES *>(state_uniform_.get()));
+}
+
 void RenderStateGLES::InitializeAttributes(const GLuint program_handle) {
   vertex_attribute_locations_[kAttribute_Position] = glGetAttribLocation(
       program_handle, vertex_attribute_names[kAttribute_Position]);
@@ -154,6 +164,11 @@ void RenderStateGLES::InitializeAttributes(const GLuint program_handle) {
         program_handle, sampler_name);
     RENDERER_CHECK_GLES("glGetUniformLocation (sampler)");
     RENDERER_ASSERT(sampler_location_ >= 0)
+
+    // The sampler is program state and we only use texture stage 0, so it
+    // only needs to be set once while the program is bound here
+    glUniform1i(sampler_location_, 0);
+    RENDERER_CHECK_GLES("glUniform1i (sampler)");
   } else {
     vertex_attribute_locations_[kAttribute_TexCoord] = -1;
     sampler_location_ = -1;
@@ -174,12 +189,22 @@ void RenderStateGLES::InitializeUniforms(const GLuint program_handle) {
   const UniformBufferGLES& buffer = GetUniformBuffer();
   uint32_t i = 0;
   RENDERER_ASSERT(buffer.GetBufferElementCount() <= UniformBuffer::kMaxUniforms)
-  while (i < buffer.GetBufferElementCount()) {
-    const char* element_name = buffer.GetElement(i).element_name;
-    uniform_locations_[i] = glGetUniformLocation(program_handle, element_name);
-    RENDERER_CHECK_GLES("glGetUniformLocation (shader uniform)");
-    RENDERER_ASSERT(uniform_locations_[i] >= 0)
-    ++i;
+  if (buffer.GetUsesUniformRing()) {
+    // Uniforms are read from a std140 uniform block bound to binding point 0 instead
+    RENDERER_ASSERT(buffer.GetBlockName() != nullptr)
+    const GLuint block_index = glGetUniformBlockIndex(program_handle, buffer.GetBlockName());
+    RENDERER_CHECK_GLES("glGetUniformBlockIndex");
+    RENDERER_ASSERT(block_index != GL_INVALID_INDEX)
+    glUniformBlockBinding(program_handle, block_index, 0);
+    RENDERER_CHECK_GLES("glUniformBlockBinding");
+  } else {
+    while (i < buffer.GetBufferElementCount()) {
+      const char* element_name = buffer.GetElement(i).element_name;
+      uniform_locations_[i] = glGetUniformLocation(program_handle, element_name);
+      RENDERER_CHECK_GLES("glGetUniformLocation (shader uniform)");
+      RENDERER_ASSERT(uniform_locations_[i] >= 0)
+      ++i;
+    }
   }
 
   while (i < UniformBuffer::kMaxUniforms) {
@@ -188,88 +213,81 @@ void RenderStateGLES::InitializeUniforms(const GLuint program_handle) {
   }
 }
 
-void RenderStateGLES::BindRenderState() {
+void RenderStateGLES::BindRenderState(StateCacheGLES& state_cache) {
+  state_cache.SetCapability(GL_BLEND, blend_enabled_);
   if (blend_enabled_) {
-    glEnable(GL_BLEND);
-    glBlendFunc(src_blend_, dst_blend_);
-  } else {
-    glDisable(GL_BLEND);
+    state_cache.BlendFunc(src_blend_, dst_blend_);
   }
 
+  state_cache.SetCapability(GL_CULL_FACE, cull_enabled_);
   if (cull_enabled_) {
-    glEnable(GL_CULL_FACE);
-    glCullFace(cull_function_);
-    glFrontFace(front_face_);
-  } else {
-    glDisable(GL_CULL_FACE);
+    state_cache.CullFace(cull_function_);
+    state_cache.FrontFace(front_face_);
   }
 
+  state_cache.SetCapability(GL_DEPTH_TEST, depth_test_);
   if (depth_test_) {
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(depth_function_);
-  } else {
-    glDisable(GL_DEPTH_TEST);
+    state_cache.DepthFunc(depth_function_);
   }
-  glDepthMask(depth_write_);
+  state_cache.DepthMask(depth_write_);
 
+  state_cache.SetCapability(GL_SCISSOR_TEST, scissor_test_);
   if (scissor_test_) {
-    glEnable(GL_SCISSOR_TEST);
-    glScissor(scissor_rect_.x, scissor_rect_.y,
-              scissor_rect_.width, scissor_rect_.height);
-  } else {
-    glDisable(GL_SCISSOR_TEST);
+    state_cache.Scissor(scissor_rect_.x, scissor_rect_.y,
+                        scissor_rect_.width, scissor_rect_.height);
   }
 
-  glLineWidth(line_width_);
+  state_cache.LineWidth(line_width_);
 
-  glViewport(viewport_.x, viewport_.y, viewport_.width, viewport_.height);
-  glDepthRangef(viewport_.min_depth, viewport_.max_depth);
+  state_cache.Viewport(viewport_.x, viewport_.y, viewport_.width, viewport_.height);
+  state_cache.DepthRange(viewport_.min_depth, viewport_.max_depth);
 
   const ShaderProgramGLES& program = GetShaderProgram();
   const GLuint program_handle = program.GetProgramHandle();
-  glUseProgram(program_handle);
-  RENDERER_CHECK_GLES("glUseProgram");
-}
+  state_cache.UseProgram(program_handle);
 
-void RenderStateGLES::UnbindRenderState() {
-  for (uint32_t i = 0; i < kAttribute_Count; ++i) {
-    if (vertex_attribute_enabled_[i]) {
-      glDisableVertexAttribArray(vertex_attribute_locations_[i]);
-      RENDERER_CHECK_GLES("glDisableVertexAttribArray");
-      vertex_attribute_enabled_[i] = false;
-    }
+  // Another render state sharing the program may have uploaded its own uniform values
+  if (state_cache.GetProgramUniformOwner(program_handle) != this) {
+    uploaded_uniform_data_valid_ = false;
   }
-  glUseProgram(0);
-  RENDERER_CHECK_GLES("glUseProgram");
 }
 
-void RenderStateGLES::BindVertexAttributes() {
+void RenderStateGLES::UnbindRenderState(StateCacheGLES& state_cache) {
+  state_cache.DisableVertexAttributes(0);
+  state_cache.UseProgram(0);
+}
+
+void RenderStateGLES::BindVertexAttributes(StateCacheGLES& state_cache,
+                                           const uint32_t base_vertex) {
+  // Disable attributes left enabled by a previous render state that this layout doesn't use
+  state_cache.DisableVertexAttributes(vertex_attribute_mask_);
+
+  // The attribute pointers are still valid if this state set them for the bound vertex buffer
+  if (state_cache.GetVertexAttributesCurrent(this, base_vertex)) {
+    state_cache.AddElidedCalls(__builtin_popcount(vertex_attribute_mask_));
+    return;
+  }
+  state_cache.AddIssuedCalls(__builtin_popcount(vertex_attribute_mask_));
+
   const GLsizei vertex_stride = vertex_format_strides[state_vertex_layout_];
+  const size_t base_offset = static_cast<size_t>(base_vertex) * vertex_stride;
   // Configure vertex attributes based on the active vertex buffer format
   // We always have position, and may have texture, color, or texture+color
   glVertexAttribPointer(vertex_attribute_locations_[kAttribute_Position],
                         3, GL_FLOAT, vertex_attribute_normalized[kAttribute_Position],
                         vertex_stride,
-                        reinterpret_cast<void*>(kPositionAttributeOffset));
+                        reinterpret_cast<void*>(base_offset + kPositionAttributeOffset));
   RENDERER_CHECK_GLES("glVertexAttribPointer (pos)");
-  glEnableVertexAttribArray(vertex_attribute_locations_[kAttribute_Position]);
-  RENDERER_CHECK_GLES("glEnableVertexAttribArray (pos)");
-  vertex_attribute_enabled_[kAttribute_Position] = true;
+  state_cache.SetVertexAttributeEnabled(vertex_attribute_locations_[kAttribute_Position], true);
 
   if (state_vertex_layout_ == VertexBuffer::kVertexFormat_P3T2 ||
       state_vertex_layout_ == VertexBuffer::kVertexFormat_P3T2C4) {
     glVertexAttribPointer(vertex_attribute_locations_[kAttribute_TexCoord],
                           2, GL_FLOAT, vertex_attribute_normalized[kAttribute_TexCoord],
                           vertex_stride,
-                          reinterpret_cast<void*>(kTextureAttributeOffset));
+                          reinterpret_cast<void*>(base_offset + kTextureAttributeOffset));
     RENDERER_CHECK_GLES("glVertexAttribPointer (tex)");
-    glEnableVertexAttribArray(vertex_attribute_locations_[kAttribute_TexCoord]);
-    RENDERER_CHECK_GLES("glEnableVertexAttribArray (tex)");
-    vertex_attribute_enabled_[kAttribute_TexCoord] = true;
-
-    // Also update sampler location here, we only use texture stage 0
-    glUniform1i(sampler_location_, 0);
-    RENDERER_CHECK_GLES("glUniform1i (sampler)");
+    state_cache.SetVertexAttributeEnabled(vertex_attribute_locations_[kAttribute_TexCoord], true);
   }
 
   if (state_vertex_layout_ == VertexBuffer::kVertexFormat_P3C4 ||
@@ -280,42 +298,77 @@ void RenderStateGLES::BindVertexAttributes() {
     glVertexAttribPointer(vertex_attribute_locations_[kAttribute_Color],
                           4, GL_FLOAT, vertex_attribute_normalized[kAttribute_Color],
                           vertex_stride,
-                          reinterpret_cast<void*>(color_offset));
+                          reinterpret_cast<void*>(base_offset + color_offset));
     RENDERER_CHECK_GLES("glVertexAttribPointer (color)");
-    glEnableVertexAttribArray(vertex_attribute_locations_[kAttribute_Color]);
-    RENDERER_CHECK_GLES("glEnableVertexAttribArray (color)");
-    vertex_attribute_enabled_[kAttribute_Color] = true;
+    state_cache.SetVertexAttributeEnabled(vertex_attribute_locations_[kAttribute_Color], true);
   }
+  state_cache.SetVertexAttributesOwner(this, base_vertex);
 }
 
-void RenderStateGLES::UpdateUniformData(bool force_update) {
+void RenderStateGLES::UpdateUniformData(StateCacheGLES& state_cache, bool force_update) {
   UniformBufferGLES& buffer = *(static_cast<UniformBufferGLES *>(state_uniform_.get()));
-  // We don't need to rebind vertex attributes if we didn't change the vertex buffer,
-  // but at the moment we always do it
-  BindVertexAttributes();
-  if (buffer.GetBufferDirty() || force_update) {
-    const float* buffer_data = buffer.GetBufferData();
-
-    for (uint32_t i = 0; i < buffer.GetBufferElementCount(); ++i) {
-      const UniformBuffer::UniformBufferElement& element = buffer.GetElement(i);
-      const float* element_data = &buffer_data[buffer.GetElementOffset(i)];
-      switch (element.element_type) {
-        case UniformBuffer::kBufferElement_Float4:
-          glUniform4f(uniform_locations_[i],
-                      element_data[0],
-                      element_data[1],
-                      element_data[2],
-                      element_data[3]);
-          RENDERER_CHECK_GLES("glUniform4f");
-          break;
-        case UniformBuffer::kBufferElement_Matrix44:
-          glUniformMatrix4fv(uniform_locations_[i], 1, GL_FALSE, element_data);
-          RENDERER_CHECK_GLES("glUniformMatrix4fv");
-          break;
-      }
+
+  if (buffer.GetUsesUniformRing()) {
+    RendererGLES& renderer = RendererGLES::GetInstanceGLES();
+    UniformRingBufferGLES& uniform_ring = renderer.GetUniformRing();
+    const uint64_t frame_number = renderer.GetFrameNumber();
+    uint32_t ring_offset = buffer.GetRingOffset();
+    // A copy from a previous frame lives in a segment that may have been reused
+    if (buffer.GetBufferDirty() || buffer.GetRingFrameNumber() != frame_number ||
+        ring_offset == UniformRingBufferGLES::kInvalidOffset) {
+      ring_offset = uniform_ring.Write(state_cache, buffer.GetBufferData(),
+                                       buffer.GetBufferSizeInBytes());
+      buffer.SetRingOffset(ring_offset, frame_number);
+      buffer.SetBufferDirty(false);
+      renderer.GetStats().Add(RendererStats::kStat_UniformBytes, buffer.GetBufferSizeInBytes());
+    }
+    if (ring_offset != UniformRingBufferGLES::kInvalidOffset) {
+      uniform_ring.Bind(state_cache, ring_offset, buffer.GetBufferSizeInBytes());
     }
-    buffer.SetBufferDirty(false);
+    return;
   }
+
+  // The buffer dirty flag can't be used to skip the compare, the buffer may be shared
+  // with other render states that have already cleared it
+  const bool upload_all = force_update || !uploaded_uniform_data_valid_;
+  const float* buffer_data = buffer.GetBufferData();
+  uint64_t uploaded_bytes = 0;
+
+  for (uint32_t i = 0; i < buffer.GetBufferElementCount(); ++i) {
+    const UniformBuffer::UniformBufferElement& element = buffer.GetElement(i);
+    const uint32_t element_offset = buffer.GetElementOffset(i);
+    const float* element_data = &buffer_data[element_offset];
+    float* uploaded_data = &uploaded_uniform_data_[element_offset];
+    const size_t element_size = (element.element_type == UniformBuffer::kBufferElement_Matrix44) ?
+        UniformBuffer::kElementSize_Matrix44 : UniformBuffer::kElementSize_Float4;
+    if (!upload_all && memcmp(uploaded_data, element_data, element_size) == 0) {
+      state_cache.AddElidedCalls(1);
+      continue;
+    }
+    memcpy(uploaded_data, element_data, element_size);
+    state_cache.AddIssuedCalls(1);
+    uploaded_bytes += element_size;
+
+    switch (element.element_type) {
+      case UniformBuffer::kBufferElement_Float4:
+        glUniform4f(uniform_locations_[i],
+                    element_data[0],
+                    element_data[1],
+                    element_data[2],
+                    element_data[3]);
+        RENDERER_CHECK_GLES("glUniform4f");
+        break;
+      case UniformBuffer::kBufferElement_Matrix44:
+        glUniformMatrix4fv(uniform_locations_[i], 1, GL_FALSE, element_data);
+        RENDERER_CHECK_GLES("glUniformMatrix4fv");
+        break;
+    }
+  }
+  buffer.SetBufferDirty(false);
+  uploaded_uniform_data_valid_ = true;
+  RendererGLES::GetInstanceGLES().GetStats().Add(RendererStats::kStat_UniformBytes,
+                                                 uploaded_bytes);
+  state_cache.SetProgramUniformOwner(GetShaderProgram().GetProgramHandle(), this);
 }
 
-}
\ No newline at end of file
+}
@@ -19,6 +19,7 @@
 
 #include "renderer_render_state.h"
 #include "renderer_shader_program_gles.h"
+#include "renderer_state_cache_gles.h"
 #include "renderer_uniform_buffer_gles.h"
 
 namespace simple_renderer {
@@ -37,11 +38,17 @@ class RenderStateGLES : public RenderState {
 
   const ShaderProgramGLES& GetShaderProgram() const;
   const UniformBufferGLES& GetUniformBuffer() const;
+  UniformBufferGLES& GetUniformBuffer();
 
-  void BindRenderState();
-  void UnbindRenderState();
+  void BindRenderState(StateCacheGLES& state_cache);
+  void UnbindRenderState(StateCacheGLES& state_cache);
 
-  void UpdateUniformData(bool force_update);
+  // Sets the attribute pointers for the bound vertex buffer, starting at base_vertex
+  void BindVertexAttributes(StateCacheGLES& state_cache, const uint32_t base_vertex);
+
+  // Only elements that differ from the values last uploaded by this render state
+  // are uploaded, unless force_update is set
+  void UpdateUniformData(StateCacheGLES& state_cache, bool force_update);
 
   GLenum GetPrimitiveType() const { return primitive_type_;}
 
@@ -56,7 +63,6 @@ class RenderStateGLES : public RenderState {
  private:
   void InitializeAttributes(const GLuint program_handle);
   void InitializeUniforms(const GLuint program_handle);
-  void BindVertexAttributes();
 
   RenderState::ScissorRect scissor_rect_;
   RenderState::Viewport viewport_;
@@ -67,7 +73,11 @@ class RenderStateGLES : public RenderState {
   GLint sampler_location_;
   GLint uniform_locations_[UniformBuffer::kMaxUniforms];
   GLint vertex_attribute_locations_[kAttribute_Count];
-  bool vertex_attribute_enabled_[kAttribute_Count];
+  // Bitmask of the attribute locations used by the vertex layout
+  uint32_t vertex_attribute_mask_;
+  // Copy of the uniform buffer data as last uploaded to the program by this state
+  float uploaded_uniform_data_[UniformBuffer::kMaxUniformBufferFloatSize];
+  bool uploaded_uniform_data_valid_;
   GLenum cull_function_;
   GLenum depth_function_;
   GLenum front_face_;
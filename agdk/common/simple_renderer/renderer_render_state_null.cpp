@@ -0,0 +1,35 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "renderer_render_state_null.h"
+
+namespace simple_renderer {
+
+RenderStateNull::RenderStateNull(const RenderStateCreationParams& params) :
+    scissor_rect_(params.scissor_rect),
+    viewport_(params.viewport),
+    state_program_(params.state_program),
+    state_uniform_(params.state_uniform),
+    primitive_type_(params.primitive_type) {
+}
+
+RenderStateNull::~RenderStateNull() {
+  state_program_ = nullptr;
+  state_uniform_ = nullptr;
+}
+
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SIMPLERENDERER_RENDER_STATE_NULL_H_
+#define SIMPLERENDERER_RENDER_STATE_NULL_H_
+
+#include "renderer_render_state.h"
+#include "renderer_uniform_buffer_null.h"
+
+namespace simple_renderer {
+
+class RenderStateNull : public RenderState {
+ public:
+  RenderStateNull(const RenderStateCreationParams& params);
+  virtual ~RenderStateNull();
+
+  virtual void SetViewport(const RenderState::Viewport& viewport) {
+    viewport_ = viewport;
+  }
+
+  virtual void SetScissorRect(const RenderState::ScissorRect& scissor_rect) {
+    scissor_rect_ = scissor_rect;
+  }
+
+  const UniformBufferNull& GetUniformBuffer() const {
+    return *(static_cast<UniformBufferNull*>(state_uniform_.get()));
+  }
+  UniformBufferNull& GetUniformBuffer() {
+    return *(static_cast<UniformBufferNull*>(state_uniform_.get()));
+  }
+
+  RenderPrimitiveType GetPrimitiveType() const { return primitive_type_; }
+
+ private:
+  RenderState::ScissorRect scissor_rect_;
+  RenderState::Viewport viewport_;
+  std::shared_ptr<ShaderProgram> state_program_;
+  std::shared_ptr<UniformBuffer> state_uniform_;
+  RenderPrimitiveType primitive_type_;
+};
+
+}
+
+#endif // SIMPLERENDERER_RENDER_STATE_NULL_H_
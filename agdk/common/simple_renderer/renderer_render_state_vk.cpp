@@ -19,6 +19,7 @@
 #include "renderer_render_pass_vk.h"
 #include "renderer_shader_program_vk.h"
 #include "renderer_uniform_buffer_vk.h"
+#include "renderer_uniform_ring_buffer_vk.h"
 #include "renderer_vk_includes.h"
 #include "renderer_vk.h"
 
@@ -53,12 +54,13 @@ static constexpr uint32_t kTextureAttributeSize = (2 * sizeof(float));
 static constexpr uint32_t kColorAttributeSize = (4 * sizeof(float));
 
 static void ConfigureAttachmentStates(const RenderState::RenderStateCreationParams& params,
+    const VkSampleCountFlagBits sample_count,
     VkPipelineMultisampleStateCreateInfo& pipeline_multisample_state_info,
     VkPipelineColorBlendStateCreateInfo& pipeline_color_blend_state_info,
     VkPipelineDepthStencilStateCreateInfo& pipeline_depth_stencil_state_info,
     VkPipelineColorBlendAttachmentState& pipeline_color_blend_attachment_state) {
   pipeline_multisample_state_info.sampleShadingEnable = VK_FALSE;
-  pipeline_multisample_state_info.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+  pipeline_multisample_state_info.rasterizationSamples = sample_count;
   pipeline_multisample_state_info.minSampleShading = 1.f;
   pipeline_multisample_state_info.pSampleMask = nullptr;
   pipeline_multisample_state_info.alphaToCoverageEnable = VK_FALSE;
@@ -133,6 +135,7 @@ static uint32_t ConfigureAttributeDescriptions(const VertexBuffer::VertexFormat
 }
 
 static void ConfigureRasterizationState(const RenderState::RenderStateCreationParams& params,
+    const bool flipped_viewport,
     VkPipelineRasterizationStateCreateInfo& pipeline_rasterization_state_info) {
   pipeline_rasterization_state_info.depthClampEnable = VK_FALSE;
   pipeline_rasterization_state_info.rasterizerDiscardEnable = VK_FALSE;
@@ -141,9 +144,11 @@ static void ConfigureRasterizationState(const RenderState::RenderStateCreationPa
   const VkCullModeFlagBits cull_mode = params.cull_enabled ?
                                        cull_modes[params.cull_face] : VK_CULL_MODE_NONE;
   pipeline_rasterization_state_info.cullMode = cull_mode;
-  pipeline_rasterization_state_info.frontFace =
-      (params.front_face == RenderState::kFrontFaceClockwise) ? VK_FRONT_FACE_CLOCKWISE :
-                                                                VK_FRONT_FACE_COUNTER_CLOCKWISE;
+  // Winding is evaluated in framebuffer space, without the viewport flip the
+  // GL front face is reversed
+  const bool clockwise = (params.front_face == RenderState::kFrontFaceClockwise);
+  pipeline_rasterization_state_info.frontFace = (clockwise == flipped_viewport) ?
+      VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
   pipeline_rasterization_state_info.depthBiasEnable = VK_FALSE;
   pipeline_rasterization_state_info.depthBiasConstantFactor = 0.f;
   pipeline_rasterization_state_info.depthBiasClamp = 0.f;
@@ -226,12 +231,14 @@ RenderStateVk::RenderStateVk(const RenderStateCreationParams& params) :
   vertex_pipeline_info.stage = VK_SHADER_STAGE_VERTEX_BIT;
   vertex_pipeline_info.module = shader_program.GetVertexModule();
   vertex_pipeline_info.pName = "main";
+  vertex_pipeline_info.pSpecializationInfo = shader_program.GetSpecializationInfo();
 
   VkPipelineShaderStageCreateInfo fragment_pipeline_info =
       { VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO };
   fragment_pipeline_info.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
   fragment_pipeline_info.module = shader_program.GetFragmentModule();
   fragment_pipeline_info.pName = "main";
+  fragment_pipeline_info.pSpecializationInfo = shader_program.GetSpecializationInfo();
 
   VkPipelineShaderStageCreateInfo pipeline_shader_info[] = {
 vertex_pipeline_info,
@@ -246,13 +253,18 @@ fragment_pipeline_info
 
   VkPipelineRasterizationStateCreateInfo pipeline_rasterization_state_info =
       {VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO };
-  ConfigureRasterizationState(params, pipeline_rasterization_state_info);
+  ConfigureRasterizationState(params, render_pass_vk.FlipsViewport(),
+                              pipeline_rasterization_state_info);
 
   VkPipelineMultisampleStateCreateInfo pipeline_multisample_state_info = {VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO };
   VkPipelineColorBlendStateCreateInfo pipeline_color_blend_state_info = {VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO };
   VkPipelineDepthStencilStateCreateInfo pipeline_depth_stencil_state_info = {VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO };
   VkPipelineColorBlendAttachmentState pipeline_color_blend_attachment_state = {};
-  ConfigureAttachmentStates(params, pipeline_multisample_state_info, pipeline_color_blend_state_info, pipeline_depth_stencil_state_info, pipeline_color_blend_attachment_state);
+  ConfigureAttachmentStates(params, render_pass_vk.GetSampleCountVk(),
+                            pipeline_multisample_state_info, pipeline_color_blend_state_info, pipeline_depth_stencil_state_info, pipeline_color_blend_attachment_state);
+  if (!render_pass_vk.HasColorAttachment()) {
+    pipeline_color_blend_state_info.attachmentCount = 0;
+  }
 
   VkDynamicState dynamic_states[2] = {
       VK_DYNAMIC_STATE_VIEWPORT,
@@ -308,6 +320,7 @@ RenderStateVk::~RenderStateVk() {
 void RenderStateVk::CreatePipelineLayout(const RenderStateCreationParams& params) {
   UniformBufferVk& buffer = *(static_cast<UniformBufferVk *>(state_uniform_.get()));
   const UniformBuffer::UniformBufferStageRanges& stage_ranges = buffer.GetStageRanges();
+  RendererVk &renderer = RendererVk::GetInstanceVk();
 
   uint32_t range_count = 0;
 
@@ -315,36 +328,74 @@ void RenderStateVk::CreatePipelineLayout(const RenderStateCreationParams& params
   VkPushConstantRange push_constant_ranges[max_range_count];
   memset(push_constant_ranges, 0, sizeof(VkPushConstantRange) * max_range_count);
 
-  if (stage_ranges.vertex_stage_offset != UniformBufferVk::kUnusedStageRange) {
+  // Uniform ring buffers are delivered through set 1 instead of push constants
+  const bool use_uniform_ring = buffer.GetUsesUniformRing();
+  if (!use_uniform_ring &&
+      stage_ranges.vertex_stage_offset != UniformBufferVk::kUnusedStageRange) {
     push_constant_ranges[range_count].offset = stage_ranges.vertex_stage_offset;
     push_constant_ranges[range_count].size = stage_ranges.vertex_stage_size;
     push_constant_ranges[range_count].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
     ++range_count;
   }
 
-  if (stage_ranges.fragment_stage_offset != UniformBufferVk::kUnusedStageRange) {
+  if (!use_uniform_ring &&
+      stage_ranges.fragment_stage_offset != UniformBufferVk::kUnusedStageRange) {
     push_constant_ranges[range_count].offset = stage_ranges.fragment_stage_offset;
     push_constant_ranges[range_count].size = stage_ranges.fragment_stage_size;
     push_constant_ranges[range_count].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
     ++range_count;
   }
 
-  VkDescriptorSetLayout descriptor_set_layouts[] = {descriptor_set_layout_};
+  // The texture set layout always exists (empty for formats without a sampler),
+  // so the uniform ring can always be set 1
+  RENDERER_ASSERT(!use_uniform_ring || descriptor_set_layout_ != VK_NULL_HANDLE)
+  VkDescriptorSetLayout descriptor_set_layouts[] = {
+      descriptor_set_layout_,
+      use_uniform_ring ? renderer.GetUniformRing().GetDescriptorSetLayout() : VK_NULL_HANDLE
+  };
+  uint32_t set_layout_count = (descriptor_set_layout_ != VK_NULL_HANDLE) ? 1 : 0;
+  if (use_uniform_ring) {
+    set_layout_count = 2;
+  }
   VkPipelineLayoutCreateInfo pipeline_layout_info{};
   pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-  pipeline_layout_info.setLayoutCount = (descriptor_set_layout_ != VK_NULL_HANDLE) ? 1 : 0;
-  pipeline_layout_info.pSetLayouts = (descriptor_set_layout_ != VK_NULL_HANDLE) ?
-      descriptor_set_layouts : nullptr;
+  pipeline_layout_info.setLayoutCount = set_layout_count;
+  pipeline_layout_info.pSetLayouts = (set_layout_count > 0) ? descriptor_set_layouts : nullptr;
   pipeline_layout_info.pushConstantRangeCount = range_count;
   pipeline_layout_info.pPushConstantRanges = (range_count > 0) ? push_constant_ranges : nullptr;
-  RendererVk &renderer = RendererVk::GetInstanceVk();
   const VkResult layout_result = vkCreatePipelineLayout(renderer.GetDevice(), &pipeline_layout_info,
                                                         nullptr, &pipeline_layout_);
   RENDERER_CHECK_VK(layout_result, "vkCreatePipelineLayout");
 }
 
-void RenderStateVk::UpdateUniformData(VkCommandBuffer command_buffer, bool force_update) {
+void RenderStateVk::UpdateUniformData(VkCommandBuffer command_buffer, bool force_update,
+                                      bool reuse_ring_copy, uint32_t& bound_ring_offset) {
   UniformBufferVk& buffer = *(static_cast<UniformBufferVk *>(state_uniform_.get()));
+  if (buffer.GetUsesUniformRing()) {
+    RendererVk& renderer = RendererVk::GetInstanceVk();
+    UniformRingBufferVk& uniform_ring = renderer.GetUniformRing();
+    const uint64_t frame_number = renderer.GetFrameNumber();
+    uint32_t ring_offset = buffer.GetRingOffset();
+    if (!reuse_ring_copy) {
+      ring_offset = uniform_ring.Write(buffer.GetBufferData(), buffer.GetBufferSize());
+      renderer.GetStats().Add(RendererStats::kStat_UniformBytes, buffer.GetBufferSize());
+    } else if (buffer.GetBufferDirty() || buffer.GetRingFrameNumber() != frame_number ||
+               ring_offset == UniformRingBufferVk::kInvalidOffset) {
+      // Copy from a previous frame lives in a segment that may have been reused
+      ring_offset = uniform_ring.Write(buffer.GetBufferData(), buffer.GetBufferSize());
+      buffer.SetRingOffset(ring_offset, frame_number);
+      buffer.SetBufferDirty(false);
+      renderer.GetStats().Add(RendererStats::kStat_UniformBytes, buffer.GetBufferSize());
+    }
+    if (ring_offset != UniformRingBufferVk::kInvalidOffset && ring_offset != bound_ring_offset) {
+      const VkDescriptorSet ring_descriptor_set = uniform_ring.GetDescriptorSet();
+      vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                              pipeline_layout_, 1, 1, &ring_descriptor_set, 1, &ring_offset);
+      bound_ring_offset = ring_offset;
+    }
+    return;
+  }
+
   if (buffer.GetBufferDirty() || force_update) {
     const UniformBuffer::UniformBufferStageRanges& stage_ranges = buffer.GetStageRanges();
     const uint8_t *buffer_data = reinterpret_cast<const uint8_t*>(buffer.GetBufferData());
@@ -357,6 +408,8 @@ void RenderStateVk::UpdateUniformData(VkCommandBuffer command_buffer, bool force
                          buffer_data + stage_ranges.fragment_stage_offset);
     }
     buffer.SetBufferDirty(false);
+    RendererVk::GetInstanceVk().GetStats().Add(RendererStats::kStat_UniformBytes,
+                                               buffer.GetBufferSize());
   }
 }
 
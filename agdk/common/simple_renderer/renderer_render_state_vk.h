@@ -41,7 +41,13 @@ class RenderStateVk : public RenderState {
 
   VkPipelineLayout GetPipelineLayout() const { return pipeline_layout_; }
 
-  void UpdateUniformData(VkCommandBuffer command_buffer, bool force_update);
+  VkPrimitiveTopology GetPrimitiveTopology() const { return primitive_type_; }
+
+  // Push constants are only pushed if the uniform buffer is dirty unless force_update is set.
+  // Uniform ring buffers reuse the ring copy made earlier in the frame if unchanged and
+  // reuse_ring_copy is set, and only rebind when the offset differs from bound_ring_offset.
+  void UpdateUniformData(VkCommandBuffer command_buffer, bool force_update,
+                         bool reuse_ring_copy, uint32_t& bound_ring_offset);
 
  private:
   void CreatePipelineLayout(const RenderStateCreationParams& params);
@@ -21,152 +21,133 @@ namespace simple_renderer {
 
 static constexpr long kExpectedUseCount = 1;
 
-void RendererResources::ProcessDeleteQueue() {
-  while (!index_buffer_delete_queue_.empty()) {
-    RENDERER_ASSERT(index_buffer_delete_queue_.front().use_count() == kExpectedUseCount)
-    index_buffer_delete_queue_.pop();
-  }
+RendererResources::RendererResources(RendererStats& stats) :
+    stats_(stats),
+    frame_number_(0) {
+}
 
-  while (!render_state_delete_queue_.empty()) {
-    RENDERER_ASSERT(render_state_delete_queue_.front().use_count() == kExpectedUseCount)
-    render_state_delete_queue_.pop();
-  }
+void RendererResources::BeginFrame(const uint64_t frame_number,
+                                   const uint64_t completed_frame_number) {
+  RetireAllDeletes(completed_frame_number);
+  frame_number_ = frame_number;
+}
 
-  while (!render_pass_delete_queue_.empty()) {
-    RENDERER_ASSERT(render_pass_delete_queue_.front().use_count() == kExpectedUseCount)
-    render_pass_delete_queue_.pop();
-  }
+void RendererResources::ProcessDeleteQueue() {
+  RetireAllDeletes(UINT64_MAX);
+}
 
-  while (!shader_program_delete_queue_.empty()) {
-    RENDERER_ASSERT(shader_program_delete_queue_.front().use_count() == kExpectedUseCount)
-    shader_program_delete_queue_.pop();
+template <typename T>
+void RendererResources::RetireDeletes(DeleteQueue<T>& queue,
+                                      const uint64_t completed_frame_number) {
+  // Frame numbers are queued in increasing order
+  while (!queue.empty() && queue.front().frame_number <= completed_frame_number) {
+    RENDERER_ASSERT(queue.front().resource.use_count() == kExpectedUseCount)
+    stats_.Add(RendererStats::kStat_ResourcesDestroyed, 1);
+    queue.pop();
   }
+}
 
-  while (!texture_delete_queue_.empty()) {
-    RENDERER_ASSERT(texture_delete_queue_.front().use_count() == kExpectedUseCount)
-    texture_delete_queue_.pop();
-  }
+void RendererResources::RetireAllDeletes(const uint64_t completed_frame_number) {
+  // Recording contexts may hold references to other resources, delete them first
+  RetireDeletes(recording_context_delete_queue_, completed_frame_number);
+  RetireDeletes(index_buffer_delete_queue_, completed_frame_number);
+  RetireDeletes(render_state_delete_queue_, completed_frame_number);
+  RetireDeletes(render_pass_delete_queue_, completed_frame_number);
+  RetireDeletes(shader_program_delete_queue_, completed_frame_number);
+  RetireDeletes(texture_delete_queue_, completed_frame_number);
+  RetireDeletes(uniform_buffer_delete_queue_, completed_frame_number);
+  RetireDeletes(vertex_buffer_delete_queue_, completed_frame_number);
+}
 
-  while (!uniform_buffer_delete_queue_.empty()) {
-    RENDERER_ASSERT(uniform_buffer_delete_queue_.front().use_count() == kExpectedUseCount)
-    uniform_buffer_delete_queue_.pop();
+template <typename T>
+void RendererResources::QueueDelete(RendererResourcePool<T>& pool, DeleteQueue<T>& queue,
+                                    const std::shared_ptr<T>& resource) {
+  if (resource.get() == nullptr) {
+    return;
   }
-
-  while (!vertex_buffer_delete_queue_.empty()) {
-    RENDERER_ASSERT(vertex_buffer_delete_queue_.front().use_count() == kExpectedUseCount)
-    vertex_buffer_delete_queue_.pop();
+  // The resource stays alive in the queue until the frames that may reference
+  // it have completed, but its handle is stale from this point on
+  std::shared_ptr<T> pool_resource = pool.Remove(resource->GetHandle());
+  if (pool_resource.get() != nullptr) {
+    queue.push({frame_number_, std::move(pool_resource)});
   }
 }
 
 std::shared_ptr<IndexBuffer> RendererResources::AddIndexBuffer(IndexBuffer* index_buffer) {
-  std::shared_ptr<IndexBuffer> share = std::shared_ptr<IndexBuffer>(index_buffer);
-  index_buffers_.insert({reinterpret_cast<RendererKey>(index_buffer), share});
-  return share;
+  stats_.Add(RendererStats::kStat_ResourcesCreated, 1);
+  return index_buffers_.Add(index_buffer);
 }
 
 void RendererResources::QueueDeleteIndexBuffer(const std::shared_ptr<IndexBuffer>& index_buffer) {
-  const RendererKey buffer_key = reinterpret_cast<RendererKey>(index_buffer.get());
-  auto iter = index_buffers_.find(buffer_key);
-  if (iter != index_buffers_.end()) {
-    index_buffer_delete_queue_.push(iter->second);
-    index_buffers_.erase(iter);
-  }
+  QueueDelete(index_buffers_, index_buffer_delete_queue_, index_buffer);
+}
 
+std::shared_ptr<RecordingContext> RendererResources::AddRecordingContext(
+    RecordingContext* recording_context) {
+  stats_.Add(RendererStats::kStat_ResourcesCreated, 1);
+  return recording_contexts_.Add(recording_context);
 }
 
-std::shared_ptr<RenderPass> RendererResources::AddRenderPass(RenderPass* render_pass) {
-  std::shared_ptr<RenderPass> share = std::shared_ptr<RenderPass>(render_pass);
-  render_passes_.insert({reinterpret_cast<RendererKey>(render_pass), share});
-  return share;
+void RendererResources::QueueDeleteRecordingContext(const std::shared_ptr<RecordingContext>&
+    recording_context) {
+  QueueDelete(recording_contexts_, recording_context_delete_queue_, recording_context);
+}
 
+std::shared_ptr<RenderPass> RendererResources::AddRenderPass(RenderPass* render_pass) {
+  stats_.Add(RendererStats::kStat_ResourcesCreated, 1);
+  return render_passes_.Add(render_pass);
 }
 
 void RendererResources::QueueDeleteRenderPass(const std::shared_ptr<RenderPass>& render_pass) {
-  const RendererKey pass_key = reinterpret_cast<RendererKey>(render_pass.get());
-  auto iter = render_passes_.find(pass_key);
-  if (iter != render_passes_.end()) {
-    render_pass_delete_queue_.push(iter->second);
-    render_passes_.erase(iter);
-  }
+  QueueDelete(render_passes_, render_pass_delete_queue_, render_pass);
 }
 
 std::shared_ptr<RenderState> RendererResources::AddRenderState(RenderState* render_state) {
-  std::shared_ptr<RenderState> share = std::shared_ptr<RenderState>(render_state);
-  render_states_.insert({reinterpret_cast<RendererKey>(render_state),share});
-  return share;
-
+  stats_.Add(RendererStats::kStat_ResourcesCreated, 1);
+  return render_states_.Add(render_state);
 }
 
 void RendererResources::QueueDeleteRenderState(const std::shared_ptr<RenderState>& render_state) {
-  const RendererKey state_key = reinterpret_cast<RendererKey>(render_state.get());
-  auto iter = render_states_.find(state_key);
-  if (iter != render_states_.end()) {
-    render_state_delete_queue_.push(iter->second);
-    render_states_.erase(iter);
-  }
+  QueueDelete(render_states_, render_state_delete_queue_, render_state);
 }
 
 std::shared_ptr<ShaderProgram> RendererResources::AddShaderProgram(ShaderProgram* shader_program) {
-  std::shared_ptr<ShaderProgram> share = std::shared_ptr<ShaderProgram>(shader_program);
-  shader_programs_.insert({reinterpret_cast<RendererKey>(shader_program),share});
-  return share;
+  stats_.Add(RendererStats::kStat_ResourcesCreated, 1);
+  return shader_programs_.Add(shader_program);
 }
 
 void RendererResources::QueueDeleteShaderProgram(const std::shared_ptr<ShaderProgram>&
     shader_program) {
-  const RendererKey shader_key = reinterpret_cast<RendererKey>(shader_program.get());
-  auto iter = shader_programs_.find(shader_key);
-  if (iter != shader_programs_.end()) {
-    shader_program_delete_queue_.push(iter->second);
-    shader_programs_.erase(iter);
-  }
+  QueueDelete(shader_programs_, shader_program_delete_queue_, shader_program);
 }
 
 std::shared_ptr<Texture> RendererResources::AddTexture(Texture* texture) {
-  std::shared_ptr<Texture> share = std::shared_ptr<Texture>(texture);
-  textures_.insert({reinterpret_cast<RendererKey>(texture), share});
-  return share;
+  stats_.Add(RendererStats::kStat_ResourcesCreated, 1);
+  return textures_.Add(texture);
 }
 
 void RendererResources::QueueDeleteTexture(const std::shared_ptr<Texture>& texture) {
-  const RendererKey texture_key = reinterpret_cast<RendererKey>(texture.get());
-  auto iter = textures_.find(texture_key);
-  if (iter != textures_.end()) {
-    texture_delete_queue_.push(iter->second);
-    textures_.erase(iter);
-  }
+  QueueDelete(textures_, texture_delete_queue_, texture);
 }
 
 std::shared_ptr<UniformBuffer> RendererResources::AddUniformBuffer(UniformBuffer* uniform_buffer) {
-  std::shared_ptr<UniformBuffer> share = std::shared_ptr<UniformBuffer>(uniform_buffer);
-  uniform_buffers_.insert({reinterpret_cast<RendererKey>(uniform_buffer), share});
-  return share;
+  stats_.Add(RendererStats::kStat_ResourcesCreated, 1);
+  return uniform_buffers_.Add(uniform_buffer);
 }
 
 void RendererResources::QueueDeleteUniformBuffer(const std::shared_ptr<UniformBuffer>&
     uniform_buffer) {
-  const RendererKey uniform_key = reinterpret_cast<RendererKey>(uniform_buffer.get());
-  auto iter = uniform_buffers_.find(uniform_key);
-  if (iter != uniform_buffers_.end()) {
-    uniform_buffer_delete_queue_.push(iter->second);
-    uniform_buffers_.erase(iter);
-  }
+  QueueDelete(uniform_buffers_, uniform_buffer_delete_queue_, uniform_buffer);
 }
 
 std::shared_ptr<VertexBuffer> RendererResources::AddVertexBuffer(VertexBuffer* vertex_buffer) {
-  std::shared_ptr<VertexBuffer> share = std::shared_ptr<VertexBuffer>(vertex_buffer);
-  vertex_buffers_.insert({reinterpret_cast<RendererKey>(vertex_buffer), share});
-  return share;
+  stats_.Add(RendererStats::kStat_ResourcesCreated, 1);
+  return vertex_buffers_.Add(vertex_buffer);
 }
 
 void RendererResources::QueueDeleteVertexBuffer(const std::shared_ptr<VertexBuffer>&
     vertex_buffer) {
-  const RendererKey buffer_key = reinterpret_cast<RendererKey>(vertex_buffer.get());
-  auto iter = vertex_buffers_.find(buffer_key);
-  if (iter != vertex_buffers_.end()) {
-    vertex_buffer_delete_queue_.push(iter->second);
-    vertex_buffers_.erase(iter);
-  }
+  QueueDelete(vertex_buffers_, vertex_buffer_delete_queue_, vertex_buffer);
 }
 
-}
\ No newline at end of file
+}
@@ -17,59 +17,209 @@
 #ifndef SIMPLERENDERER_RESOURCES_H_
 #define SIMPLERENDERER_RESOURCES_H_
 
+#include "renderer_debug.h"
 #include "renderer_interface.h"
 #include <queue>
-#include <unordered_map>
+#include <vector>
 
 namespace simple_renderer {
 
-typedef uint64_t RendererKey;
+// Dense slot array holding the live resources of one type. Handles index the
+// slots directly; the slot generation is advanced when a resource is removed,
+// so lookups of stale handles can be caught. Freed slots are reused LIFO.
+template <typename T>
+class RendererResourcePool {
+ public:
+  typedef RendererHandle<T> Handle;
+
+  std::shared_ptr<T> Add(T* resource) {
+    uint32_t index = 0;
+    if (!free_indices_.empty()) {
+      index = free_indices_.back();
+      free_indices_.pop_back();
+    } else {
+      index = static_cast<uint32_t>(slots_.size());
+      RENDERER_ASSERT(index <= Handle::kIndexMask)
+      slots_.push_back({nullptr, 1});
+    }
+    ResourceSlot& slot = slots_[index];
+    slot.resource = std::shared_ptr<T>(resource);
+    resource->handle_ = Handle(index, slot.generation);
+    return slot.resource;
+  }
+
+  // Returns the pool reference to the resource, or nullptr if the handle is stale,
+  // and invalidates the handle
+  std::shared_ptr<T> Remove(const Handle handle) {
+    if (!IsValid(handle)) {
+      return nullptr;
+    }
+    ResourceSlot& slot = slots_[handle.GetIndex()];
+    std::shared_ptr<T> resource = std::move(slot.resource);
+    slot.resource = nullptr;
+    // Generation zero is reserved for the invalid handle
+    slot.generation = (slot.generation % Handle::kGenerationMask) + 1;
+    free_indices_.push_back(handle.GetIndex());
+    return resource;
+  }
+
+  bool IsValid(const Handle handle) const {
+    return handle.IsValid() && handle.GetIndex() < slots_.size() &&
+           slots_[handle.GetIndex()].generation == handle.GetGeneration();
+  }
+
+  // Returns whether the handle is live, asserting in debug builds if it is not.
+  // Release builds return false so callers can skip the stale handle.
+  bool Validate(const Handle handle) const {
+    if (IsValid(handle)) {
+      return true;
+    }
+#if !defined(NDEBUG)
+    RENDERER_ERROR("Stale or invalid resource handle 0x%x", handle.GetValue())
+    RENDERER_ASSERT(false)
+#endif
+    return false;
+  }
+
+  // Stale handles are only validated in debug builds, callers that can be
+  // passed a stale handle in release builds must check Validate first
+  const std::shared_ptr<T>& Get(const Handle handle) const {
+#if !defined(NDEBUG)
+    Validate(handle);
+#endif
+    return slots_[handle.GetIndex()].resource;
+  }
+
+  template <typename Func>
+  void ForEach(Func func) const {
+    for (const ResourceSlot& slot : slots_) {
+      if (slot.resource) {
+        func(*slot.resource);
+      }
+    }
+  }
+
+ private:
+  struct ResourceSlot {
+    std::shared_ptr<T> resource;
+    uint32_t generation;
+  };
+
+  std::vector<ResourceSlot> slots_;
+  std::vector<uint32_t> free_indices_;
+};
 
 class RendererResources {
  public:
+  // Resource creation and destruction is counted in stats
+  explicit RendererResources(RendererStats& stats);
+
+  // Sets the frame that resources queued for deletion from now on are tagged
+  // with, and deletes the queued resources whose frame is no later than
+  // completed_frame_number, as the GPU can no longer be referencing them
+  void BeginFrame(const uint64_t frame_number, const uint64_t completed_frame_number);
+
+  // Deletes all queued resources regardless of their frame, for backends whose
+  // API defers deletion internally or after the GPU has been idled
   void ProcessDeleteQueue();
 
   std::shared_ptr<IndexBuffer> AddIndexBuffer(IndexBuffer* index_buffer);
   void QueueDeleteIndexBuffer(const std::shared_ptr<IndexBuffer>& index_buffer);
+  const std::shared_ptr<IndexBuffer>& GetIndexBuffer(const IndexBufferHandle handle) const {
+    return index_buffers_.Get(handle);
+  }
+  bool Validate(const IndexBufferHandle handle) const {
+    return index_buffers_.Validate(handle);
+  }
+
+  std::shared_ptr<RecordingContext> AddRecordingContext(RecordingContext* recording_context);
+  void QueueDeleteRecordingContext(const std::shared_ptr<RecordingContext>& recording_context);
 
   std::shared_ptr<RenderPass> AddRenderPass(RenderPass* render_pass);
   void QueueDeleteRenderPass(const std::shared_ptr<RenderPass>& render_pass);
+  const std::shared_ptr<RenderPass>& GetRenderPass(const RenderPassHandle handle) const {
+    return render_passes_.Get(handle);
+  }
+  bool Validate(const RenderPassHandle handle) const {
+    return render_passes_.Validate(handle);
+  }
 
   std::shared_ptr<RenderState> AddRenderState(RenderState* render_state);
   void QueueDeleteRenderState(const std::shared_ptr<RenderState>& render_state);
+  const std::shared_ptr<RenderState>& GetRenderState(const RenderStateHandle handle) const {
+    return render_states_.Get(handle);
+  }
+  bool Validate(const RenderStateHandle handle) const {
+    return render_states_.Validate(handle);
+  }
 
   std::shared_ptr<ShaderProgram> AddShaderProgram(ShaderProgram* shader_program);
   void QueueDeleteShaderProgram(const std::shared_ptr<ShaderProgram>& shader_program);
 
   std::shared_ptr<Texture> AddTexture(Texture* texture);
   void QueueDeleteTexture(const std::shared_ptr<Texture>& texture);
+  const std::shared_ptr<Texture>& GetTexture(const TextureHandle handle) const {
+    return textures_.Get(handle);
+  }
+  bool Validate(const TextureHandle handle) const {
+    return textures_.Validate(handle);
+  }
 
   std::shared_ptr<UniformBuffer> AddUniformBuffer(UniformBuffer* uniform_buffer);
   void QueueDeleteUniformBuffer(const std::shared_ptr<UniformBuffer>& uniform_buffer);
 
   std::shared_ptr<VertexBuffer> AddVertexBuffer(VertexBuffer* vertex_buffer);
   void QueueDeleteVertexBuffer(const std::shared_ptr<VertexBuffer>& vertex_buffer);
+  const std::shared_ptr<VertexBuffer>& GetVertexBuffer(const VertexBufferHandle handle) const {
+    return vertex_buffers_.Get(handle);
+  }
+  bool Validate(const VertexBufferHandle handle) const {
+    return vertex_buffers_.Validate(handle);
+  }
 
-  auto &GetRenderPasses() {
+  const RendererResourcePool<RenderPass>& GetRenderPasses() const {
     return render_passes_;
   }
 
  private:
-  std::unordered_map<RendererKey, std::shared_ptr<IndexBuffer> > index_buffers_;
-  std::unordered_map<RendererKey, std::shared_ptr<RenderPass> > render_passes_;
-  std::unordered_map<RendererKey, std::shared_ptr<RenderState> > render_states_;
-  std::unordered_map<RendererKey, std::shared_ptr<ShaderProgram> > shader_programs_;
-  std::unordered_map<RendererKey, std::shared_ptr<Texture> > textures_;
-  std::unordered_map<RendererKey, std::shared_ptr<UniformBuffer> > uniform_buffers_;
-  std::unordered_map<RendererKey, std::shared_ptr<VertexBuffer> > vertex_buffers_;
-
-  std::queue< std::shared_ptr<IndexBuffer> > index_buffer_delete_queue_;
-  std::queue< std::shared_ptr<RenderPass> > render_pass_delete_queue_;
-  std::queue< std::shared_ptr<RenderState> > render_state_delete_queue_;
-  std::queue< std::shared_ptr<ShaderProgram> > shader_program_delete_queue_;
-  std::queue< std::shared_ptr<Texture> > texture_delete_queue_;
-  std::queue< std::shared_ptr<UniformBuffer> > uniform_buffer_delete_queue_;
-  std::queue< std::shared_ptr<VertexBuffer> > vertex_buffer_delete_queue_;
+  template <typename T>
+  struct PendingDelete {
+    uint64_t frame_number;
+    std::shared_ptr<T> resource;
+  };
+
+  template <typename T>
+  using DeleteQueue = std::queue< PendingDelete<T> >;
+
+  template <typename T>
+  void QueueDelete(RendererResourcePool<T>& pool, DeleteQueue<T>& queue,
+                   const std::shared_ptr<T>& resource);
+
+  template <typename T>
+  void RetireDeletes(DeleteQueue<T>& queue, const uint64_t completed_frame_number);
+
+  void RetireAllDeletes(const uint64_t completed_frame_number);
+
+  RendererStats& stats_;
+  uint64_t frame_number_;
+
+  RendererResourcePool<IndexBuffer> index_buffers_;
+  RendererResourcePool<RecordingContext> recording_contexts_;
+  RendererResourcePool<RenderPass> render_passes_;
+  RendererResourcePool<RenderState> render_states_;
+  RendererResourcePool<ShaderProgram> shader_programs_;
+  RendererResourcePool<Texture> textures_;
+  RendererResourcePool<UniformBuffer> uniform_buffers_;
+  RendererResourcePool<VertexBuffer> vertex_buffers_;
+
+  DeleteQueue<IndexBuffer> index_buffer_delete_queue_;
+  DeleteQueue<RecordingContext> recording_context_delete_queue_;
+  DeleteQueue<RenderPass> render_pass_delete_queue_;
+  DeleteQueue<RenderState> render_state_delete_queue_;
+  DeleteQueue<ShaderProgram> shader_program_delete_queue_;
+  DeleteQueue<Texture> texture_delete_queue_;
+  DeleteQueue<UniformBuffer> uniform_buffer_delete_queue_;
+  DeleteQueue<VertexBuffer> vertex_buffer_delete_queue_;
 };
 
 }
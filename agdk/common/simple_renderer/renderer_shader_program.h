@@ -20,15 +20,24 @@
 #include <cstdint>
 #include <string>
 
+#include "renderer_handle.h"
+
 namespace simple_renderer
 {
 /**
  * @brief The base class definition for the `ShaderProgram` class of SimpleRenderer.
  * Use the `Renderer` class interface to create and destroy `ShaderProgram` objects.
  * Currently all shader programs consist of a paired vertex shader and fragment shader.
+ * Shader sources can declare feature keywords, a program is created as the variant of
+ * the sources with a specific set of keywords enabled, see `ShaderVariantCache`.
  */
 class ShaderProgram {
  public:
+  /**
+   * @brief The maximum number of feature keywords of a shader program.
+   */
+  static constexpr uint32_t kMaxFeatureKeywords = 32;
+
   /**
    * @brief A structure holding required parameters to create a new `ShaderProgram`.
    * Passed to the Renderer::CreateShaderProgram function.
@@ -42,6 +51,18 @@ class ShaderProgram {
     size_t fragment_data_byte_count;
     /** @brief Size of the vertex shader data array in bytes */
     size_t vertex_data_byte_count;
+    /**
+     * @brief An array of the feature keyword names declared by the shaders, bit i of
+     * `feature_mask` enables the keyword at index i. GLES shader source is compiled with
+     * `#define <keyword> 0|1` lines inserted after its `#version` line. SPIR-V shaders
+     * declare each keyword as a bool specialization constant with `constant_id` i.
+     * May be nullptr if `feature_keyword_count` is 0.
+     */
+    const char* const* feature_keywords;
+    /** @brief Number of entries in the feature keywords array, up to ::kMaxFeatureKeywords */
+    uint32_t feature_keyword_count;
+    /** @brief Bitmask of the feature keywords enabled in the program */
+    uint32_t feature_mask;
   };
 
   /**
@@ -65,20 +86,39 @@ class ShaderProgram {
    */
   void SetVertexDebugName(const std::string& name) { vertex_debug_name_ = name; }
 
+  /**
+   * @brief Retrieve the bitmask of feature keywords the program was created with
+   * @result The `feature_mask` of the creation parameters.
+   */
+  uint32_t GetFeatureMask() const { return feature_mask_; }
+
   /**
    * @brief Base class destructor, do not call directly.
    */
   virtual ~ShaderProgram() {}
 
+  /**
+   * @brief Retrieve the handle identifying the `ShaderProgram` in the resource pool of
+   * the `Renderer`. The handle becomes stale once the `ShaderProgram` is destroyed.
+   * @return A `ShaderProgramHandle`.
+   */
+  ShaderProgramHandle GetHandle() const { return handle_; }
+
  protected:
   ShaderProgram() {
     fragment_debug_name_ = "noname";
     vertex_debug_name_ = "noname";
+    feature_mask_ = 0;
   }
 
+  uint32_t feature_mask_;
+
  private:
   std::string fragment_debug_name_;
   std::string vertex_debug_name_;
+
+  template <typename T> friend class RendererResourcePool;
+  ShaderProgramHandle handle_;
 };
 }
 
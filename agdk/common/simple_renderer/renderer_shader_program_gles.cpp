@@ -17,6 +17,8 @@
 #include "renderer_shader_program_gles.h"
 #include "renderer_debug.h"
 
+#include <string>
+
 namespace simple_renderer {
 
 static bool CheckProgramStatus(GLuint program_handle) {
@@ -49,23 +51,59 @@ static bool CheckShaderStatus(GLuint shader_handle) {
   return valid;
 }
 
+// Insert a define for each feature keyword after the #version line, which must remain
+// the first line of the source
+static std::string BuildVariantSource(const void* source_data, const size_t source_byte_count,
+                                      const ShaderProgram::ShaderProgramCreationParams& params) {
+  std::string source(static_cast<const char*>(source_data), source_byte_count);
+  std::string defines;
+  for (uint32_t i = 0; i < params.feature_keyword_count; ++i) {
+    defines += "#define ";
+    defines += params.feature_keywords[i];
+    defines += ((params.feature_mask & (1U << i)) != 0) ? " 1\n" : " 0\n";
+  }
+  size_t insert_offset = 0;
+  const size_t version_offset = source.find("#version");
+  if (version_offset != std::string::npos) {
+    const size_t line_end = source.find('\n', version_offset);
+    insert_offset = (line_end != std::string::npos) ? line_end + 1 : source.size();
+  }
+  source.insert(insert_offset, defines);
+  return source;
+}
+
 ShaderProgramGLES::ShaderProgramGLES(const ShaderProgram::ShaderProgramCreationParams& params) {
+  RENDERER_ASSERT(params.feature_keyword_count <= kMaxFeatureKeywords)
   valid_program_ = false;
+  feature_mask_ = params.feature_mask;
   fragment_handle_ = glCreateShader(GL_FRAGMENT_SHADER);
   vertex_handle_ = glCreateShader(GL_VERTEX_SHADER);
   program_handle_ = glCreateProgram();
 
   if (fragment_handle_ && vertex_handle_ && program_handle_) {
+    const void* vertex_source = params.vertex_shader_data;
+    const void* fragment_source = params.fragment_shader_data;
+    std::string vertex_variant;
+    std::string fragment_variant;
+    if (params.feature_keyword_count > 0) {
+      vertex_variant = BuildVariantSource(params.vertex_shader_data,
+                                          params.vertex_data_byte_count, params);
+      fragment_variant = BuildVariantSource(params.fragment_shader_data,
+                                            params.fragment_data_byte_count, params);
+      vertex_source = vertex_variant.c_str();
+      fragment_source = fragment_variant.c_str();
+    }
+
     // Compile vertex shader
     glShaderSource(vertex_handle_, 1,
-                   reinterpret_cast<const GLchar * const *>(&params.vertex_shader_data),
+                   reinterpret_cast<const GLchar * const *>(&vertex_source),
                    nullptr);
     glCompileShader(vertex_handle_);
     valid_program_ = CheckShaderStatus(vertex_handle_);
     if (valid_program_) {
       // Compile fragment shader
       glShaderSource(fragment_handle_, 1,
-                     reinterpret_cast<const GLchar * const *>(&params.fragment_shader_data),
+                     reinterpret_cast<const GLchar * const *>(&fragment_source),
                      nullptr);
       glCompileShader(fragment_handle_);
       valid_program_ = CheckShaderStatus(fragment_handle_);
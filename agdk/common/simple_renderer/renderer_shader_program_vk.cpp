@@ -23,6 +23,7 @@ namespace simple_renderer {
 ShaderProgramVk::ShaderProgramVk(const ShaderProgram::ShaderProgramCreationParams& params) {
   RendererVk& renderer = RendererVk::GetInstanceVk();
   valid_program_ = false;
+  feature_mask_ = params.feature_mask;
   // Input SPIR-V code must be 32 bit aligned
   RENDERER_ASSERT((((uint64_t)params.vertex_shader_data) & 0x3) == 0)
   RENDERER_ASSERT((((uint64_t)params.fragment_shader_data) & 0x3) == 0)
@@ -41,6 +42,22 @@ ShaderProgramVk::ShaderProgramVk(const ShaderProgram::ShaderProgramCreationParam
                                                        nullptr, &fragment_module_);
   RENDERER_CHECK_VK(fragment_create_result, "vkCreateShaderModule (fragment)");
   valid_program_ = (vertex_create_result == VK_SUCCESS && fragment_create_result == VK_SUCCESS);
+
+  // Feature keyword i is the bool specialization constant with constant_id i, the
+  // driver removes the code of disabled features when the pipeline is compiled
+  RENDERER_ASSERT(params.feature_keyword_count <= kMaxFeatureKeywords)
+  specialization_entries_.resize(params.feature_keyword_count);
+  specialization_data_.resize(params.feature_keyword_count);
+  for (uint32_t i = 0; i < params.feature_keyword_count; ++i) {
+    specialization_entries_[i].constantID = i;
+    specialization_entries_[i].offset = i * sizeof(VkBool32);
+    specialization_entries_[i].size = sizeof(VkBool32);
+    specialization_data_[i] = ((params.feature_mask & (1U << i)) != 0) ? VK_TRUE : VK_FALSE;
+  }
+  specialization_info_.mapEntryCount = params.feature_keyword_count;
+  specialization_info_.pMapEntries = specialization_entries_.data();
+  specialization_info_.dataSize = specialization_data_.size() * sizeof(VkBool32);
+  specialization_info_.pData = specialization_data_.data();
 }
 
 ShaderProgramVk::~ShaderProgramVk() {
@@ -18,6 +18,7 @@
 #define SIMPLERENDERER_SHADER_PROGRAM_VK_H_
 
 #include <cstdint>
+#include <vector>
 #include "renderer_vk_includes.h"
 #include "renderer_shader_program.h"
 
@@ -30,10 +31,18 @@ class ShaderProgramVk : public ShaderProgram {
 
   VkShaderModule GetVertexModule() const { return vertex_module_; }
   VkShaderModule GetFragmentModule() const { return fragment_module_; }
+  // Feature keyword values for the specialization constants of both stages,
+  // nullptr if the program has no feature keywords
+  const VkSpecializationInfo* GetSpecializationInfo() const {
+    return specialization_entries_.empty() ? nullptr : &specialization_info_;
+  }
 
  private:
   VkShaderModule vertex_module_;
   VkShaderModule fragment_module_;
+  std::vector<VkSpecializationMapEntry> specialization_entries_;
+  std::vector<VkBool32> specialization_data_;
+  VkSpecializationInfo specialization_info_;
   bool valid_program_;
 };
 } // namespace simple_renderer
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "renderer_shader_variant_cache.h"
+#include "renderer_debug.h"
+#include "renderer_interface.h"
+
+#include <cstring>
+
+namespace simple_renderer {
+
+ShaderVariantCache::ShaderVariantCache(const ShaderProgram::ShaderProgramCreationParams& params,
+                                       const char* const* feature_keywords,
+                                       const uint32_t feature_keyword_count) :
+    vertex_data_(),
+    fragment_data_(),
+    vertex_data_byte_count_(params.vertex_data_byte_count),
+    fragment_data_byte_count_(params.fragment_data_byte_count),
+    feature_keywords_(),
+    feature_keyword_names_(),
+    variants_() {
+  RENDERER_ASSERT(feature_keyword_count <= ShaderProgram::kMaxFeatureKeywords)
+  CopyShaderData(params.vertex_shader_data, params.vertex_data_byte_count, vertex_data_);
+  CopyShaderData(params.fragment_shader_data, params.fragment_data_byte_count, fragment_data_);
+  feature_keywords_.reserve(feature_keyword_count);
+  for (uint32_t i = 0; i < feature_keyword_count; ++i) {
+    feature_keywords_.push_back(feature_keywords[i]);
+  }
+  for (const std::string& keyword : feature_keywords_) {
+    feature_keyword_names_.push_back(keyword.c_str());
+  }
+}
+
+ShaderVariantCache::~ShaderVariantCache() {
+  DestroyVariants();
+}
+
+void ShaderVariantCache::CopyShaderData(const void* data, const size_t byte_count,
+                                        std::vector<uint32_t>& storage) {
+  storage.assign((byte_count / sizeof(uint32_t)) + 1, 0);
+  memcpy(storage.data(), data, byte_count);
+}
+
+std::shared_ptr<ShaderProgram> ShaderVariantCache::GetVariant(const uint32_t feature_mask) {
+  // Bits without a keyword have no effect, don't create duplicate variants for them
+  const uint32_t keyword_mask = (feature_keywords_.size() < 32) ?
+      ((1U << feature_keywords_.size()) - 1) : 0xFFFFFFFFU;
+  const uint32_t variant_mask = feature_mask & keyword_mask;
+  auto iter = variants_.find(variant_mask);
+  if (iter != variants_.end()) {
+    return iter->second;
+  }
+
+  ShaderProgram::ShaderProgramCreationParams params = {
+      fragment_data_.data(),
+      vertex_data_.data(),
+      fragment_data_byte_count_,
+      vertex_data_byte_count_,
+      feature_keyword_names_.data(),
+      static_cast<uint32_t>(feature_keyword_names_.size()),
+      variant_mask
+  };
+  std::shared_ptr<ShaderProgram> program = Renderer::GetInstance().CreateShaderProgram(params);
+  variants_.insert({variant_mask, program});
+  return program;
+}
+
+void ShaderVariantCache::DestroyVariants() {
+  if (variants_.empty()) {
+    return;
+  }
+  Renderer& renderer = Renderer::GetInstance();
+  for (auto& variant : variants_) {
+    renderer.DestroyShaderProgram(variant.second);
+  }
+  variants_.clear();
+}
+
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SIMPLERENDERER_SHADER_VARIANT_CACHE_H_
+#define SIMPLERENDERER_SHADER_VARIANT_CACHE_H_
+
+#include "renderer_shader_program.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace simple_renderer {
+
+/**
+ * @brief A `ShaderVariantCache` owns a copy of the vertex and fragment shader data of a
+ * program and the feature keywords the shaders declare, and creates a `ShaderProgram` for
+ * each combination of keywords the first time it is requested. Variants let shaders
+ * replace dynamic branches and uniforms that are constant for a render state with
+ * keywords that are resolved when the program is compiled. On Vulkan all variants share
+ * one SPIR-V module pair specialized at pipeline creation.
+ */
+class ShaderVariantCache {
+ public:
+  /**
+   * @brief Create a cache for the specified shaders. The shader data is copied, the
+   * `feature_keywords` and `feature_mask` members of `params` are ignored. No programs
+   * are created until ::GetVariant is called.
+   * @param params Creation parameters of the shader programs.
+   * @param feature_keywords An array of the feature keyword names declared by the shaders,
+   * keyword i is enabled by bit i of a feature mask.
+   * @param feature_keyword_count Number of entries in `feature_keywords`, up to
+   * ShaderProgram::kMaxFeatureKeywords.
+   */
+  ShaderVariantCache(const ShaderProgram::ShaderProgramCreationParams& params,
+                     const char* const* feature_keywords,
+                     const uint32_t feature_keyword_count);
+
+  /**
+   * @brief Destroys the variant programs through the `Renderer`.
+   */
+  ~ShaderVariantCache();
+
+  /**
+   * @brief Retrieve the program with the specified feature keywords enabled, creating it
+   * if this is the first request for the combination.
+   * @param feature_mask Bitmask of the feature keywords to enable.
+   * @return A shared pointer to a renderer `ShaderProgram`.
+   */
+  std::shared_ptr<ShaderProgram> GetVariant(const uint32_t feature_mask);
+
+  /**
+   * @brief Retrieve the number of variants created by the cache.
+   * @return The number of variants.
+   */
+  size_t GetVariantCount() const { return variants_.size(); }
+
+  /**
+   * @brief Destroy all the variant programs through the `Renderer`. Render states
+   * referencing them keep them alive until the render states are destroyed.
+   */
+  void DestroyVariants();
+
+ private:
+  // Word storage keeps SPIR-V aligned, and always leaves room for a terminator
+  // after GLES source text
+  static void CopyShaderData(const void* data, const size_t byte_count,
+                             std::vector<uint32_t>& storage);
+
+  std::vector<uint32_t> vertex_data_;
+  std::vector<uint32_t> fragment_data_;
+  size_t vertex_data_byte_count_;
+  size_t fragment_data_byte_count_;
+  std::vector<std::string> feature_keywords_;
+  std::vector<const char*> feature_keyword_names_;
+  std::unordered_map<uint32_t, std::shared_ptr<ShaderProgram> > variants_;
+};
+
+}
+
+#endif // SIMPLERENDERER_SHADER_VARIANT_CACHE_H_
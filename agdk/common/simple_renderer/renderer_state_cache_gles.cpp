@@ -0,0 +1,342 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "renderer_state_cache_gles.h"
+#include "renderer_debug.h"
+
+namespace simple_renderer {
+
+StateCacheGLES::StateCacheGLES() :
+    counters_({0, 0}),
+    program_uniform_owners_(),
+    vertex_attributes_owner_(nullptr),
+    vertex_attributes_buffer_(0),
+    vertex_attributes_base_vertex_(0),
+    valid_mask_(0),
+    vertex_attributes_known_(0),
+    vertex_attributes_enabled_(kAllVertexAttributesMask),
+    program_(0),
+    array_buffer_(0),
+    element_array_buffer_(0),
+    uniform_buffer_(0),
+    uniform_buffer_range_buffer_(0),
+    uniform_buffer_range_offset_(0),
+    uniform_buffer_range_size_(0),
+    texture_(0),
+    blend_src_factor_(GL_ONE),
+    blend_dst_factor_(GL_ZERO),
+    cull_face_(GL_BACK),
+    front_face_(GL_CCW),
+    depth_func_(GL_LESS),
+    depth_mask_(GL_TRUE),
+    depth_range_near_(0.0f),
+    depth_range_far_(1.0f),
+    line_width_(1.0f),
+    scissor_(),
+    viewport_(),
+    capabilities_(),
+    enabled_(true) {
+}
+
+StateCacheGLES::~StateCacheGLES() {
+}
+
+void StateCacheGLES::Invalidate() {
+  valid_mask_ = 0;
+  // Attributes may have been left enabled by the previous frame or by other code,
+  // treat every location as possibly enabled so DisableVertexAttributes disables it
+  vertex_attributes_known_ = 0;
+  vertex_attributes_enabled_ = kAllVertexAttributesMask;
+  vertex_attributes_owner_ = nullptr;
+  program_uniform_owners_.clear();
+}
+
+void StateCacheGLES::InvalidateBufferBinding(const GLenum target) {
+  if (target == GL_ARRAY_BUFFER) {
+    valid_mask_ &= ~kValid_ArrayBuffer;
+  } else if (target == GL_UNIFORM_BUFFER) {
+    valid_mask_ &= ~(kValid_UniformBuffer | kValid_UniformBufferRange);
+  } else {
+    valid_mask_ &= ~kValid_ElementArrayBuffer;
+  }
+}
+
+void StateCacheGLES::InvalidateTextureBinding() {
+  valid_mask_ &= ~kValid_Texture;
+}
+
+void StateCacheGLES::InvalidateProgram() {
+  valid_mask_ &= ~kValid_Program;
+}
+
+void StateCacheGLES::ResetCounters() {
+  counters_.issued_calls = 0;
+  counters_.elided_calls = 0;
+}
+
+bool StateCacheGLES::ElideCall(const uint32_t valid_bit, const bool state_matches) {
+  if (enabled_ && (valid_mask_ & valid_bit) != 0 && state_matches) {
+    ++counters_.elided_calls;
+    return true;
+  }
+  valid_mask_ |= valid_bit;
+  ++counters_.issued_calls;
+  return false;
+}
+
+void StateCacheGLES::UseProgram(const GLuint program) {
+  if (ElideCall(kValid_Program, program_ == program)) {
+    return;
+  }
+  program_ = program;
+  glUseProgram(program);
+  RENDERER_CHECK_GLES("glUseProgram");
+}
+
+void StateCacheGLES::BindBuffer(const GLenum target, const GLuint buffer) {
+  if (target == GL_ARRAY_BUFFER) {
+    if (ElideCall(kValid_ArrayBuffer, array_buffer_ == buffer)) {
+      return;
+    }
+    array_buffer_ = buffer;
+  } else if (target == GL_UNIFORM_BUFFER) {
+    if (ElideCall(kValid_UniformBuffer, uniform_buffer_ == buffer)) {
+      return;
+    }
+    uniform_buffer_ = buffer;
+  } else {
+    RENDERER_ASSERT(target == GL_ELEMENT_ARRAY_BUFFER)
+    if (ElideCall(kValid_ElementArrayBuffer, element_array_buffer_ == buffer)) {
+      return;
+    }
+    element_array_buffer_ = buffer;
+  }
+  glBindBuffer(target, buffer);
+  RENDERER_CHECK_GLES("glBindBuffer");
+}
+
+void StateCacheGLES::BindUniformBufferRange(const GLuint buffer, const GLintptr offset,
+                                            const GLsizeiptr size) {
+  if (ElideCall(kValid_UniformBufferRange, uniform_buffer_range_buffer_ == buffer &&
+                uniform_buffer_range_offset_ == offset && uniform_buffer_range_size_ == size)) {
+    return;
+  }
+  uniform_buffer_range_buffer_ = buffer;
+  uniform_buffer_range_offset_ = offset;
+  uniform_buffer_range_size_ = size;
+  glBindBufferRange(GL_UNIFORM_BUFFER, 0, buffer, offset, size);
+  RENDERER_CHECK_GLES("glBindBufferRange");
+  uniform_buffer_ = buffer;
+  valid_mask_ |= kValid_UniformBuffer;
+}
+
+void StateCacheGLES::BindTexture(const GLuint texture) {
+  if (ElideCall(kValid_Texture, texture_ == texture)) {
+    return;
+  }
+  texture_ = texture;
+  glBindTexture(GL_TEXTURE_2D, texture);
+  RENDERER_CHECK_GLES("glBindTexture");
+}
+
+void StateCacheGLES::SetCapability(const GLenum cap, const bool enabled) {
+  uint32_t index = kCapability_Blend;
+  switch (cap) {
+    case GL_BLEND:
+      index = kCapability_Blend;
+      break;
+    case GL_CULL_FACE:
+      index = kCapability_CullFace;
+      break;
+    case GL_DEPTH_TEST:
+      index = kCapability_DepthTest;
+      break;
+    case GL_SCISSOR_TEST:
+      index = kCapability_ScissorTest;
+      break;
+    default:
+      RENDERER_ASSERT(false)
+      break;
+  }
+  if (ElideCall(kValid_CapabilityFirst << index, capabilities_[index] == enabled)) {
+    return;
+  }
+  capabilities_[index] = enabled;
+  if (enabled) {
+    glEnable(cap);
+  } else {
+    glDisable(cap);
+  }
+}
+
+void StateCacheGLES::BlendFunc(const GLenum src_factor, const GLenum dst_factor) {
+  if (ElideCall(kValid_BlendFunc,
+                blend_src_factor_ == src_factor && blend_dst_factor_ == dst_factor)) {
+    return;
+  }
+  blend_src_factor_ = src_factor;
+  blend_dst_factor_ = dst_factor;
+  glBlendFunc(src_factor, dst_factor);
+}
+
+void StateCacheGLES::CullFace(const GLenum mode) {
+  if (ElideCall(kValid_CullFace, cull_face_ == mode)) {
+    return;
+  }
+  cull_face_ = mode;
+  glCullFace(mode);
+}
+
+void StateCacheGLES::FrontFace(const GLenum mode) {
+  if (ElideCall(kValid_FrontFace, front_face_ == mode)) {
+    return;
+  }
+  front_face_ = mode;
+  glFrontFace(mode);
+}
+
+void StateCacheGLES::DepthFunc(const GLenum func) {
+  if (ElideCall(kValid_DepthFunc, depth_func_ == func)) {
+    return;
+  }
+  depth_func_ = func;
+  glDepthFunc(func);
+}
+
+void StateCacheGLES::DepthMask(const GLboolean flag) {
+  if (ElideCall(kValid_DepthMask, depth_mask_ == flag)) {
+    return;
+  }
+  depth_mask_ = flag;
+  glDepthMask(flag);
+}
+
+void StateCacheGLES::DepthRange(const GLfloat near_depth, const GLfloat far_depth) {
+  if (ElideCall(kValid_DepthRange,
+                depth_range_near_ == near_depth && depth_range_far_ == far_depth)) {
+    return;
+  }
+  depth_range_near_ = near_depth;
+  depth_range_far_ = far_depth;
+  glDepthRangef(near_depth, far_depth);
+}
+
+void StateCacheGLES::LineWidth(const GLfloat width) {
+  if (ElideCall(kValid_LineWidth, line_width_ == width)) {
+    return;
+  }
+  line_width_ = width;
+  glLineWidth(width);
+}
+
+void StateCacheGLES::Scissor(const GLint x, const GLint y, const GLsizei width,
+                             const GLsizei height) {
+  if (ElideCall(kValid_Scissor, scissor_[0] == x && scissor_[1] == y &&
+                                scissor_[2] == width && scissor_[3] == height)) {
+    return;
+  }
+  scissor_[0] = x;
+  scissor_[1] = y;
+  scissor_[2] = width;
+  scissor_[3] = height;
+  glScissor(x, y, width, height);
+}
+
+void StateCacheGLES::Viewport(const GLint x, const GLint y, const GLsizei width,
+                              const GLsizei height) {
+  if (ElideCall(kValid_Viewport, viewport_[0] == x && viewport_[1] == y &&
+                                 viewport_[2] == width && viewport_[3] == height)) {
+    return;
+  }
+  viewport_[0] = x;
+  viewport_[1] = y;
+  viewport_[2] = width;
+  viewport_[3] = height;
+  glViewport(x, y, width, height);
+}
+
+void StateCacheGLES::SetVertexAttributeEnabled(const GLuint location, const bool enabled) {
+  if (location >= kMaxVertexAttributes) {
+    ++counters_.issued_calls;
+    if (enabled) {
+      glEnableVertexAttribArray(location);
+    } else {
+      glDisableVertexAttribArray(location);
+    }
+    return;
+  }
+
+  const uint32_t location_bit = (1U << location);
+  const bool current_enabled = (vertex_attributes_enabled_ & location_bit) != 0;
+  if (enabled_ && (vertex_attributes_known_ & location_bit) != 0 &&
+      current_enabled == enabled) {
+    ++counters_.elided_calls;
+    return;
+  }
+  ++counters_.issued_calls;
+  vertex_attributes_known_ |= location_bit;
+  if (enabled) {
+    vertex_attributes_enabled_ |= location_bit;
+    glEnableVertexAttribArray(location);
+    RENDERER_CHECK_GLES("glEnableVertexAttribArray");
+  } else {
+    vertex_attributes_enabled_ &= ~location_bit;
+    glDisableVertexAttribArray(location);
+    RENDERER_CHECK_GLES("glDisableVertexAttribArray");
+  }
+}
+
+void StateCacheGLES::DisableVertexAttributes(const uint32_t keep_mask) {
+  // Attributes in an unknown state have their enabled bit set, they are disabled
+  // with a real call the first time
+  uint32_t disable_mask = vertex_attributes_enabled_ & ~keep_mask;
+  GLuint location = 0;
+  while (disable_mask != 0) {
+    if ((disable_mask & 1U) != 0) {
+      SetVertexAttributeEnabled(location, false);
+    }
+    disable_mask >>= 1;
+    ++location;
+  }
+}
+
+bool StateCacheGLES::GetVertexAttributesCurrent(const void* owner,
+                                                const uint32_t base_vertex) const {
+  return enabled_ && vertex_attributes_owner_ == owner &&
+         (valid_mask_ & kValid_ArrayBuffer) != 0 && vertex_attributes_buffer_ == array_buffer_ &&
+         vertex_attributes_base_vertex_ == base_vertex;
+}
+
+void StateCacheGLES::SetVertexAttributesOwner(const void* owner, const uint32_t base_vertex) {
+  vertex_attributes_owner_ = owner;
+  vertex_attributes_buffer_ = array_buffer_;
+  vertex_attributes_base_vertex_ = base_vertex;
+}
+
+const void* StateCacheGLES::GetProgramUniformOwner(const GLuint program) const {
+  if (!enabled_) {
+    return nullptr;
+  }
+  auto iter = program_uniform_owners_.find(program);
+  return (iter != program_uniform_owners_.end()) ? iter->second : nullptr;
+}
+
+void StateCacheGLES::SetProgramUniformOwner(const GLuint program, const void* owner) {
+  program_uniform_owners_[program] = owner;
+}
+
+} // namespace simple_renderer
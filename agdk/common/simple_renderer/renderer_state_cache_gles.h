@@ -0,0 +1,175 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SIMPLERENDERER_STATE_CACHE_GLES_H_
+#define SIMPLERENDERER_STATE_CACHE_GLES_H_
+
+#include <cstdint>
+#include <unordered_map>
+#include <GLES3/gl3.h>
+
+namespace simple_renderer {
+
+// Shadow copy of the GL state set by the GLES renderer. State changes are routed
+// through the cache, calls that would not change the current state are elided.
+// The shadow state is invalidated at the start of every frame, since code outside
+// the renderer (ImGui, Swappy) may also modify GL state.
+// The renderer does not use vertex array objects, the default VAO is always bound
+// and its attribute enable state is shadowed instead.
+class StateCacheGLES {
+ public:
+  struct Counters {
+    // GL calls passed through to the driver
+    uint64_t issued_calls;
+    // GL calls skipped because the state was already current
+    uint64_t elided_calls;
+  };
+
+  // Shadowed attribute locations, higher locations bypass the cache
+  static constexpr GLuint kMaxVertexAttributes = 16;
+  static constexpr uint32_t kAllVertexAttributesMask = (1U << kMaxVertexAttributes) - 1;
+
+  StateCacheGLES();
+  ~StateCacheGLES();
+
+  // Forget all shadowed state, the next call of each type will be issued
+  void Invalidate();
+  // Forget individual bindings after GL calls made outside the cache
+  void InvalidateBufferBinding(const GLenum target);
+  void InvalidateTextureBinding();
+  void InvalidateProgram();
+
+  // If disabled, all calls are issued, used to measure the effect of the cache
+  void SetEnabled(const bool enabled) { enabled_ = enabled; }
+  bool GetEnabled() const { return enabled_; }
+
+  const Counters& GetCounters() const { return counters_; }
+  void ResetCounters();
+
+  // Account for calls made or skipped outside of the cache (i.e. uniform uploads)
+  void AddIssuedCalls(const uint32_t count) { counters_.issued_calls += count; }
+  void AddElidedCalls(const uint32_t count) { counters_.elided_calls += count; }
+
+  void UseProgram(const GLuint program);
+  GLuint GetProgram() const { return program_; }
+
+  // target must be GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER or GL_UNIFORM_BUFFER
+  void BindBuffer(const GLenum target, const GLuint buffer);
+  // Bind a range of a buffer to uniform buffer binding point 0, this also sets
+  // the generic GL_UNIFORM_BUFFER binding
+  void BindUniformBufferRange(const GLuint buffer, const GLintptr offset, const GLsizeiptr size);
+  // GL_TEXTURE_2D on texture unit 0
+  void BindTexture(const GLuint texture);
+
+  // cap must be GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST or GL_SCISSOR_TEST
+  void SetCapability(const GLenum cap, const bool enabled);
+  void BlendFunc(const GLenum src_factor, const GLenum dst_factor);
+  void CullFace(const GLenum mode);
+  void FrontFace(const GLenum mode);
+  void DepthFunc(const GLenum func);
+  void DepthMask(const GLboolean flag);
+  void DepthRange(const GLfloat near_depth, const GLfloat far_depth);
+  void LineWidth(const GLfloat width);
+  void Scissor(const GLint x, const GLint y, const GLsizei width, const GLsizei height);
+  void Viewport(const GLint x, const GLint y, const GLsizei width, const GLsizei height);
+
+  void SetVertexAttributeEnabled(const GLuint location, const bool enabled);
+  // Disable every attribute whose bit is not set in keep_mask and that is enabled, or
+  // in an unknown state since the last Invalidate
+  void DisableVertexAttributes(const uint32_t keep_mask);
+
+  // Vertex attribute pointers capture the GL_ARRAY_BUFFER binding at the time they
+  // are set. They are still valid if the same owner sets them for the same buffer
+  // and base vertex.
+  bool GetVertexAttributesCurrent(const void* owner, const uint32_t base_vertex) const;
+  void SetVertexAttributesOwner(const void* owner, const uint32_t base_vertex);
+
+  // Uniform values are program object state, the owner is the last render state
+  // that uploaded uniform values to the program
+  const void* GetProgramUniformOwner(const GLuint program) const;
+  void SetProgramUniformOwner(const GLuint program, const void* owner);
+
+ private:
+  enum CapabilityIndex : uint32_t {
+    kCapability_Blend = 0,
+    kCapability_CullFace,
+    kCapability_DepthTest,
+    kCapability_ScissorTest,
+    kCapability_Count
+  };
+
+  // Bits for valid_mask_, tracking which shadow values match the GL state
+  enum ValidBits : uint32_t {
+    kValid_Program = (1U << 0),
+    kValid_ArrayBuffer = (1U << 1),
+    kValid_ElementArrayBuffer = (1U << 2),
+    kValid_Texture = (1U << 3),
+    kValid_BlendFunc = (1U << 4),
+    kValid_CullFace = (1U << 5),
+    kValid_FrontFace = (1U << 6),
+    kValid_DepthFunc = (1U << 7),
+    kValid_DepthMask = (1U << 8),
+    kValid_DepthRange = (1U << 9),
+    kValid_LineWidth = (1U << 10),
+    kValid_Scissor = (1U << 11),
+    kValid_Viewport = (1U << 12),
+    kValid_UniformBuffer = (1U << 13),
+    kValid_UniformBufferRange = (1U << 14),
+    // One bit per capability from here
+    kValid_CapabilityFirst = (1U << 15)
+  };
+
+  // Returns true and counts an elided call if the shadow value is valid and
+  // matches, otherwise marks the value valid and counts an issued call
+  bool ElideCall(const uint32_t valid_bit, const bool state_matches);
+
+  Counters counters_;
+  std::unordered_map<GLuint, const void*> program_uniform_owners_;
+  const void* vertex_attributes_owner_;
+  GLuint vertex_attributes_buffer_;
+  uint32_t vertex_attributes_base_vertex_;
+  uint32_t valid_mask_;
+  // Per location bits, attributes not set in the known mask are in an unknown state
+  // and have their enabled bit set, as they may be enabled
+  uint32_t vertex_attributes_known_;
+  uint32_t vertex_attributes_enabled_;
+  GLuint program_;
+  GLuint array_buffer_;
+  GLuint element_array_buffer_;
+  GLuint uniform_buffer_;
+  GLuint uniform_buffer_range_buffer_;
+  GLintptr uniform_buffer_range_offset_;
+  GLsizeiptr uniform_buffer_range_size_;
+  GLuint texture_;
+  GLenum blend_src_factor_;
+  GLenum blend_dst_factor_;
+  GLenum cull_face_;
+  GLenum front_face_;
+  GLenum depth_func_;
+  GLboolean depth_mask_;
+  GLfloat depth_range_near_;
+  GLfloat depth_range_far_;
+  GLfloat line_width_;
+  GLint scissor_[4];
+  GLint viewport_[4];
+  bool capabilities_[kCapability_Count];
+  bool enabled_;
+};
+
+} // namespace simple_renderer
+
+#endif // SIMPLERENDERER_STATE_CACHE_GLES_H_
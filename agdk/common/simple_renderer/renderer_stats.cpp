@@ -0,0 +1,208 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "renderer_stats.h"
+#include "renderer_debug.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace simple_renderer {
+
+static const char* kStatNames[RendererStats::kStat_Count] = {
+    "draw_calls",
+    "instances",
+    "triangles",
+    "pipeline_binds",
+    "descriptor_allocations",
+    "uniform_bytes",
+    "buffer_bytes_uploaded",
+    "texture_bytes_uploaded",
+    "resources_created",
+    "resources_destroyed",
+    "begin_frame_ns",
+    "end_frame_ns",
+    "gpu_frame_ns",
+    "objects_culled",
+    "objects_visible",
+    "scene_scale_permille"
+};
+
+static constexpr RendererStats::FrameStats kZeroFrameStats = {};
+
+// Large enough for a full JSON dump line
+static constexpr size_t kDumpLineSize = 2048;
+
+RendererStats::RendererStats() :
+    history_(),
+    history_count_(0),
+    history_next_(0),
+    frame_number_(0),
+    gpu_scope_timings_(),
+    dump_interval_(0),
+    frames_until_dump_(0),
+    dump_format_(kDumpFormat_CSV),
+    dump_file_path_(),
+    dump_header_written_(false) {
+  for (uint32_t i = 0; i < kStat_Count; ++i) {
+    current_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+RendererStats::~RendererStats() {
+}
+
+void RendererStats::AddTextureUpload(const Texture::TextureCreationParams& params) {
+  uint64_t texture_bytes = 0;
+  if (params.texture_sizes != nullptr) {
+    for (uint32_t i = 0; i < params.mip_count; ++i) {
+      texture_bytes += params.texture_sizes[i];
+    }
+  }
+  Add(kStat_TextureBytesUploaded, texture_bytes);
+}
+
+void RendererStats::BeginFrame(const uint64_t frame_number) {
+  FrameStats& frame_stats = history_[history_next_];
+  frame_stats.frame_number = frame_number_;
+  for (uint32_t i = 0; i < kStat_Count; ++i) {
+    frame_stats.values[i] = current_[i].exchange(0, std::memory_order_relaxed);
+  }
+  history_next_ = (history_next_ + 1) % kHistoryFrameCount;
+  history_count_ = std::min(history_count_ + 1, kHistoryFrameCount);
+  frame_number_ = frame_number;
+
+  if (dump_interval_ > 0 && --frames_until_dump_ == 0) {
+    WriteDump();
+    frames_until_dump_ = dump_interval_;
+  }
+}
+
+const RendererStats::FrameStats& RendererStats::GetLastFrameStats() const {
+  if (history_count_ == 0) {
+    return kZeroFrameStats;
+  }
+  return history_[(history_next_ + kHistoryFrameCount - 1) % kHistoryFrameCount];
+}
+
+const RendererStats::FrameStats& RendererStats::GetHistoryFrameStats(const uint32_t index) const {
+  RENDERER_ASSERT(index < history_count_)
+  const uint32_t oldest = (history_next_ + kHistoryFrameCount - history_count_) %
+      kHistoryFrameCount;
+  return history_[(oldest + index) % kHistoryFrameCount];
+}
+
+RendererStats::StatSummary RendererStats::GetSummary(const StatType stat,
+                                                     const uint32_t frame_count) const {
+  StatSummary summary = {0.0, 0.0, 0.0};
+  const uint32_t summary_count = std::min(frame_count, history_count_);
+  if (summary_count == 0) {
+    return summary;
+  }
+
+  uint64_t min_value = UINT64_MAX;
+  uint64_t max_value = 0;
+  uint64_t total = 0;
+  for (uint32_t i = history_count_ - summary_count; i < history_count_; ++i) {
+    const uint64_t value = GetHistoryFrameStats(i).values[stat];
+    min_value = std::min(min_value, value);
+    max_value = std::max(max_value, value);
+    total += value;
+  }
+  summary.min = static_cast<double>(min_value);
+  summary.avg = static_cast<double>(total) / static_cast<double>(summary_count);
+  summary.max = static_cast<double>(max_value);
+  return summary;
+}
+
+void RendererStats::SetDumpInterval(const uint32_t frame_interval, const DumpFormat format,
+                                    const std::string& file_path) {
+  dump_interval_ = frame_interval;
+  frames_until_dump_ = frame_interval;
+  dump_format_ = format;
+  if (file_path != dump_file_path_) {
+    dump_header_written_ = false;
+  }
+  dump_file_path_ = file_path;
+}
+
+void RendererStats::SetGPUScopeTimings(const std::vector<GPUScopeTiming>& scope_timings) {
+  gpu_scope_timings_ = scope_timings;
+  if (!scope_timings.empty()) {
+    Add(kStat_GPUFrameTime, scope_timings[0].gpu_time);
+  }
+}
+
+const char* RendererStats::GetStatName(const StatType stat) {
+  return kStatNames[stat];
+}
+
+void RendererStats::WriteDump() {
+  FILE* dump_file = nullptr;
+  if (!dump_file_path_.empty()) {
+    dump_file = fopen(dump_file_path_.c_str(), "a");
+    if (dump_file == nullptr) {
+      RENDERER_ERROR("Failed to open renderer stats dump file %s", dump_file_path_.c_str())
+      dump_interval_ = 0;
+      return;
+    }
+  }
+
+  const uint64_t last_frame = GetLastFrameStats().frame_number;
+  char line[kDumpLineSize];
+  if (dump_format_ == kDumpFormat_CSV) {
+    if (dump_file != nullptr && !dump_header_written_) {
+      fputs("frame,stat,min,avg,max\n", dump_file);
+      dump_header_written_ = true;
+    }
+    for (uint32_t i = 0; i < kStat_Count; ++i) {
+      const StatType stat = static_cast<StatType>(i);
+      const StatSummary summary = GetSummary(stat, dump_interval_);
+      snprintf(line, sizeof(line), "%llu,%s,%.0f,%.2f,%.0f",
+               static_cast<unsigned long long>(last_frame), kStatNames[i],
+               summary.min, summary.avg, summary.max);
+      if (dump_file != nullptr) {
+        fprintf(dump_file, "%s\n", line);
+      } else {
+        RENDERER_LOG("RendererStats: %s", line)
+      }
+    }
+  } else {
+    int line_size = snprintf(line, sizeof(line), "{\"frame\":%llu,\"frame_count\":%u",
+                             static_cast<unsigned long long>(last_frame),
+                             std::min(dump_interval_, history_count_));
+    for (uint32_t i = 0; i < kStat_Count; ++i) {
+      const StatType stat = static_cast<StatType>(i);
+      const StatSummary summary = GetSummary(stat, dump_interval_);
+      line_size += snprintf(line + line_size, sizeof(line) - line_size,
+                            ",\"%s\":{\"min\":%.0f,\"avg\":%.2f,\"max\":%.0f}",
+                            kStatNames[i], summary.min, summary.avg, summary.max);
+    }
+    snprintf(line + line_size, sizeof(line) - line_size, "}");
+    if (dump_file != nullptr) {
+      fprintf(dump_file, "%s\n", line);
+    } else {
+      RENDERER_LOG("RendererStats: %s", line)
+    }
+  }
+
+  if (dump_file != nullptr) {
+    fclose(dump_file);
+  }
+}
+
+}
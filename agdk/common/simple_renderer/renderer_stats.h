@@ -0,0 +1,248 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SIMPLERENDERER_STATS_H_
+#define SIMPLERENDERER_STATS_H_
+
+#include "renderer_texture.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace simple_renderer {
+
+/**
+ * @brief Per-frame statistics of the work submitted through the `Renderer`.
+ * Counters for the frame in progress can be incremented from any thread. A history
+ * of completed frames is kept for querying rolling minimum, average and maximum
+ * values, and can optionally be dumped in CSV or JSON format at a fixed frame interval.
+ * Retrieve the statistics of the active renderer with Renderer::GetStats.
+ */
+class RendererStats {
+ public:
+  /**
+   * @brief The statistics recorded for each frame.
+   */
+  enum StatType : uint32_t {
+    kStat_DrawCalls = 0, ///< Number of draw calls
+    kStat_Instances, ///< Number of instances drawn by draw calls
+    kStat_Triangles, ///< Number of triangles drawn
+    kStat_PipelineBinds, ///< Number of render state (pipeline or program) changes
+    kStat_DescriptorAllocations, ///< Number of descriptor sets allocated
+    kStat_UniformBytes, ///< Bytes of push constant or uniform data delivered
+    kStat_BufferBytesUploaded, ///< Bytes of vertex and index data uploaded
+    kStat_TextureBytesUploaded, ///< Bytes of texel data uploaded
+    kStat_ResourcesCreated, ///< Number of resources created
+    kStat_ResourcesDestroyed, ///< Number of resources destroyed
+    kStat_BeginFrameTime, ///< CPU time spent in Renderer::BeginFrame, in nanoseconds
+    kStat_EndFrameTime, ///< CPU time spent in Renderer::EndFrame, in nanoseconds
+    kStat_GPUFrameTime, ///< GPU time of the most recently resolved frame, in nanoseconds
+    kStat_ObjectsCulled, ///< Number of objects rejected by application visibility culling
+    kStat_ObjectsVisible, ///< Number of objects accepted by application visibility culling
+    kStat_SceneScale, ///< Application render resolution scale, in thousandths of full resolution
+    kStat_Count ///< Count of statistic types
+  };
+
+  /**
+   * @brief File format of the periodic statistics dump.
+   */
+  enum DumpFormat : uint32_t {
+    kDumpFormat_CSV = 0, ///< One `frame,stat,min,avg,max` row per statistic
+    kDumpFormat_JSON ///< One JSON object per dump, one dump per line
+  };
+
+  /**
+   * @brief Number of completed frames kept in the statistics history.
+   */
+  static constexpr uint32_t kHistoryFrameCount = 120;
+
+  /**
+   * @brief The statistic values of a single frame.
+   */
+  struct FrameStats {
+    /** @brief Renderer frame number the statistics were recorded in */
+    uint64_t frame_number;
+    /** @brief Statistic values, indexed by `StatType` */
+    uint64_t values[kStat_Count];
+  };
+
+  /**
+   * @brief Minimum, average and maximum values of a statistic over a range of frames.
+   */
+  struct StatSummary {
+    double min;
+    double avg;
+    double max;
+  };
+
+  /**
+   * @brief GPU time of a named scope, see Renderer::BeginGPUScope.
+   */
+  struct GPUScopeTiming {
+    /** @brief Name of the scope */
+    const char* name;
+    /** @brief Nesting depth of the scope, 0 for the frame scope */
+    uint32_t depth;
+    /** @brief GPU time between the start and end of the scope, in nanoseconds */
+    uint64_t gpu_time;
+  };
+
+  /**
+   * @brief Measures the time between construction and destruction of the timer
+   * and adds it to the specified time statistic.
+   */
+  class ScopedTimer {
+   public:
+    ScopedTimer(RendererStats& stats, const StatType stat) :
+        stats_(stats), stat_(stat), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+      const std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start_;
+      stats_.Add(stat_, static_cast<uint64_t>(elapsed.count()));
+    }
+
+   private:
+    RendererStats& stats_;
+    const StatType stat_;
+    const std::chrono::steady_clock::time_point start_;
+  };
+
+  RendererStats();
+  ~RendererStats();
+
+  /**
+   * @brief Add to a statistic of the frame in progress. Safe to call from any thread.
+   * @param stat The statistic to add to.
+   * @param value The amount to add.
+   */
+  void Add(const StatType stat, const uint64_t value) {
+    current_[stat].fetch_add(value, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Add a non-instanced draw call and the triangles it draws.
+   * @param triangle_list true if the draw call renders a list of triangles.
+   * @param vertex_count Number of vertices or indices of the draw call.
+   */
+  void AddDraw(const bool triangle_list, const uint32_t vertex_count) {
+    Add(kStat_DrawCalls, 1);
+    Add(kStat_Instances, 1);
+    if (triangle_list) {
+      Add(kStat_Triangles, vertex_count / 3);
+    }
+  }
+
+  /**
+   * @brief Add the texel data of all mip levels of a texture being created.
+   * @param params The creation parameters of the texture.
+   */
+  void AddTextureUpload(const Texture::TextureCreationParams& params);
+
+  /**
+   * @brief Complete the frame in progress, adding it to the history and writing
+   * a dump if one is due, and start recording the new frame. Called by the
+   * renderer at the start of Renderer::BeginFrame.
+   * @param frame_number Renderer frame number of the new frame.
+   */
+  void BeginFrame(const uint64_t frame_number);
+
+  /**
+   * @brief Retrieve the statistics of the most recently completed frame.
+   * @return Reference to a `FrameStats` structure, all zero if no frame has completed.
+   */
+  const FrameStats& GetLastFrameStats() const;
+
+  /**
+   * @brief Retrieve the number of completed frames in the history.
+   * @return Frame count, at most `kHistoryFrameCount`.
+   */
+  uint32_t GetHistoryFrameCount() const { return history_count_; }
+
+  /**
+   * @brief Retrieve the statistics of a completed frame from the history, for plotting.
+   * @param index Index of the frame, 0 is the oldest frame in the history.
+   * @return Reference to a `FrameStats` structure.
+   */
+  const FrameStats& GetHistoryFrameStats(const uint32_t index) const;
+
+  /**
+   * @brief Calculate the minimum, average and maximum value of a statistic over the
+   * most recently completed frames.
+   * @param stat The statistic to summarize.
+   * @param frame_count Number of frames to summarize, clamped to the history size.
+   * @return A `StatSummary` structure, all zero if no frame has completed.
+   */
+  StatSummary GetSummary(const StatType stat, const uint32_t frame_count) const;
+
+  /**
+   * @brief Enable periodic dumping of the statistics summary. Every `frame_interval`
+   * frames a summary of the last `frame_interval` frames (clamped to the history size)
+   * is appended to the specified file, or written to the log if no file is specified.
+   * @param frame_interval Number of frames between dumps, 0 disables dumping.
+   * @param format File format of the dump.
+   * @param file_path Path of the file to append the dumps to, an empty string
+   * writes the dumps to the log.
+   */
+  void SetDumpInterval(const uint32_t frame_interval, const DumpFormat format,
+                       const std::string& file_path);
+
+  /**
+   * @brief Retrieve the GPU scope timings of the most recently resolved frame, in the
+   * order the scopes were opened. GPU results are read back without stalling, so they
+   * lag behind the CPU frame by the number of frames in flight. Empty if GPU timestamps
+   * are unavailable, see Renderer::kFeature_GPUTimestamps.
+   * @return Reference to an array of `GPUScopeTiming` structures.
+   */
+  const std::vector<GPUScopeTiming>& GetGPUScopeTimings() const { return gpu_scope_timings_; }
+
+  /**
+   * @brief Publish the GPU scope timings of a resolved frame, also adding the time of
+   * the frame scope to `kStat_GPUFrameTime`. Called by the renderer.
+   * @param scope_timings The scope timings, the first entry is the frame scope.
+   */
+  void SetGPUScopeTimings(const std::vector<GPUScopeTiming>& scope_timings);
+
+  /**
+   * @brief Retrieve the name of a statistic, as used in dumps.
+   * @param stat The statistic.
+   * @return A string containing the name of the statistic.
+   */
+  static const char* GetStatName(const StatType stat);
+
+ private:
+  void WriteDump();
+
+  std::atomic<uint64_t> current_[kStat_Count];
+  std::array<FrameStats, kHistoryFrameCount> history_;
+  uint32_t history_count_;
+  uint32_t history_next_;
+  uint64_t frame_number_;
+  std::vector<GPUScopeTiming> gpu_scope_timings_;
+
+  uint32_t dump_interval_;
+  uint32_t frames_until_dump_;
+  DumpFormat dump_format_;
+  std::string dump_file_path_;
+  bool dump_header_written_;
+};
+
+}
+
+#endif // SIMPLERENDERER_STATS_H_
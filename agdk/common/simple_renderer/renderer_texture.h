@@ -20,13 +20,16 @@
 #include <cstdint>
 #include <string>
 
+#include "renderer_handle.h"
+
 namespace simple_renderer
 {
 /**
  * @brief The base class definition for the `Texture` class of SimpleRenderer.
  * Use the `Renderer` class interface to create and destroy `Texture` objects.
  * `Texture` does not currently support dynamically updating texture data after
- * initial creation.
+ * initial creation. A `Texture` created with Renderer::CreateRenderTarget has no
+ * initial data and is written by a `RenderPass` that uses it as an attachment.
  */
 class Texture {
  public:
@@ -45,6 +48,10 @@ class Texture {
     kTextureFormat_ETC2,
     /** @brief Compressed ASTC texture */
     kTextureFormat_ASTC,
+    /** @brief 24 bit depth with 8 bit stencil, render targets only */
+    kTextureFormat_Depth24_Stencil8,
+    /** @brief 32 bit floating point depth, render targets only */
+    kTextureFormat_Depth32F,
     /** @brief Count of texture formats */
     kTextureFormat_Count
   };
@@ -159,6 +166,19 @@ class Texture {
     kWrapT_Count
   };
 
+  /**
+   * @brief Bitflags for the usage of a render target `Texture`
+   */
+  enum RenderTargetFlags : uint32_t {
+    /** @brief The render target can be bound with Renderer::BindTexture once the
+     * render pass writing it has ended */
+    kRenderTarget_Sampled = (1U << 0),
+    /** @brief The contents of the render target only live within a render pass and
+     * are never loaded or stored, memory is lazily allocated where supported.
+     * Cannot be combined with `kRenderTarget_Sampled` */
+    kRenderTarget_Transient = (1U << 1)
+  };
+
   /**
    * @brief A structure holding required parameters to create a new `Texture`.
    * Passed to the Renderer::CreateTextureBuffer function.
@@ -188,6 +208,30 @@ class Texture {
     const void* texture_data;
   };
 
+  /**
+   * @brief A structure holding required parameters to create a new render target
+   * `Texture`. Passed to the Renderer::CreateRenderTarget function.
+   */
+  struct RenderTargetCreationParams {
+    /** @brief Pixel format of the render target, `kTextureFormat_RGBA_8888`,
+     * `kTextureFormat_RGB_888` or one of the depth formats */
+    Texture::TextureFormat format;
+    /** @brief Minified function used when sampling the render target */
+    Texture::TextureMinFilter min_filter;
+    /** @brief Magnified function used when sampling the render target */
+    Texture::TextureMagFilter mag_filter;
+    /** @brief Width of the render target in pixels */
+    uint32_t width;
+    /** @brief Height of the render target in pixels */
+    uint32_t height;
+    /** @brief Samples per pixel, 1 for no multisampling. 4 is always supported.
+     * Multisampled render targets cannot be sampled and are resolved by the
+     * render pass that writes them */
+    uint32_t sample_count;
+    /** @brief Bitflags (RenderTargetFlags) of the render target usage */
+    uint32_t flags;
+  };
+
   /**
    * @brief Retrieve the debug name string associated with the `Texture`
    * @result A string containing the debug name.
@@ -240,17 +284,61 @@ class Texture {
     return 0;
   }
 
+  /**
+   * @brief Whether the `Texture` was created as a render target.
+   * @return true if the `Texture` is a render target
+   */
+  bool IsRenderTarget() const { return render_target_; }
+
+  /**
+   * @brief Get the render target usage flags of the `Texture`.
+   * @return Bitflags (RenderTargetFlags), 0 if the `Texture` is not a render target
+   */
+  uint32_t GetRenderTargetFlags() const { return render_target_flags_; }
+
+  /**
+   * @brief Get the samples per pixel of the `Texture`.
+   * @return The sample count of the `Texture`, 1 if not multisampled
+   */
+  uint32_t GetSampleCount() const { return texture_sample_count_; }
+
+  /**
+   * @brief Whether the pixel format of the `Texture` is a depth format.
+   * @return true if the `Texture` has a depth format
+   */
+  bool IsDepthFormat() const { return IsDepthFormat(texture_format_); }
+
+  /**
+   * @brief Whether a pixel format is a depth format.
+   * @param format The pixel format to test.
+   * @return true if the pixel format is a depth format
+   */
+  static bool IsDepthFormat(const TextureFormat format) {
+    return (format == kTextureFormat_Depth24_Stencil8 || format == kTextureFormat_Depth32F);
+  }
+
   /**
    * @brief Base class destructor, do not call directly.
    */
   virtual ~Texture() {}
 
+  /**
+   * @brief Retrieve the handle of the `Texture`. The handle can be passed to the
+   * `Renderer` bind functions instead of the shared pointer, and becomes stale once
+   * the `Texture` is destroyed.
+   * @return A `TextureHandle`.
+   */
+  TextureHandle GetHandle() const { return handle_; }
+
  protected:
   Texture(const TextureCreationParams& params)
       : texture_format_(params.format),
         texture_compression_type_(params.compression_type),
         texture_base_width_(params.base_width),
         texture_base_height_(params.base_height),
+        texture_sample_count_(1),
+        render_target_flags_(0),
+        render_target_(false),
         texture_debug_name_("noname)") {
     texture_mip_count_ = params.mip_count;
     if (params.mip_count > kMaxMipCount) {
@@ -267,11 +355,29 @@ class Texture {
     }
   }
 
+  Texture(const RenderTargetCreationParams& params)
+      : texture_format_(params.format),
+        texture_compression_type_(kTextureCompression_None),
+        texture_base_width_(params.width),
+        texture_base_height_(params.height),
+        texture_mip_count_(1),
+        texture_sample_count_((params.sample_count > 1) ? params.sample_count : 1),
+        render_target_flags_(params.flags),
+        render_target_(true),
+        texture_debug_name_("noname") {
+    for (uint32_t i = 0; i < kMaxMipCount; ++i) {
+      texture_sizes_[i] = 0;
+    }
+  }
+
  private:
   Texture()
   : texture_format_(kTextureFormat_Count),
     texture_compression_type_(kTextureCompression_Count),
-    texture_mip_count_(0) {
+    texture_mip_count_(0),
+    texture_sample_count_(1),
+    render_target_flags_(0),
+    render_target_(false) {
       for (uint32_t i = 0; i < kMaxMipCount; ++i) {
         texture_sizes_[i] = 0;
       }
@@ -283,9 +389,15 @@ class Texture {
   uint32_t texture_base_width_;
   uint32_t texture_base_height_;
   uint32_t texture_mip_count_;
+  uint32_t texture_sample_count_;
+  uint32_t render_target_flags_;
+  bool render_target_;
   size_t texture_sizes_[kMaxMipCount];
 
   std::string texture_debug_name_;
+
+  template <typename T> friend class RendererResourcePool;
+  TextureHandle handle_;
 };
 } // namespace simple_renderer
 
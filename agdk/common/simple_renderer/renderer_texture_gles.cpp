@@ -16,6 +16,7 @@
 
 #include "renderer_texture_gles.h"
 #include "renderer_debug.h"
+#include <algorithm>
 
 namespace simple_renderer {
 
@@ -84,9 +85,27 @@ static constexpr GLint kGLWrapT[Texture::kWrapT_Count] = {
     GL_MIRRORED_REPEAT
 };
 
+static GLenum GetRenderTargetGLFormat(const Texture::TextureFormat format) {
+  switch (format) {
+    case Texture::kTextureFormat_RGBA_8888:
+      return GL_RGBA8;
+    case Texture::kTextureFormat_RGB_888:
+      return GL_RGB8;
+    case Texture::kTextureFormat_Depth24_Stencil8:
+      return GL_DEPTH24_STENCIL8;
+    case Texture::kTextureFormat_Depth32F:
+      return GL_DEPTH_COMPONENT32F;
+    default:
+      RENDERER_ERROR("Unsupported render target format %u", format)
+      break;
+  }
+  return GL_RGBA8;
+}
+
 TextureGLES::TextureGLES(const Texture::TextureCreationParams& params)
                          : Texture(params) {
   texture_object_ = 0;
+  renderbuffer_object_ = 0;
 
   glGenTextures(1, &texture_object_);
   RENDERER_CHECK_GLES("glGenTextures");
@@ -134,11 +153,65 @@ TextureGLES::TextureGLES(const Texture::TextureCreationParams& params)
   RENDERER_CHECK_GLES("glBindTexture");
 }
 
-TextureGLES::~TextureGLES() {
-  glBindTexture(GL_TEXTURE_2D, 0);
-  RENDERER_CHECK_GLES("glBindTexture");
-  glDeleteTextures(1, &texture_object_);
-  RENDERER_CHECK_GLES("glDeleteTextures");
+TextureGLES::TextureGLES(const Texture::RenderTargetCreationParams& params)
+                         : Texture(params) {
   texture_object_ = 0;
+  renderbuffer_object_ = 0;
+
+  const bool is_sampled = ((params.flags & kRenderTarget_Sampled) != 0);
+  RENDERER_ASSERT(!(is_sampled && (params.flags & kRenderTarget_Transient) != 0))
+  // GLES 3.0 has no multisampled textures, multisampled targets are resolved with a blit
+  RENDERER_ASSERT(!(is_sampled && GetSampleCount() > 1))
+  const GLenum internal_format = GetRenderTargetGLFormat(params.format);
+
+  if (is_sampled) {
+    glGenTextures(1, &texture_object_);
+    RENDERER_CHECK_GLES("glGenTextures");
+    glBindTexture(GL_TEXTURE_2D, texture_object_);
+    RENDERER_CHECK_GLES("glBindTexture");
+    glTexStorage2D(GL_TEXTURE_2D, 1, internal_format, params.width, params.height);
+    RENDERER_CHECK_GLES("glTexStorage2D");
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, kGLMinFilters[params.min_filter]);
+    RENDERER_CHECK_GLES("glTexParameteri");
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, kGLMagFilters[params.mag_filter]);
+    RENDERER_CHECK_GLES("glTexParameteri");
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    RENDERER_CHECK_GLES("glTexParameteri");
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    RENDERER_CHECK_GLES("glTexParameteri");
+    glBindTexture(GL_TEXTURE_2D, 0);
+    RENDERER_CHECK_GLES("glBindTexture");
+  } else {
+    // Renderbuffers that are invalidated at the end of each pass never leave
+    // tile memory on tiled GPUs, which is the GLES equivalent of a transient attachment
+    GLint max_samples = 1;
+    glGetIntegerv(GL_MAX_SAMPLES, &max_samples);
+    const GLsizei samples = (GetSampleCount() > 1) ?
+        std::min(static_cast<GLsizei>(GetSampleCount()), static_cast<GLsizei>(max_samples)) : 0;
+    glGenRenderbuffers(1, &renderbuffer_object_);
+    RENDERER_CHECK_GLES("glGenRenderbuffers");
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer_object_);
+    RENDERER_CHECK_GLES("glBindRenderbuffer");
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, internal_format,
+                                     params.width, params.height);
+    RENDERER_CHECK_GLES("glRenderbufferStorageMultisample");
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    RENDERER_CHECK_GLES("glBindRenderbuffer");
+  }
+}
+
+TextureGLES::~TextureGLES() {
+  if (texture_object_ != 0) {
+    glBindTexture(GL_TEXTURE_2D, 0);
+    RENDERER_CHECK_GLES("glBindTexture");
+    glDeleteTextures(1, &texture_object_);
+    RENDERER_CHECK_GLES("glDeleteTextures");
+    texture_object_ = 0;
+  }
+  if (renderbuffer_object_ != 0) {
+    glDeleteRenderbuffers(1, &renderbuffer_object_);
+    RENDERER_CHECK_GLES("glDeleteRenderbuffers");
+    renderbuffer_object_ = 0;
+  }
 }
 }
\ No newline at end of file
@@ -26,12 +26,16 @@ namespace simple_renderer
 class TextureGLES : public Texture {
  public:
   TextureGLES(const Texture::TextureCreationParams& params);
+  TextureGLES(const Texture::RenderTargetCreationParams& params);
   virtual ~TextureGLES();
 
   GLuint GetTextureObject() const { return texture_object_; }
+  // Render targets that can't be sampled are renderbuffers instead of textures
+  GLuint GetRenderbufferObject() const { return renderbuffer_object_; }
 
  private:
   GLuint texture_object_;
+  GLuint renderbuffer_object_;
 };
 } // namespace simple_renderer
 
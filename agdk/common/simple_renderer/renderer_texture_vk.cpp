@@ -115,17 +115,46 @@ static VkFormat GetTextureVkFormat(const Texture::TextureCreationParams& params)
   return texture_format;
 }
 
+static VkFormat GetRenderTargetVkFormat(const Texture::TextureFormat format) {
+  switch (format) {
+    case Texture::kTextureFormat_RGBA_8888:
+      return VK_FORMAT_R8G8B8A8_UNORM;
+    case Texture::kTextureFormat_RGB_888:
+      return VK_FORMAT_R8G8B8_UNORM;
+    case Texture::kTextureFormat_Depth24_Stencil8: {
+      // D24S8 is not supported by every Android GPU, fall back to D32S8
+      VkFormatProperties format_properties = {};
+      vkGetPhysicalDeviceFormatProperties(RendererVk::GetInstanceVk().GetPhysicalDevice(),
+                                          VK_FORMAT_D24_UNORM_S8_UINT, &format_properties);
+      if ((format_properties.optimalTilingFeatures &
+          VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) != 0) {
+        return VK_FORMAT_D24_UNORM_S8_UINT;
+      }
+      return VK_FORMAT_D32_SFLOAT_S8_UINT;
+    }
+    case Texture::kTextureFormat_Depth32F:
+      return VK_FORMAT_D32_SFLOAT;
+    default:
+      RENDERER_ERROR("Unsupported render target format %u", format)
+      break;
+  }
+  return VK_FORMAT_R8G8B8A8_UNORM;
+}
+
 TextureVk::TextureVk(const Texture::TextureCreationParams& params)
     : Texture(params)
     , image_(VK_NULL_HANDLE)
     , image_view_(VK_NULL_HANDLE)
     , image_alloc_(VK_NULL_HANDLE)
-    , sampler_(VK_NULL_HANDLE) {
+    , sampler_(VK_NULL_HANDLE)
+    , image_format_(VK_FORMAT_UNDEFINED)
+    , image_layout_(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
 
   RendererVk &renderer = RendererVk::GetInstanceVk();
   VmaAllocator allocator = renderer.GetAllocator();
 
   const VkFormat texture_format = GetTextureVkFormat(params);
+  image_format_ = texture_format;
 
   // Create a staging buffer for the texture data
   VkBufferCreateInfo create_info = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
@@ -226,11 +255,146 @@ TextureVk::TextureVk(const Texture::TextureCreationParams& params)
                                                          nullptr, &image_view_);
   RENDERER_CHECK_VK(create_view_result, "vkCreateImageView");
 
+  CreateSampler(kVkMinFilters[params.min_filter], kVkMagFilters[params.mag_filter],
+                kVkMipmapMode[params.min_filter], kVkWrapS[params.wrap_s], kVkWrapT[params.wrap_t]);
+}
+
+TextureVk::TextureVk(const Texture::RenderTargetCreationParams& params)
+    : Texture(params)
+    , image_(VK_NULL_HANDLE)
+    , image_view_(VK_NULL_HANDLE)
+    , image_alloc_(VK_NULL_HANDLE)
+    , sampler_(VK_NULL_HANDLE)
+    , image_format_(GetRenderTargetVkFormat(params.format))
+    , image_layout_(VK_IMAGE_LAYOUT_UNDEFINED) {
+  RendererVk &renderer = RendererVk::GetInstanceVk();
+  VmaAllocator allocator = renderer.GetAllocator();
+
+  const bool is_depth = IsDepthFormat();
+  const bool is_sampled = ((params.flags & kRenderTarget_Sampled) != 0);
+  const bool is_transient = ((params.flags & kRenderTarget_Transient) != 0);
+  RENDERER_ASSERT(!(is_sampled && is_transient))
+  // Sampling multisampled images would need sampler2DMS support in the shaders
+  RENDERER_ASSERT(!(is_sampled && GetSampleCount() > 1))
+  // Depth and stencil can't be read through one image view
+  RENDERER_ASSERT(!(is_sampled && params.format == kTextureFormat_Depth24_Stencil8))
+
+  VkImageUsageFlags usage = is_depth ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT :
+                                       VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+  if (is_sampled) {
+    usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+    image_layout_ = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  } else {
+    image_layout_ = is_depth ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL :
+                               VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+  }
+  if (is_transient) {
+    usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+  }
+
+  VkImageCreateInfo image_create_info = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+  image_create_info.imageType = VK_IMAGE_TYPE_2D;
+  image_create_info.extent.width = params.width;
+  image_create_info.extent.height = params.height;
+  image_create_info.extent.depth = 1;
+  image_create_info.mipLevels = 1;
+  image_create_info.arrayLayers = 1;
+  image_create_info.format = image_format_;
+  image_create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+  image_create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  image_create_info.usage = usage;
+  image_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  image_create_info.samples = GetSampleCountVk();
+  image_create_info.flags = 0;
+
+  // Transient attachments live in tile memory on tiled GPUs and never need
+  // backing memory, lazily allocated memory types may not exist elsewhere
+  VmaAllocationCreateInfo image_alloc_create_info = {};
+  image_alloc_create_info.usage = is_transient ? VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED :
+                                                 VMA_MEMORY_USAGE_AUTO;
+  VkResult image_alloc_result = vmaCreateImage(allocator, &image_create_info,
+                                               &image_alloc_create_info, &image_,
+                                               &image_alloc_, nullptr);
+  if (image_alloc_result != VK_SUCCESS && is_transient) {
+    image_alloc_create_info.usage = VMA_MEMORY_USAGE_AUTO;
+    image_alloc_result = vmaCreateImage(allocator, &image_create_info,
+                                        &image_alloc_create_info, &image_,
+                                        &image_alloc_, nullptr);
+  }
+  RENDERER_CHECK_VK(image_alloc_result, "vmaCreateImage (render target)");
+
+  VkImageAspectFlags aspect_mask = VK_IMAGE_ASPECT_COLOR_BIT;
+  if (is_depth) {
+    aspect_mask = VK_IMAGE_ASPECT_DEPTH_BIT;
+    if (params.format == kTextureFormat_Depth24_Stencil8) {
+      aspect_mask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+  }
+
+  // Move the image to the layout render passes expect to find it in, so the
+  // first pass can load it the same as any later one
+  VkCommandBuffer command_buffer = renderer.BeginStagingCommandBuffer();
+  VkImageMemoryBarrier image_memory_barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+  image_memory_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  image_memory_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  image_memory_barrier.subresourceRange.aspectMask = aspect_mask;
+  image_memory_barrier.subresourceRange.baseMipLevel = 0;
+  image_memory_barrier.subresourceRange.levelCount = 1;
+  image_memory_barrier.subresourceRange.baseArrayLayer = 0;
+  image_memory_barrier.subresourceRange.layerCount = 1;
+  image_memory_barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  image_memory_barrier.newLayout = image_layout_;
+  image_memory_barrier.image = image_;
+  image_memory_barrier.srcAccessMask = 0;
+  image_memory_barrier.dstAccessMask = 0;
+  vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                       VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr,
+                       1, &image_memory_barrier);
+  renderer.EndStagingCommandBuffer();
+
+  VkImageViewCreateInfo view_create_info = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+  view_create_info.image = image_;
+  view_create_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+  view_create_info.format = image_format_;
+  view_create_info.subresourceRange.aspectMask = aspect_mask;
+  view_create_info.subresourceRange.baseMipLevel = 0;
+  view_create_info.subresourceRange.levelCount = 1;
+  view_create_info.subresourceRange.baseArrayLayer = 0;
+  view_create_info.subresourceRange.layerCount = 1;
+  const VkResult create_view_result = vkCreateImageView(renderer.GetDevice(), &view_create_info,
+                                                        nullptr, &image_view_);
+  RENDERER_CHECK_VK(create_view_result, "vkCreateImageView (render target)");
+
+  if (is_sampled) {
+    CreateSampler(kVkMinFilters[params.min_filter], kVkMagFilters[params.mag_filter],
+                  VK_SAMPLER_MIPMAP_MODE_NEAREST, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+                  VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+  }
+}
+
+VkSampleCountFlagBits TextureVk::GetSampleCountVk() const {
+  switch (GetSampleCount()) {
+    case 1: return VK_SAMPLE_COUNT_1_BIT;
+    case 2: return VK_SAMPLE_COUNT_2_BIT;
+    case 4: return VK_SAMPLE_COUNT_4_BIT;
+    case 8: return VK_SAMPLE_COUNT_8_BIT;
+    default:
+      RENDERER_ERROR("Unsupported render target sample count %u", GetSampleCount())
+      break;
+  }
+  return VK_SAMPLE_COUNT_1_BIT;
+}
+
+void TextureVk::CreateSampler(const VkFilter min_filter, const VkFilter mag_filter,
+                              const VkSamplerMipmapMode mipmap_mode,
+                              const VkSamplerAddressMode address_mode_u,
+                              const VkSamplerAddressMode address_mode_v) {
+  RendererVk &renderer = RendererVk::GetInstanceVk();
   VkSamplerCreateInfo sampler_create_info = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
-  sampler_create_info.magFilter = kVkMagFilters[params.mag_filter];
-  sampler_create_info.minFilter = kVkMinFilters[params.min_filter];
-  sampler_create_info.addressModeU = kVkWrapS[params.wrap_s];
-  sampler_create_info.addressModeV = kVkWrapT[params.wrap_t];
+  sampler_create_info.magFilter = mag_filter;
+  sampler_create_info.minFilter = min_filter;
+  sampler_create_info.addressModeU = address_mode_u;
+  sampler_create_info.addressModeV = address_mode_v;
   sampler_create_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
   sampler_create_info.anisotropyEnable = VK_FALSE;
   sampler_create_info.maxAnisotropy = 1;
@@ -238,14 +402,13 @@ TextureVk::TextureVk(const Texture::TextureCreationParams& params)
   sampler_create_info.unnormalizedCoordinates = VK_FALSE;
   sampler_create_info.compareEnable = VK_FALSE;
   sampler_create_info.compareOp = VK_COMPARE_OP_ALWAYS;
-  sampler_create_info.mipmapMode = kVkMipmapMode[params.min_filter];
+  sampler_create_info.mipmapMode = mipmap_mode;
   sampler_create_info.mipLodBias = 0.f;
   sampler_create_info.minLod = 0.f;
   sampler_create_info.maxLod = FLT_MAX;
   const VkResult sampler_result = vkCreateSampler(renderer.GetDevice(), &sampler_create_info,
                                                   nullptr, &sampler_);
   RENDERER_CHECK_VK(sampler_result, "vkCreateSampler");
-
 }
 
 TextureVk::~TextureVk() {
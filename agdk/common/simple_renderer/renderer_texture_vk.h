@@ -26,16 +26,30 @@ namespace simple_renderer
 class TextureVk : public Texture {
  public:
   TextureVk(const Texture::TextureCreationParams& params);
+  TextureVk(const Texture::RenderTargetCreationParams& params);
   virtual ~TextureVk();
 
   VkImageView GetImageView() const { return image_view_; }
   VkSampler GetSampler() const { return sampler_; }
 
+  VkFormat GetFormatVk() const { return image_format_; }
+  VkSampleCountFlagBits GetSampleCountVk() const;
+  // Layout the image is kept in outside of render passes, render passes using
+  // the texture as an attachment transition it back to this layout when they end
+  VkImageLayout GetImageLayout() const { return image_layout_; }
+
  private:
+  void CreateSampler(const VkFilter min_filter, const VkFilter mag_filter,
+                     const VkSamplerMipmapMode mipmap_mode,
+                     const VkSamplerAddressMode address_mode_u,
+                     const VkSamplerAddressMode address_mode_v);
+
   VkImage image_;
   VkImageView image_view_;
   VmaAllocation image_alloc_;
   VkSampler sampler_;
+  VkFormat image_format_;
+  VkImageLayout image_layout_;
 };
 } // namespace simple_renderer
 
@@ -18,6 +18,7 @@
 #define SIMPLERENDERER_UNIFORM_BUFFER_H_
 
 #include "renderer_buffer.h"
+#include "renderer_handle.h"
 
 namespace simple_renderer
 {
@@ -74,7 +75,14 @@ class UniformBuffer : public RendererBuffer {
      */
     kBufferFlag_UpdateDynamicPerDraw = (1U << 0),
     /** @brief Deliver via push constant on Vulkan (only method supported currently */
-    kBufferFlag_UsePushConstants = (1U << 1)
+    kBufferFlag_UsePushConstants = (1U << 1),
+    /**
+     * @brief Deliver via a per-frame uniform ring buffer bound with a dynamic offset
+     * (a dynamic uniform buffer descriptor in set 1, binding 0 on Vulkan, a uniform block
+     * bound with glBindBufferRange on OpenGL ES). Buffer data is only copied to the ring
+     * when it has changed since the last draw. Overrides kBufferFlag_UsePushConstants.
+     */
+    kBufferFlag_UseUniformRing = (1U << 2)
   };
 
   /**
@@ -132,6 +140,11 @@ class UniformBuffer : public RendererBuffer {
     UniformBufferStageRanges stage_ranges;
     /** @brief The size of the uniform buffer data in bytes */
     size_t data_byte_count;
+    /**
+     * @brief The name of the uniform block in the shader, used for OpenGL ES
+     * when `kBufferFlag_UseUniformRing` is set. Must persist like `element_array`.
+     */
+    const char* block_name;
   };
 
   /**
@@ -139,6 +152,13 @@ class UniformBuffer : public RendererBuffer {
    */
   virtual ~UniformBuffer() {}
 
+  /**
+   * @brief Retrieve the handle identifying the `UniformBuffer` in the resource pool of
+   * the `Renderer`. The handle becomes stale once the `UniformBuffer` is destroyed.
+   * @return An `UniformBufferHandle`.
+   */
+  UniformBufferHandle GetHandle() const { return handle_; }
+
   /**
    * @brief Get the element description of a `UniformBuffer` element at the specified index.
    * @param index The index of the element, must be less than ::GetElementCount
@@ -160,16 +180,36 @@ class UniformBuffer : public RendererBuffer {
    */
   virtual void SetBufferElementData(const uint32_t index, const float* data, const size_t size) = 0;
 
+  /**
+   * @brief Get the `UniformBufferFlags` bitflags the `UniformBuffer` was created with.
+   * @return The buffer flags of the `UniformBuffer`
+   */
+  uint32_t GetBufferFlags() const { return buffer_flags_; }
+
+  /**
+   * @brief Get the shader uniform block name of the `UniformBuffer`.
+   * @return The uniform block name, nullptr if none was specified
+   */
+  const char* GetBlockName() const { return block_name_; }
+
  protected:
   UniformBuffer(const UniformBufferCreationParams& params) :
       RendererBuffer(params.element_count, params.data_byte_count, params.data_byte_count),
-    element_array_(params.element_array) {
+    element_array_(params.element_array),
+    block_name_(params.block_name),
+    buffer_flags_(params.buffer_flags) {
   }
 
  private:
-  UniformBuffer() : RendererBuffer(0, 0, 0), element_array_(nullptr) {}
+  UniformBuffer() : RendererBuffer(0, 0, 0), element_array_(nullptr), block_name_(nullptr),
+                    buffer_flags_(0) {}
 
   const UniformBufferElement* element_array_;
+  const char* block_name_;
+  uint32_t buffer_flags_;
+
+  template <typename T> friend class RendererResourcePool;
+  UniformBufferHandle handle_;
 };
 }
 
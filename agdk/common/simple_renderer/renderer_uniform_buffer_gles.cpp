@@ -20,7 +20,9 @@
 namespace simple_renderer {
 
 UniformBufferGLES::UniformBufferGLES(const UniformBuffer::UniformBufferCreationParams& params) :
-  UniformBuffer(params) {
+  UniformBuffer(params),
+  ring_offset_(0),
+  ring_frame_number_(0) {
   const uint32_t count = GetBufferElementCount();
   uint32_t i = 0;
   uint32_t offset = 0;
@@ -74,6 +76,11 @@ void UniformBufferGLES::SetBufferElementData(const uint32_t index, const float*
     RENDERER_ASSERT(offset < kMaxUniformBufferFloatSize)
     RENDERER_ASSERT(end_offset <= kMaxUniformBufferFloatSize)
     if (offset < kMaxUniformBufferFloatSize && end_offset <= kMaxUniformBufferFloatSize) {
+      // Skip the update if the data hasn't changed, so the buffer stays clean and
+      // doesn't need to be copied into the uniform ring again
+      if (memcmp(&buffer_data_[offset], data, size) == 0) {
+        return;
+      }
       memcpy(&buffer_data_[offset], data, size);
     }
   }
@@ -18,13 +18,15 @@
 #define SIMPLERENDERER_UNIFORM_BUFFER_GLES_H_
 
 #include <cstdint>
+#include <cstring>
 #include <GLES3/gl3.h>
 #include "renderer_uniform_buffer.h"
 
 namespace simple_renderer
 {
-// The GLES uniform buffer implementation currently keeps the original rendering code
-// GLES2 element update style instead of actually using a buffer object.
+// The GLES uniform buffer implementation keeps the original rendering code GLES2
+// element update style, unless kBufferFlag_UseUniformRing is set, in which case the
+// data is copied into the uniform ring buffer object of the renderer.
 class UniformBufferGLES : public UniformBuffer {
  public:
   UniformBufferGLES(const UniformBuffer::UniformBufferCreationParams& params);
@@ -36,12 +38,34 @@ class UniformBufferGLES : public UniformBuffer {
 
   const float* GetBufferData() const { return buffer_data_; }
 
+  // Replace the entire buffer contents, used to replay recorded draws
+  void SetBufferData(const float* data) {
+    if (memcmp(buffer_data_, data, sizeof(buffer_data_)) != 0) {
+      memcpy(buffer_data_, data, sizeof(buffer_data_));
+      SetBufferDirty(true);
+    }
+  }
+
   bool GetBufferDirty() const { return buffer_dirty_; }
   void SetBufferDirty(bool dirty) { buffer_dirty_ = dirty; }
 
+  bool GetUsesUniformRing() const {
+    return (GetBufferFlags() & UniformBuffer::kBufferFlag_UseUniformRing) != 0;
+  }
+
+  // Offset of the copy of the buffer data in the uniform ring, and the frame it was written in
+  uint32_t GetRingOffset() const { return ring_offset_; }
+  uint64_t GetRingFrameNumber() const { return ring_frame_number_; }
+  void SetRingOffset(const uint32_t offset, const uint64_t frame_number) {
+    ring_offset_ = offset;
+    ring_frame_number_ = frame_number;
+  }
+
  private:
   float buffer_data_[kMaxUniformBufferFloatSize];
   uint32_t element_offsets_[kMaxUniforms];
+  uint32_t ring_offset_;
+  uint64_t ring_frame_number_;
   bool buffer_dirty_;
 };
 } // namespace simple_renderer
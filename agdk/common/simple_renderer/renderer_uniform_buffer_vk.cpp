@@ -20,8 +20,9 @@
 namespace simple_renderer {
 
 UniformBufferVk::UniformBufferVk(const UniformBuffer::UniformBufferCreationParams& params) :
-    UniformBuffer(params) {
-  buffer_flags_ = params.buffer_flags;
+    UniformBuffer(params),
+    ring_offset_(0),
+    ring_frame_number_(0) {
   stage_ranges_ = params.stage_ranges;
   const uint32_t count = GetBufferElementCount();
   uint32_t i = 0;
@@ -84,6 +85,11 @@ void UniformBufferVk::SetBufferElementData(const uint32_t index, const float* da
     RENDERER_ASSERT(offset < kMaxUniformBufferFloatSize)
     RENDERER_ASSERT(end_offset < kMaxUniformBufferFloatSize)
     if (offset < kMaxUniformBufferFloatSize && end_offset < kMaxUniformBufferFloatSize) {
+      // Skip the update if the data hasn't changed, so the buffer stays clean and
+      // doesn't need to be copied into the uniform ring again
+      if (memcmp(&buffer_data_[offset], data, size) == 0) {
+        return;
+      }
       memcpy(&buffer_data_[offset], data, size);
     }
   }
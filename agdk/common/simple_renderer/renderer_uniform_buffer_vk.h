@@ -43,13 +43,26 @@ class UniformBufferVk : public UniformBuffer {
 
   const UniformBufferStageRanges& GetStageRanges() const { return stage_ranges_; }
 
+  bool GetUsesUniformRing() const {
+    return (GetBufferFlags() & UniformBuffer::kBufferFlag_UseUniformRing) != 0;
+  }
+
+  // Offset of the copy of the buffer data in the uniform ring, and the frame it was written in
+  uint32_t GetRingOffset() const { return ring_offset_; }
+  uint64_t GetRingFrameNumber() const { return ring_frame_number_; }
+  void SetRingOffset(const uint32_t offset, const uint64_t frame_number) {
+    ring_offset_ = offset;
+    ring_frame_number_ = frame_number;
+  }
+
  private:
   UniformBufferStageRanges stage_ranges_;
   float buffer_data_[kMaxUniformBufferFloatSize];
   uint32_t element_offsets_[kMaxUniforms];
   VkShaderStageFlags stage_flags_;
-  uint32_t buffer_flags_;
   uint32_t buffer_size_;
+  uint32_t ring_offset_;
+  uint64_t ring_frame_number_;
   bool buffer_dirty_;
 };
 } // namespace simple_renderer
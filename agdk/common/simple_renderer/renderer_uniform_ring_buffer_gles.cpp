@@ -0,0 +1,82 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "renderer_uniform_ring_buffer_gles.h"
+#include "renderer_debug.h"
+#include "renderer_state_cache_gles.h"
+
+namespace simple_renderer {
+
+UniformRingBufferGLES::UniformRingBufferGLES(StateCacheGLES& state_cache) :
+    buffer_(0),
+    offset_alignment_(1),
+    segment_start_(0),
+    write_offset_(0),
+    overflow_reported_(false) {
+  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offset_alignment_);
+  RENDERER_CHECK_GLES("glGetIntegerv GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT");
+  if (offset_alignment_ <= 0) {
+    offset_alignment_ = 1;
+  }
+
+  glGenBuffers(1, &buffer_);
+  RENDERER_CHECK_GLES("glGenBuffers");
+  state_cache.BindBuffer(GL_UNIFORM_BUFFER, buffer_);
+  glBufferData(GL_UNIFORM_BUFFER, kFrameSegmentSize * kFrameSegmentCount, nullptr,
+               GL_DYNAMIC_DRAW);
+  RENDERER_CHECK_GLES("glBufferData");
+}
+
+UniformRingBufferGLES::~UniformRingBufferGLES() {
+  if (buffer_ != 0) {
+    glDeleteBuffers(1, &buffer_);
+    buffer_ = 0;
+  }
+}
+
+void UniformRingBufferGLES::BeginFrame(const uint64_t frame_number) {
+  segment_start_ = static_cast<uint32_t>(frame_number % kFrameSegmentCount) * kFrameSegmentSize;
+  write_offset_ = segment_start_;
+  overflow_reported_ = false;
+}
+
+uint32_t UniformRingBufferGLES::Write(StateCacheGLES& state_cache, const void* data,
+                                      const size_t size) {
+  const uint32_t alignment = static_cast<uint32_t>(offset_alignment_);
+  const uint32_t offset = write_offset_;
+  if (offset + size > segment_start_ + kFrameSegmentSize) {
+    if (!overflow_reported_) {
+      RENDERER_ERROR("Uniform ring segment full (%u bytes)", kFrameSegmentSize)
+      overflow_reported_ = true;
+    }
+    return kInvalidOffset;
+  }
+  // The alignment isn't guaranteed to be a power of two
+  write_offset_ += ((static_cast<uint32_t>(size) + alignment - 1) / alignment) * alignment;
+
+  state_cache.BindBuffer(GL_UNIFORM_BUFFER, buffer_);
+  glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+  RENDERER_CHECK_GLES("glBufferSubData");
+  return offset;
+}
+
+void UniformRingBufferGLES::Bind(StateCacheGLES& state_cache, const uint32_t offset,
+                                 const size_t size) {
+  state_cache.BindUniformBufferRange(buffer_, offset, size);
+}
+
+} // namespace simple_renderer
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SIMPLERENDERER_UNIFORM_RING_BUFFER_GLES_H_
+#define SIMPLERENDERER_UNIFORM_RING_BUFFER_GLES_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <GLES3/gl3.h>
+
+namespace simple_renderer {
+
+class StateCacheGLES;
+
+// A GL_UNIFORM_BUFFER divided into one segment per frame, rotated each frame so
+// writes don't overlap ranges still being read by draws from the previous frames.
+// Uniform buffers using kBufferFlag_UseUniformRing copy their data into the active
+// segment when it changes, and the copy is bound with glBindBufferRange.
+// ES 3.0 has no persistent mapping, data is written with glBufferSubData.
+class UniformRingBufferGLES {
+ public:
+  static constexpr uint32_t kFrameSegmentCount = 3;
+  static constexpr uint32_t kFrameSegmentSize = 64 * 1024;
+  // Returned by Write if the frame segment is full
+  static constexpr uint32_t kInvalidOffset = 0xFFFFFFFF;
+
+  UniformRingBufferGLES(StateCacheGLES& state_cache);
+  ~UniformRingBufferGLES();
+
+  void BeginFrame(const uint64_t frame_number);
+
+  // Copy data into the active frame segment, returns the offset of the copy,
+  // or kInvalidOffset if the segment is full
+  uint32_t Write(StateCacheGLES& state_cache, const void* data, const size_t size);
+
+  // Bind the range at offset to uniform buffer binding point 0
+  void Bind(StateCacheGLES& state_cache, const uint32_t offset, const size_t size);
+
+ private:
+  GLuint buffer_;
+  GLint offset_alignment_;
+  uint32_t segment_start_;
+  uint32_t write_offset_;
+  bool overflow_reported_;
+};
+
+} // namespace simple_renderer
+
+#endif // SIMPLERENDERER_UNIFORM_RING_BUFFER_GLES_H_
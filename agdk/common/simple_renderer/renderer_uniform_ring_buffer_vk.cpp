@@ -0,0 +1,174 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "renderer_uniform_ring_buffer_vk.h"
+#include "renderer_debug.h"
+#include "renderer_uniform_buffer.h"
+
+namespace simple_renderer {
+
+UniformRingBufferVk::UniformRingBufferVk(VkDevice device, VkPhysicalDevice physical_device,
+                                         VmaAllocator allocator,
+                                         const uint32_t in_flight_frame_count) :
+    device_(device),
+    allocator_(allocator),
+    buffer_(VK_NULL_HANDLE),
+    buffer_alloc_(VK_NULL_HANDLE),
+    mapped_data_(nullptr),
+    descriptor_set_layout_(VK_NULL_HANDLE),
+    descriptor_pool_(VK_NULL_HANDLE),
+    descriptor_set_(VK_NULL_HANDLE),
+    in_flight_frame_count_(in_flight_frame_count),
+    offset_alignment_(1),
+    segment_start_(0),
+    write_offset_(0),
+    overflow_reported_(false) {
+  VkPhysicalDeviceProperties device_properties;
+  vkGetPhysicalDeviceProperties(physical_device, &device_properties);
+  offset_alignment_ = static_cast<uint32_t>(
+      device_properties.limits.minUniformBufferOffsetAlignment);
+  if (offset_alignment_ == 0) {
+    offset_alignment_ = 1;
+  }
+
+  VkBufferCreateInfo create_info = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+  create_info.size = kFrameSegmentSize * in_flight_frame_count_;
+  create_info.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+  create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  VmaAllocationCreateInfo alloc_info = {};
+  alloc_info.usage = VMA_MEMORY_USAGE_AUTO;
+  alloc_info.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+      VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+  VmaAllocationInfo buffer_info = {};
+  const VkResult alloc_result = vmaCreateBuffer(allocator_, &create_info, &alloc_info,
+                                                &buffer_, &buffer_alloc_, &buffer_info);
+  RENDERER_CHECK_VK(alloc_result, "vmaCreateBuffer (uniform ring)");
+  RENDERER_ASSERT(buffer_info.pMappedData != nullptr)
+  mapped_data_ = reinterpret_cast<uint8_t*>(buffer_info.pMappedData);
+
+  CreateDescriptors();
+}
+
+UniformRingBufferVk::~UniformRingBufferVk() {
+  if (descriptor_pool_ != VK_NULL_HANDLE) {
+    vkDestroyDescriptorPool(device_, descriptor_pool_, nullptr);
+    descriptor_pool_ = VK_NULL_HANDLE;
+    descriptor_set_ = VK_NULL_HANDLE;
+  }
+  if (descriptor_set_layout_ != VK_NULL_HANDLE) {
+    vkDestroyDescriptorSetLayout(device_, descriptor_set_layout_, nullptr);
+    descriptor_set_layout_ = VK_NULL_HANDLE;
+  }
+  if (buffer_ != VK_NULL_HANDLE) {
+    vmaDestroyBuffer(allocator_, buffer_, buffer_alloc_);
+    buffer_ = VK_NULL_HANDLE;
+  }
+}
+
+void UniformRingBufferVk::CreateDescriptors() {
+  VkDescriptorSetLayoutBinding uniform_layout_binding = {};
+  uniform_layout_binding.binding = 0;
+  uniform_layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+  uniform_layout_binding.descriptorCount = 1;
+  uniform_layout_binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+  VkDescriptorSetLayoutCreateInfo descriptor_set_layout_info = {};
+  descriptor_set_layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  descriptor_set_layout_info.bindingCount = 1;
+  descriptor_set_layout_info.pBindings = &uniform_layout_binding;
+  const VkResult layout_result = vkCreateDescriptorSetLayout(device_, &descriptor_set_layout_info,
+                                                             nullptr, &descriptor_set_layout_);
+  RENDERER_CHECK_VK(layout_result, "vkCreateDescriptorSetLayout (uniform ring)");
+
+  VkDescriptorPoolSize pool_size = {};
+  pool_size.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+  pool_size.descriptorCount = 1;
+
+  VkDescriptorPoolCreateInfo pool_create_info = {};
+  pool_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  pool_create_info.poolSizeCount = 1;
+  pool_create_info.pPoolSizes = &pool_size;
+  pool_create_info.maxSets = 1;
+  const VkResult pool_result = vkCreateDescriptorPool(device_, &pool_create_info, nullptr,
+                                                      &descriptor_pool_);
+  RENDERER_CHECK_VK(pool_result, "vkCreateDescriptorPool (uniform ring)");
+
+  VkDescriptorSetAllocateInfo descriptor_set_info = {};
+  descriptor_set_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  descriptor_set_info.descriptorPool = descriptor_pool_;
+  descriptor_set_info.descriptorSetCount = 1;
+  descriptor_set_info.pSetLayouts = &descriptor_set_layout_;
+  const VkResult allocate_result = vkAllocateDescriptorSets(device_, &descriptor_set_info,
+                                                            &descriptor_set_);
+  RENDERER_CHECK_VK(allocate_result, "vkAllocateDescriptorSets (uniform ring)");
+
+  // The descriptor is never rewritten, a single descriptor covering the maximum
+  // uniform buffer size is used for every draw with a different dynamic offset
+  VkDescriptorBufferInfo descriptor_buffer_info = {};
+  descriptor_buffer_info.buffer = buffer_;
+  descriptor_buffer_info.offset = 0;
+  descriptor_buffer_info.range = UniformBuffer::kMaxUniformBufferByteSize;
+
+  VkWriteDescriptorSet write_descriptor_set = {};
+  write_descriptor_set.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  write_descriptor_set.dstSet = descriptor_set_;
+  write_descriptor_set.dstBinding = 0;
+  write_descriptor_set.dstArrayElement = 0;
+  write_descriptor_set.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+  write_descriptor_set.descriptorCount = 1;
+  write_descriptor_set.pBufferInfo = &descriptor_buffer_info;
+  vkUpdateDescriptorSets(device_, 1, &write_descriptor_set, 0, nullptr);
+}
+
+void UniformRingBufferVk::BeginFrame(const uint32_t frame_index) {
+  RENDERER_ASSERT(frame_index < in_flight_frame_count_)
+  segment_start_ = frame_index * kFrameSegmentSize;
+  write_offset_.store(segment_start_);
+  overflow_reported_ = false;
+}
+
+void UniformRingBufferVk::EndFrame() {
+  const uint32_t write_end = write_offset_.load();
+  if (write_end > segment_start_) {
+    // No-op for host coherent memory
+    const uint32_t flush_size = std::min(write_end, segment_start_ + kFrameSegmentSize) -
+        segment_start_;
+    vmaFlushAllocation(allocator_, buffer_alloc_, segment_start_, flush_size);
+  }
+}
+
+uint32_t UniformRingBufferVk::Write(const void* data, const size_t size) {
+  RENDERER_ASSERT(size <= UniformBuffer::kMaxUniformBufferByteSize)
+  const uint32_t aligned_size = (static_cast<uint32_t>(size) + offset_alignment_ - 1) &
+      ~(offset_alignment_ - 1);
+  const uint32_t offset = write_offset_.fetch_add(aligned_size);
+  // The descriptor range is always kMaxUniformBufferByteSize, so make sure it
+  // doesn't extend past the end of the segment
+  if (offset + UniformBuffer::kMaxUniformBufferByteSize > segment_start_ + kFrameSegmentSize) {
+    if (!overflow_reported_) {
+      RENDERER_ERROR("Uniform ring segment full (%u bytes)", kFrameSegmentSize)
+      overflow_reported_ = true;
+    }
+    return kInvalidOffset;
+  }
+  memcpy(mapped_data_ + offset, data, size);
+  return offset;
+}
+
+} // namespace simple_renderer
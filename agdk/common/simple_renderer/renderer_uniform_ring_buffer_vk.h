@@ -0,0 +1,75 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SIMPLERENDERER_UNIFORM_RING_BUFFER_VK_H_
+#define SIMPLERENDERER_UNIFORM_RING_BUFFER_VK_H_
+
+#include <atomic>
+#include <cstdint>
+#include "renderer_vk_includes.h"
+
+namespace simple_renderer {
+
+// A persistently mapped, host visible buffer divided into one segment per in-flight
+// frame. Uniform buffers using kBufferFlag_UseUniformRing copy their data into the
+// segment of the active frame when it changes, and are bound with a dynamic offset
+// into a single dynamic uniform buffer descriptor.
+class UniformRingBufferVk {
+ public:
+  // Size of each per-frame segment
+  static constexpr uint32_t kFrameSegmentSize = 256 * 1024;
+  // Returned by Write if the frame segment is full
+  static constexpr uint32_t kInvalidOffset = 0xFFFFFFFF;
+
+  UniformRingBufferVk(VkDevice device, VkPhysicalDevice physical_device,
+                      VmaAllocator allocator, const uint32_t in_flight_frame_count);
+  ~UniformRingBufferVk();
+
+  // Start writing into the segment of the specified in-flight frame, the frame fence
+  // must have been waited on
+  void BeginFrame(const uint32_t frame_index);
+  // Flush the data written this frame, if the memory isn't host coherent
+  void EndFrame();
+
+  // Copy data into the active frame segment, returns the dynamic offset of the copy,
+  // or kInvalidOffset if the segment is full. Safe to call from multiple threads.
+  uint32_t Write(const void* data, const size_t size);
+
+  VkDescriptorSetLayout GetDescriptorSetLayout() const { return descriptor_set_layout_; }
+  VkDescriptorSet GetDescriptorSet() const { return descriptor_set_; }
+
+ private:
+  void CreateDescriptors();
+
+  VkDevice device_;
+  VmaAllocator allocator_;
+  VkBuffer buffer_;
+  VmaAllocation buffer_alloc_;
+  uint8_t* mapped_data_;
+  VkDescriptorSetLayout descriptor_set_layout_;
+  VkDescriptorPool descriptor_pool_;
+  VkDescriptorSet descriptor_set_;
+  uint32_t in_flight_frame_count_;
+  uint32_t offset_alignment_;
+  uint32_t segment_start_;
+  std::atomic<uint32_t> write_offset_;
+  bool overflow_reported_;
+};
+
+} // namespace simple_renderer
+
+#endif // SIMPLERENDERER_UNIFORM_RING_BUFFER_VK_H_
@@ -18,6 +18,7 @@
 #define SIMPLERENDERER_VERTEX_BUFFER_H_
 
 #include "renderer_buffer.h"
+#include "renderer_handle.h"
 
 namespace simple_renderer
 {
@@ -100,6 +101,14 @@ class VertexBuffer : public RendererBuffer {
    */
   virtual ~VertexBuffer() {}
 
+  /**
+   * @brief Retrieve the handle of the `VertexBuffer`. The handle can be passed to the
+   * `Renderer` bind functions instead of the shared pointer, and becomes stale once
+   * the `VertexBuffer` is destroyed.
+   * @return A `VertexBufferHandle`.
+   */
+  VertexBufferHandle GetHandle() const { return handle_; }
+
  protected:
   VertexBuffer(const VertexBufferCreationParams& params) :
       RendererBuffer(params.data_byte_size / kVertexStrides[params.vertex_format],
@@ -117,6 +126,9 @@ class VertexBuffer : public RendererBuffer {
   static constexpr size_t kVertexStrides[kVertexFormat_Count] = {
       12, 20, 28, 36 };
   VertexFormat vertex_format_;
+
+  template <typename T> friend class RendererResourcePool;
+  VertexBufferHandle handle_;
 };
 } // namespace simple_renderer
 
@@ -16,33 +16,57 @@
 
 #include "renderer_vk.h"
 #include "renderer_debug.h"
+#include "renderer_geometry_ring_buffer_vk.h"
+#include "renderer_gpu_profiler_vk.h"
 #include "renderer_index_buffer_vk.h"
+#include "renderer_indirect_ring_buffer_vk.h"
+#include "renderer_recording_context_vk.h"
 #include "renderer_render_pass_vk.h"
 #include "renderer_render_state_vk.h"
 #include "renderer_shader_program_vk.h"
 #include "renderer_texture_vk.h"
 #include "renderer_uniform_buffer_vk.h"
+#include "renderer_uniform_ring_buffer_vk.h"
 #include "renderer_vertex_buffer_vk.h"
 #include "display_manager.h"
+#include <algorithm>
 
 using namespace base_game_framework;
 
 namespace simple_renderer {
 
+static constexpr const char* kRenderPassGPUScopeName = "render pass";
+
+static_assert(sizeof(Renderer::DrawIndexedRecord) == sizeof(VkDrawIndexedIndirectCommand),
+              "DrawIndexedRecord must match VkDrawIndexedIndirectCommand");
+
 RendererVk& RendererVk::GetInstanceVk() {
   return *(static_cast<RendererVk*>(Renderer::GetInstancePtr()));
 }
 
 RendererVk::RendererVk() :
+    resources_(stats_),
     staging_command_buffer_(VK_NULL_HANDLE),
+    frame_number_(0),
+    completed_frame_number_(0),
+    frame_slot_numbers_(),
     render_command_buffer_(VK_NULL_HANDLE),
     active_extent_{0, 0},
     active_frame_pool_(VK_NULL_HANDLE),
+    render_pass_secondary_contents_(false),
     bound_descriptor_set_(VK_NULL_HANDLE),
     bound_image_view_(VK_NULL_HANDLE),
     dirty_descriptor_set_(false),
+    bound_uniform_ring_offset_(UniformRingBufferVk::kInvalidOffset),
     descriptor_pools_(),
     descriptor_set_layouts_(),
+    uniform_ring_(),
+    geometry_ring_(),
+    indirect_ring_(),
+    gpu_profiler_(),
+    render_pass_gpu_scope_(GPUProfiler::kInvalidScope),
+    multi_draw_indirect_(false),
+    draw_indirect_first_instance_(false),
     descriptor_set_vertex_table_(VertexBuffer::kVertexFormat_Count),
     texture_descriptor_frame_cache_(kMaxSamplerDescriptors) {
   DisplayManager& display_manager = DisplayManager::GetInstance();
@@ -66,8 +90,24 @@ RendererVk::RendererVk() :
       break;
   }
 
+  frame_slot_numbers_.resize(in_flight_frame_count_, 0);
   CreateDescriptorPools();
   CreateCommandBuffers();
+  uniform_ring_.reset(new UniformRingBufferVk(vk_.device, vk_.physical_device, vk_.allocator,
+                                              in_flight_frame_count_));
+  geometry_ring_.reset(new GeometryRingBufferVk(vk_.allocator, in_flight_frame_count_));
+  gpu_profiler_.reset(new GPUProfilerVk(vk_.device, vk_.physical_device,
+                                        vk_.graphics_queue_index, in_flight_frame_count_));
+
+  // Without multiDrawIndirect each record would need its own indirect draw call,
+  // which is no better than recording vkCmdDrawIndexed directly
+  multi_draw_indirect_ = api_features.HasGraphicsFeature(
+      GraphicsAPIFeatures::kGraphicsFeature_Multi_Draw_Indirect);
+  draw_indirect_first_instance_ = api_features.HasGraphicsFeature(
+      GraphicsAPIFeatures::kGraphicsFeature_Draw_Indirect_First_Instance);
+  if (multi_draw_indirect_) {
+    indirect_ring_.reset(new IndirectRingBufferVk(vk_.allocator, in_flight_frame_count_));
+  }
 
   // Grab swapchain information, but don't request a frame yet (should only happen in BeginFrame)
   const DisplayManager::SwapchainFrameHandle frame_handle =
@@ -83,6 +123,9 @@ RendererVk::~RendererVk() {
 void RendererVk::PrepareShutdown() {
   render_pass_ = nullptr;
   render_state_ = nullptr;
+  // Queued resources may still be referenced by in-flight frames
+  const VkResult wait_result = vkDeviceWaitIdle(vk_.device);
+  RENDERER_CHECK_VK(wait_result, "vkDeviceWaitIdle");
   resources_.ProcessDeleteQueue();
 
   DestroyCommandBuffers();
@@ -96,6 +139,11 @@ void RendererVk::PrepareShutdown() {
     vkDestroyDescriptorPool(vk_.device, pool, nullptr);
   }
   descriptor_pools_.clear();
+
+  uniform_ring_.reset();
+  geometry_ring_.reset();
+  indirect_ring_.reset();
+  gpu_profiler_.reset();
 }
 
 bool RendererVk::GetFeatureAvailable(const RendererFeature feature) {
@@ -106,6 +154,13 @@ bool RendererVk::GetFeatureAvailable(const RendererFeature feature) {
       // initialized RendererVk without it
       supported = true;
       break;
+    case Renderer::kFeature_GPUTimestamps:
+      supported = gpu_profiler_->GetEnabled();
+      break;
+    case Renderer::kFeature_DrawIndirect:
+    case Renderer::kFeature_MultiDrawIndirect:
+      supported = multi_draw_indirect_;
+      break;
     default:
       break;
   }
@@ -114,14 +169,23 @@ bool RendererVk::GetFeatureAvailable(const RendererFeature feature) {
 
 void RendererVk::BeginFrame(
     const base_game_framework::DisplayManager::SwapchainHandle swapchain_handle) {
-  resources_.ProcessDeleteQueue();
-  // At the moment, we don't support render targets, so grab a swapchain image
-  // as soon as we start a frame
+  RendererStats::ScopedTimer begin_frame_timer(stats_, RendererStats::kStat_BeginFrameTime);
+  stats_.BeginFrame(frame_number_ + 1);
+  ++frame_number_;
+  // Grab a swapchain image as soon as we start a frame, even if the first
+  // render passes only use render targets
   DisplayManager& display_manager = DisplayManager::GetInstance();
   const DisplayManager::SwapchainFrameHandle frame_handle =
       display_manager.GetCurrentSwapchainFrame(swapchain_handle);
   if (frame_handle != DisplayManager::kInvalid_swapchain_handle) {
-    display_manager.GetSwapchainFrameResourcesVk(frame_handle, swap_, true);
+    // Acquiring the frame waits on the fence of its in-flight slot, so the frame
+    // last submitted in that slot has completed, and every frame before it
+    if (display_manager.GetSwapchainFrameResourcesVk(frame_handle, swap_, true)) {
+      RENDERER_ASSERT(swap_.swapchain_frame_index < frame_slot_numbers_.size())
+      uint64_t& slot_frame_number = frame_slot_numbers_[swap_.swapchain_frame_index];
+      completed_frame_number_ = std::max(completed_frame_number_, slot_frame_number);
+      slot_frame_number = frame_number_;
+    }
     active_extent_ = swap_.swapchain_extent;
 
     RENDERER_ASSERT(swap_.swapchain_frame_index < descriptor_pools_.size())
@@ -129,6 +193,15 @@ void RendererVk::BeginFrame(
     VkResult reset_result = vkResetDescriptorPool(vk_.device, active_frame_pool_, 0);
     RENDERER_CHECK_VK(reset_result, "vkResetDescriptorPool");
   }
+  // Resources destroyed from here on are deleted once this frame completes
+  resources_.BeginFrame(frame_number_, completed_frame_number_);
+
+  uniform_ring_->BeginFrame(swap_.swapchain_frame_index);
+  geometry_ring_->BeginFrame(swap_.swapchain_frame_index);
+  if (indirect_ring_.get() != nullptr) {
+    indirect_ring_->BeginFrame(swap_.swapchain_frame_index);
+  }
+  bound_uniform_ring_offset_ = UniformRingBufferVk::kInvalidOffset;
 
   render_command_buffer_ = command_buffers_[swap_.swapchain_frame_index];
 
@@ -142,32 +215,54 @@ void RendererVk::BeginFrame(
                                                              &command_buffer_begin_info);
   RENDERER_CHECK_VK(begin_command_result, "vkBeginCommandBuffer");
 
+  // Resets this frame's queries, which must happen outside of a render pass
+  gpu_profiler_->SetCommandBuffer(render_command_buffer_);
+  gpu_profiler_->BeginFrame(swap_.swapchain_frame_index, stats_);
+  render_pass_gpu_scope_ = GPUProfiler::kInvalidScope;
+
   // We enabled dynamic viewport and width in the pipeline object,
   // so set them at the beginning of our render command buffer
+  SetViewportAndScissor(render_command_buffer_, active_extent_, true);
+}
 
+void RendererVk::SetViewportAndScissor(VkCommandBuffer command_buffer, const VkExtent2D& extent,
+                                       const bool flip_y) const {
   VkViewport viewport{};
-  viewport.width = static_cast<float>(active_extent_.width);
-  // SimpleRenderer assumes GL style Y axis points up. Vulkan is Y axis points
-  // down. The VK_KHR_MAINTENANCE1 extension lets us negate the viewport
-  // height to flip the Y axis, we also have to set Y = height instead of 0
-  viewport.y = static_cast<float>(active_extent_.height);
-  viewport.height = -(static_cast<float>(active_extent_.height));
+  viewport.width = static_cast<float>(extent.width);
+  if (flip_y) {
+    // SimpleRenderer assumes GL style Y axis points up. Vulkan is Y axis points
+    // down. The VK_KHR_MAINTENANCE1 extension lets us negate the viewport
+    // height to flip the Y axis, we also have to set Y = height instead of 0
+    viewport.y = static_cast<float>(extent.height);
+    viewport.height = -(static_cast<float>(extent.height));
+  } else {
+    viewport.height = static_cast<float>(extent.height);
+  }
   viewport.minDepth = 0.0f;
   viewport.maxDepth = 1.0f;
-  vkCmdSetViewport(render_command_buffer_, 0, 1, &viewport);
+  vkCmdSetViewport(command_buffer, 0, 1, &viewport);
 
   VkRect2D scissor{};
-  scissor.extent = active_extent_;
-  vkCmdSetScissor(render_command_buffer_, 0, 1, &scissor);
+  scissor.extent = extent;
+  vkCmdSetScissor(command_buffer, 0, 1, &scissor);
 }
 
 void RendererVk::EndFrame() {
+  RendererStats::ScopedTimer end_frame_timer(stats_, RendererStats::kStat_EndFrameTime);
   if (render_pass_.get() != nullptr) {
     render_pass_.get()->EndRenderPass();
     render_pass_ = nullptr;
   }
+  render_pass_secondary_contents_ = false;
   render_state_ = nullptr;
+  gpu_profiler_->EndFrame();
+  render_pass_gpu_scope_ = GPUProfiler::kInvalidScope;
   vkEndCommandBuffer(render_command_buffer_);
+  uniform_ring_->EndFrame();
+  geometry_ring_->EndFrame();
+  if (indirect_ring_.get() != nullptr) {
+    indirect_ring_->EndFrame();
+  }
 
   VkSubmitInfo submit_info{};
   submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -196,83 +291,167 @@ void RendererVk::EndFrame() {
 void RendererVk::SwapchainRecreated() {
   // Our cached framebuffers were associated with image view from the old
   // swapchain, purge the cache to rebuild them using the new swapchain
-  for (auto &render_pass : resources_.GetRenderPasses()) {
-    RenderPassVk *render_pass_vk = reinterpret_cast<RenderPassVk*>(render_pass.second.get());
-    render_pass_vk->PurgeFramebufferCache();
-  }
+  resources_.GetRenderPasses().ForEach([](RenderPass& render_pass) {
+    static_cast<RenderPassVk&>(render_pass).PurgeFramebufferCache();
+  });
 }
 
-void RendererVk::Draw(const uint32_t vertex_count, const uint32_t first_vertex) {
+void RendererVk::AcquireThreadContext() {
+  // Vulkan objects are not bound to a thread
+}
+
+void RendererVk::ReleaseThreadContext() {
+}
+
+RenderStateVk& RendererVk::PrepareDraw() {
   RenderStateVk& state = *(static_cast<RenderStateVk*>(render_state_.get()));
   if (dirty_descriptor_set_) {
-    vkCmdBindDescriptorSets(render_command_buffer_, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            state.GetPipelineLayout(), 0, 1, &bound_descriptor_set_,
-                            0, nullptr);
+    // Nothing to bind after BindTexture(nullptr), VK_NULL_HANDLE is not a valid set
+    if (bound_descriptor_set_ != VK_NULL_HANDLE) {
+      vkCmdBindDescriptorSets(render_command_buffer_, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                              state.GetPipelineLayout(), 0, 1, &bound_descriptor_set_,
+                              0, nullptr);
+    }
     dirty_descriptor_set_ = false;
   }
 
   // Update any uniform data that might have changed between draw calls
-  state.UpdateUniformData(render_command_buffer_, true);
+  state.UpdateUniformData(render_command_buffer_, true, true, bound_uniform_ring_offset_);
+  return state;
+}
 
+void RendererVk::Draw(const uint32_t vertex_count, const uint32_t first_vertex) {
+  RENDERER_ASSERT(!render_pass_secondary_contents_)
+  RenderStateVk& state = PrepareDraw();
   vkCmdDraw(render_command_buffer_, vertex_count, 1, first_vertex, 0);
+  stats_.AddDraw(state.GetPrimitiveTopology() == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, vertex_count);
 }
 
 void RendererVk::DrawIndexed(const uint32_t index_count, const uint32_t first_index) {
-  RenderStateVk& state = *(static_cast<RenderStateVk*>(render_state_.get()));
-  if (dirty_descriptor_set_) {
-    vkCmdBindDescriptorSets(render_command_buffer_, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            state.GetPipelineLayout(), 0, 1, &bound_descriptor_set_,
-                            0, nullptr);
-    dirty_descriptor_set_ = false;
+  DrawIndexed(index_count, first_index, 0);
+}
+
+void RendererVk::DrawIndexed(const uint32_t index_count, const uint32_t first_index,
+                             const uint32_t base_vertex) {
+  RENDERER_ASSERT(!render_pass_secondary_contents_)
+  RenderStateVk& state = PrepareDraw();
+  vkCmdDrawIndexed(render_command_buffer_, index_count, 1, first_index,
+                   static_cast<int32_t>(base_vertex), 0);
+  stats_.AddDraw(state.GetPrimitiveTopology() == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, index_count);
+}
+
+void RendererVk::DrawIndexedMulti(const DrawIndexedRecord* records, const uint32_t record_count) {
+  RENDERER_ASSERT(!render_pass_secondary_contents_)
+  if (record_count == 0) {
+    return;
+  }
+  RenderStateVk& state = PrepareDraw();
+  const bool triangle_list =
+      (state.GetPrimitiveTopology() == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+
+  bool use_indirect = multi_draw_indirect_;
+  if (use_indirect && !draw_indirect_first_instance_) {
+    for (uint32_t i = 0; i < record_count; ++i) {
+      if (records[i].first_instance != 0) {
+        use_indirect = false;
+        break;
+      }
+    }
   }
 
-  // Update any uniform data that might have changed between draw calls
-  state.UpdateUniformData(render_command_buffer_, true);
+  uint32_t indirect_offset = IndirectRingBufferVk::kInvalidOffset;
+  if (use_indirect) {
+    indirect_offset = indirect_ring_->Write(records, record_count * sizeof(DrawIndexedRecord));
+  }
+  if (indirect_offset != IndirectRingBufferVk::kInvalidOffset) {
+    vkCmdDrawIndexedIndirect(render_command_buffer_, indirect_ring_->GetBuffer(), indirect_offset,
+                             record_count, sizeof(DrawIndexedRecord));
+    AddMultiDrawStats(records, record_count, triangle_list, 1);
+  } else {
+    for (uint32_t i = 0; i < record_count; ++i) {
+      const DrawIndexedRecord& record = records[i];
+      vkCmdDrawIndexed(render_command_buffer_, record.index_count, record.instance_count,
+                       record.first_index, record.base_vertex, record.first_instance);
+    }
+    AddMultiDrawStats(records, record_count, triangle_list, record_count);
+  }
+}
+
+void RendererVk::DrawIndexedDynamic(const VertexBuffer::VertexFormat vertex_format,
+                                    const void* vertex_data, const uint32_t vertex_count,
+                                    const uint16_t* index_data, const uint32_t index_count) {
+  RENDERER_ASSERT(!render_pass_secondary_contents_)
+  if (index_count == 0) {
+    return;
+  }
+  const size_t vertex_size = vertex_count * VertexBuffer::GetVertexFormatStride(vertex_format);
+  const size_t index_size = index_count * sizeof(uint16_t);
+  const uint32_t vertex_offset = geometry_ring_->Write(vertex_data, vertex_size);
+  if (vertex_offset == GeometryRingBufferVk::kInvalidOffset) {
+    return;
+  }
+  const uint32_t index_offset = geometry_ring_->Write(index_data, index_size);
+  if (index_offset == GeometryRingBufferVk::kInvalidOffset) {
+    return;
+  }
+  stats_.Add(RendererStats::kStat_BufferBytesUploaded, vertex_size + index_size);
 
-  vkCmdDrawIndexed(render_command_buffer_, index_count, 1, first_index, 0, 0);
+  const VkBuffer ring_buffer = geometry_ring_->GetBuffer();
+  const VkDeviceSize vertex_buffer_offset = vertex_offset;
+  vkCmdBindVertexBuffers(render_command_buffer_, 0, 1, &ring_buffer, &vertex_buffer_offset);
+  vkCmdBindIndexBuffer(render_command_buffer_, ring_buffer, index_offset, VK_INDEX_TYPE_UINT16);
+  RenderStateVk& state = PrepareDraw();
+  vkCmdDrawIndexed(render_command_buffer_, index_count, 1, 0, 0, 0);
+  stats_.AddDraw(state.GetPrimitiveTopology() == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, index_count);
 }
 
-void RendererVk::SetRenderPass(std::shared_ptr<RenderPass> render_pass) {
+void RendererVk::SetRenderPass(const std::shared_ptr<RenderPass>& render_pass) {
   RenderPass* new_render_pass = render_pass.get();
   RenderPass* old_render_pass = render_pass_.get();
   if (new_render_pass != old_render_pass) {
     if (old_render_pass != nullptr) {
       old_render_pass->EndRenderPass();
     }
+    gpu_profiler_->CloseScope(render_pass_gpu_scope_);
+    render_pass_gpu_scope_ = gpu_profiler_->OpenScope(kRenderPassGPUScopeName);
     render_pass_ = render_pass;
     render_state_ = nullptr;
+    render_pass_secondary_contents_ = false;
     new_render_pass->BeginRenderPass();
   }
 }
 
-void RendererVk::SetRenderState(std::shared_ptr<RenderState> render_state) {
+void RendererVk::SetRenderState(const std::shared_ptr<RenderState>& render_state) {
   if (render_state.get() != render_state_.get()) {
     render_state_ = render_state;
     RenderStateVk& state = *(static_cast<RenderStateVk*>(render_state_.get()));
     vkCmdBindPipeline(render_command_buffer_, VK_PIPELINE_BIND_POINT_GRAPHICS, state.GetPipeline());
+    stats_.Add(RendererStats::kStat_PipelineBinds, 1);
     bound_descriptor_set_ = VK_NULL_HANDLE;
     bound_image_view_ = VK_NULL_HANDLE;
+    bound_uniform_ring_offset_ = UniformRingBufferVk::kInvalidOffset;
   }
 }
 
-void RendererVk::BindIndexBuffer(std::shared_ptr<IndexBuffer> index_buffer) {
+void RendererVk::BindIndexBuffer(const std::shared_ptr<IndexBuffer>& index_buffer) {
   IndexBufferVk& index_buffer_vk = *(static_cast<IndexBufferVk*>(index_buffer.get()));
   vkCmdBindIndexBuffer(render_command_buffer_, index_buffer_vk.GetIndexBuffer(),
                        0, VK_INDEX_TYPE_UINT16);
 }
 
-void RendererVk::BindVertexBuffer(std::shared_ptr<VertexBuffer> vertex_buffer) {
+void RendererVk::BindVertexBuffer(const std::shared_ptr<VertexBuffer>& vertex_buffer) {
   VertexBufferVk& vertex_buffer_vk = *(static_cast<VertexBufferVk*>(vertex_buffer.get()));
   VkBuffer vertex_buffers[] = {vertex_buffer_vk.GetVertexBuffer()};
   VkDeviceSize vertex_offsets[] = {0};
   vkCmdBindVertexBuffers(render_command_buffer_, 0, 1, vertex_buffers, vertex_offsets);
 }
 
-void RendererVk::BindTexture(std::shared_ptr<Texture> texture) {
+void RendererVk::BindTexture(const std::shared_ptr<Texture>& texture) {
   if (texture.get() == nullptr) {
     bound_descriptor_set_ = VK_NULL_HANDLE;
     bound_image_view_ = VK_NULL_HANDLE;
     dirty_descriptor_set_ = true;
+    return;
   }
 
   TextureVk& texture_vk = *(static_cast<TextureVk*>(texture.get()));
@@ -281,36 +460,79 @@ void RendererVk::BindTexture(std::shared_ptr<Texture> texture) {
     return;
   }
   bound_image_view_ = texture_image_view;
+
+  RenderStateVk& state = *(static_cast<RenderStateVk*>(render_state_.get()));
+  bound_descriptor_set_ = GetTextureDescriptorSet(texture_vk, state.GetDescriptorSetLayout());
+  dirty_descriptor_set_ = true;
+}
+
+void RendererVk::SetRenderPass(const RenderPassHandle render_pass) {
+  if (!resources_.Validate(render_pass)) {
+    return;
+  }
+  SetRenderPass(resources_.GetRenderPass(render_pass));
+}
+
+void RendererVk::SetRenderState(const RenderStateHandle render_state) {
+  if (!resources_.Validate(render_state)) {
+    return;
+  }
+  SetRenderState(resources_.GetRenderState(render_state));
+}
+
+void RendererVk::BindIndexBuffer(const IndexBufferHandle index_buffer) {
+  if (!resources_.Validate(index_buffer)) {
+    return;
+  }
+  BindIndexBuffer(resources_.GetIndexBuffer(index_buffer));
+}
+
+void RendererVk::BindVertexBuffer(const VertexBufferHandle vertex_buffer) {
+  if (!resources_.Validate(vertex_buffer)) {
+    return;
+  }
+  BindVertexBuffer(resources_.GetVertexBuffer(vertex_buffer));
+}
+
+void RendererVk::BindTexture(const TextureHandle texture) {
+  if (!resources_.Validate(texture)) {
+    return;
+  }
+  BindTexture(resources_.GetTexture(texture));
+}
+
+VkDescriptorSet RendererVk::GetTextureDescriptorSet(const TextureVk& texture_vk,
+                                                    const VkDescriptorSetLayout layout) {
+  std::lock_guard<std::mutex> descriptor_lock(texture_descriptor_mutex_);
+  const VkImageView texture_image_view = texture_vk.GetImageView();
   for (const TextureDescriptorFrameCache& cache : texture_descriptor_frame_cache_) {
     if (cache.texture_image_view == texture_image_view) {
-      bound_descriptor_set_ = cache.descriptor_set;
-      dirty_descriptor_set_ = true;
-      return;
+      return cache.descriptor_set;
     }
   }
 
   // Create a new descriptor/descriptor set for this texture for this frame and
   // write the descriptor data
-  RenderStateVk& state = *(static_cast<RenderStateVk*>(render_state_.get()));
-
-  VkDescriptorSetLayout descriptor_set_layouts[] = {state.GetDescriptorSetLayout() };
+  VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+  VkDescriptorSetLayout descriptor_set_layouts[] = { layout };
   VkDescriptorSetAllocateInfo descriptor_set_info = {};
   descriptor_set_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
   descriptor_set_info.descriptorPool = active_frame_pool_;
   descriptor_set_info.descriptorSetCount = 1;
   descriptor_set_info.pSetLayouts = descriptor_set_layouts;
   const VkResult allocate_result = vkAllocateDescriptorSets(vk_.device, &descriptor_set_info,
-                                                            &bound_descriptor_set_);
+                                                            &descriptor_set);
   RENDERER_CHECK_VK(allocate_result, "vkAllocateDescriptorSets");
+  stats_.Add(RendererStats::kStat_DescriptorAllocations, 1);
 
   VkDescriptorImageInfo descriptor_image_info = {};
   descriptor_image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-  descriptor_image_info.imageView = texture_vk.GetImageView();
+  descriptor_image_info.imageView = texture_image_view;
   descriptor_image_info.sampler = texture_vk.GetSampler();
 
   VkWriteDescriptorSet write_descriptor_set = {};
   write_descriptor_set.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-  write_descriptor_set.dstSet = bound_descriptor_set_;
+  write_descriptor_set.dstSet = descriptor_set;
   write_descriptor_set.dstBinding = 1;
   write_descriptor_set.dstArrayElement = 0;
   write_descriptor_set.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -318,14 +540,58 @@ void RendererVk::BindTexture(std::shared_ptr<Texture> texture) {
   write_descriptor_set.pImageInfo = &descriptor_image_info;
 
   vkUpdateDescriptorSets(vk_.device, 1, &write_descriptor_set, 0, nullptr);
-  dirty_descriptor_set_ = true;
 
-  texture_descriptor_frame_cache_.push_back(
-      {texture_vk.GetImageView(), bound_descriptor_set_});
+  texture_descriptor_frame_cache_.push_back({texture_image_view, descriptor_set});
+  return descriptor_set;
+}
+
+void RendererVk::ExecuteRecordingContexts(std::shared_ptr<RenderPass> render_pass,
+                                          const std::shared_ptr<RecordingContext>* contexts,
+                                          const uint32_t context_count) {
+  // Secondary command buffers can't be mixed with inline commands in the same
+  // subpass, and beginning the current pass again would re-run its load op and
+  // clear what was already drawn in it
+  RENDERER_ASSERT(render_pass.get() != render_pass_.get() || render_pass_secondary_contents_)
+  if (render_pass.get() != render_pass_.get()) {
+    if (render_pass_.get() != nullptr) {
+      render_pass_->EndRenderPass();
+    }
+    gpu_profiler_->CloseScope(render_pass_gpu_scope_);
+    render_pass_gpu_scope_ = gpu_profiler_->OpenScope(kRenderPassGPUScopeName);
+    render_pass_ = render_pass;
+    render_state_ = nullptr;
+    render_pass_secondary_contents_ = true;
+    RenderPassVk& render_pass_vk = *(static_cast<RenderPassVk*>(render_pass.get()));
+    render_pass_vk.BeginRenderPass(VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+  }
+
+  // Execute in context array order, then in the order each context recorded
+  std::vector<VkCommandBuffer> command_buffers;
+  for (uint32_t i = 0; i < context_count; ++i) {
+    const RecordingContextVk& context = *(static_cast<RecordingContextVk*>(contexts[i].get()));
+    for (const RecordingContextVk::RecordedCommandBuffer& recorded :
+        context.GetRecordedCommandBuffers(frame_number_)) {
+      if (recorded.render_pass == render_pass.get()) {
+        command_buffers.push_back(recorded.command_buffer);
+      }
+    }
+  }
+  if (!command_buffers.empty()) {
+    vkCmdExecuteCommands(render_command_buffer_, command_buffers.size(), command_buffers.data());
+  }
+}
+
+void RendererVk::BeginGPUScope(const char* name) {
+  gpu_profiler_->BeginScope(name);
+}
+
+void RendererVk::EndGPUScope() {
+  gpu_profiler_->EndScope();
 }
 
 std::shared_ptr<IndexBuffer> RendererVk::CreateIndexBuffer(
     const IndexBuffer::IndexBufferCreationParams& params) {
+  stats_.Add(RendererStats::kStat_BufferBytesUploaded, params.data_byte_size);
   return resources_.AddIndexBuffer(new IndexBufferVk(params));
 }
 
@@ -333,6 +599,14 @@ void RendererVk::DestroyIndexBuffer(std::shared_ptr<IndexBuffer> index_buffer) {
   resources_.QueueDeleteIndexBuffer(index_buffer);
 }
 
+std::shared_ptr<RecordingContext> RendererVk::CreateRecordingContext() {
+  return resources_.AddRecordingContext(new RecordingContextVk());
+}
+
+void RendererVk::DestroyRecordingContext(std::shared_ptr<RecordingContext> recording_context) {
+  resources_.QueueDeleteRecordingContext(recording_context);
+}
+
 std::shared_ptr<RenderPass> RendererVk::CreateRenderPass(
     const RenderPass::RenderPassCreationParams& params) {
   return resources_.AddRenderPass(new RenderPassVk(params));
@@ -361,6 +635,12 @@ void RendererVk::DestroyShaderProgram(std::shared_ptr<ShaderProgram> shader_prog
 }
 
 std::shared_ptr<Texture> RendererVk::CreateTexture(const Texture::TextureCreationParams& params) {
+  stats_.AddTextureUpload(params);
+  return resources_.AddTexture(new TextureVk(params));
+}
+
+std::shared_ptr<Texture> RendererVk::CreateRenderTarget(
+    const Texture::RenderTargetCreationParams& params) {
   return resources_.AddTexture(new TextureVk(params));
 }
 
@@ -379,6 +659,7 @@ void RendererVk::DestroyUniformBuffer(std::shared_ptr<UniformBuffer> uniform_buf
 
 std::shared_ptr<VertexBuffer> RendererVk::CreateVertexBuffer(
     const VertexBuffer::VertexBufferCreationParams& params) {
+  stats_.Add(RendererStats::kStat_BufferBytesUploaded, params.data_byte_size);
   return resources_.AddVertexBuffer(new VertexBufferVk(params));
 }
 
@@ -21,10 +21,19 @@
 #include "renderer_interface.h"
 #include "renderer_resources.h"
 #include "vulkan/graphics_api_vulkan_resources.h"
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace simple_renderer {
 
+class GPUProfilerVk;
+class GeometryRingBufferVk;
+class IndirectRingBufferVk;
+class RenderStateVk;
+class TextureVk;
+class UniformRingBufferVk;
+
 /*
 struct RendererVkResources {
   VkDevice device = VK_NULL_HANDLE;
@@ -68,22 +77,47 @@ class RendererVk : public Renderer {
 
   virtual void SwapchainRecreated();
 
+  virtual void AcquireThreadContext();
+  virtual void ReleaseThreadContext();
+
   virtual void Draw(const uint32_t vertex_count, const uint32_t first_vertex);
   virtual void DrawIndexed(const uint32_t index_count, const uint32_t first_index);
+  virtual void DrawIndexed(const uint32_t index_count, const uint32_t first_index,
+                           const uint32_t base_vertex);
+  virtual void DrawIndexedMulti(const DrawIndexedRecord* records, const uint32_t record_count);
+  virtual void DrawIndexedDynamic(const VertexBuffer::VertexFormat vertex_format,
+                                  const void* vertex_data, const uint32_t vertex_count,
+                                  const uint16_t* index_data, const uint32_t index_count);
 
-  virtual void SetRenderPass(std::shared_ptr<RenderPass> render_pass);
-  virtual void SetRenderState(std::shared_ptr<RenderState> render_state);
+  virtual void SetRenderPass(const std::shared_ptr<RenderPass>& render_pass);
+  virtual void SetRenderState(const std::shared_ptr<RenderState>& render_state);
 
   // Resource binds
-  virtual void BindIndexBuffer(std::shared_ptr<IndexBuffer> index_buffer);
-  virtual void BindVertexBuffer(std::shared_ptr<VertexBuffer> vertex_buffer);
-  virtual void BindTexture(std::shared_ptr<Texture> texture);
+  virtual void BindIndexBuffer(const std::shared_ptr<IndexBuffer>& index_buffer);
+  virtual void BindVertexBuffer(const std::shared_ptr<VertexBuffer>& vertex_buffer);
+  virtual void BindTexture(const std::shared_ptr<Texture>& texture);
+
+  virtual void SetRenderPass(const RenderPassHandle render_pass);
+  virtual void SetRenderState(const RenderStateHandle render_state);
+  virtual void BindIndexBuffer(const IndexBufferHandle index_buffer);
+  virtual void BindVertexBuffer(const VertexBufferHandle vertex_buffer);
+  virtual void BindTexture(const TextureHandle texture);
+
+  virtual void ExecuteRecordingContexts(std::shared_ptr<RenderPass> render_pass,
+                                        const std::shared_ptr<RecordingContext>* contexts,
+                                        const uint32_t context_count);
+
+  virtual void BeginGPUScope(const char* name);
+  virtual void EndGPUScope();
 
   // Resource creation and destruction
   virtual std::shared_ptr<IndexBuffer> CreateIndexBuffer(
       const IndexBuffer::IndexBufferCreationParams& params);
   virtual void DestroyIndexBuffer(std::shared_ptr<IndexBuffer> index_buffer);
 
+  virtual std::shared_ptr<RecordingContext> CreateRecordingContext();
+  virtual void DestroyRecordingContext(std::shared_ptr<RecordingContext> recording_context);
+
   virtual std::shared_ptr<RenderPass> CreateRenderPass(
       const RenderPass::RenderPassCreationParams& params);
   virtual void DestroyRenderPass(std::shared_ptr<RenderPass> render_pass);
@@ -98,6 +132,8 @@ class RendererVk : public Renderer {
 
   virtual std::shared_ptr<Texture> CreateTexture(
       const Texture::TextureCreationParams& params);
+  virtual std::shared_ptr<Texture> CreateRenderTarget(
+      const Texture::RenderTargetCreationParams& params);
   virtual void DestroyTexture(std::shared_ptr<Texture> texture);
 
   virtual std::shared_ptr<UniformBuffer> CreateUniformBuffer(
@@ -119,6 +155,16 @@ class RendererVk : public Renderer {
 
   VkDescriptorSetLayout GetDescriptorSetLayout(const VertexBuffer::VertexFormat vertex_format);
 
+  // Returns a descriptor set for the texture allocated from the active frame
+  // descriptor pool. Safe to call from recording context threads.
+  VkDescriptorSet GetTextureDescriptorSet(const TextureVk& texture_vk,
+                                          const VkDescriptorSetLayout layout);
+
+  // Sets the viewport and scissor to cover extent, flip_y negates the viewport
+  // height to match the GL coordinate system
+  void SetViewportAndScissor(VkCommandBuffer command_buffer, const VkExtent2D& extent,
+                             const bool flip_y) const;
+
   // Used for buffer/image copy staging operations, creates and submits a
   // temporary command buffer.
   VkCommandBuffer BeginStagingCommandBuffer();
@@ -127,6 +173,14 @@ class RendererVk : public Renderer {
   VkCommandBuffer GetRenderCommandBuffer() const { return render_command_buffer_; };
   VkExtent2D GetActiveExtent() const { return active_extent_; }
 
+  uint32_t GetInFlightFrameCount() const { return in_flight_frame_count_; }
+  uint32_t GetGraphicsQueueIndex() const { return RendererVk::vk_.graphics_queue_index; }
+  // Index of the in-flight frame slot in use, and a count of frames begun
+  uint32_t GetFrameIndex() const { return RendererVk::swap_.swapchain_frame_index; }
+  uint64_t GetFrameNumber() const { return frame_number_; }
+
+  UniformRingBufferVk& GetUniformRing() const { return *uniform_ring_; }
+
   VkFormat GetSwapchainColorFormat() const { return RendererVk::swap_.swapchain_color_format; }
   VkFormat GetSwapchainDepthStencilFormat() const {
     return RendererVk::swap_.swapchain_depth_stencil_format; }
@@ -152,6 +206,9 @@ class RendererVk : public Renderer {
 
   void CreateDescriptorPools();
 
+  // Bind the descriptor set and uniform data of the current render state for a draw
+  RenderStateVk& PrepareDraw();
+
   RendererResources resources_;
 
   std::shared_ptr<RenderPass> render_pass_;
@@ -160,26 +217,44 @@ class RendererVk : public Renderer {
   VkCommandBuffer staging_command_buffer_;
 
   uint32_t in_flight_frame_count_;
+  uint64_t frame_number_;
+  // Most recent frame known to have completed on the GPU, and the frame last
+  // submitted with the fence of each in-flight frame slot
+  uint64_t completed_frame_number_;
+  std::vector<uint64_t> frame_slot_numbers_;
 
   // Active frame resources
   VkCommandBuffer render_command_buffer_;
   VkExtent2D active_extent_;
   VkDescriptorPool active_frame_pool_;
+  // Set if the active render pass was begun for secondary command buffers
+  bool render_pass_secondary_contents_;
 
   // Active draw resources
   VkDescriptorSet bound_descriptor_set_;
   VkImageView bound_image_view_;
   bool dirty_descriptor_set_;
+  uint32_t bound_uniform_ring_offset_;
 
   VkCommandPool command_pool_;
   std::vector<VkCommandBuffer> command_buffers_;
   std::vector<VkDescriptorPool> descriptor_pools_;
   std::vector<VkDescriptorSetLayout> descriptor_set_layouts_;
+  std::unique_ptr<UniformRingBufferVk> uniform_ring_;
+  std::unique_ptr<GeometryRingBufferVk> geometry_ring_;
+  std::unique_ptr<IndirectRingBufferVk> indirect_ring_;
+  std::unique_ptr<GPUProfilerVk> gpu_profiler_;
+  uint32_t render_pass_gpu_scope_;
+  // Device features enabled for vkCmdDrawIndexedIndirect
+  bool multi_draw_indirect_;
+  bool draw_indirect_first_instance_;
   // Build a mapping table per-vertex format for easier lookup from render state
   std::vector<VkDescriptorSetLayout> descriptor_set_vertex_table_;
   // Plain old vector since we only have a handful of textures, this
   // would need a more efficient storage/lookup method otherwise
   std::vector<TextureDescriptorFrameCache> texture_descriptor_frame_cache_;
+  // Guards the frame descriptor pool and cache against recording context threads
+  std::mutex texture_descriptor_mutex_;
 
   base_game_framework::GraphicsAPIResourcesVk vk_;
   base_game_framework::SwapchainFrameResourcesVk swap_;
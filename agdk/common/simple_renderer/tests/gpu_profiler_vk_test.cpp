@@ -0,0 +1,344 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// Tests of GPUProfilerVk on a Vulkan device, meant for a software implementation such
+// as lavapipe or SwiftShader: records nested scopes around buffer fills over several
+// frames and checks the timings published when each frame slot is reused. A CPU device
+// is preferred when several are present; select one with VK_ICD_FILENAMES.
+// Exits with kSkipped when there is no Vulkan loader, device or timestamp support.
+
+#include "renderer_gpu_profiler_vk.h"
+#include "renderer_stats.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace simple_renderer;
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      ++failures; \
+    } \
+  } while (0)
+
+// ctest SKIP_RETURN_CODE of the test
+static constexpr int kSkipped = 77;
+static constexpr uint32_t kFrameSlotCount = 2;
+static constexpr uint32_t kFrameCount = 6;
+// Each fill writes half of the buffer, long enough to take measurable time on a CPU
+static constexpr VkDeviceSize kBufferSize = 64 * 1024 * 1024;
+
+static const char* kOuterScopeName = "outer";
+static const char* kInnerScopeName = "inner";
+
+struct VulkanContext {
+  VkInstance instance;
+  VkPhysicalDevice physical_device;
+  VkDevice device;
+  VkQueue queue;
+  uint32_t queue_family_index;
+  VkBuffer buffer;
+  VkDeviceMemory buffer_memory;
+  VkCommandPool command_pool;
+  VkCommandBuffer command_buffers[kFrameSlotCount];
+  VkFence fences[kFrameSlotCount];
+};
+
+static VkPhysicalDevice ChoosePhysicalDevice(VkInstance instance) {
+  uint32_t device_count = 0;
+  vkEnumeratePhysicalDevices(instance, &device_count, nullptr);
+  std::vector<VkPhysicalDevice> devices(device_count);
+  vkEnumeratePhysicalDevices(instance, &device_count, devices.data());
+  VkPhysicalDevice chosen = VK_NULL_HANDLE;
+  for (VkPhysicalDevice device : devices) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device, &properties);
+    if (chosen == VK_NULL_HANDLE || properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU) {
+      chosen = device;
+    }
+  }
+  if (chosen != VK_NULL_HANDLE) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(chosen, &properties);
+    printf("Vulkan device: %s\n", properties.deviceName);
+  }
+  return chosen;
+}
+
+// A queue family that can fill buffers and write timestamps
+static bool ChooseQueueFamily(VkPhysicalDevice physical_device, uint32_t& family_index) {
+  uint32_t family_count = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, nullptr);
+  std::vector<VkQueueFamilyProperties> families(family_count);
+  vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, families.data());
+  for (uint32_t i = 0; i < family_count; ++i) {
+    const VkQueueFlags flags = families[i].queueFlags;
+    if ((flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) != 0 &&
+        families[i].timestampValidBits != 0) {
+      family_index = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool CreateBuffer(VulkanContext& context) {
+  VkBufferCreateInfo buffer_info = {};
+  buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  buffer_info.size = kBufferSize;
+  buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+  buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  if (vkCreateBuffer(context.device, &buffer_info, nullptr, &context.buffer) != VK_SUCCESS) {
+    return false;
+  }
+
+  VkMemoryRequirements requirements;
+  vkGetBufferMemoryRequirements(context.device, context.buffer, &requirements);
+  VkPhysicalDeviceMemoryProperties memory_properties;
+  vkGetPhysicalDeviceMemoryProperties(context.physical_device, &memory_properties);
+  uint32_t memory_type = memory_properties.memoryTypeCount;
+  for (uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i) {
+    if ((requirements.memoryTypeBits & (1U << i)) != 0) {
+      memory_type = i;
+      if ((memory_properties.memoryTypes[i].propertyFlags &
+           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) != 0) {
+        break;
+      }
+    }
+  }
+  if (memory_type == memory_properties.memoryTypeCount) {
+    return false;
+  }
+
+  VkMemoryAllocateInfo allocate_info = {};
+  allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocate_info.allocationSize = requirements.size;
+  allocate_info.memoryTypeIndex = memory_type;
+  if (vkAllocateMemory(context.device, &allocate_info, nullptr,
+                       &context.buffer_memory) != VK_SUCCESS) {
+    return false;
+  }
+  return vkBindBufferMemory(context.device, context.buffer, context.buffer_memory, 0) ==
+         VK_SUCCESS;
+}
+
+// Returns kSkipped if Vulkan is not available, 1 on an error, 0 on success
+static int CreateContext(VulkanContext& context) {
+  if (volkInitialize() != VK_SUCCESS) {
+    printf("No Vulkan loader, skipped\n");
+    return kSkipped;
+  }
+
+  VkApplicationInfo application_info = {};
+  application_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+  application_info.pApplicationName = "gpu_profiler_vk_test";
+  application_info.apiVersion = VK_API_VERSION_1_1;
+  VkInstanceCreateInfo instance_info = {};
+  instance_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+  instance_info.pApplicationInfo = &application_info;
+  if (vkCreateInstance(&instance_info, nullptr, &context.instance) != VK_SUCCESS) {
+    printf("No Vulkan driver, skipped\n");
+    return kSkipped;
+  }
+  volkLoadInstance(context.instance);
+
+  context.physical_device = ChoosePhysicalDevice(context.instance);
+  if (context.physical_device == VK_NULL_HANDLE ||
+      !ChooseQueueFamily(context.physical_device, context.queue_family_index)) {
+    printf("No Vulkan device with timestamp support, skipped\n");
+    return kSkipped;
+  }
+
+  const float queue_priority = 1.0f;
+  VkDeviceQueueCreateInfo queue_info = {};
+  queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+  queue_info.queueFamilyIndex = context.queue_family_index;
+  queue_info.queueCount = 1;
+  queue_info.pQueuePriorities = &queue_priority;
+  VkDeviceCreateInfo device_info = {};
+  device_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+  device_info.queueCreateInfoCount = 1;
+  device_info.pQueueCreateInfos = &queue_info;
+  if (vkCreateDevice(context.physical_device, &device_info, nullptr,
+                     &context.device) != VK_SUCCESS) {
+    fprintf(stderr, "vkCreateDevice failed\n");
+    return 1;
+  }
+  volkLoadDevice(context.device);
+  vkGetDeviceQueue(context.device, context.queue_family_index, 0, &context.queue);
+
+  if (!CreateBuffer(context)) {
+    fprintf(stderr, "Creating the fill buffer failed\n");
+    return 1;
+  }
+
+  VkCommandPoolCreateInfo pool_info = {};
+  pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+  pool_info.queueFamilyIndex = context.queue_family_index;
+  VkCommandBufferAllocateInfo allocate_info = {};
+  allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  allocate_info.commandBufferCount = kFrameSlotCount;
+  VkFenceCreateInfo fence_info = {};
+  fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+  fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+  if (vkCreateCommandPool(context.device, &pool_info, nullptr,
+                          &context.command_pool) != VK_SUCCESS) {
+    fprintf(stderr, "vkCreateCommandPool failed\n");
+    return 1;
+  }
+  allocate_info.commandPool = context.command_pool;
+  if (vkAllocateCommandBuffers(context.device, &allocate_info,
+                               context.command_buffers) != VK_SUCCESS) {
+    fprintf(stderr, "vkAllocateCommandBuffers failed\n");
+    return 1;
+  }
+  for (uint32_t i = 0; i < kFrameSlotCount; ++i) {
+    if (vkCreateFence(context.device, &fence_info, nullptr, &context.fences[i]) != VK_SUCCESS) {
+      fprintf(stderr, "vkCreateFence failed\n");
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static void DestroyContext(VulkanContext& context) {
+  if (context.device != VK_NULL_HANDLE) {
+    vkDeviceWaitIdle(context.device);
+    for (uint32_t i = 0; i < kFrameSlotCount; ++i) {
+      vkDestroyFence(context.device, context.fences[i], nullptr);
+    }
+    vkDestroyCommandPool(context.device, context.command_pool, nullptr);
+    vkDestroyBuffer(context.device, context.buffer, nullptr);
+    vkFreeMemory(context.device, context.buffer_memory, nullptr);
+    vkDestroyDevice(context.device, nullptr);
+  }
+  if (context.instance != VK_NULL_HANDLE) {
+    vkDestroyInstance(context.instance, nullptr);
+  }
+}
+
+// The published scopes of a frame: the frame scope, the outer scope around a fill and
+// the inner scope, and the inner scope around a second fill
+static void CheckTimings(const std::vector<RendererStats::GPUScopeTiming>& timings) {
+  CHECK(timings.size() == 3);
+  if (timings.size() != 3) {
+    return;
+  }
+  const RendererStats::GPUScopeTiming& frame = timings[0];
+  const RendererStats::GPUScopeTiming& outer = timings[1];
+  const RendererStats::GPUScopeTiming& inner = timings[2];
+  CHECK(strcmp(frame.name, GPUProfiler::kFrameScopeName) == 0 && frame.depth == 0);
+  CHECK(strcmp(outer.name, kOuterScopeName) == 0 && outer.depth == 1);
+  CHECK(strcmp(inner.name, kInnerScopeName) == 0 && inner.depth == 2);
+  CHECK(inner.gpu_time > 0);
+  CHECK(outer.gpu_time > inner.gpu_time);
+  CHECK(frame.gpu_time >= outer.gpu_time);
+  // Ten seconds is far longer than the fills take on any device, larger times mean
+  // the ticks were scaled wrong
+  CHECK(frame.gpu_time < 10000000000ULL);
+  printf("frame %llu ns, outer %llu ns, inner %llu ns\n",
+         static_cast<unsigned long long>(frame.gpu_time),
+         static_cast<unsigned long long>(outer.gpu_time),
+         static_cast<unsigned long long>(inner.gpu_time));
+}
+
+static bool RunFrames(VulkanContext& context, GPUProfilerVk& profiler, RendererStats& stats) {
+  uint32_t checked_frames = 0;
+  for (uint32_t frame = 0; frame < kFrameCount; ++frame) {
+    const uint32_t slot = frame % kFrameSlotCount;
+    VkCommandBuffer command_buffer = context.command_buffers[slot];
+    // Waiting on the fence of the slot makes its previous results available
+    vkWaitForFences(context.device, 1, &context.fences[slot], VK_TRUE, UINT64_MAX);
+    vkResetFences(context.device, 1, &context.fences[slot]);
+    vkResetCommandBuffer(command_buffer, 0);
+    VkCommandBufferBeginInfo begin_info = {};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(command_buffer, &begin_info);
+
+    profiler.SetCommandBuffer(command_buffer);
+    profiler.BeginFrame(slot, stats);
+    if (frame >= kFrameSlotCount) {
+      CheckTimings(stats.GetGPUScopeTimings());
+      ++checked_frames;
+    } else {
+      CHECK(stats.GetGPUScopeTimings().empty());
+    }
+
+    profiler.BeginScope(kOuterScopeName);
+    vkCmdFillBuffer(command_buffer, context.buffer, 0, kBufferSize / 2, frame);
+    profiler.BeginScope(kInnerScopeName);
+    vkCmdFillBuffer(command_buffer, context.buffer, kBufferSize / 2, kBufferSize / 2, frame);
+    profiler.EndScope();
+    profiler.EndScope();
+    profiler.EndFrame();
+
+    vkEndCommandBuffer(command_buffer);
+    VkSubmitInfo submit_info = {};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &command_buffer;
+    if (vkQueueSubmit(context.queue, 1, &submit_info, context.fences[slot]) != VK_SUCCESS) {
+      fprintf(stderr, "vkQueueSubmit failed\n");
+      return false;
+    }
+  }
+  CHECK(checked_frames == kFrameCount - kFrameSlotCount);
+  return true;
+}
+
+int main() {
+  VulkanContext context = {};
+  const int create_result = CreateContext(context);
+  if (create_result != 0) {
+    DestroyContext(context);
+    return create_result;
+  }
+
+  int result = 0;
+  {
+    RendererStats stats;
+    GPUProfilerVk profiler(context.device, context.physical_device,
+                           context.queue_family_index, kFrameSlotCount);
+    if (!profiler.GetEnabled()) {
+      printf("GPU profiler disabled on this device, skipped\n");
+      result = kSkipped;
+    } else if (!RunFrames(context, profiler, stats)) {
+      result = 1;
+    }
+    // The query pools of the profiler must not be in use when it is destroyed
+    vkDeviceWaitIdle(context.device);
+  }
+  DestroyContext(context);
+
+  if (result != 0) {
+    return result;
+  }
+  if (failures != 0) {
+    fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  printf("GPU profiler tests passed\n");
+  return 0;
+}
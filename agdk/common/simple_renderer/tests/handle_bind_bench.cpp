@@ -0,0 +1,260 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// Host benchmark of the handle overloads of the Renderer bind functions against the
+// shared pointer overloads, on the null renderer: draws the same objects both ways,
+// checks the two command streams are identical, checks a stale handle is skipped
+// instead of dereferenced, then times both ways with the command stream disabled.
+//
+// Usage: handle_bind_bench [object count] [frame count]
+// Exits with a failure status if a check fails.
+
+#include "renderer_interface.h"
+#include "renderer_null.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace simple_renderer;
+
+static const int kTimedPasses = 5;
+static const uint32_t kRenderStateCount = 4;
+static const uint32_t kIndexCount = 36;
+
+static const UniformBuffer::UniformBufferElement kUniformElements[] = {
+    {UniformBuffer::kBufferElement_Float4, UniformBuffer::kElementStageVertexFlag, 0, 0, "u_Value"}
+};
+
+// The resources of one object of the scene, kept both ways like a game would
+struct BenchObject {
+  std::shared_ptr<RenderState> render_state;
+  std::shared_ptr<IndexBuffer> index_buffer;
+  std::shared_ptr<VertexBuffer> vertex_buffer;
+  std::shared_ptr<Texture> texture;
+  RenderStateHandle render_state_handle;
+  IndexBufferHandle index_buffer_handle;
+  VertexBufferHandle vertex_buffer_handle;
+  TextureHandle texture_handle;
+};
+
+struct BenchScene {
+  std::shared_ptr<RenderPass> render_pass;
+  std::shared_ptr<UniformBuffer> uniform_buffer;
+  std::vector<std::shared_ptr<RenderState> > render_states;
+  std::vector<BenchObject> objects;
+};
+
+static void CreateScene(Renderer& renderer, const uint32_t object_count, BenchScene& scene) {
+  RenderPass::RenderPassCreationParams pass_params = {};
+  scene.render_pass = renderer.CreateRenderPass(pass_params);
+
+  UniformBuffer::UniformBufferCreationParams uniform_params = {};
+  uniform_params.element_array = kUniformElements;
+  uniform_params.element_count = 1;
+  uniform_params.data_byte_count = UniformBuffer::kElementSize_Float4;
+  scene.uniform_buffer = renderer.CreateUniformBuffer(uniform_params);
+
+  for (uint32_t i = 0; i < kRenderStateCount; ++i) {
+    RenderState::RenderStateCreationParams state_params = {};
+    state_params.render_pass = scene.render_pass;
+    state_params.state_uniform = scene.uniform_buffer;
+    state_params.state_vertex_layout = VertexBuffer::kVertexFormat_P3;
+    state_params.primitive_type = RenderState::kTriangleList;
+    scene.render_states.push_back(renderer.CreateRenderState(state_params));
+  }
+
+  uint16_t indices[kIndexCount] = {};
+  float vertices[8 * 3] = {};
+  IndexBuffer::IndexBufferCreationParams index_params = {indices, sizeof(indices)};
+  VertexBuffer::VertexBufferCreationParams vertex_params = {vertices,
+      VertexBuffer::kVertexFormat_P3, sizeof(vertices)};
+  const uint32_t texture_size = 4;
+  const uint32_t texel = 0;
+  Texture::TextureCreationParams texture_params = {};
+  texture_params.format = Texture::kTextureFormat_RGBA_8888;
+  texture_params.base_width = 1;
+  texture_params.base_height = 1;
+  texture_params.mip_count = 1;
+  texture_params.texture_sizes = &texture_size;
+  texture_params.texture_data = &texel;
+
+  scene.objects.resize(object_count);
+  for (uint32_t i = 0; i < object_count; ++i) {
+    BenchObject& object = scene.objects[i];
+    // Objects sorted by state, as a game would submit them
+    object.render_state = scene.render_states[(i * kRenderStateCount) / object_count];
+    object.index_buffer = renderer.CreateIndexBuffer(index_params);
+    object.vertex_buffer = renderer.CreateVertexBuffer(vertex_params);
+    object.texture = renderer.CreateTexture(texture_params);
+    object.render_state_handle = object.render_state->GetHandle();
+    object.index_buffer_handle = object.index_buffer->GetHandle();
+    object.vertex_buffer_handle = object.vertex_buffer->GetHandle();
+    object.texture_handle = object.texture->GetHandle();
+  }
+}
+
+static void DestroyScene(Renderer& renderer, BenchScene& scene) {
+  // The renderer asserts it holds the last reference of a resource it deletes
+  for (BenchObject& object : scene.objects) {
+    object.render_state = nullptr;
+    if (object.index_buffer != nullptr) {
+      renderer.DestroyIndexBuffer(std::move(object.index_buffer));
+    }
+    renderer.DestroyVertexBuffer(std::move(object.vertex_buffer));
+    renderer.DestroyTexture(std::move(object.texture));
+  }
+  scene.objects.clear();
+  for (std::shared_ptr<RenderState>& render_state : scene.render_states) {
+    renderer.DestroyRenderState(std::move(render_state));
+  }
+  scene.render_states.clear();
+  renderer.DestroyUniformBuffer(std::move(scene.uniform_buffer));
+  renderer.DestroyRenderPass(std::move(scene.render_pass));
+}
+
+static void DrawObjectsShared(Renderer& renderer, const BenchScene& scene) {
+  for (const BenchObject& object : scene.objects) {
+    renderer.SetRenderState(object.render_state);
+    renderer.BindVertexBuffer(object.vertex_buffer);
+    renderer.BindIndexBuffer(object.index_buffer);
+    renderer.BindTexture(object.texture);
+    renderer.DrawIndexed(kIndexCount, 0);
+  }
+}
+
+static void DrawObjectsHandles(Renderer& renderer, const BenchScene& scene) {
+  for (const BenchObject& object : scene.objects) {
+    renderer.SetRenderState(object.render_state_handle);
+    renderer.BindVertexBuffer(object.vertex_buffer_handle);
+    renderer.BindIndexBuffer(object.index_buffer_handle);
+    renderer.BindTexture(object.texture_handle);
+    renderer.DrawIndexed(kIndexCount, 0);
+  }
+}
+
+typedef void (*DrawFunction)(Renderer&, const BenchScene&);
+
+static std::vector<RendererNull::Command> RecordFrame(Renderer& renderer,
+                                                      const BenchScene& scene,
+                                                      DrawFunction draw) {
+  renderer.BeginFrame(base_game_framework::DisplayManager::kInvalid_swapchain_handle);
+  renderer.SetRenderPass(scene.render_pass);
+  draw(renderer, scene);
+  renderer.EndFrame();
+  return RendererNull::GetInstanceNull().GetCommandStream();
+}
+
+static bool CheckStreams(Renderer& renderer, const BenchScene& scene) {
+  const std::vector<RendererNull::Command> shared_stream =
+      RecordFrame(renderer, scene, DrawObjectsShared);
+  const std::vector<RendererNull::Command> handle_stream =
+      RecordFrame(renderer, scene, DrawObjectsHandles);
+  // A render pass, then the binds and draw of every object, with the render state
+  // only set when it changes
+  const size_t expected_size = 1 + scene.objects.size() * 4 + kRenderStateCount;
+  if (shared_stream.size() != expected_size || handle_stream.size() != expected_size) {
+    fprintf(stderr, "command streams hold %zu and %zu commands, expected %zu\n",
+            shared_stream.size(), handle_stream.size(), expected_size);
+    return false;
+  }
+  for (size_t i = 0; i < expected_size; ++i) {
+    const RendererNull::Command& a = shared_stream[i];
+    const RendererNull::Command& b = handle_stream[i];
+    if (a.type != b.type || a.resource != b.resource || a.count != b.count ||
+        a.first != b.first || a.base_vertex != b.base_vertex) {
+      fprintf(stderr, "command %zu differs between shared pointer and handle binds\n", i);
+      return false;
+    }
+  }
+  printf("shared pointer and handle binds give identical command streams\n");
+  return true;
+}
+
+// Release builds skip binds of stale handles, debug builds assert on them
+static bool CheckStaleHandle(Renderer& renderer, BenchScene& scene) {
+  BenchObject& object = scene.objects[0];
+  const IndexBufferHandle stale_handle = object.index_buffer_handle;
+  renderer.DestroyIndexBuffer(std::move(object.index_buffer));
+
+  renderer.BeginFrame(base_game_framework::DisplayManager::kInvalid_swapchain_handle);
+  renderer.SetRenderPass(scene.render_pass);
+  renderer.BindIndexBuffer(stale_handle);
+  renderer.EndFrame();
+
+  const RendererNull& renderer_null = RendererNull::GetInstanceNull();
+  if (renderer_null.GetCommandStream().size() != 1 ||
+      renderer_null.GetFrameCounters().index_buffer_binds != 0) {
+    fprintf(stderr, "a stale index buffer handle was bound\n");
+    return false;
+  }
+  printf("stale handle bind skipped\n");
+  return true;
+}
+
+// Best of kTimedPasses, in nanoseconds per object
+static double TimeDraw(Renderer& renderer, const BenchScene& scene, const uint32_t frame_count,
+                       DrawFunction draw) {
+  double best = 0.0;
+  for (int pass = 0; pass < kTimedPasses; ++pass) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < frame_count; ++frame) {
+      renderer.BeginFrame(base_game_framework::DisplayManager::kInvalid_swapchain_handle);
+      renderer.SetRenderPass(scene.render_pass);
+      draw(renderer, scene);
+      renderer.EndFrame();
+    }
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (pass == 0 || seconds < best) {
+      best = seconds;
+    }
+  }
+  return best * 1e9 / (static_cast<double>(frame_count) * scene.objects.size());
+}
+
+int main(int argc, char** argv) {
+  const uint32_t object_count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 2000;
+  const uint32_t frame_count = argc > 2 ? strtoul(argv[2], nullptr, 10) : 1000;
+  if (object_count < kRenderStateCount || frame_count == 0) {
+    fprintf(stderr, "usage: %s [object count >= %u] [frame count]\n", argv[0],
+            kRenderStateCount);
+    return 1;
+  }
+
+  Renderer::SetRendererAPI(Renderer::kAPI_Null);
+  Renderer& renderer = Renderer::GetInstance();
+  BenchScene scene;
+  CreateScene(renderer, object_count, scene);
+
+  bool passed = CheckStreams(renderer, scene);
+  if (passed) {
+    RendererNull::GetInstanceNull().SetCommandStreamEnabled(false);
+    const double shared_time = TimeDraw(renderer, scene, frame_count, DrawObjectsShared);
+    const double handle_time = TimeDraw(renderer, scene, frame_count, DrawObjectsHandles);
+    printf("%u objects, %u frames: shared pointer binds %.2f ns, handle binds %.2f ns "
+           "(%.2fx) per object\n", object_count, frame_count, shared_time, handle_time,
+           shared_time / handle_time);
+    RendererNull::GetInstanceNull().SetCommandStreamEnabled(true);
+    passed = CheckStaleHandle(renderer, scene);
+  }
+
+  DestroyScene(renderer, scene);
+  Renderer::ShutdownInstance();
+  return passed ? 0 : 1;
+}
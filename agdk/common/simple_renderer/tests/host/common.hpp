@@ -0,0 +1,34 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host replacement of the common.hpp of the games, providing the logging and assert
+// macros renderer_debug.h maps the renderer ones to. Like the macros of Log.h, the
+// logging macros end with a semicolon, the renderer calls them without one.
+
+#ifndef SIMPLERENDERER_TESTS_HOST_COMMON_HPP
+#define SIMPLERENDERER_TESTS_HOST_COMMON_HPP
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define ALOGE(...) { fprintf(stderr, __VA_ARGS__); fputc('\n', stderr); };
+#define ALOGW(...) { fprintf(stderr, __VA_ARGS__); fputc('\n', stderr); };
+#define ALOGI(...) { fprintf(stdout, __VA_ARGS__); fputc('\n', stdout); };
+
+#define MY_ASSERT(cond) { if (!(cond)) { ALOGE("ASSERTION FAILED: %s", #cond); abort(); } }
+
+#endif // SIMPLERENDERER_TESTS_HOST_COMMON_HPP
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gles_fake.h"
+
+#include <cstring>
+
+GLESFakeState gles_fake;
+
+void GLESFakeReset() {
+  memset(&gles_fake, 0, sizeof(gles_fake));
+}
+
+namespace simple_renderer {
+bool RendererCheckGLES(const char* /*message*/) {
+  return true;
+}
+}
+
+extern "C" {
+
+GL_APICALL void GL_APIENTRY glUseProgram(GLuint program) {
+  ++gles_fake.call_count;
+  gles_fake.program = program;
+}
+
+GL_APICALL void GL_APIENTRY glBindBuffer(GLenum target, GLuint buffer) {
+  ++gles_fake.call_count;
+  if (target == GL_ARRAY_BUFFER) {
+    gles_fake.array_buffer = buffer;
+  } else if (target == GL_ELEMENT_ARRAY_BUFFER) {
+    gles_fake.element_array_buffer = buffer;
+  }
+}
+
+GL_APICALL void GL_APIENTRY glBindBufferRange(GLenum, GLuint, GLuint, GLintptr, GLsizeiptr) {
+  ++gles_fake.call_count;
+}
+
+GL_APICALL void GL_APIENTRY glBindTexture(GLenum, GLuint) {
+  ++gles_fake.call_count;
+}
+
+GL_APICALL void GL_APIENTRY glEnable(GLenum) {
+  ++gles_fake.call_count;
+}
+
+GL_APICALL void GL_APIENTRY glDisable(GLenum) {
+  ++gles_fake.call_count;
+}
+
+GL_APICALL void GL_APIENTRY glBlendFunc(GLenum, GLenum) {
+  ++gles_fake.call_count;
+}
+
+GL_APICALL void GL_APIENTRY glCullFace(GLenum) {
+  ++gles_fake.call_count;
+}
+
+GL_APICALL void GL_APIENTRY glFrontFace(GLenum) {
+  ++gles_fake.call_count;
+}
+
+GL_APICALL void GL_APIENTRY glDepthFunc(GLenum) {
+  ++gles_fake.call_count;
+}
+
+GL_APICALL void GL_APIENTRY glDepthMask(GLboolean) {
+  ++gles_fake.call_count;
+}
+
+GL_APICALL void GL_APIENTRY glDepthRangef(GLfloat, GLfloat) {
+  ++gles_fake.call_count;
+}
+
+GL_APICALL void GL_APIENTRY glLineWidth(GLfloat) {
+  ++gles_fake.call_count;
+}
+
+GL_APICALL void GL_APIENTRY glScissor(GLint, GLint, GLsizei, GLsizei) {
+  ++gles_fake.call_count;
+}
+
+GL_APICALL void GL_APIENTRY glViewport(GLint, GLint, GLsizei, GLsizei) {
+  ++gles_fake.call_count;
+}
+
+GL_APICALL void GL_APIENTRY glEnableVertexAttribArray(GLuint index) {
+  ++gles_fake.call_count;
+  ++gles_fake.attribute_calls;
+  gles_fake.attribute_enabled[index] = true;
+}
+
+GL_APICALL void GL_APIENTRY glDisableVertexAttribArray(GLuint index) {
+  ++gles_fake.call_count;
+  ++gles_fake.attribute_calls;
+  gles_fake.attribute_enabled[index] = false;
+}
+
+} // extern "C"
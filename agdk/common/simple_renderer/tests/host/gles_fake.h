@@ -0,0 +1,40 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host stand-in for the OpenGL ES entry points called by StateCacheGLES. The calls
+// are counted and the state they set is recorded, nothing is rendered.
+
+#ifndef SIMPLERENDERER_TESTS_HOST_GLES_FAKE_H
+#define SIMPLERENDERER_TESTS_HOST_GLES_FAKE_H
+
+#include <cstdint>
+#include <GLES3/gl3.h>
+
+struct GLESFakeState {
+  // Every faked GL call made since the last GLESFakeReset
+  uint64_t call_count;
+  uint64_t attribute_calls;
+  bool attribute_enabled[32];
+  GLuint program;
+  GLuint array_buffer;
+  GLuint element_array_buffer;
+};
+
+extern GLESFakeState gles_fake;
+
+void GLESFakeReset();
+
+#endif // SIMPLERENDERER_TESTS_HOST_GLES_FAKE_H
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Tests of RangeAllocator, the allocator behind the vertex and index ranges of a
+// GeometryArena: allocation and freeing, merging of free ranges, the high water mark and
+// the fragmentation statistics, then random allocations checked against a per-element map.
+
+#include "renderer_range_allocator.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using simple_renderer::RangeAllocator;
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      ++failures; \
+    } \
+  } while (0)
+
+static void TestAllocate() {
+  RangeAllocator allocator(100);
+  uint32_t offset = 1;
+  CHECK(allocator.Allocate(0, offset) && offset == 0);
+  CHECK(allocator.GetUsed() == 0 && allocator.GetHighWaterMark() == 0);
+
+  CHECK(allocator.Allocate(10, offset) && offset == 0);
+  CHECK(allocator.Allocate(20, offset) && offset == 10);
+  CHECK(allocator.Allocate(70, offset) && offset == 30);
+  CHECK(allocator.GetUsed() == 100);
+  CHECK(allocator.GetFreeBlockCount() == 0 && allocator.GetLargestFreeBlock() == 0);
+  CHECK(allocator.GetFragmentation() == 0.0f);
+  CHECK(!allocator.Allocate(1, offset));
+
+  RangeAllocator empty(0);
+  CHECK(!empty.Allocate(1, offset));
+  CHECK(empty.GetHighWaterMark() == 0 && empty.GetFreeBlockCount() == 0);
+}
+
+static void TestFreeAndMerge() {
+  RangeAllocator allocator(50);
+  uint32_t offsets[5];
+  for (uint32_t i = 0; i < 5; ++i) {
+    CHECK(allocator.Allocate(10, offsets[i]) && offsets[i] == i * 10);
+  }
+
+  // Separate holes, then a block joining its two neighbours
+  allocator.Free(offsets[1], 10);
+  allocator.Free(offsets[3], 10);
+  CHECK(allocator.GetFreeBlockCount() == 2 && allocator.GetLargestFreeBlock() == 10);
+  allocator.Free(offsets[2], 10);
+  CHECK(allocator.GetFreeBlockCount() == 1 && allocator.GetLargestFreeBlock() == 30);
+
+  // First fit takes the lowest hole, a smaller block splits it
+  uint32_t offset = 0;
+  CHECK(allocator.Allocate(5, offset) && offset == 10);
+  CHECK(allocator.GetFreeBlockCount() == 1 && allocator.GetLargestFreeBlock() == 25);
+  allocator.Free(offset, 5);
+
+  // Merging with the previous range only, and with the next range only
+  allocator.Free(offsets[0], 10);
+  CHECK(allocator.GetFreeBlockCount() == 1 && allocator.GetLargestFreeBlock() == 40);
+  allocator.Free(offsets[4], 10);
+  CHECK(allocator.GetFreeBlockCount() == 1 && allocator.GetLargestFreeBlock() == 50);
+  CHECK(allocator.GetUsed() == 0);
+
+  // Freeing 0 elements does nothing
+  allocator.Free(0, 0);
+  CHECK(allocator.GetFreeBlockCount() == 1 && allocator.GetUsed() == 0);
+}
+
+static void TestHighWaterMark() {
+  RangeAllocator allocator(64);
+  uint32_t low = 0, middle = 0, high = 0;
+  CHECK(allocator.Allocate(16, low));
+  CHECK(allocator.Allocate(16, middle));
+  CHECK(allocator.Allocate(16, high));
+  CHECK(allocator.GetHighWaterMark() == 48);
+
+  // Holes below the highest block do not lower the mark, freeing the highest does
+  allocator.Free(middle, 16);
+  CHECK(allocator.GetHighWaterMark() == 48);
+  allocator.Free(high, 16);
+  CHECK(allocator.GetHighWaterMark() == 16);
+  allocator.Free(low, 16);
+  CHECK(allocator.GetHighWaterMark() == 0);
+
+  // A full allocator has its mark at the capacity
+  CHECK(allocator.Allocate(64, low) && allocator.GetHighWaterMark() == 64);
+}
+
+static void TestFragmentation() {
+  RangeAllocator allocator(40);
+  uint32_t offsets[4];
+  for (uint32_t i = 0; i < 4; ++i) {
+    CHECK(allocator.Allocate(10, offsets[i]));
+  }
+  allocator.Free(offsets[0], 10);
+  allocator.Free(offsets[2], 10);
+  // 20 elements free, largest block 10
+  CHECK(fabsf(allocator.GetFragmentation() - 0.5f) < 1e-6f);
+  uint32_t offset = 0;
+  CHECK(!allocator.Allocate(20, offset));
+
+  allocator.Free(offsets[1], 10);
+  CHECK(allocator.GetFragmentation() == 0.0f);
+  CHECK(allocator.Allocate(30, offset) && offset == 0);
+}
+
+// Random allocations and frees, checking the allocator against a per-element map
+static void TestRandom() {
+  const uint32_t capacity = 1000;
+  RangeAllocator allocator(capacity);
+  std::vector<bool> used(capacity, false);
+  struct Block {
+    uint32_t offset;
+    uint32_t count;
+  };
+  std::vector<Block> blocks;
+  std::mt19937 rng(1);
+
+  for (int step = 0; step < 20000 && failures == 0; ++step) {
+    if (blocks.empty() || rng() % 3 != 0) {
+      const uint32_t count = 1 + rng() % 40;
+      // Expected first fit offset from the map
+      uint32_t expected = capacity;
+      for (uint32_t start = 0, run = 0; start < capacity; ++start) {
+        run = used[start] ? 0 : run + 1;
+        if (run == count) {
+          expected = start + 1 - count;
+          break;
+        }
+      }
+      uint32_t offset = 0;
+      const bool allocated = allocator.Allocate(count, offset);
+      CHECK(allocated == (expected != capacity));
+      if (allocated) {
+        CHECK(offset == expected);
+        for (uint32_t i = offset; i < offset + count; ++i) {
+          used[i] = true;
+        }
+        blocks.push_back({offset, count});
+      }
+    } else {
+      const size_t index = rng() % blocks.size();
+      allocator.Free(blocks[index].offset, blocks[index].count);
+      for (uint32_t i = blocks[index].offset; i < blocks[index].offset + blocks[index].count;
+           ++i) {
+        used[i] = false;
+      }
+      blocks[index] = blocks.back();
+      blocks.pop_back();
+    }
+
+    uint32_t used_count = 0, free_blocks = 0, largest = 0, high_water_mark = 0, run = 0;
+    for (uint32_t i = 0; i < capacity; ++i) {
+      if (used[i]) {
+        ++used_count;
+        high_water_mark = i + 1;
+        run = 0;
+      } else {
+        free_blocks += (run == 0) ? 1 : 0;
+        ++run;
+        largest = (run > largest) ? run : largest;
+      }
+    }
+    CHECK(allocator.GetUsed() == used_count);
+    CHECK(allocator.GetFreeBlockCount() == free_blocks);
+    CHECK(allocator.GetLargestFreeBlock() == largest);
+    CHECK(allocator.GetHighWaterMark() == high_water_mark);
+  }
+}
+
+int main() {
+  TestAllocate();
+  TestFreeAndMerge();
+  TestHighWaterMark();
+  TestFragmentation();
+  TestRandom();
+  if (failures != 0) {
+    fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  printf("RangeAllocator tests passed\n");
+  return 0;
+}
@@ -0,0 +1,229 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Tests of RecordingContext on the null renderer: contexts recorded concurrently by
+// several threads are replayed in context array order, each in recording order, only
+// for the render pass they were recorded against, with the uniform data captured at
+// each draw. The uniform buffers hold the contents the game set again afterwards.
+
+#include "renderer_interface.h"
+#include "renderer_null.h"
+#include "renderer_uniform_buffer_null.h"
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace simple_renderer;
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      ++failures; \
+    } \
+  } while (0)
+
+static constexpr uint32_t kThreadCount = 4;
+static constexpr uint32_t kDrawsPerThread = 2000;
+
+static const UniformBuffer::UniformBufferElement kUniformElements[] = {
+    {UniformBuffer::kBufferElement_Float4, UniformBuffer::kElementStageVertexFlag, 0, 0, "u_Value"}
+};
+
+static std::shared_ptr<RenderPass> CreateRenderPass(Renderer& renderer) {
+  RenderPass::RenderPassCreationParams params = {};
+  return renderer.CreateRenderPass(params);
+}
+
+static std::shared_ptr<UniformBuffer> CreateUniformBuffer(Renderer& renderer) {
+  UniformBuffer::UniformBufferCreationParams params = {};
+  params.element_array = kUniformElements;
+  params.element_count = 1;
+  params.buffer_flags = UniformBuffer::kBufferFlag_UpdateDynamicPerDraw;
+  params.data_byte_count = UniformBuffer::kElementSize_Float4;
+  return renderer.CreateUniformBuffer(params);
+}
+
+static std::shared_ptr<RenderState> CreateRenderState(Renderer& renderer,
+    const std::shared_ptr<RenderPass>& render_pass,
+    const std::shared_ptr<UniformBuffer>& uniform_buffer) {
+  RenderState::RenderStateCreationParams params = {};
+  params.render_pass = render_pass;
+  params.state_uniform = uniform_buffer;
+  params.state_vertex_layout = VertexBuffer::kVertexFormat_P3;
+  params.primitive_type = RenderState::kTriangleList;
+  return renderer.CreateRenderState(params);
+}
+
+static void SetValue(UniformBuffer& uniform_buffer, const float value) {
+  const float data[4] = {value, 0.0f, 0.0f, 0.0f};
+  uniform_buffer.SetBufferElementData(0, data, UniformBuffer::kElementSize_Float4);
+}
+
+static float GetValue(const std::shared_ptr<UniformBuffer>& uniform_buffer) {
+  return static_cast<const UniformBufferNull*>(uniform_buffer.get())->GetBufferData()[0];
+}
+
+// Draw counts encode the recording thread and the draw number
+static uint32_t DrawCount(const uint32_t thread, const uint32_t draw) {
+  return (thread + 1) * 100000 + draw;
+}
+
+struct ThreadResources {
+  std::shared_ptr<RecordingContext> context;
+  std::shared_ptr<UniformBuffer> uniform_buffer;
+  std::shared_ptr<RenderState> render_state;
+};
+
+static void RecordThread(const uint32_t thread, ThreadResources& resources,
+                         const std::shared_ptr<RenderPass>& main_pass,
+                         const std::shared_ptr<RenderPass>& overlay_pass) {
+  RecordingContext& context = *resources.context;
+  context.BeginRecording(main_pass);
+  context.SetRenderState(resources.render_state);
+  for (uint32_t draw = 0; draw < kDrawsPerThread; ++draw) {
+    SetValue(*resources.uniform_buffer, static_cast<float>(DrawCount(thread, draw)));
+    context.Draw(DrawCount(thread, draw), draw);
+  }
+  context.EndRecording();
+
+  // A second pass recorded by the same context, executed separately
+  context.BeginRecording(overlay_pass);
+  context.SetRenderState(resources.render_state);
+  context.DrawIndexed(DrawCount(thread, 0), 3, 7);
+  context.EndRecording();
+
+  // The value the game leaves in the buffer, Execute must restore it
+  SetValue(*resources.uniform_buffer, -1.0f - thread);
+}
+
+// Checks the command stream from start holds the replay of every thread in array
+// order, returns the position after it
+static size_t CheckMainPass(const std::vector<RendererNull::Command>& stream, size_t start,
+                            const std::vector<ThreadResources>& threads) {
+  size_t position = start;
+  for (uint32_t thread = 0; thread < kThreadCount; ++thread) {
+    CHECK(position < stream.size());
+    if (position >= stream.size()) {
+      return position;
+    }
+    CHECK(stream[position].type == RendererNull::kCommand_SetRenderState);
+    CHECK(stream[position].resource == threads[thread].render_state.get());
+    ++position;
+    for (uint32_t draw = 0; draw < kDrawsPerThread; ++draw, ++position) {
+      if (position >= stream.size()) {
+        CHECK(position < stream.size());
+        return position;
+      }
+      const RendererNull::Command& command = stream[position];
+      if (command.type != RendererNull::kCommand_Draw ||
+          command.count != DrawCount(thread, draw) || command.first != draw) {
+        fprintf(stderr, "thread %u draw %u replayed out of order\n", thread, draw);
+        ++failures;
+        return stream.size();
+      }
+    }
+  }
+  return position;
+}
+
+static void TestConcurrentRecording() {
+  Renderer::SetRendererAPI(Renderer::kAPI_Null);
+  Renderer& renderer = Renderer::GetInstance();
+  RendererNull& renderer_null = RendererNull::GetInstanceNull();
+
+  std::shared_ptr<RenderPass> main_pass = CreateRenderPass(renderer);
+  std::shared_ptr<RenderPass> overlay_pass = CreateRenderPass(renderer);
+  std::vector<ThreadResources> threads(kThreadCount);
+  std::vector<std::shared_ptr<RecordingContext> > contexts;
+  for (ThreadResources& resources : threads) {
+    resources.context = renderer.CreateRecordingContext();
+    resources.uniform_buffer = CreateUniformBuffer(renderer);
+    resources.render_state = CreateRenderState(renderer, main_pass, resources.uniform_buffer);
+    contexts.push_back(resources.context);
+  }
+
+  for (uint32_t frame = 0; frame < 3; ++frame) {
+    renderer.BeginFrame(base_game_framework::DisplayManager::kInvalid_swapchain_handle);
+    std::vector<std::thread> workers;
+    for (uint32_t thread = 0; thread < kThreadCount; ++thread) {
+      workers.emplace_back(RecordThread, thread, std::ref(threads[thread]), std::cref(main_pass),
+                           std::cref(overlay_pass));
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+
+    renderer.ExecuteRecordingContexts(main_pass, contexts.data(), kThreadCount);
+    renderer.ExecuteRecordingContexts(overlay_pass, contexts.data(), kThreadCount);
+    renderer.EndFrame();
+
+    const std::vector<RendererNull::Command>& stream = renderer_null.GetCommandStream();
+    CHECK(!stream.empty() && stream[0].type == RendererNull::kCommand_SetRenderPass &&
+          stream[0].resource == main_pass.get());
+    size_t position = CheckMainPass(stream, 1, threads);
+
+    // The overlay pass only replays the single indexed draw of each context
+    CHECK(position < stream.size() &&
+          stream[position].type == RendererNull::kCommand_SetRenderPass &&
+          stream[position].resource == overlay_pass.get());
+    ++position;
+    for (uint32_t thread = 0; thread < kThreadCount && position + 1 < stream.size(); ++thread) {
+      CHECK(stream[position].type == RendererNull::kCommand_SetRenderState);
+      const RendererNull::Command& draw = stream[position + 1];
+      CHECK(draw.type == RendererNull::kCommand_DrawIndexed);
+      CHECK(draw.count == DrawCount(thread, 0) && draw.first == 3 && draw.base_vertex == 7);
+      position += 2;
+    }
+    CHECK(position == stream.size());
+
+    // Every replayed draw saw new uniform data, captured when it was recorded
+    const RendererNull::Counters& counters = renderer_null.GetFrameCounters();
+    const uint32_t draw_count = kThreadCount * (kDrawsPerThread + 1);
+    CHECK(counters.draw_calls == draw_count);
+    CHECK(counters.uniform_bytes == draw_count * UniformBuffer::kElementSize_Float4);
+
+    for (uint32_t thread = 0; thread < kThreadCount; ++thread) {
+      CHECK(GetValue(threads[thread].uniform_buffer) == -1.0f - thread);
+    }
+  }
+
+  for (ThreadResources& resources : threads) {
+    renderer.DestroyRecordingContext(resources.context);
+    renderer.DestroyRenderState(resources.render_state);
+    renderer.DestroyUniformBuffer(resources.uniform_buffer);
+  }
+  contexts.clear();
+  threads.clear();
+  renderer.DestroyRenderPass(main_pass);
+  renderer.DestroyRenderPass(overlay_pass);
+  main_pass = nullptr;
+  overlay_pass = nullptr;
+  Renderer::ShutdownInstance();
+}
+
+int main() {
+  TestConcurrentRecording();
+  if (failures != 0) {
+    fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  printf("RecordingContext tests passed\n");
+  return 0;
+}
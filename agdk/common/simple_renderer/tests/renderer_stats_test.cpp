@@ -0,0 +1,224 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// Tests of the RendererStats history: the per-frame values and frame numbers kept
+// once the history ring has wrapped, GetSummary minimum, average and maximum over
+// windows that straddle the wrap, and the values written by the CSV and JSON dumps.
+
+#include "renderer_stats.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace simple_renderer;
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      ++failures; \
+    } \
+  } while (0)
+
+static const uint32_t kHistory = RendererStats::kHistoryFrameCount;
+// Enough frames to wrap the history ring, leaving its start mid-array
+static const uint32_t kFrameCount = kHistory * 2 + 37;
+
+static const char* kDumpPath = "renderer_stats_test_dump.txt";
+
+// Draw call count of a frame, in no particular order so min and max aren't at the ends
+static uint64_t FrameDraws(const uint64_t frame) {
+  return (frame * 37) % 101;
+}
+
+// Records frames [first, first + count) the way the renderer does: the statistics of
+// the frame in progress, then BeginFrame of the next frame completes it
+static void RecordFrames(RendererStats& stats, const uint64_t first, const uint32_t count) {
+  for (uint64_t frame = first; frame < first + count; ++frame) {
+    for (uint64_t draw = 0; draw < FrameDraws(frame); ++draw) {
+      stats.AddDraw(true, 3);
+    }
+    stats.Add(RendererStats::kStat_UniformBytes, 16);
+    stats.BeginFrame(frame + 1);
+  }
+}
+
+static RendererStats::StatSummary ExpectedSummary(const uint64_t frame_count,
+                                                  const uint32_t window) {
+  const uint32_t count = std::min(window, std::min(kHistory,
+                                                   static_cast<uint32_t>(frame_count)));
+  RendererStats::StatSummary summary = {1e30, 0.0, 0.0};
+  uint64_t total = 0;
+  for (uint64_t frame = frame_count - count; frame < frame_count; ++frame) {
+    const double value = static_cast<double>(FrameDraws(frame));
+    summary.min = std::min(summary.min, value);
+    summary.max = std::max(summary.max, value);
+    total += FrameDraws(frame);
+  }
+  summary.avg = static_cast<double>(total) / count;
+  return summary;
+}
+
+static bool SummaryEqual(const RendererStats::StatSummary& a,
+                         const RendererStats::StatSummary& b) {
+  return a.min == b.min && a.avg == b.avg && a.max == b.max;
+}
+
+static void TestEmpty() {
+  RendererStats stats;
+  const RendererStats::StatSummary summary = stats.GetSummary(RendererStats::kStat_DrawCalls, 10);
+  CHECK(summary.min == 0.0 && summary.avg == 0.0 && summary.max == 0.0);
+  CHECK(stats.GetHistoryFrameCount() == 0);
+  CHECK(stats.GetLastFrameStats().values[RendererStats::kStat_DrawCalls] == 0);
+}
+
+static void TestPartialHistory() {
+  RendererStats stats;
+  RecordFrames(stats, 0, 10);
+  CHECK(stats.GetHistoryFrameCount() == 10);
+  CHECK(stats.GetHistoryFrameStats(0).frame_number == 0);
+  CHECK(stats.GetLastFrameStats().frame_number == 9);
+  // Windows larger than the frames recorded so far cover only those frames
+  CHECK(SummaryEqual(stats.GetSummary(RendererStats::kStat_DrawCalls, 60),
+                     ExpectedSummary(10, 60)));
+  CHECK(SummaryEqual(stats.GetSummary(RendererStats::kStat_DrawCalls, 4),
+                     ExpectedSummary(10, 4)));
+}
+
+static void TestWrappedHistory() {
+  RendererStats stats;
+  RecordFrames(stats, 0, kFrameCount);
+  CHECK(stats.GetHistoryFrameCount() == kHistory);
+
+  // The history holds the last kHistory frames, oldest first
+  bool history_matches = true;
+  for (uint32_t i = 0; i < kHistory; ++i) {
+    const RendererStats::FrameStats& frame_stats = stats.GetHistoryFrameStats(i);
+    const uint64_t frame = kFrameCount - kHistory + i;
+    if (frame_stats.frame_number != frame ||
+        frame_stats.values[RendererStats::kStat_DrawCalls] != FrameDraws(frame) ||
+        frame_stats.values[RendererStats::kStat_Triangles] != FrameDraws(frame)) {
+      history_matches = false;
+    }
+  }
+  CHECK(history_matches);
+  CHECK(stats.GetLastFrameStats().frame_number == kFrameCount - 1);
+
+  // 37 frames are at the start of the array, longer windows straddle the wrap
+  const uint32_t windows[] = {1, 10, 37, 38, 60, kHistory - 1, kHistory, kHistory + 50};
+  for (const uint32_t window : windows) {
+    const RendererStats::StatSummary summary =
+        stats.GetSummary(RendererStats::kStat_DrawCalls, window);
+    const RendererStats::StatSummary expected = ExpectedSummary(kFrameCount, window);
+    if (!SummaryEqual(summary, expected)) {
+      fprintf(stderr, "window %u: min %g avg %g max %g, expected %g %g %g\n", window,
+              summary.min, summary.avg, summary.max, expected.min, expected.avg,
+              expected.max);
+      ++failures;
+    }
+  }
+
+  // A constant statistic summarizes to itself
+  const RendererStats::StatSummary uniform =
+      stats.GetSummary(RendererStats::kStat_UniformBytes, kHistory);
+  CHECK(uniform.min == 16.0 && uniform.avg == 16.0 && uniform.max == 16.0);
+}
+
+static std::string ReadFile(const char* path) {
+  std::string contents;
+  FILE* file = fopen(path, "r");
+  if (file == nullptr) {
+    return contents;
+  }
+  char buffer[4096];
+  size_t read_size = 0;
+  while ((read_size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    contents.append(buffer, read_size);
+  }
+  fclose(file);
+  return contents;
+}
+
+static void TestDumps() {
+  const uint32_t interval = 50;
+  // kFrameCount is not a multiple of the interval, record up to a dump frame
+  const uint32_t dump_frames = kFrameCount - (kFrameCount % interval);
+  CHECK(dump_frames > kHistory);
+  char expected_last_csv[256];
+  const RendererStats::StatSummary expected_last = ExpectedSummary(dump_frames, interval);
+  snprintf(expected_last_csv, sizeof(expected_last_csv), "%u,draw_calls,%.0f,%.2f,%.0f\n",
+           dump_frames - 1, expected_last.min, expected_last.avg, expected_last.max);
+
+  remove(kDumpPath);
+  {
+    RendererStats stats;
+    stats.SetDumpInterval(interval, RendererStats::kDumpFormat_CSV, kDumpPath);
+    RecordFrames(stats, 0, dump_frames);
+    const std::string dump = ReadFile(kDumpPath);
+    CHECK(dump.compare(0, strlen("frame,stat,min,avg,max\n"), "frame,stat,min,avg,max\n") == 0);
+    // One row per statistic for each dump
+    CHECK(static_cast<size_t>(std::count(dump.begin(), dump.end(), '\n')) ==
+          1 + (dump_frames / interval) * RendererStats::kStat_Count);
+    CHECK(dump.find(expected_last_csv) != std::string::npos);
+  }
+  remove(kDumpPath);
+
+  {
+    RendererStats stats;
+    stats.SetDumpInterval(interval, RendererStats::kDumpFormat_JSON, kDumpPath);
+    RecordFrames(stats, 0, dump_frames);
+    const std::string dump = ReadFile(kDumpPath);
+    CHECK(static_cast<size_t>(std::count(dump.begin(), dump.end(), '\n')) ==
+          dump_frames / interval);
+    char expected_last_json[256];
+    snprintf(expected_last_json, sizeof(expected_last_json),
+             "{\"frame\":%u,\"frame_count\":%u,\"draw_calls\":{\"min\":%.0f,\"avg\":%.2f,"
+             "\"max\":%.0f}", dump_frames - 1, interval, expected_last.min, expected_last.avg,
+             expected_last.max);
+    CHECK(dump.find(expected_last_json) != std::string::npos);
+  }
+  remove(kDumpPath);
+}
+
+static void TestGPUScopeTimings() {
+  RendererStats stats;
+  const RendererStats::GPUScopeTiming timings[] = {{"frame", 0, 5000}, {"pass", 1, 3000}};
+  stats.SetGPUScopeTimings(std::vector<RendererStats::GPUScopeTiming>(timings, timings + 2));
+  stats.BeginFrame(1);
+  CHECK(stats.GetGPUScopeTimings().size() == 2);
+  // The frame scope is also recorded as the GPU frame time of the frame
+  CHECK(stats.GetLastFrameStats().values[RendererStats::kStat_GPUFrameTime] == 5000);
+}
+
+int main() {
+  TestEmpty();
+  TestPartialHistory();
+  TestWrappedHistory();
+  TestDumps();
+  TestGPUScopeTimings();
+  if (failures != 0) {
+    fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  printf("RendererStats tests passed\n");
+  return 0;
+}
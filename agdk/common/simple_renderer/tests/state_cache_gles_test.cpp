@@ -0,0 +1,184 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Tests of StateCacheGLES against a fake GL: redundant calls are elided and counted,
+// every issued call reaches GL, invalidation forces the next calls through, and vertex
+// attributes left enabled before an invalidation are disabled when a later draw doesn't
+// use them.
+
+#include "renderer_state_cache_gles.h"
+#include "gles_fake.h"
+
+#include <cstdio>
+
+using simple_renderer::StateCacheGLES;
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      ++failures; \
+    } \
+  } while (0)
+
+// Make the same state changes twice, as two draws sharing a render state would
+static void SetDrawState(StateCacheGLES& cache) {
+  cache.UseProgram(3);
+  cache.BindBuffer(GL_ARRAY_BUFFER, 4);
+  cache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 5);
+  cache.BindTexture(6);
+  cache.SetCapability(GL_DEPTH_TEST, true);
+  cache.SetCapability(GL_BLEND, false);
+  cache.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  cache.DepthFunc(GL_LEQUAL);
+  cache.Viewport(0, 0, 640, 480);
+  cache.Scissor(0, 0, 640, 480);
+}
+static const uint64_t kDrawStateCalls = 10;
+
+static void TestElision() {
+  GLESFakeReset();
+  StateCacheGLES cache;
+  SetDrawState(cache);
+  CHECK(cache.GetCounters().issued_calls == kDrawStateCalls);
+  CHECK(cache.GetCounters().elided_calls == 0);
+  CHECK(gles_fake.call_count == kDrawStateCalls);
+  CHECK(gles_fake.program == 3 && gles_fake.array_buffer == 4);
+
+  SetDrawState(cache);
+  CHECK(cache.GetCounters().issued_calls == kDrawStateCalls);
+  CHECK(cache.GetCounters().elided_calls == kDrawStateCalls);
+  CHECK(gles_fake.call_count == kDrawStateCalls);
+
+  // A changed value is issued, the unchanged ones are still elided
+  cache.BindBuffer(GL_ARRAY_BUFFER, 7);
+  cache.UseProgram(3);
+  CHECK(cache.GetCounters().issued_calls == kDrawStateCalls + 1);
+  CHECK(cache.GetCounters().elided_calls == kDrawStateCalls + 1);
+  CHECK(gles_fake.call_count == kDrawStateCalls + 1 && gles_fake.array_buffer == 7);
+
+  cache.ResetCounters();
+  CHECK(cache.GetCounters().issued_calls == 0 && cache.GetCounters().elided_calls == 0);
+}
+
+static void TestDisabledAndInvalidated() {
+  GLESFakeReset();
+  StateCacheGLES cache;
+  cache.SetEnabled(false);
+  SetDrawState(cache);
+  SetDrawState(cache);
+  CHECK(cache.GetCounters().issued_calls == 2 * kDrawStateCalls);
+  CHECK(cache.GetCounters().elided_calls == 0);
+  CHECK(gles_fake.call_count == 2 * kDrawStateCalls);
+
+  // Start from a clean shadow state when turning the cache back on
+  GLESFakeReset();
+  cache.SetEnabled(true);
+  cache.Invalidate();
+  cache.ResetCounters();
+  SetDrawState(cache);
+  cache.Invalidate();
+  SetDrawState(cache);
+  CHECK(cache.GetCounters().issued_calls == 2 * kDrawStateCalls);
+  CHECK(gles_fake.call_count == 2 * kDrawStateCalls);
+
+  // Individual invalidation only forces the matching call through
+  cache.InvalidateBufferBinding(GL_ELEMENT_ARRAY_BUFFER);
+  cache.InvalidateProgram();
+  SetDrawState(cache);
+  CHECK(cache.GetCounters().issued_calls == 2 * kDrawStateCalls + 2);
+  CHECK(cache.GetCounters().elided_calls == kDrawStateCalls - 2);
+}
+
+static void TestVertexAttributes() {
+  GLESFakeReset();
+  StateCacheGLES cache;
+  cache.Invalidate();
+
+  // Position and color enabled by one frame
+  cache.DisableVertexAttributes(0x5);
+  cache.SetVertexAttributeEnabled(0, true);
+  cache.SetVertexAttributeEnabled(2, true);
+  CHECK(gles_fake.attribute_enabled[0] && gles_fake.attribute_enabled[2]);
+  CHECK(!gles_fake.attribute_enabled[1]);
+
+  // Same layout again, nothing is issued
+  uint64_t attribute_calls = gles_fake.attribute_calls;
+  cache.DisableVertexAttributes(0x5);
+  cache.SetVertexAttributeEnabled(0, true);
+  cache.SetVertexAttributeEnabled(2, true);
+  CHECK(gles_fake.attribute_calls == attribute_calls);
+
+  // Next frame: other code enables an attribute, then a position only draw must
+  // disable everything else, including the color attribute of the previous frame
+  cache.Invalidate();
+  glEnableVertexAttribArray(9);
+  cache.DisableVertexAttributes(0x1);
+  cache.SetVertexAttributeEnabled(0, true);
+  CHECK(gles_fake.attribute_enabled[0]);
+  for (GLuint location = 1; location < StateCacheGLES::kMaxVertexAttributes; ++location) {
+    CHECK(!gles_fake.attribute_enabled[location]);
+  }
+
+  // The state is known again, a second position only draw issues nothing
+  attribute_calls = gles_fake.attribute_calls;
+  cache.DisableVertexAttributes(0x1);
+  cache.SetVertexAttributeEnabled(0, true);
+  CHECK(gles_fake.attribute_calls == attribute_calls);
+
+  // Switching back to the color layout only enables the color attribute
+  cache.DisableVertexAttributes(0x5);
+  cache.SetVertexAttributeEnabled(0, true);
+  cache.SetVertexAttributeEnabled(2, true);
+  CHECK(gles_fake.attribute_calls == attribute_calls + 1);
+  CHECK(gles_fake.attribute_enabled[2]);
+}
+
+static void TestVertexAttributesOwner() {
+  GLESFakeReset();
+  StateCacheGLES cache;
+  int owner = 0;
+  int other_owner = 0;
+  cache.BindBuffer(GL_ARRAY_BUFFER, 4);
+  cache.SetVertexAttributesOwner(&owner, 0);
+  CHECK(cache.GetVertexAttributesCurrent(&owner, 0));
+  CHECK(!cache.GetVertexAttributesCurrent(&owner, 12));
+  CHECK(!cache.GetVertexAttributesCurrent(&other_owner, 0));
+
+  // Pointers were captured for buffer 4, another buffer needs them set again
+  cache.BindBuffer(GL_ARRAY_BUFFER, 7);
+  CHECK(!cache.GetVertexAttributesCurrent(&owner, 0));
+  cache.BindBuffer(GL_ARRAY_BUFFER, 4);
+  CHECK(cache.GetVertexAttributesCurrent(&owner, 0));
+
+  cache.Invalidate();
+  CHECK(!cache.GetVertexAttributesCurrent(&owner, 0));
+}
+
+int main() {
+  TestElision();
+  TestDisabledAndInvalidated();
+  TestVertexAttributes();
+  TestVertexAttributesOwner();
+  if (failures != 0) {
+    fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  printf("StateCacheGLES tests passed\n");
+  return 0;
+}